@@ -0,0 +1,384 @@
+#pragma once
+
+/*
+ * Glob patterns for paths, compiled into one bit-parallel automaton so that
+ * many patterns are matched in a single pass over path.
+ * @see GlobCompile()
+ *
+ * Syntax:
+ *   *       any bytes except '/'
+ *   ?       one byte except '/'
+ *   [a-z]   one byte in class, [!a-z] or [^a-z] for one byte not in class,
+ *           never '/'
+ *   **      as whole path component, any directories: "**" + "/" matches
+ *           zero or more directories, "/" + "**" at end matches everything
+ *           under directory
+ *   \x      byte x
+ * Pattern must match whole path, e.g. "*.log" does not match "var/a.log".
+ */
+
+#include "memory.h"
+#include "text.h"
+
+/*
+ * Each pattern is a line of states. Bytes outside of loops move to next
+ * state, and so does "**" + "/" without byte. Bit of state is at
+ * startState + n in state vector of all patterns.
+ */
+struct glob_pattern {
+  // literal bytes every match starts and ends with, escapes are removed
+  struct string prefix;
+  struct string suffix;
+  // count of bytes that are matched outside of loops
+  u64 minimumLength;
+  u64 startState;
+  u64 finalState;
+  b8 hasLoop;
+  // prefix and suffix decide match, NFA is not run, e.g. "build/" + "**"
+  // and "**" + "/*.log"
+  b8 isAffixOnly;
+  u8 _padding[6];
+};
+
+// most patterns take fewer than 16 states, so 1024 states is plenty
+#define GLOB_STATE_WORD_MAX 16
+
+struct glob {
+  struct glob_pattern *patterns;
+  u64 patternCount;
+  // u64 words of state vector
+  u64 wordCount;
+  // byte c moves state n to n + 1 when bit n + 1 of transitions[c * wordCount] is set
+  u64 *transitions;
+  // byte c keeps state n when bit n of loops[c * wordCount] is set
+  u64 *loops;
+  // states that also move to next one without byte, at start of path and
+  // right after '/', for "**/"
+  u64 *skips;
+  u64 *finals;
+};
+
+/*
+ * Parses one pattern. When glob is 0 only counts states.
+ * @param literals one byte per state after start, byte of literal that
+ *                 moves into it, unused when counting
+ * @return 0 when pattern is invalid
+ */
+internalfn b8
+GlobParsePattern(struct string *string, struct glob *glob, struct glob_pattern *pattern, u8 *literals)
+{
+  u64 state = pattern->startState;
+  u64 length = string->length;
+  u8 *value = string->value;
+  // first state that loops and first one reached by class, they end prefix
+  u64 prefixEnd = U64_MAX;
+  u64 suffixStart = pattern->startState;
+  u64 skipCount = 0;
+  pattern->hasLoop = 0;
+
+  for (u64 index = 0; index < length;) {
+    u8 character = value[index];
+    u64 set[4] = {0};
+    b8 isLiteral = 0;
+
+    if (character == '*') {
+      u64 end = index;
+      while (end < length && value[end] == '*')
+        end++;
+      b8 isComponent =
+          end - index >= 2 && (index == 0 || value[index - 1] == '/') && (end == length || value[end] == '/');
+      b8 isSkip = isComponent && end < length;
+      if (glob) {
+        u64 *loop = glob->loops + state / 64;
+        u64 bit = (u64)1 << (state % 64);
+        for (u32 byte = 0; byte < 256; byte++) {
+          if (isComponent || byte != '/')
+            loop[byte * glob->wordCount] |= bit;
+        }
+        if (isSkip)
+          glob->skips[state / 64] |= bit;
+      }
+      pattern->hasLoop = 1;
+      if (prefixEnd == U64_MAX)
+        prefixEnd = state;
+      suffixStart = state;
+      if (isSkip) {
+        // "**/" takes its '/', whatever follows is in state of its own, so
+        // it is not looped over
+        state++;
+        skipCount++;
+        suffixStart = state;
+        if (glob)
+          literals[state - pattern->startState - 1] = '/';
+      }
+      index = isSkip ? end + 1 : end;
+      continue;
+    }
+
+    if (character == '?') {
+      set[0] = set[1] = set[2] = set[3] = ~(u64)0;
+      index++;
+    } else if (character == '[') {
+      u64 end = index + 1;
+      b8 isNegated = end < length && (value[end] == '!' || value[end] == '^');
+      if (isNegated)
+        end++;
+      // ']' right after '[' is literal
+      for (u64 first = end; end < length && (value[end] != ']' || end == first); end++) {
+        u8 low = value[end];
+        if (low == '\\') {
+          if (end + 1 == length)
+            return 0;
+          low = value[++end];
+        }
+        u8 high = low;
+        if (end + 2 < length && value[end + 1] == '-' && value[end + 2] != ']') {
+          end += 2;
+          high = value[end];
+          if (high == '\\') {
+            if (end + 1 == length)
+              return 0;
+            high = value[++end];
+          }
+        }
+        for (u32 byte = low; byte <= high; byte++)
+          set[byte / 64] |= (u64)1 << (byte % 64);
+      }
+      if (end == length)
+        return 0;
+      if (isNegated) {
+        set[0] = ~set[0], set[1] = ~set[1], set[2] = ~set[2], set[3] = ~set[3];
+      }
+      index = end + 1;
+    } else {
+      if (character == '\\') {
+        if (index + 1 == length)
+          return 0;
+        character = value[++index];
+      }
+      set[character / 64] = (u64)1 << (character % 64);
+      isLiteral = 1;
+      index++;
+    }
+    if (!isLiteral)
+      set['/' / 64] &= ~((u64)1 << ('/' % 64));
+
+    state++;
+    if (!isLiteral) {
+      if (prefixEnd == U64_MAX)
+        prefixEnd = state - 1;
+      suffixStart = state;
+    }
+    if (glob) {
+      u64 *transition = glob->transitions + state / 64;
+      u64 bit = (u64)1 << (state % 64);
+      for (u32 byte = 0; byte < 256; byte++) {
+        if (set[byte / 64] & ((u64)1 << (byte % 64)))
+          transition[byte * glob->wordCount] |= bit;
+      }
+      literals[state - pattern->startState - 1] = character;
+    }
+  }
+
+  if (prefixEnd == U64_MAX)
+    prefixEnd = state;
+  pattern->finalState = state;
+  pattern->minimumLength = state - pattern->startState - skipCount;
+  // "dir/**" or "**", and "**" + "/*" followed by bytes without special
+  // meaning and without '/'
+  pattern->isAffixOnly = 0;
+  if (length >= 2 && value[length - 2] == '*' && value[length - 1] == '*' &&
+      (length == 2 || value[length - 3] == '/')) {
+    pattern->isAffixOnly = prefixEnd - pattern->startState == length - 2;
+  } else if (length >= 4 && value[0] == '*' && value[1] == '*' && value[2] == '/' && value[3] == '*') {
+    pattern->isAffixOnly = state - suffixStart == length - 4;
+    for (u64 index = 4; index < length; index++)
+      pattern->isAffixOnly &= value[index] != '/';
+  }
+
+  if (glob) {
+    pattern->prefix = StringFromBuffer(literals, prefixEnd - pattern->startState);
+    pattern->suffix = StringFromBuffer(literals + suffixStart - pattern->startState, state - suffixStart);
+  }
+  return 1;
+}
+
+/*
+ * Compiles patterns into one automaton. Lookup tables take 4 KiB per 64
+ * states, there is one state per byte of pattern and one per pattern.
+ *
+ * @param errorIndex optional, on failure set to index of invalid pattern,
+ *                   patternCount when arena is full or there are more than
+ *                   64 * GLOB_STATE_WORD_MAX states
+ * @return 0 on failure, arena is given back
+ *
+ * @code
+ *   struct string patterns[] = {StringFromLiteral("*.log"), StringFromLiteral("*.tmp")};
+ *   struct glob excluded;
+ *   if (!GlobCompile(arena, patterns, ARRAY_COUNT(patterns), &excluded, 0))
+ *     return 0;
+ *   if (GlobMatch(&excluded, &path, 0))
+ *     continue;
+ * @endcode
+ */
+internalfn b8
+GlobCompile(memory_arena *arena, struct string *patterns, u64 patternCount, struct glob *glob, u64 *errorIndex)
+{
+  // count states
+  u64 stateCount = 0;
+  u64 literalCount = 0;
+  for (u64 index = 0; index < patternCount; index++) {
+    struct glob_pattern pattern = {.startState = stateCount};
+    if (!GlobParsePattern(patterns + index, 0, &pattern, 0)) {
+      if (errorIndex)
+        *errorIndex = index;
+      return 0;
+    }
+    stateCount = pattern.finalState + 1;
+    literalCount += pattern.finalState - pattern.startState;
+  }
+
+  u64 wordCount = (stateCount + 63) / 64;
+  u64 tableSize = (2 * 256 + 2) * wordCount * sizeof(u64);
+  u64 size = tableSize + patternCount * sizeof(struct glob_pattern) + literalCount;
+  memory_temp temp = MemoryTempBegin(arena);
+  u64 *tables = MemoryArenaPushAligned(arena, 0, sizeof(u64));
+  if (wordCount > GLOB_STATE_WORD_MAX || (u64)((u8 *)tables - arena->block) + size > arena->total) {
+    MemoryTempEnd(&temp);
+    if (errorIndex)
+      *errorIndex = patternCount;
+    return 0;
+  }
+  arena->used += size;
+  MemoryClear(tables, tableSize);
+
+  glob->wordCount = wordCount;
+  glob->transitions = tables;
+  glob->loops = tables + 256 * wordCount;
+  glob->skips = tables + 2 * 256 * wordCount;
+  glob->finals = tables + (2 * 256 + 1) * wordCount;
+  glob->patterns = (struct glob_pattern *)(tables + (2 * 256 + 2) * wordCount);
+  glob->patternCount = patternCount;
+
+  u8 *literals = (u8 *)(glob->patterns + patternCount);
+  u64 state = 0;
+  for (u64 index = 0; index < patternCount; index++) {
+    struct glob_pattern *pattern = glob->patterns + index;
+    pattern->startState = state;
+    GlobParsePattern(patterns + index, glob, pattern, literals);
+    glob->finals[pattern->finalState / 64] |= (u64)1 << (pattern->finalState % 64);
+    literals += pattern->finalState - pattern->startState;
+    state = pattern->finalState + 1;
+  }
+
+  return 1;
+}
+
+/*
+ * Moves states that "**" + "/" lets skip to their next state.
+ */
+internalfn void
+GlobSkip(struct glob *glob, u64 *states)
+{
+  // "**/**/" skips twice
+  for (b8 isChanged = 1; isChanged;) {
+    isChanged = 0;
+    u64 carry = 0;
+    for (u64 word = 0; word < glob->wordCount; word++) {
+      u64 skipping = states[word] & glob->skips[word];
+      u64 next = states[word] | (skipping << 1) | carry;
+      carry = skipping >> 63;
+      isChanged |= next != states[word];
+      states[word] = next;
+    }
+  }
+}
+
+/*
+ * Matches path against all patterns at once. Patterns whose literal prefix,
+ * suffix or length rule path out are not started, and matching stops when
+ * no pattern is left. Patterns such as "build/" + "**" and
+ * "**" + "/" + "*.log" are decided by prefix and suffix alone.
+ *
+ * @param patternIndex optional, set to index of first pattern that matches
+ * @return 1 when any pattern matches whole path
+ *
+ * @code
+ *   // directory of file, "" when path has no directory
+ *   struct string directory = PathGetDirectory(&path);
+ *   if (GlobMatch(&ignoredDirectories, &directory, 0))
+ *     continue;
+ * @endcode
+ */
+internalfn b8
+GlobMatch(struct glob *glob, struct string *path, u64 *patternIndex)
+{
+  u64 wordCount = glob->wordCount;
+  u64 states[GLOB_STATE_WORD_MAX] = {0};
+  b8 isAnyStarted = 0;
+  // patterns after one that matches by prefix and suffix alone cannot be first
+  u64 affixMatchIndex = glob->patternCount;
+  for (u64 index = 0; index < glob->patternCount; index++) {
+    struct glob_pattern *pattern = glob->patterns + index;
+    if (path->length < pattern->minimumLength || (!pattern->hasLoop && path->length != pattern->minimumLength))
+      continue;
+    if (pattern->prefix.length != 0 && !IsStringStartsWith(path, &pattern->prefix))
+      continue;
+    if (pattern->suffix.length != 0 && !IsStringEndsWith(path, &pattern->suffix))
+      continue;
+    if (pattern->isAffixOnly) {
+      affixMatchIndex = index;
+      break;
+    }
+    states[pattern->startState / 64] |= (u64)1 << (pattern->startState % 64);
+    isAnyStarted = 1;
+  }
+
+  b8 isAffixMatch = affixMatchIndex != glob->patternCount;
+  if (isAffixMatch && (!patternIndex || !isAnyStarted)) {
+    if (patternIndex)
+      *patternIndex = affixMatchIndex;
+    return 1;
+  }
+  if (!isAnyStarted)
+    return 0;
+
+  GlobSkip(glob, states);
+  for (u64 index = 0; index < path->length; index++) {
+    u8 character = path->value[index];
+    u64 *transitions = glob->transitions + character * wordCount;
+    u64 *loops = glob->loops + character * wordCount;
+    u64 carry = 0;
+    u64 active = 0;
+    for (u64 word = 0; word < wordCount; word++) {
+      u64 next = (((states[word] << 1) | carry) & transitions[word]) | (states[word] & loops[word]);
+      carry = states[word] >> 63;
+      states[word] = next;
+      active |= next;
+    }
+    if (!active)
+      break;
+    if (character == '/')
+      GlobSkip(glob, states);
+  }
+
+  for (u64 word = 0; word < wordCount; word++) {
+    u64 matches = states[word] & glob->finals[word];
+    if (!matches)
+      continue;
+    if (patternIndex) {
+      u64 state = word * 64 + (u64)__builtin_ctzll(matches);
+      for (u64 index = 0; index < glob->patternCount; index++) {
+        if (glob->patterns[index].finalState == state) {
+          *patternIndex = index;
+          break;
+        }
+      }
+    }
+    return 1;
+  }
+
+  if (isAffixMatch && patternIndex)
+    *patternIndex = affixMatchIndex;
+  return isAffixMatch;
+}
@@ -0,0 +1,939 @@
+#pragma once
+
+/*
+ * JSON parser in two stages.
+ * Stage one finds positions of structural characters 64 bytes at a time.
+ * Stage two walks these positions and writes tape of values that refer back
+ * into input.
+ * @see JSONParse()
+ *
+ * JSON writer that appends to string builder.
+ * @see JSONWriterFrom()
+ */
+
+#include "memory.h"
+#include "string_builder.h"
+#include "string_cursor.h"
+#include "text.h"
+
+enum json_type {
+  JSON_TYPE_NULL,
+  JSON_TYPE_BOOLEAN,
+  JSON_TYPE_NUMBER,
+  JSON_TYPE_STRING,
+  JSON_TYPE_ARRAY,
+  JSON_TYPE_OBJECT,
+};
+
+/*
+ * Object children are key and value one after another.
+ */
+struct json_value {
+  enum json_type type;
+  // values in array, keys in object
+  u32 count;
+  // tape entries taken by value and its children, next sibling is value + size
+  u64 size;
+  // string is without quotes and escapes are not decoded, see JSONUnescape()
+  // array and object are whole text
+  struct string text;
+};
+
+struct json_tape {
+  struct json_value *values;
+  u64 count;
+};
+
+struct json_block {
+  u64 quotes;
+  u64 backslashes;
+  // {}[]:,
+  u64 operators;
+  u64 whitespace;
+  // [0x00, 0x1f]
+  u64 controls;
+};
+
+internalfn void
+JSONClassifyBlock(u8 *block, struct json_block *result)
+{
+  *result = (struct json_block){0};
+#if defined(__AVX2__)
+#define EQUAL(vector, character) _mm256_cmpeq_epi8(vector, _mm256_set1_epi8(character))
+  for (u32 index = 0; index < 2; index++) {
+    __m256i chunk = _mm256_loadu_si256((__m256i *)(block + index * 32));
+    // '[' | 0x20 is '{', ']' | 0x20 is '}'
+    __m256i lower = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+    __m256i operators = _mm256_or_si256(_mm256_or_si256(EQUAL(lower, '{'), EQUAL(lower, '}')),
+                                        _mm256_or_si256(EQUAL(chunk, ':'), EQUAL(chunk, ',')));
+    __m256i whitespace = _mm256_or_si256(_mm256_or_si256(EQUAL(chunk, ' '), EQUAL(chunk, '\t')),
+                                         _mm256_or_si256(EQUAL(chunk, '\n'), EQUAL(chunk, '\r')));
+    __m256i controls = _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, _mm256_set1_epi8(0x1f)), _mm256_set1_epi8(0x1f));
+
+    u32 shift = index * 32;
+    result->quotes |= (u64)(u32)_mm256_movemask_epi8(EQUAL(chunk, '"')) << shift;
+    result->backslashes |= (u64)(u32)_mm256_movemask_epi8(EQUAL(chunk, '\\')) << shift;
+    result->operators |= (u64)(u32)_mm256_movemask_epi8(operators) << shift;
+    result->whitespace |= (u64)(u32)_mm256_movemask_epi8(whitespace) << shift;
+    result->controls |= (u64)(u32)_mm256_movemask_epi8(controls) << shift;
+  }
+#undef EQUAL
+#elif defined(__SSE2__)
+#define EQUAL(vector, character) _mm_cmpeq_epi8(vector, _mm_set1_epi8(character))
+  for (u32 index = 0; index < 4; index++) {
+    __m128i chunk = _mm_loadu_si128((__m128i *)(block + index * 16));
+    // '[' | 0x20 is '{', ']' | 0x20 is '}'
+    __m128i lower = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+    __m128i operators = _mm_or_si128(_mm_or_si128(EQUAL(lower, '{'), EQUAL(lower, '}')),
+                                     _mm_or_si128(EQUAL(chunk, ':'), EQUAL(chunk, ',')));
+    __m128i whitespace = _mm_or_si128(_mm_or_si128(EQUAL(chunk, ' '), EQUAL(chunk, '\t')),
+                                      _mm_or_si128(EQUAL(chunk, '\n'), EQUAL(chunk, '\r')));
+    __m128i controls = _mm_cmpeq_epi8(_mm_max_epu8(chunk, _mm_set1_epi8(0x1f)), _mm_set1_epi8(0x1f));
+
+    u32 shift = index * 16;
+    result->quotes |= (u64)(u32)_mm_movemask_epi8(EQUAL(chunk, '"')) << shift;
+    result->backslashes |= (u64)(u32)_mm_movemask_epi8(EQUAL(chunk, '\\')) << shift;
+    result->operators |= (u64)(u32)_mm_movemask_epi8(operators) << shift;
+    result->whitespace |= (u64)(u32)_mm_movemask_epi8(whitespace) << shift;
+    result->controls |= (u64)(u32)_mm_movemask_epi8(controls) << shift;
+  }
+#undef EQUAL
+#else
+  for (u32 index = 0; index < 64; index++) {
+    u8 character = block[index];
+    u8 lower = character | 0x20;
+    u64 bit = (u64)1 << index;
+    result->quotes |= character == '"' ? bit : 0;
+    result->backslashes |= character == '\\' ? bit : 0;
+    result->operators |= (lower == '{' || lower == '}' || character == ':' || character == ',') ? bit : 0;
+    result->whitespace |= (character == ' ' || character == '\t' || character == '\n' || character == '\r') ? bit : 0;
+    result->controls |= character <= 0x1f ? bit : 0;
+  }
+#endif
+}
+
+/*
+ * @param isNextEscaped in: first byte is escaped by backslash in previous
+ *                      block, out: same for next block
+ * @return bit n is set when block[n] is escaped by backslash
+ */
+internalfn u64
+JSONEscapedMask64(u64 backslashes, u64 *isNextEscaped)
+{
+  // backslash series starting at even position escapes character at odd
+  // position when it is odd long, borrow of subtraction runs through series
+  comptime u64 ODD_BITS = 0xaaaaaaaaaaaaaaaa;
+  u64 potentialEscapes = backslashes & ~*isNextEscaped;
+  u64 maybeEscaped = potentialEscapes << 1;
+  u64 escapesAndTerminals = ((maybeEscaped | ODD_BITS) - potentialEscapes) ^ ODD_BITS;
+  u64 escaped = escapesAndTerminals ^ (backslashes | *isNextEscaped);
+  *isNextEscaped = (escapesAndTerminals & backslashes) >> 63;
+  return escaped;
+}
+
+/*
+ * @param position of byte after backslash
+ * @return true if escape is one that JSON defines, \" \\ \/ \b \f \n \r \t
+ *         or \u with 4 hex digits
+ */
+internalfn b8
+IsJSONEscape(struct string *source, u64 position)
+{
+  u8 escape = source->value[position];
+  if (escape != 'u')
+    return escape == '"' || escape == '\\' || escape == '/' || escape == 'b' || escape == 'f' || escape == 'n' ||
+           escape == 'r' || escape == 't';
+
+  if (source->length - position <= 4)
+    return 0;
+  for (u64 index = position + 1; index <= position + 4; index++) {
+    u8 character = source->value[index];
+    if ((u8)(character - '0') > 9 && (u8)((character | 0x20) - 'a') > 5)
+      return 0;
+  }
+  return 1;
+}
+
+/*
+ * Stage one.
+ * Writes positions of operators, quotes and first bytes of numbers and
+ * literals into free space of arena. Last position is source length.
+ * @return true if index fits into arena and strings are well formed
+ */
+internalfn b8
+JSONIndexStructurals(memory_arena *arena, struct string *source, u32 **positions, u64 *count, u64 *errorIndex)
+{
+  memory_temp temp = MemoryTempBegin(arena);
+  u32 *output = MemoryArenaPushAligned(arena, 0, sizeof(u64));
+  u64 capacity = arena->used < arena->total ? (arena->total - arena->used) / sizeof(*output) : 0;
+  u64 outputCount = 0;
+  u64 errorPosition = U64_MAX;
+
+  if (source->length >= U32_MAX) {
+    errorPosition = 0;
+    goto error;
+  }
+
+  u64 isNextEscaped = 0;
+  u64 inStringCarry = 0;
+  u64 scalarCarry = 0;
+  for (u64 blockStart = 0; blockStart < source->length; blockStart += 64) {
+    u8 *block = source->value + blockStart;
+    u64 validMask = U64_MAX;
+    u8 tail[64];
+    if (blockStart + 64 > source->length) {
+      u64 length = source->length - blockStart;
+      for (u32 index = 0; index < ARRAY_COUNT(tail); index++)
+        tail[index] = ' ';
+      MemoryCopy(tail, block, length);
+      block = tail;
+      validMask = ((u64)1 << length) - 1;
+    }
+
+    struct json_block classes;
+    JSONClassifyBlock(block, &classes);
+
+    u64 escaped = JSONEscapedMask64(classes.backslashes, &isNextEscaped);
+    u64 quotes = classes.quotes & ~escaped;
+    // opening quote and string bytes are set, closing quote is not
+    u64 inString = PrefixXor64(quotes) ^ inStringCarry;
+    inStringCarry = (u64)((s64)inString >> 63);
+
+    u64 errors = classes.controls & inString & validMask;
+    if (errors) {
+      errorPosition = blockStart + (u64)__builtin_ctzll(errors);
+      goto error;
+    }
+
+    // escapes are rare, they are checked one by one
+    u64 escapes = escaped & inString & validMask;
+    while (escapes) {
+      u64 position = blockStart + (u64)__builtin_ctzll(escapes);
+      if (!IsJSONEscape(source, position)) {
+        errorPosition = position;
+        goto error;
+      }
+      escapes &= escapes - 1;
+    }
+
+    u64 operators = classes.operators & ~inString;
+    u64 scalars = ~(classes.operators | classes.whitespace | quotes | inString);
+    u64 scalarStarts = scalars & ~((scalars << 1) | scalarCarry);
+    scalarCarry = scalars >> 63;
+
+    u64 structurals = (operators | quotes | scalarStarts) & validMask;
+    // one more for source length
+    if (outputCount + (u64)__builtin_popcountll(structurals) + 1 > capacity) {
+      errorPosition = blockStart;
+      goto error;
+    }
+
+    while (structurals) {
+      output[outputCount++] = (u32)(blockStart + (u64)__builtin_ctzll(structurals));
+      structurals &= structurals - 1;
+    }
+  }
+
+  if (inStringCarry) {
+    errorPosition = source->length;
+    goto error;
+  }
+
+  if (outputCount + 1 > capacity) {
+    errorPosition = source->length;
+    goto error;
+  }
+  output[outputCount] = (u32)source->length;
+
+  arena->used += (outputCount + 1) * sizeof(*output);
+  *positions = output;
+  *count = outputCount;
+  return 1;
+
+error:
+  MemoryTempEnd(&temp);
+  if (errorIndex)
+    *errorIndex = errorPosition;
+  return 0;
+}
+
+/*
+ * @return true if text is number as JSON defines
+ *         -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+ */
+internalfn b8
+IsJSONNumber(struct string *text)
+{
+  u8 *cursor = text->value;
+  u8 *end = text->value + text->length;
+
+  if (cursor < end && *cursor == '-')
+    cursor++;
+
+  if (cursor == end)
+    return 0;
+  if (*cursor == '0') {
+    cursor++;
+  } else if ((u8)(*cursor - '1') < 9) {
+    while (cursor < end && (u8)(*cursor - '0') < 10)
+      cursor++;
+  } else {
+    return 0;
+  }
+
+  if (cursor < end && *cursor == '.') {
+    cursor++;
+    if (cursor == end || (u8)(*cursor - '0') >= 10)
+      return 0;
+    while (cursor < end && (u8)(*cursor - '0') < 10)
+      cursor++;
+  }
+
+  if (cursor < end && (*cursor == 'e' || *cursor == 'E')) {
+    cursor++;
+    if (cursor < end && (*cursor == '-' || *cursor == '+'))
+      cursor++;
+    if (cursor == end || (u8)(*cursor - '0') >= 10)
+      return 0;
+    while (cursor < end && (u8)(*cursor - '0') < 10)
+      cursor++;
+  }
+
+  return cursor == end;
+}
+
+/*
+ * Parses source into tape of values, allocated from arena.
+ * Strings, numbers and literals point into source.
+ * @param errorIndex optional, byte position where parsing failed
+ * @return true if source is valid UTF-8 JSON and tape fits into arena
+ *         false otherwise, arena is left untouched
+ * @code
+ *   struct json_tape tape;
+ *   if (JSONParse(arena, &text, &tape, 0)) {
+ *     struct json_value *root = tape.values;
+ *     struct json_value *name = JSONObjectGet(root, &StringFromLiteral("name"));
+ *   }
+ * @endcode
+ */
+internalfn b8
+JSONParse(memory_arena *arena, struct string *source, struct json_tape *tape, u64 *errorIndex)
+{
+  u64 invalidIndex;
+  if (StringIndexOfInvalidUTF8(source, &invalidIndex)) {
+    if (errorIndex)
+      *errorIndex = invalidIndex;
+    return 0;
+  }
+
+  memory_temp temp = MemoryTempBegin(arena);
+  u32 *positions;
+  u64 positionCount;
+  if (!JSONIndexStructurals(arena, source, &positions, &positionCount, errorIndex))
+    return 0;
+
+  // every value starts at structural
+  u64 valueCapacity = positionCount;
+  struct json_value *values = MemoryArenaPushAligned(arena, 0, sizeof(u64));
+  if (arena->used > arena->total || (arena->total - arena->used) / sizeof(*values) < valueCapacity) {
+    MemoryTempEnd(&temp);
+    if (errorIndex)
+      *errorIndex = 0;
+    return 0;
+  }
+
+  enum {
+    EXPECT_VALUE,
+    EXPECT_VALUE_OR_CLOSE,
+    EXPECT_KEY,
+    EXPECT_KEY_OR_CLOSE,
+    EXPECT_COLON,
+    EXPECT_COMMA_OR_CLOSE,
+    EXPECT_NOTHING,
+  } expect = EXPECT_VALUE;
+
+  u64 valueCount = 0;
+  // open containers are linked through size until they are closed
+  u64 parent = U64_MAX;
+  u64 positionIndex = 0;
+  u64 position = 0;
+  for (; positionIndex < positionCount; positionIndex++) {
+    position = positions[positionIndex];
+    u8 character = source->value[position];
+
+    switch (expect) {
+    case EXPECT_KEY_OR_CLOSE:
+      if (character == '}')
+        goto close;
+      // fallthrough
+    case EXPECT_KEY: {
+      if (character != '"')
+        goto error;
+      u64 closingQuote = positions[++positionIndex];
+      values[valueCount++] = (struct json_value){
+          .type = JSON_TYPE_STRING,
+          .size = 1,
+          .text = StringFromBuffer(source->value + position + 1, closingQuote - position - 1),
+      };
+      expect = EXPECT_COLON;
+    } break;
+
+    case EXPECT_COLON:
+      if (character != ':')
+        goto error;
+      expect = EXPECT_VALUE;
+      break;
+
+    case EXPECT_VALUE_OR_CLOSE:
+      if (character == ']')
+        goto close;
+      // fallthrough
+    case EXPECT_VALUE: {
+      if (parent != U64_MAX)
+        values[parent].count++;
+
+      struct json_value *value = values + valueCount++;
+      if (character == '{' || character == '[') {
+        *value = (struct json_value){
+            .type = character == '{' ? JSON_TYPE_OBJECT : JSON_TYPE_ARRAY,
+            .size = parent,
+            .text = StringFromBuffer(source->value + position, 0),
+        };
+        parent = (u64)(value - values);
+        expect = character == '{' ? EXPECT_KEY_OR_CLOSE : EXPECT_VALUE_OR_CLOSE;
+        break;
+      }
+
+      if (character == '"') {
+        u64 closingQuote = positions[++positionIndex];
+        *value = (struct json_value){
+            .type = JSON_TYPE_STRING,
+            .size = 1,
+            .text = StringFromBuffer(source->value + position + 1, closingQuote - position - 1),
+        };
+      } else {
+        // scalar ends at whitespace before next structural
+        u64 end = positions[positionIndex + 1];
+        while (end > position && (source->value[end - 1] == ' ' || source->value[end - 1] == '\t' ||
+                                  source->value[end - 1] == '\n' || source->value[end - 1] == '\r'))
+          end--;
+        struct string text = StringFromBuffer(source->value + position, end - position);
+
+        enum json_type type;
+        if (character == 'n' && IsStringEqual(&text, &StringFromLiteral("null")))
+          type = JSON_TYPE_NULL;
+        else if ((character == 't' && IsStringEqual(&text, &StringFromLiteral("true"))) ||
+                 (character == 'f' && IsStringEqual(&text, &StringFromLiteral("false"))))
+          type = JSON_TYPE_BOOLEAN;
+        else if (IsJSONNumber(&text))
+          type = JSON_TYPE_NUMBER;
+        else
+          goto error;
+
+        *value = (struct json_value){
+            .type = type,
+            .size = 1,
+            .text = text,
+        };
+      }
+      expect = parent == U64_MAX ? EXPECT_NOTHING : EXPECT_COMMA_OR_CLOSE;
+    } break;
+
+    case EXPECT_COMMA_OR_CLOSE:
+      if (character == ',') {
+        expect = values[parent].type == JSON_TYPE_OBJECT ? EXPECT_KEY : EXPECT_VALUE;
+        break;
+      }
+      if ((character == '}' && values[parent].type == JSON_TYPE_OBJECT) ||
+          (character == ']' && values[parent].type == JSON_TYPE_ARRAY))
+        goto close;
+      goto error;
+
+    case EXPECT_NOTHING:
+      goto error;
+    }
+    continue;
+
+  close: {
+    struct json_value *container = values + parent;
+    parent = container->size;
+    container->size = valueCount - (u64)(container - values);
+    container->text.length = (u64)(source->value + position + 1 - container->text.value);
+    expect = parent == U64_MAX ? EXPECT_NOTHING : EXPECT_COMMA_OR_CLOSE;
+  }
+  }
+
+  if (expect != EXPECT_NOTHING) {
+    position = source->length;
+    goto error;
+  }
+
+  // positions are not needed anymore
+  struct json_value *tapeValues = (struct json_value *)(void *)positions;
+  MemoryMove(tapeValues, values, valueCount * sizeof(*values));
+  arena->used = (u64)((u8 *)(tapeValues + valueCount) - arena->block);
+
+  *tape = (struct json_tape){
+      .values = tapeValues,
+      .count = valueCount,
+  };
+  return 1;
+
+error:
+  MemoryTempEnd(&temp);
+  if (errorIndex)
+    *errorIndex = position;
+  return 0;
+}
+
+/*
+ * @return value of key in object
+ *         0 if key not found
+ */
+internalfn struct json_value *
+JSONObjectGet(struct json_value *object, struct string *key)
+{
+  if (object->type != JSON_TYPE_OBJECT)
+    return 0;
+
+  struct json_value *child = object + 1;
+  for (u32 index = 0; index < object->count; index++) {
+    struct json_value *value = child + 1;
+    if (IsStringEqual(&child->text, key))
+      return value;
+    child = value + value->size;
+  }
+  return 0;
+}
+
+/*
+ * @return value at index of array
+ *         0 if index is out of bounds
+ */
+internalfn struct json_value *
+JSONArrayGet(struct json_value *array, u64 index)
+{
+  if (array->type != JSON_TYPE_ARRAY || index >= array->count)
+    return 0;
+
+  struct json_value *child = array + 1;
+  for (u64 childIndex = 0; childIndex < index; childIndex++)
+    child += child->size;
+  return child;
+}
+
+internalfn b8
+JSONValueGetBoolean(struct json_value *value, b8 *result)
+{
+  if (value->type != JSON_TYPE_BOOLEAN)
+    return 0;
+  *result = value->text.value[0] == 't';
+  return 1;
+}
+
+internalfn b8
+JSONValueGetU64(struct json_value *value, u64 *result)
+{
+  if (value->type != JSON_TYPE_NUMBER)
+    return 0;
+  return ParseU64(&value->text, result);
+}
+
+internalfn b8
+JSONValueGetS64(struct json_value *value, s64 *result)
+{
+  if (value->type != JSON_TYPE_NUMBER)
+    return 0;
+
+  b8 isNegative = value->text.value[0] == '-';
+  struct string digits = isNegative ? StringFromBuffer(value->text.value + 1, value->text.length - 1) : value->text;
+  u64 magnitude;
+  if (!ParseU64(&digits, &magnitude) || magnitude > (u64)S64_MAX + isNegative)
+    return 0;
+
+  *result = isNegative ? (s64)(0 - magnitude) : (s64)magnitude;
+  return 1;
+}
+
+internalfn b8
+JSONValueGetF64(struct json_value *value, f64 *result)
+{
+  if (value->type != JSON_TYPE_NUMBER)
+    return 0;
+  return ParseF64(&value->text, result);
+}
+
+/*
+ * Decodes escapes of string in place, e.g. \n, \u00e9, \ud83d\ude00.
+ * @return decoded string
+ *         null if escape is invalid
+ */
+internalfn struct string
+JSONUnescape(struct string *string)
+{
+  u64 index;
+  if (!StringIndexOf(string, &StringFromLiteral("\\"), &index))
+    return *string;
+
+  u8 *value = string->value;
+  u64 length = index;
+  while (index < string->length) {
+    u8 character = value[index];
+    if (character != '\\') {
+      value[length++] = character;
+      index++;
+      continue;
+    }
+
+    if (index + 1 == string->length)
+      return StringNull();
+
+    u8 escape = value[index + 1];
+    index += 2;
+    switch (escape) {
+    case '"':
+    case '\\':
+    case '/':
+      value[length++] = escape;
+      break;
+    case 'b':
+      value[length++] = '\b';
+      break;
+    case 'f':
+      value[length++] = '\f';
+      break;
+    case 'n':
+      value[length++] = '\n';
+      break;
+    case 'r':
+      value[length++] = '\r';
+      break;
+    case 't':
+      value[length++] = '\t';
+      break;
+    case 'u': {
+      u64 codepoint;
+      struct string hex = StringFromBuffer(value + index, 4);
+      if (index + 4 > string->length || !ParseHex(&hex, &codepoint))
+        return StringNull();
+      index += 4;
+
+      // surrogate pair
+      if (codepoint >= 0xdc00 && codepoint <= 0xdfff)
+        return StringNull();
+      if (codepoint >= 0xd800 && codepoint <= 0xdbff) {
+        u64 low;
+        hex = StringFromBuffer(value + index + 2, 4);
+        if (index + 6 > string->length || value[index] != '\\' || value[index + 1] != 'u' || !ParseHex(&hex, &low) ||
+            low < 0xdc00 || low > 0xdfff)
+          return StringNull();
+        index += 6;
+        codepoint = 0x10000 + ((codepoint - 0xd800) << 10) + (low - 0xdc00);
+      }
+
+      length += UTF8EncodeCodepoint(value + length, (u32)codepoint);
+    } break;
+    default:
+      return StringNull();
+    }
+  }
+
+  return StringFromBuffer(value, length);
+}
+
+/*
+ * @return bit n is set when block[n] must be escaped in JSON string,
+ *         which is '"', '\\' and [0x00, 0x1f]
+ */
+internalfn u32
+JSONEscapeMask32(u8 *block)
+{
+#if defined(__AVX2__)
+  __m256i chunk = _mm256_loadu_si256((__m256i *)block);
+  __m256i controls = _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, _mm256_set1_epi8(0x1f)), _mm256_set1_epi8(0x1f));
+  __m256i quotes = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'));
+  __m256i backslashes = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\'));
+  return (u32)_mm256_movemask_epi8(_mm256_or_si256(controls, _mm256_or_si256(quotes, backslashes)));
+#elif defined(__SSE2__)
+  u32 result = 0;
+  for (u32 index = 0; index < 2; index++) {
+    __m128i chunk = _mm_loadu_si128((__m128i *)(block + index * 16));
+    __m128i controls = _mm_cmpeq_epi8(_mm_max_epu8(chunk, _mm_set1_epi8(0x1f)), _mm_set1_epi8(0x1f));
+    __m128i quotes = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'));
+    __m128i backslashes = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'));
+    result |= (u32)_mm_movemask_epi8(_mm_or_si128(controls, _mm_or_si128(quotes, backslashes))) << (index * 16);
+  }
+  return result;
+#else
+  // high bit of each byte lane marks match, adding 0x7f to low 7 bits does not
+  // carry into next lane
+  comptime u64 LOW_BITS = 0x7f7f7f7f7f7f7f7f;
+  comptime u64 HIGH_BITS = 0x8080808080808080;
+  u32 result = 0;
+  for (u32 index = 0; index < 4; index++) {
+    u64 lanes;
+    MemoryCopy(&lanes, block + index * 8, sizeof(lanes));
+    u64 controls = ~(((lanes & LOW_BITS) + 0x6060606060606060) | lanes);
+    u64 quotes = lanes ^ 0x2222222222222222;
+    quotes = ~(((quotes & LOW_BITS) + LOW_BITS) | quotes);
+    u64 backslashes = lanes ^ 0x5c5c5c5c5c5c5c5c;
+    backslashes = ~(((backslashes & LOW_BITS) + LOW_BITS) | backslashes);
+    u64 matches = (controls | quotes | backslashes) & HIGH_BITS;
+    // gather high bits of lanes into low byte
+    result |= (u32)(((matches >> 7) * 0x0102040810204080) >> 56) << (index * 8);
+  }
+  return result;
+#endif
+}
+
+/*
+ * Appends string with quotes, escaping bytes that JSON does not allow in
+ * strings. Bytes that need no escape are copied 32 at a time.
+ *
+ * @code
+ *   // "tab\there"
+ *   StringBuilderAppendJSONString(sb, &StringFromLiteral("tab\there"));
+ * @endcode
+ */
+internalfn void
+StringBuilderAppendJSONString(string_builder *stringBuilder, struct string *string)
+{
+  struct string *outBuffer = stringBuilder->outBuffer;
+  u8 *dest = outBuffer->value + stringBuilder->length;
+  u8 *source = string->value;
+  u64 length = string->length;
+
+  *dest++ = '"';
+
+  u64 index = 0;
+  u8 tail[32] = {0};
+  while (index < length) {
+    u8 *block = source + index;
+    u64 blockLength = 32;
+    u32 mask;
+    if (index + 32 <= length) {
+      mask = JSONEscapeMask32(block);
+    } else {
+      // last block is shorter, bits past its end are ignored
+      blockLength = length - index;
+      MemoryCopy(tail, block, blockLength);
+      mask = JSONEscapeMask32(tail) & (((u32)1 << blockLength) - 1);
+    }
+
+    if (mask == 0) {
+      MemoryCopy(dest, block, blockLength);
+      dest += blockLength;
+      index += blockLength;
+      continue;
+    }
+
+    u32 cleanCount = (u32)__builtin_ctz(mask);
+    MemoryCopy(dest, block, cleanCount);
+    dest += cleanCount;
+    index += cleanCount + 1;
+
+    u8 character = block[cleanCount];
+    comptime u8 shortEscapes[] = {
+        ['\b'] = 'b', ['\t'] = 't', ['\n'] = 'n', ['\f'] = 'f', ['\r'] = 'r', ['"'] = '"', ['\\'] = '\\',
+    };
+    u8 shortEscape = character < ARRAY_COUNT(shortEscapes) ? shortEscapes[character] : 0;
+    if (shortEscape) {
+      dest[0] = '\\';
+      dest[1] = shortEscape;
+      dest += 2;
+    } else {
+      dest[0] = '\\';
+      dest[1] = 'u';
+      dest[2] = '0';
+      dest[3] = '0';
+      dest[4] = (u8)("0123456789abcdef"[character >> 4]);
+      dest[5] = (u8)("0123456789abcdef"[character & 15]);
+      dest += 6;
+    }
+  }
+
+  *dest++ = '"';
+
+  stringBuilder->length = (u64)(dest - outBuffer->value);
+  debug_assert(stringBuilder->length <= outBuffer->length);
+}
+
+/*
+ * Writes JSON text one token at a time. Commas and colons are placed by
+ * writer. State of each open container is one bit, so nesting costs nothing
+ * and is limited to 64 levels.
+ *
+ * @code
+ *   // {"name":"x","sizes":[1,2]}
+ *   struct json_writer writer = JSONWriterFrom(sb);
+ *   JSONWriterBeginObject(&writer);
+ *   JSONWriterKey(&writer, &StringFromLiteral("name"));
+ *   JSONWriterString(&writer, &StringFromLiteral("x"));
+ *   JSONWriterKey(&writer, &StringFromLiteral("sizes"));
+ *   JSONWriterBeginArray(&writer);
+ *   JSONWriterU64(&writer, 1);
+ *   JSONWriterU64(&writer, 2);
+ *   JSONWriterEndArray(&writer);
+ *   JSONWriterEndObject(&writer);
+ * @endcode
+ */
+struct json_writer {
+  string_builder *stringBuilder;
+  // bit n is set when container at depth n is object
+  u64 objects;
+  // bit n is set when container at depth n has at least one element
+  u64 nonEmpty;
+  // count of open containers
+  u32 depth;
+  // key is written, value must follow
+  b8 isAfterKey;
+  u8 _padding[3];
+};
+
+/*
+ * @param stringBuilder string buffer must be able to hold 32 bytes for
+ *                      numbers
+ */
+internalfn struct json_writer
+JSONWriterFrom(string_builder *stringBuilder)
+{
+  return (struct json_writer){.stringBuilder = stringBuilder};
+}
+
+/*
+ * Writes comma when value is not first in its container.
+ */
+internalfn void
+JSONWriterSeparate(struct json_writer *writer)
+{
+  if (writer->isAfterKey) {
+    writer->isAfterKey = 0;
+    return;
+  }
+
+  if (writer->depth == 0)
+    return;
+
+  u64 bit = (u64)1 << (writer->depth - 1);
+  debug_assert(!(writer->objects & bit) && "value in object must follow key");
+  if (writer->nonEmpty & bit)
+    StringBuilderAppendStringLiteral(writer->stringBuilder, ",");
+  writer->nonEmpty |= bit;
+}
+
+internalfn void
+JSONWriterBegin(struct json_writer *writer, b8 isObject)
+{
+  JSONWriterSeparate(writer);
+  debug_assert(writer->depth < 64 && "nesting is too deep");
+
+  u64 bit = (u64)1 << writer->depth;
+  writer->objects = isObject ? writer->objects | bit : writer->objects & ~bit;
+  writer->nonEmpty &= ~bit;
+  writer->depth++;
+  StringBuilderAppendString(writer->stringBuilder, isObject ? &StringFromLiteral("{") : &StringFromLiteral("["));
+}
+
+internalfn void
+JSONWriterEnd(struct json_writer *writer, b8 isObject)
+{
+  debug_assert(writer->depth > 0 && !writer->isAfterKey);
+  writer->depth--;
+  debug_assert(isObject == (b8)((writer->objects >> writer->depth) & 1) && "container type must match");
+  StringBuilderAppendString(writer->stringBuilder, isObject ? &StringFromLiteral("}") : &StringFromLiteral("]"));
+}
+
+internalfn void
+JSONWriterBeginObject(struct json_writer *writer)
+{
+  JSONWriterBegin(writer, 1);
+}
+
+internalfn void
+JSONWriterEndObject(struct json_writer *writer)
+{
+  JSONWriterEnd(writer, 1);
+}
+
+internalfn void
+JSONWriterBeginArray(struct json_writer *writer)
+{
+  JSONWriterBegin(writer, 0);
+}
+
+internalfn void
+JSONWriterEndArray(struct json_writer *writer)
+{
+  JSONWriterEnd(writer, 0);
+}
+
+/*
+ * Writes key of object member, next call must write its value.
+ */
+internalfn void
+JSONWriterKey(struct json_writer *writer, struct string *key)
+{
+  debug_assert(writer->depth > 0 && !writer->isAfterKey);
+  u64 bit = (u64)1 << (writer->depth - 1);
+  debug_assert((writer->objects & bit) && "key must be in object");
+  if (writer->nonEmpty & bit)
+    StringBuilderAppendStringLiteral(writer->stringBuilder, ",");
+  writer->nonEmpty |= bit;
+
+  StringBuilderAppendJSONString(writer->stringBuilder, key);
+  StringBuilderAppendStringLiteral(writer->stringBuilder, ":");
+  writer->isAfterKey = 1;
+}
+
+internalfn void
+JSONWriterString(struct json_writer *writer, struct string *value)
+{
+  JSONWriterSeparate(writer);
+  StringBuilderAppendJSONString(writer->stringBuilder, value);
+}
+
+internalfn void
+JSONWriterU64(struct json_writer *writer, u64 value)
+{
+  JSONWriterSeparate(writer);
+  StringBuilderAppendU64(writer->stringBuilder, value);
+}
+
+internalfn void
+JSONWriterS64(struct json_writer *writer, s64 value)
+{
+  JSONWriterSeparate(writer);
+  if (value < 0)
+    StringBuilderAppendStringLiteral(writer->stringBuilder, "-");
+  // magnitude of S64_MIN does not fit in s64
+  StringBuilderAppendU64(writer->stringBuilder, value < 0 ? (u64)0 - (u64)value : (u64)value);
+}
+
+/*
+ * NaN and infinity have no JSON form, they are written as null.
+ * @param fractionCount [1, 51]
+ */
+internalfn void
+JSONWriterF32(struct json_writer *writer, f32 value, u32 fractionCount)
+{
+  JSONWriterSeparate(writer);
+  // NaN is not equal to itself, infinity minus infinity is NaN
+  if (value - value != 0)
+    StringBuilderAppendStringLiteral(writer->stringBuilder, "null");
+  else
+    StringBuilderAppendF32(writer->stringBuilder, value, fractionCount);
+}
+
+internalfn void
+JSONWriterBoolean(struct json_writer *writer, b8 value)
+{
+  JSONWriterSeparate(writer);
+  StringBuilderAppendString(writer->stringBuilder, value ? &StringFromLiteral("true") : &StringFromLiteral("false"));
+}
+
+internalfn void
+JSONWriterNull(struct json_writer *writer)
+{
+  JSONWriterSeparate(writer);
+  StringBuilderAppendStringLiteral(writer->stringBuilder, "null");
+}
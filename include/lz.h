@@ -0,0 +1,687 @@
+#pragma once
+
+/*
+ * LZ77 compression in LZ4 block format, so blocks are exchangeable with other
+ * LZ4 implementations. Block is list of sequences:
+ *   token      high 4 bits literal length, low 4 bits match length - 4,
+ *              15 means length bytes follow, each adds 0-255 until one is
+ *              less than 255
+ *   literals
+ *   offset     2 bytes little endian, distance back to start of match
+ * Last sequence has literals only. Last 5 bytes are always literals and last
+ * match starts at least 12 bytes before end.
+ *
+ * Matches are found through hash chains: positions that have same hash of
+ * their first 4 bytes are linked, and searchDepth of them are compared.
+ * Decompression copies 16 bytes at a time when there is room after output.
+ * @see LZCompress(), LZDecompress(), LZFrameWriterWrite()
+ */
+
+#include "memory.h"
+#include "string_cursor.h"
+#include "text.h"
+
+#define LZ_MATCH_MIN 4
+#define LZ_OFFSET_MAX 65535
+// bytes at end that are always literals
+#define LZ_LAST_LITERALS 5
+// bytes at end where match can not start
+#define LZ_MATCH_START_LIMIT 12
+// same as LZ4, larger input must be split into blocks
+#define LZ_INPUT_MAX 0x7e000000
+#define LZ_HASH_BITS_MAX 16
+#define LZ_CHAIN_SIZE_MAX (1 << 16)
+// candidates compared per position, 1 is fastest
+#define LZ_SEARCH_DEPTH_DEFAULT 16
+// bytes that compressed input of length takes in worst case
+#define LZ_COMPRESS_BOUND(length) ((length) + (length) / 255 + 16)
+
+/*
+ * Recent positions of input by hash of their first 4 bytes.
+ */
+struct lz_match_finder {
+  // last position that has hash
+  u32 *head;
+  // distance from position to previous one with same hash, 0 when there is none
+  u16 *chain;
+  u32 hashBits;
+  u32 chainMask;
+  u32 searchDepth;
+  u8 _padding[4];
+};
+
+internalfn void *
+LZArenaPush(memory_arena *arena, u64 size)
+{
+  u8 *block = MemoryArenaPushAligned(arena, 0, sizeof(u64));
+  if ((u64)(block - arena->block) + size > arena->total)
+    return 0;
+  arena->used += size;
+  return block;
+}
+
+/*
+ * Tables are sized to input, so that small inputs do not clear large tables.
+ * @param length longest input that is compressed
+ * @return 0 when arena is full
+ */
+internalfn b8
+LZMatchFinderFrom(memory_arena *arena, u64 length, u32 searchDepth, struct lz_match_finder *finder)
+{
+  u32 bits = 8;
+  while (bits < LZ_HASH_BITS_MAX && ((u64)1 << bits) < length)
+    bits++;
+
+  finder->hashBits = bits;
+  finder->chainMask = (u32)Minimum((u64)1 << bits, LZ_CHAIN_SIZE_MAX) - 1;
+  finder->searchDepth = searchDepth == 0 ? 1 : searchDepth;
+  finder->head = LZArenaPush(arena, sizeof(*finder->head) << bits);
+  finder->chain = LZArenaPush(arena, sizeof(*finder->chain) * (finder->chainMask + 1));
+  return finder->head && finder->chain;
+}
+
+internalfn u32
+LZHash(u8 *bytes, u32 hashBits)
+{
+  u32 value;
+  MemoryCopy(&value, bytes, sizeof(value));
+  return (value * 2654435761u) >> (32 - hashBits);
+}
+
+internalfn void
+LZMatchFinderInsert(struct lz_match_finder *finder, u8 *input, u64 position)
+{
+  u32 hash = LZHash(input + position, finder->hashBits);
+  u64 distance = position - finder->head[hash];
+  finder->chain[position & finder->chainMask] = (u16)(distance <= LZ_OFFSET_MAX ? distance : 0);
+  finder->head[hash] = (u32)position;
+}
+
+/*
+ * @return count of bytes that are same, compared 8 bytes at a time
+ */
+internalfn u64
+LZMatchLength(u8 *match, u8 *bytes, u8 *end)
+{
+  u8 *start = bytes;
+  while (bytes + sizeof(u64) <= end) {
+    u64 left;
+    u64 right;
+    MemoryCopy(&left, match, sizeof(left));
+    MemoryCopy(&right, bytes, sizeof(right));
+    u64 difference = left ^ right;
+    if (difference)
+      return (u64)(bytes - start) + (u64)__builtin_ctzll(difference) / 8;
+    match += sizeof(u64);
+    bytes += sizeof(u64);
+  }
+
+  while (bytes < end && *match == *bytes) {
+    match++;
+    bytes++;
+  }
+  return (u64)(bytes - start);
+}
+
+internalfn u8 *
+LZWriteLength(u8 *output, u64 length)
+{
+  while (length >= 255) {
+    *output++ = 255;
+    length -= 255;
+  }
+  *output++ = (u8)length;
+  return output;
+}
+
+/*
+ * @param matchLength 0 for last sequence
+ */
+internalfn u8 *
+LZWriteSequence(u8 *output, u8 *literals, u64 literalLength, u64 offset, u64 matchLength)
+{
+  u8 *token = output++;
+  u8 tokenValue;
+  if (literalLength >= 15) {
+    tokenValue = 15 << 4;
+    output = LZWriteLength(output, literalLength - 15);
+  } else {
+    tokenValue = (u8)(literalLength << 4);
+  }
+  MemoryCopy(output, literals, literalLength);
+  output += literalLength;
+
+  if (matchLength != 0) {
+    output[0] = (u8)offset;
+    output[1] = (u8)(offset >> 8);
+    output += 2;
+
+    u64 extraLength = matchLength - LZ_MATCH_MIN;
+    if (extraLength >= 15) {
+      tokenValue |= 15;
+      output = LZWriteLength(output, extraLength - 15);
+    } else {
+      tokenValue |= (u8)extraLength;
+    }
+  }
+
+  *token = tokenValue;
+  return output;
+}
+
+/*
+ * Positions where no match is found are skipped faster after every 64 of
+ * them, so that incompressible input does not search every position.
+ *
+ * @param length at most LZ_INPUT_MAX and what finder is sized for
+ * @param output at least LZ_COMPRESS_BOUND(length) bytes
+ * @return length of compressed block
+ */
+internalfn u64
+LZCompressBlock(struct lz_match_finder *finder, u8 *input, u64 length, u8 *output)
+{
+  debug_assert(length <= LZ_INPUT_MAX);
+  u8 *outputStart = output;
+  u64 anchor = 0;
+
+  if (length > LZ_MATCH_START_LIMIT) {
+    MemoryClear(finder->head, sizeof(*finder->head) << finder->hashBits);
+    u64 matchStartLimit = length - LZ_MATCH_START_LIMIT;
+    u8 *matchEnd = input + length - LZ_LAST_LITERALS;
+    u64 insertPosition = 0;
+    u64 missCount = 0;
+
+    u64 position = 0;
+    while (position < matchStartLimit) {
+      for (; insertPosition < position; insertPosition++)
+        LZMatchFinderInsert(finder, input, insertPosition);
+
+      u64 bestLength = 0;
+      u64 bestCandidate = 0;
+      u64 candidate = finder->head[LZHash(input + position, finder->hashBits)];
+      for (u32 depth = 0; depth < finder->searchDepth; depth++) {
+        if (candidate >= position || position - candidate > LZ_OFFSET_MAX)
+          break;
+
+        // longer match must also have 4 bytes that end after best one
+        u32 candidateBytes;
+        u32 positionBytes;
+        u64 checkOffset = bestLength < LZ_MATCH_MIN ? 0 : bestLength - 3;
+        MemoryCopy(&candidateBytes, input + candidate + checkOffset, sizeof(candidateBytes));
+        MemoryCopy(&positionBytes, input + position + checkOffset, sizeof(positionBytes));
+        if (candidateBytes == positionBytes) {
+          u64 matchLength = LZMatchLength(input + candidate, input + position, matchEnd);
+          if (matchLength > bestLength) {
+            bestLength = matchLength;
+            bestCandidate = candidate;
+          }
+        }
+
+        u16 distance = finder->chain[candidate & finder->chainMask];
+        if (distance == 0)
+          break;
+        candidate -= distance;
+      }
+
+      if (bestLength < LZ_MATCH_MIN) {
+        position += 1 + (missCount++ >> 6);
+        continue;
+      }
+
+      // literals before match may be part of it
+      while (position > anchor && bestCandidate > 0 && input[position - 1] == input[bestCandidate - 1]) {
+        position--;
+        bestCandidate--;
+        bestLength++;
+      }
+
+      output = LZWriteSequence(output, input + anchor, position - anchor, position - bestCandidate, bestLength);
+      position += bestLength;
+      anchor = position;
+      missCount = 0;
+      // fastest search does not insert positions inside match
+      if (finder->searchDepth == 1)
+        insertPosition = position - 2;
+    }
+  }
+
+  output = LZWriteSequence(output, input + anchor, length - anchor, 0, 0);
+  return (u64)(output - outputStart);
+}
+
+/*
+ * Compresses whole input as one block. Output and temporary hash chains are
+ * in arena, only output is kept.
+ * @see LZDecompress()
+ *
+ * @param searchDepth candidates compared per position, 1 is fastest,
+ *                    LZ_SEARCH_DEPTH_DEFAULT gives good ratio
+ * @return compressed block, null when input is longer than LZ_INPUT_MAX or
+ *         arena is full, arena is given back
+ *
+ * @code
+ *   struct string log = StringBuilderFlush(sb);
+ *   struct string compressed = LZCompress(arena, &log, LZ_SEARCH_DEPTH_DEFAULT);
+ *   // store log.length with compressed, decompression needs it
+ * @endcode
+ */
+internalfn struct string
+LZCompress(memory_arena *arena, struct string *input, u32 searchDepth)
+{
+  struct string result = StringNull();
+  if (!input || IsStringNull(input) || input->length > LZ_INPUT_MAX)
+    return result;
+
+  memory_temp temp = MemoryTempBegin(arena);
+  u8 *output = LZArenaPush(arena, LZ_COMPRESS_BOUND(input->length));
+  struct lz_match_finder finder;
+  if (!output || !LZMatchFinderFrom(arena, input->length, searchDepth, &finder)) {
+    MemoryTempEnd(&temp);
+    return result;
+  }
+
+  u64 length = LZCompressBlock(&finder, input->value, input->length, output);
+  // hash chains and unused output
+  arena->used = (u64)(output - arena->block) + length;
+  result = StringFromBuffer(output, length);
+  return result;
+}
+
+internalfn b8
+LZReadLength(u8 **input, u8 *end, u64 *length)
+{
+  u8 byte;
+  do {
+    if (*input == end)
+      return 0;
+    byte = *(*input)++;
+    *length += byte;
+  } while (byte == 255);
+  return 1;
+}
+
+/*
+ * Copies at least length bytes, 16 at a time.
+ * @param dest at least length + 15 bytes
+ */
+internalfn void
+LZWildCopy16(u8 *dest, u8 *src, u64 length)
+{
+  u8 *end = dest + length;
+  do {
+    MemoryCopy(dest, src, 16);
+    dest += 16;
+    src += 16;
+  } while (dest < end);
+}
+
+/*
+ * Copies match that may overlap dest, 16 bytes at a time.
+ * @param dest at least length + 15 bytes
+ */
+internalfn void
+LZCopyMatch(u8 *dest, u64 offset, u64 length)
+{
+  u8 *match = dest - offset;
+  if (offset < 16) {
+    // repeat pattern byte by byte, then copy from whole periods at least 16
+    // bytes back so that copies do not overlap
+    for (u32 index = 0; index < 16; index++)
+      dest[index] = match[index];
+    u64 period = offset * ((16 + offset - 1) / offset);
+    if (length <= 16)
+      return;
+    dest += 16;
+    match = dest - period;
+    length -= 16;
+  }
+  LZWildCopy16(dest, match, length);
+}
+
+/*
+ * Decompresses block, every length and offset is checked so malformed
+ * block never reads or writes out of bounds.
+ *
+ * @param errorIndex optional, on failure set to position in input where block
+ *                   is found malformed
+ * @return length of decompressed block, U64_MAX when block is malformed or
+ *         does not fit in outputCapacity
+ */
+internalfn u64
+LZDecompressBlock(u8 *input, u64 inputLength, u8 *output, u64 outputCapacity, u64 *errorIndex)
+{
+  u8 *in = input;
+  u8 *inEnd = input + inputLength;
+  u8 *out = output;
+  u8 *outEnd = output + outputCapacity;
+
+  while (1) {
+    if (in == inEnd)
+      goto error;
+    u8 token = *in++;
+
+    // common short sequence, copied in fixed 16 bytes of literals and 3 times 8 bytes of match
+    u64 literalLength = token >> 4;
+    u64 shortMatchLength = (token & 15) + LZ_MATCH_MIN;
+    if (literalLength != 15 && shortMatchLength != 15 + LZ_MATCH_MIN && inEnd - in >= 16 + 2 &&
+        outEnd - out >= 16 + 24) {
+      MemoryCopy(out, in, 16);
+      in += literalLength;
+      out += literalLength;
+      u64 offset = (u64)in[0] | ((u64)in[1] << 8);
+      if (offset >= 8 && offset <= (u64)(out - output)) {
+        in += 2;
+        MemoryCopy(out, out - offset, 8);
+        MemoryCopy(out + 8, out + 8 - offset, 8);
+        MemoryCopy(out + 16, out + 16 - offset, 8);
+        out += shortMatchLength;
+        continue;
+      }
+      // offset is checked below
+      in -= literalLength;
+      out -= literalLength;
+    }
+
+    if (literalLength == 15 && !LZReadLength(&in, inEnd, &literalLength))
+      goto error;
+    if (literalLength > (u64)(inEnd - in) || literalLength > (u64)(outEnd - out))
+      goto error;
+    if (literalLength + 16 <= (u64)(inEnd - in) && literalLength + 16 <= (u64)(outEnd - out))
+      LZWildCopy16(out, in, literalLength);
+    else
+      MemoryCopy(out, in, literalLength);
+    in += literalLength;
+    out += literalLength;
+
+    // last sequence has no match
+    if (in == inEnd)
+      break;
+
+    if (inEnd - in < 2)
+      goto error;
+    u64 offset = (u64)in[0] | ((u64)in[1] << 8);
+    if (offset == 0 || offset > (u64)(out - output))
+      goto error;
+    in += 2;
+
+    u64 matchLength = token & 15;
+    if (matchLength == 15 && !LZReadLength(&in, inEnd, &matchLength))
+      goto error;
+    matchLength += LZ_MATCH_MIN;
+    if (matchLength > (u64)(outEnd - out))
+      goto error;
+
+    if (matchLength + 16 <= (u64)(outEnd - out)) {
+      LZCopyMatch(out, offset, matchLength);
+    } else {
+      for (u64 index = 0; index < matchLength; index++)
+        out[index] = out[index - offset];
+    }
+    out += matchLength;
+  }
+
+  return (u64)(out - output);
+
+error:
+  if (errorIndex)
+    *errorIndex = (u64)(in - input);
+  return U64_MAX;
+}
+
+/*
+ * @param decompressedLength length of input that is compressed, output is
+ *                           allocated from arena for it
+ * @param errorIndex optional, on failure set to position in compressed where
+ *                   it is found malformed, or its length when it decompresses
+ *                   to other length
+ * @return decompressed string, null when compressed is malformed or arena is
+ *         full, arena is given back
+ */
+internalfn struct string
+LZDecompress(memory_arena *arena, struct string *compressed, u64 decompressedLength, u64 *errorIndex)
+{
+  struct string result = StringNull();
+  if (!compressed || IsStringNull(compressed))
+    return result;
+
+  memory_temp temp = MemoryTempBegin(arena);
+  u8 *output = LZArenaPush(arena, decompressedLength);
+  if (!output) {
+    if (errorIndex)
+      *errorIndex = 0;
+    return result;
+  }
+
+  u64 length = LZDecompressBlock(compressed->value, compressed->length, output, decompressedLength, errorIndex);
+  if (length != decompressedLength) {
+    if (length != U64_MAX && errorIndex)
+      *errorIndex = compressed->length;
+    MemoryTempEnd(&temp);
+    return result;
+  }
+
+  result = StringFromBuffer(output, length);
+  return result;
+}
+
+/*
+ * Framed stream is "LZF1" followed by blocks and 4 zero bytes. Block is
+ * 4 bytes little endian length of its data followed by data, which is
+ * LZ_FRAME_BLOCK_SIZE or less bytes of input compressed independently of
+ * other blocks. When compression does not make it shorter, data is input as
+ * is and LZ_FRAME_BLOCK_RAW is set in length.
+ * There is no checksum.
+ */
+#define LZ_FRAME_MAGIC 0x31465a4c
+#define LZ_FRAME_BLOCK_SIZE (64 * 1024)
+#define LZ_FRAME_BLOCK_RAW 0x80000000u
+// window of string_stream that frame is read from
+#define LZ_FRAME_WINDOW_MIN (8 + LZ_COMPRESS_BOUND(LZ_FRAME_BLOCK_SIZE))
+
+/*
+ * Compresses input that is given in pieces of any length into frame, in
+ * memory of one block.
+ * @see LZFrameWriterFrom()
+ */
+struct lz_frame_writer {
+  struct lz_match_finder finder;
+  // input collected until block is full
+  u8 *block;
+  u64 blockLength;
+  // magic, block and end of frame
+  u8 *output;
+  b8 isMagicWritten;
+  u8 _padding[7];
+};
+
+/*
+ * @code
+ *   struct lz_frame_writer writer;
+ *   if (!LZFrameWriterFrom(arena, LZ_SEARCH_DEPTH_DEFAULT, &writer))
+ *     return 0;
+ *   // for every piece of input
+ *   struct string_cursor cursor = StringCursorFromString(&piece);
+ *   while (!IsStringCursorAtEnd(&cursor)) {
+ *     struct string frame = LZFrameWriterWrite(&writer, &cursor);
+ *     // write frame out
+ *   }
+ *   // at end of input
+ *   struct string frame = LZFrameWriterFinish(&writer);
+ * @endcode
+ * @return 0 when arena is full, arena is given back
+ */
+internalfn b8
+LZFrameWriterFrom(memory_arena *arena, u32 searchDepth, struct lz_frame_writer *writer)
+{
+  memory_temp temp = MemoryTempBegin(arena);
+  *writer = (struct lz_frame_writer){0};
+  writer->block = LZArenaPush(arena, LZ_FRAME_BLOCK_SIZE);
+  writer->output = LZArenaPush(arena, 4 + 4 + LZ_COMPRESS_BOUND(LZ_FRAME_BLOCK_SIZE) + 4);
+  if (!writer->block || !writer->output ||
+      !LZMatchFinderFrom(arena, LZ_FRAME_BLOCK_SIZE, searchDepth, &writer->finder)) {
+    MemoryTempEnd(&temp);
+    return 0;
+  }
+  return 1;
+}
+
+internalfn void
+LZWriteU32(u8 *output, u32 value)
+{
+  output[0] = (u8)value;
+  output[1] = (u8)(value >> 8);
+  output[2] = (u8)(value >> 16);
+  output[3] = (u8)(value >> 24);
+}
+
+internalfn u32
+LZReadU32(u8 *input)
+{
+  return (u32)input[0] | ((u32)input[1] << 8) | ((u32)input[2] << 16) | ((u32)input[3] << 24);
+}
+
+internalfn struct string
+LZFrameWriterEncode(struct lz_frame_writer *writer, u8 *data, u64 length, b8 isLast)
+{
+  u8 *output = writer->output;
+  if (!writer->isMagicWritten) {
+    LZWriteU32(output, LZ_FRAME_MAGIC);
+    output += 4;
+    writer->isMagicWritten = 1;
+  }
+
+  if (length != 0) {
+    u64 compressedLength = LZCompressBlock(&writer->finder, data, length, output + 4);
+    if (compressedLength < length) {
+      LZWriteU32(output, (u32)compressedLength);
+      output += 4 + compressedLength;
+    } else {
+      LZWriteU32(output, (u32)length | LZ_FRAME_BLOCK_RAW);
+      MemoryCopy(output + 4, data, length);
+      output += 4 + length;
+    }
+  }
+
+  if (isLast) {
+    LZWriteU32(output, 0);
+    output += 4;
+  }
+
+  return StringFromBuffer(writer->output, (u64)(output - writer->output));
+}
+
+/*
+ * Consumes input until block is full. Full block taken straight from input
+ * is not copied.
+ * @return part of frame to write out, empty until block is full, valid until
+ *         next call
+ */
+internalfn struct string
+LZFrameWriterWrite(struct lz_frame_writer *writer, struct string_cursor *input)
+{
+  if (writer->blockLength == 0 && StringCursorRemainingLength(input) >= LZ_FRAME_BLOCK_SIZE) {
+    struct string data = StringCursorConsumeSubstring(input, LZ_FRAME_BLOCK_SIZE);
+    return LZFrameWriterEncode(writer, data.value, data.length, 0);
+  }
+
+  struct string data = StringCursorConsumeSubstring(input, LZ_FRAME_BLOCK_SIZE - writer->blockLength);
+  MemoryCopy(writer->block + writer->blockLength, data.value, data.length);
+  writer->blockLength += data.length;
+  if (writer->blockLength != LZ_FRAME_BLOCK_SIZE)
+    return StringFromBuffer(writer->output, 0);
+
+  writer->blockLength = 0;
+  return LZFrameWriterEncode(writer, writer->block, LZ_FRAME_BLOCK_SIZE, 0);
+}
+
+/*
+ * @return rest of frame to write out
+ */
+internalfn struct string
+LZFrameWriterFinish(struct lz_frame_writer *writer)
+{
+  u64 length = writer->blockLength;
+  writer->blockLength = 0;
+  return LZFrameWriterEncode(writer, writer->block, length, 1);
+}
+
+/*
+ * Decompresses frame block by block from string_stream.
+ * @see LZFrameReaderFrom()
+ */
+struct lz_frame_reader {
+  u8 *block;
+  b8 isMagicRead;
+  // end of frame is read
+  b8 isEnd;
+  u8 _padding[6];
+};
+
+/*
+ * @code
+ *   struct lz_frame_reader reader;
+ *   if (!LZFrameReaderFrom(arena, &reader))
+ *     return 0;
+ *   // window of stream is at least LZ_FRAME_WINDOW_MIN
+ *   while (1) {
+ *     struct string block = LZFrameReaderNext(&reader, &stream);
+ *     if (IsStringNull(&block) || reader.isEnd)
+ *       break;
+ *     // ...
+ *   }
+ * @endcode
+ * @return 0 when arena is full
+ */
+internalfn b8
+LZFrameReaderFrom(memory_arena *arena, struct lz_frame_reader *reader)
+{
+  *reader = (struct lz_frame_reader){0};
+  reader->block = LZArenaPush(arena, LZ_FRAME_BLOCK_SIZE);
+  return reader->block != 0;
+}
+
+/*
+ * @param stream window must be at least LZ_FRAME_WINDOW_MIN
+ * @return next block of input, valid until next call
+ *         empty at end of frame, isEnd is set
+ *         null when frame is malformed or stream ends before end of frame
+ */
+internalfn struct string
+LZFrameReaderNext(struct lz_frame_reader *reader, struct string_stream *stream)
+{
+  struct string result = StringNull();
+  if (reader->isEnd)
+    return StringFromBuffer(reader->block, 0);
+
+  if (!reader->isMagicRead) {
+    struct string magic = StringStreamConsumeSubstring(stream, 4);
+    if (magic.length != 4 || LZReadU32(magic.value) != LZ_FRAME_MAGIC)
+      return result;
+    reader->isMagicRead = 1;
+  }
+
+  struct string header = StringStreamConsumeSubstring(stream, 4);
+  if (header.length != 4)
+    return result;
+  u32 length = LZReadU32(header.value);
+  if (length == 0) {
+    reader->isEnd = 1;
+    return StringFromBuffer(reader->block, 0);
+  }
+
+  b8 isRaw = (length & LZ_FRAME_BLOCK_RAW) != 0;
+  length &= ~LZ_FRAME_BLOCK_RAW;
+  if (length > (isRaw ? LZ_FRAME_BLOCK_SIZE : LZ_COMPRESS_BOUND(LZ_FRAME_BLOCK_SIZE)))
+    return result;
+  struct string data = StringStreamConsumeSubstring(stream, length);
+  if (data.length != length)
+    return result;
+  if (isRaw)
+    return data;
+
+  u64 blockLength = LZDecompressBlock(data.value, data.length, reader->block, LZ_FRAME_BLOCK_SIZE, 0);
+  if (blockLength == U64_MAX)
+    return result;
+  result = StringFromBuffer(reader->block, blockLength);
+  return result;
+}
@@ -86,10 +86,25 @@ MemoryCopy(void *dest, void *src, u64 length)
   __builtin_memcpy(dest, src, length);
 }
 
+/*
+ * Like MemoryCopy() but dest and src may overlap.
+ */
+static void
+MemoryMove(void *dest, void *src, u64 length)
+{
+  __builtin_memmove(dest, src, length);
+}
+
 static void
 MemoryClear(void *dest, u64 length)
 {
   __builtin_bzero(dest, length);
 }
 
+static b8
+IsMemoryEqual(void *left, void *right, u64 length)
+{
+  return __builtin_memcmp(left, right, length) == 0;
+}
+
 #define __cleanup_memory_temp__ __attribute__((cleanup(MemoryTempEnd)))
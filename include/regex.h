@@ -0,0 +1,972 @@
+#pragma once
+
+/*
+ * Regular expressions over bytes. Pattern is compiled into NFA, which is
+ * turned into DFA lazily while matching: DFA state is set of NFA states and
+ * is built when first reached. DFA states live in cache of fixed size that
+ * is flushed when full.
+ * Literal that every match contains is searched first, so that most text
+ * is rejected without running DFA.
+ * @see RegexCompile()
+ *
+ * Syntax:
+ *   .              any byte except '\n'
+ *   [a-z] [^0-9]   class, ']' first in class is literal
+ *   \d \w \s       digit, word and whitespace classes, \D \W \S not in them,
+ *                  also inside class
+ *   \t \n \r \xHH  bytes, '\' before punctuation makes it literal
+ *   ^ $            start and end of string, or of line
+ *   a|b (a) (?:a)  alternation and groups
+ *   a* a+ a? a{2} a{2,} a{2,5}
+ *                  repetition, lazy forms such as a*? are same because only
+ *                  whether there is a match is reported
+ * There are no captures and no backreferences.
+ */
+
+#include "memory.h"
+#include "string_cursor.h"
+#include "text.h"
+
+// limits of NFA size, so that repetitions such as (a{1000}){1000} are rejected
+#define REGEX_STATE_MAX 4096
+#define REGEX_REPEAT_MAX 1000
+
+enum regex_node_type {
+  REGEX_NODE_EMPTY,
+  // one byte out of set
+  REGEX_NODE_SET,
+  REGEX_NODE_BEGIN,
+  REGEX_NODE_END,
+  REGEX_NODE_CONCAT,
+  REGEX_NODE_ALTERNATE,
+  // left repeated from min to max times, max is U32_MAX when unbounded
+  REGEX_NODE_REPEAT,
+};
+
+/*
+ * Syntax tree of pattern.
+ */
+struct regex_node {
+  enum regex_node_type type;
+  u32 left;
+  u32 right;
+  u32 min;
+  u32 max;
+  u8 _padding[4];
+  u64 set[4];
+};
+
+enum regex_state_type {
+  REGEX_STATE_MATCH,
+  // moves to next on byte in set of node
+  REGEX_STATE_SET,
+  // moves to both next and alternate without byte
+  REGEX_STATE_SPLIT,
+  // moves to next without byte only at start
+  REGEX_STATE_BEGIN,
+  // moves to next without byte only at end
+  REGEX_STATE_END,
+};
+
+/*
+ * State of NFA, built by Thompson's construction.
+ */
+struct regex_state {
+  enum regex_state_type type;
+  u32 next;
+  u32 alternate;
+  u32 node;
+};
+
+enum regex_dfa_flag {
+  REGEX_DFA_FLAG_MATCH = (1 << 0),
+  REGEX_DFA_FLAG_MATCH_AT_END = (1 << 1),
+  // no NFA state left, nothing can match anymore
+  REGEX_DFA_FLAG_DEAD = (1 << 2),
+};
+
+struct regex {
+  struct regex_node *nodes;
+  struct regex_state *states;
+  u32 stateCount;
+  u32 startState;
+  // u64 words of set of NFA states
+  u32 wordCount;
+  // bytes that no part of pattern tells apart are in one class
+  u32 classCount;
+  u8 classes[256];
+  // first byte of each class
+  u8 classBytes[256];
+
+  // bytes that every match contains, empty when there are none
+  struct string literal;
+  // pattern is only literal, DFA is not needed
+  b8 isLiteralOnly;
+  // empty string matches, e.g. "$^", that DFA states do not tell
+  b8 isEmptyMatch;
+  u8 _padding[6];
+
+  // sets of NFA states that DFA starts from, at start of string and after
+  // it for unanchored search
+  u64 *beginKernel;
+  u64 *anywhereKernel;
+  // scratch memory for building DFA state
+  u64 *kernel;
+  u64 *endKernel;
+  u64 *visited;
+  u32 *stack;
+
+  // classCount entries per DFA state: 0 when not built yet, otherwise
+  // offset of target row + 1, negative when target matches or is dead.
+  // Offset instead of index keeps multiply out of inner loop.
+  s32 *transitions;
+  // set of NFA states that are SET, MATCH or END, wordCount per DFA state
+  u64 *kernels;
+  // see enum regex_dfa_flag
+  u8 *flags;
+  // DFA state + 1 by hash of kernel, 0 when empty
+  u32 *hashTable;
+  u32 hashMask;
+  u32 dfaCount;
+  u32 dfaCapacity;
+  // DFA state at start of string, U32_MAX when it is not built
+  u32 beginDFA;
+  // times cache was full
+  u64 flushCount;
+};
+
+struct regex_parser {
+  u8 *value;
+  u64 length;
+  u64 position;
+  struct regex_node *nodes;
+  u32 nodeCount;
+  u32 nodeCapacity;
+};
+
+internalfn void *
+RegexArenaPush(memory_arena *arena, u64 size)
+{
+  u8 *block = MemoryArenaPushAligned(arena, 0, sizeof(u64));
+  if ((u64)(block - arena->block) + size > arena->total)
+    return 0;
+  arena->used += size;
+  return block;
+}
+
+internalfn u32
+RegexParserAddNode(struct regex_parser *parser, enum regex_node_type type, u32 left, u32 right)
+{
+  debug_assert(parser->nodeCount < parser->nodeCapacity);
+  parser->nodes[parser->nodeCount] = (struct regex_node){.type = type, .left = left, .right = right};
+  return parser->nodeCount++;
+}
+
+internalfn void
+RegexSetAddRange(u64 set[4], u32 low, u32 high)
+{
+  for (u32 byte = low; byte <= high; byte++)
+    set[byte / 64] |= (u64)1 << (byte % 64);
+}
+
+internalfn u32
+RegexSetCount(u64 set[4])
+{
+  return (u32)(__builtin_popcountll(set[0]) + __builtin_popcountll(set[1]) + __builtin_popcountll(set[2]) +
+               __builtin_popcountll(set[3]));
+}
+
+/*
+ * Parses escape after '\'.
+ * @return 0 when escape is unknown
+ */
+internalfn b8
+RegexParseEscape(struct regex_parser *parser, u64 set[4])
+{
+  if (parser->position == parser->length)
+    return 0;
+  u8 character = parser->value[parser->position++];
+
+  u64 class[4] = {0};
+  b8 isNegated = 0;
+  switch (character) {
+  case 'D':
+    isNegated = 1;
+    // fall through
+  case 'd':
+    RegexSetAddRange(class, '0', '9');
+    break;
+  case 'W':
+    isNegated = 1;
+    // fall through
+  case 'w':
+    RegexSetAddRange(class, '0', '9');
+    RegexSetAddRange(class, 'A', 'Z');
+    RegexSetAddRange(class, 'a', 'z');
+    RegexSetAddRange(class, '_', '_');
+    break;
+  case 'S':
+    isNegated = 1;
+    // fall through
+  case 's':
+    RegexSetAddRange(class, '\t', '\r');
+    RegexSetAddRange(class, ' ', ' ');
+    break;
+  case 't':
+    RegexSetAddRange(class, '\t', '\t');
+    break;
+  case 'n':
+    RegexSetAddRange(class, '\n', '\n');
+    break;
+  case 'r':
+    RegexSetAddRange(class, '\r', '\r');
+    break;
+  case 'x': {
+    if (parser->position + 2 > parser->length)
+      return 0;
+    s8 high = ASCIItoHEX[parser->value[parser->position]];
+    s8 low = ASCIItoHEX[parser->value[parser->position + 1]];
+    if ((high | low) < 0)
+      return 0;
+    parser->position += 2;
+    u32 byte = (u32)((high << 4) | low);
+    RegexSetAddRange(class, byte, byte);
+  } break;
+  default:
+    // letters and digits are reserved for escapes
+    if ((character >= '0' && character <= '9') || ((character | 0x20) >= 'a' && (character | 0x20) <= 'z'))
+      return 0;
+    RegexSetAddRange(class, character, character);
+  }
+
+  for (u32 index = 0; index < 4; index++)
+    set[index] |= isNegated ? ~class[index] : class[index];
+  return 1;
+}
+
+/*
+ * Parses class after '['.
+ */
+internalfn b8
+RegexParseClass(struct regex_parser *parser, u64 set[4])
+{
+  b8 isNegated = parser->position < parser->length && parser->value[parser->position] == '^';
+  if (isNegated)
+    parser->position++;
+
+  u64 first = parser->position;
+  while (parser->position < parser->length &&
+         (parser->value[parser->position] != ']' || parser->position == first)) {
+    u8 low = parser->value[parser->position++];
+    if (low == '\\') {
+      u64 escape[4] = {0};
+      if (!RegexParseEscape(parser, escape))
+        return 0;
+      if (RegexSetCount(escape) != 1) {
+        // class such as \d, it cannot start range
+        for (u32 index = 0; index < 4; index++)
+          set[index] |= escape[index];
+        continue;
+      }
+      for (low = 0; !(escape[low / 64] & ((u64)1 << (low % 64))); low++)
+        ;
+    }
+
+    u8 high = low;
+    if (parser->position + 1 < parser->length && parser->value[parser->position] == '-' &&
+        parser->value[parser->position + 1] != ']') {
+      parser->position++;
+      high = parser->value[parser->position++];
+      if (high == '\\') {
+        u64 escape[4] = {0};
+        if (!RegexParseEscape(parser, escape))
+          return 0;
+        for (high = 0; !(escape[high / 64] & ((u64)1 << (high % 64))); high++)
+          ;
+      }
+      if (high < low)
+        return 0;
+    }
+    RegexSetAddRange(set, low, high);
+  }
+
+  if (parser->position == parser->length)
+    return 0;
+  // ']'
+  parser->position++;
+
+  if (isNegated) {
+    for (u32 index = 0; index < 4; index++)
+      set[index] = ~set[index];
+  }
+  return 1;
+}
+
+internalfn u32 RegexParseAlternate(struct regex_parser *parser);
+
+/*
+ * @return U32_MAX on failure
+ */
+internalfn u32
+RegexParseAtom(struct regex_parser *parser)
+{
+  u8 character = parser->value[parser->position++];
+  switch (character) {
+  case '(': {
+    if (parser->position + 2 <= parser->length && parser->value[parser->position] == '?' &&
+        parser->value[parser->position + 1] == ':')
+      parser->position += 2;
+    u32 node = RegexParseAlternate(parser);
+    if (node == U32_MAX || parser->position == parser->length || parser->value[parser->position] != ')')
+      return U32_MAX;
+    parser->position++;
+    return node;
+  }
+
+  case '^':
+    return RegexParserAddNode(parser, REGEX_NODE_BEGIN, 0, 0);
+  case '$':
+    return RegexParserAddNode(parser, REGEX_NODE_END, 0, 0);
+
+  case '*':
+  case '+':
+  case '?':
+    // nothing to repeat
+    parser->position--;
+    return U32_MAX;
+  }
+
+  u32 node = RegexParserAddNode(parser, REGEX_NODE_SET, 0, 0);
+  u64 *set = parser->nodes[node].set;
+  if (character == '.') {
+    set[0] = set[1] = set[2] = set[3] = ~(u64)0;
+    set['\n' / 64] &= ~((u64)1 << ('\n' % 64));
+  } else if (character == '[') {
+    if (!RegexParseClass(parser, set))
+      return U32_MAX;
+  } else if (character == '\\') {
+    if (!RegexParseEscape(parser, set))
+      return U32_MAX;
+  } else {
+    RegexSetAddRange(set, character, character);
+  }
+  return node;
+}
+
+/*
+ * Parses decimal number of repetitions.
+ * @return U32_MAX when there is no number or it is too large
+ */
+internalfn u32
+RegexParseCount(struct regex_parser *parser)
+{
+  u32 count = 0;
+  u64 start = parser->position;
+  while (parser->position < parser->length && parser->value[parser->position] >= '0' &&
+         parser->value[parser->position] <= '9') {
+    count = count * 10 + (u32)(parser->value[parser->position++] - '0');
+    if (count > REGEX_REPEAT_MAX)
+      return U32_MAX;
+  }
+  return parser->position == start ? U32_MAX : count;
+}
+
+internalfn u32
+RegexParseRepeat(struct regex_parser *parser)
+{
+  u32 node = RegexParseAtom(parser);
+  while (node != U32_MAX && parser->position < parser->length) {
+    u8 character = parser->value[parser->position];
+    u32 min;
+    u32 max;
+    if (character == '*') {
+      min = 0, max = U32_MAX;
+      parser->position++;
+    } else if (character == '+') {
+      min = 1, max = U32_MAX;
+      parser->position++;
+    } else if (character == '?') {
+      min = 0, max = 1;
+      parser->position++;
+    } else if (character == '{') {
+      parser->position++;
+      min = RegexParseCount(parser);
+      max = min;
+      if (min != U32_MAX && parser->position < parser->length && parser->value[parser->position] == ',') {
+        parser->position++;
+        max = parser->position < parser->length && parser->value[parser->position] == '}'
+                  ? U32_MAX
+                  : RegexParseCount(parser);
+        if (max == U32_MAX && (parser->position == parser->length || parser->value[parser->position] != '}'))
+          return U32_MAX;
+      }
+      if (min == U32_MAX || (max != U32_MAX && max < min) || parser->position == parser->length ||
+          parser->value[parser->position] != '}')
+        return U32_MAX;
+      parser->position++;
+    } else {
+      break;
+    }
+
+    // lazy repetition matches same strings
+    if (parser->position < parser->length && parser->value[parser->position] == '?')
+      parser->position++;
+
+    node = RegexParserAddNode(parser, REGEX_NODE_REPEAT, node, 0);
+    parser->nodes[node].min = min;
+    parser->nodes[node].max = max;
+  }
+  return node;
+}
+
+internalfn u32
+RegexParseConcat(struct regex_parser *parser)
+{
+  u32 node = U32_MAX;
+  while (parser->position < parser->length && parser->value[parser->position] != '|' &&
+         parser->value[parser->position] != ')') {
+    u32 right = RegexParseRepeat(parser);
+    if (right == U32_MAX)
+      return U32_MAX;
+    node = node == U32_MAX ? right : RegexParserAddNode(parser, REGEX_NODE_CONCAT, node, right);
+  }
+  if (node == U32_MAX)
+    node = RegexParserAddNode(parser, REGEX_NODE_EMPTY, 0, 0);
+  return node;
+}
+
+internalfn u32
+RegexParseAlternate(struct regex_parser *parser)
+{
+  u32 node = RegexParseConcat(parser);
+  while (node != U32_MAX && parser->position < parser->length && parser->value[parser->position] == '|') {
+    parser->position++;
+    u32 right = RegexParseConcat(parser);
+    if (right == U32_MAX)
+      return U32_MAX;
+    node = RegexParserAddNode(parser, REGEX_NODE_ALTERNATE, node, right);
+  }
+  return node;
+}
+
+/*
+ * @return count of NFA states for node, REGEX_STATE_MAX + 1 when more
+ */
+internalfn u64
+RegexNodeStateCount(struct regex_node *nodes, u32 nodeIndex)
+{
+  struct regex_node *node = nodes + nodeIndex;
+  u64 count = 0;
+  switch (node->type) {
+  case REGEX_NODE_EMPTY:
+    count = 0;
+    break;
+  case REGEX_NODE_SET:
+  case REGEX_NODE_BEGIN:
+  case REGEX_NODE_END:
+    count = 1;
+    break;
+  case REGEX_NODE_CONCAT:
+    count = RegexNodeStateCount(nodes, node->left) + RegexNodeStateCount(nodes, node->right);
+    break;
+  case REGEX_NODE_ALTERNATE:
+    count = RegexNodeStateCount(nodes, node->left) + RegexNodeStateCount(nodes, node->right) + 1;
+    break;
+  case REGEX_NODE_REPEAT: {
+    u64 childCount = RegexNodeStateCount(nodes, node->left);
+    if (node->max == U32_MAX)
+      count = node->min * childCount + childCount + 1;
+    else
+      count = node->min * childCount + (node->max - node->min) * (childCount + 1);
+  } break;
+  }
+  return count > REGEX_STATE_MAX ? REGEX_STATE_MAX + 1 : count;
+}
+
+internalfn u32
+RegexAddState(struct regex *regex, enum regex_state_type type, u32 next, u32 alternate, u32 node)
+{
+  regex->states[regex->stateCount] = (struct regex_state){
+      .type = type,
+      .next = next,
+      .alternate = alternate,
+      .node = node,
+  };
+  return regex->stateCount++;
+}
+
+/*
+ * Builds NFA of node backwards, from state that comes after it.
+ * @return first state of node
+ */
+internalfn u32
+RegexCompileNode(struct regex *regex, u32 nodeIndex, u32 next)
+{
+  struct regex_node *node = regex->nodes + nodeIndex;
+  switch (node->type) {
+  case REGEX_NODE_EMPTY:
+    return next;
+  case REGEX_NODE_SET:
+    return RegexAddState(regex, REGEX_STATE_SET, next, 0, nodeIndex);
+  case REGEX_NODE_BEGIN:
+    return RegexAddState(regex, REGEX_STATE_BEGIN, next, 0, 0);
+  case REGEX_NODE_END:
+    return RegexAddState(regex, REGEX_STATE_END, next, 0, 0);
+  case REGEX_NODE_CONCAT:
+    return RegexCompileNode(regex, node->left, RegexCompileNode(regex, node->right, next));
+  case REGEX_NODE_ALTERNATE: {
+    u32 left = RegexCompileNode(regex, node->left, next);
+    u32 right = RegexCompileNode(regex, node->right, next);
+    return RegexAddState(regex, REGEX_STATE_SPLIT, left, right, 0);
+  }
+  case REGEX_NODE_REPEAT: {
+    u32 start = next;
+    if (node->max == U32_MAX) {
+      u32 split = RegexAddState(regex, REGEX_STATE_SPLIT, 0, next, 0);
+      regex->states[split].next = RegexCompileNode(regex, node->left, split);
+      start = split;
+    } else {
+      // x{0,3} is (x(x(x)?)?)?
+      for (u32 index = node->min; index < node->max; index++)
+        start = RegexAddState(regex, REGEX_STATE_SPLIT, RegexCompileNode(regex, node->left, start), next, 0);
+    }
+    for (u32 index = 0; index < node->min; index++)
+      start = RegexCompileNode(regex, node->left, start);
+    return start;
+  }
+  }
+  return next;
+}
+
+struct regex_literal {
+  u8 *buffer;
+  u64 length;
+  u64 runStart;
+  u64 bestStart;
+  u64 bestLength;
+  b8 isBroken;
+  u8 _padding[7];
+};
+
+/*
+ * Collects runs of single bytes that follow each other in every match.
+ */
+internalfn void
+RegexLiteralWalk(struct regex_node *nodes, u32 nodeIndex, struct regex_literal *literal)
+{
+  struct regex_node *node = nodes + nodeIndex;
+  if (node->type == REGEX_NODE_EMPTY)
+    return;
+  if (node->type == REGEX_NODE_CONCAT) {
+    RegexLiteralWalk(nodes, node->left, literal);
+    RegexLiteralWalk(nodes, node->right, literal);
+    return;
+  }
+
+  if (node->type == REGEX_NODE_SET && RegexSetCount(node->set) == 1) {
+    u8 byte = 0;
+    while (!(node->set[byte / 64] & ((u64)1 << (byte % 64))))
+      byte++;
+    // matching is done line by line
+    if (byte != '\n') {
+      literal->buffer[literal->length++] = byte;
+      if (literal->length - literal->runStart > literal->bestLength) {
+        literal->bestStart = literal->runStart;
+        literal->bestLength = literal->length - literal->runStart;
+      }
+      return;
+    }
+  }
+
+  // one copy is required, what comes after may be another copy
+  if (node->type == REGEX_NODE_REPEAT && node->min >= 1)
+    RegexLiteralWalk(nodes, node->left, literal);
+  literal->runStart = literal->length;
+  literal->isBroken = 1;
+}
+
+/*
+ * Adds states reachable from state without byte to kernel.
+ */
+internalfn void
+RegexClosure(struct regex *regex, u32 state, u64 *kernel, b8 isAtStart, b8 isAtEnd)
+{
+  u32 *stack = regex->stack;
+  u64 *visited = regex->visited;
+  u32 stackCount = 0;
+  stack[stackCount++] = state;
+  while (stackCount != 0) {
+    u32 index = stack[--stackCount];
+    u64 bit = (u64)1 << (index % 64);
+    if (visited[index / 64] & bit)
+      continue;
+    visited[index / 64] |= bit;
+
+    struct regex_state *current = regex->states + index;
+    switch (current->type) {
+    case REGEX_STATE_MATCH:
+    case REGEX_STATE_SET:
+      kernel[index / 64] |= bit;
+      break;
+    case REGEX_STATE_SPLIT:
+      stack[stackCount++] = current->alternate;
+      stack[stackCount++] = current->next;
+      break;
+    case REGEX_STATE_BEGIN:
+      if (isAtStart)
+        stack[stackCount++] = current->next;
+      break;
+    case REGEX_STATE_END:
+      if (isAtEnd)
+        stack[stackCount++] = current->next;
+      else
+        kernel[index / 64] |= bit;
+      break;
+    }
+  }
+}
+
+/*
+ * Empties cache of DFA states.
+ */
+internalfn void
+RegexFlush(struct regex *regex)
+{
+  MemoryClear(regex->hashTable, (regex->hashMask + 1) * sizeof(u32));
+  regex->dfaCount = 0;
+  regex->beginDFA = U32_MAX;
+  regex->flushCount++;
+}
+
+/*
+ * Finds DFA state of kernel, adds it when it is not in cache. Cache is
+ * flushed when full, so earlier DFA states are not valid after.
+ */
+internalfn u32
+RegexDFAFrom(struct regex *regex, u64 *kernel)
+{
+  u32 wordCount = regex->wordCount;
+  u64 hash = 0;
+  for (u32 word = 0; word < wordCount; word++)
+    hash = (hash ^ kernel[word]) * 0x9e3779b97f4a7c15;
+  hash ^= hash >> 32;
+
+  u32 slot = (u32)hash & regex->hashMask;
+  while (regex->hashTable[slot] != 0) {
+    u32 dfa = regex->hashTable[slot] - 1;
+    if (IsMemoryEqual(regex->kernels + dfa * wordCount, kernel, wordCount * sizeof(u64)))
+      return dfa;
+    slot = (slot + 1) & regex->hashMask;
+  }
+
+  if (regex->dfaCount == regex->dfaCapacity) {
+    RegexFlush(regex);
+    slot = (u32)hash & regex->hashMask;
+  }
+
+  u32 dfa = regex->dfaCount++;
+  regex->hashTable[slot] = dfa + 1;
+  MemoryCopy(regex->kernels + dfa * wordCount, kernel, wordCount * sizeof(u64));
+  MemoryClear(regex->transitions + dfa * regex->classCount, regex->classCount * sizeof(s32));
+
+  u8 flags = 0;
+  u64 isAny = 0;
+  MemoryClear(regex->endKernel, wordCount * sizeof(u64));
+  MemoryClear(regex->visited, wordCount * sizeof(u64));
+  for (u32 word = 0; word < wordCount; word++) {
+    isAny |= kernel[word];
+    for (u64 bits = kernel[word]; bits; bits &= bits - 1) {
+      u32 state = word * 64 + (u32)__builtin_ctzll(bits);
+      if (regex->states[state].type == REGEX_STATE_MATCH)
+        flags |= REGEX_DFA_FLAG_MATCH;
+      else if (regex->states[state].type == REGEX_STATE_END)
+        RegexClosure(regex, state, regex->endKernel, 0, 1);
+    }
+  }
+  // match state is first
+  if (regex->endKernel[0] & 1)
+    flags |= REGEX_DFA_FLAG_MATCH_AT_END;
+  if (!isAny)
+    flags |= REGEX_DFA_FLAG_DEAD;
+  regex->flags[dfa] = flags;
+  return dfa;
+}
+
+/*
+ * Builds transition of DFA state on byte class.
+ * @return transition entry, see regex.transitions
+ */
+internalfn s32
+RegexDFAStep(struct regex *regex, u32 dfa, u32 classIndex)
+{
+  u32 wordCount = regex->wordCount;
+  u8 byte = regex->classBytes[classIndex];
+  u64 *from = regex->kernels + dfa * wordCount;
+  u64 *kernel = regex->kernel;
+
+  MemoryCopy(kernel, regex->anywhereKernel, wordCount * sizeof(u64));
+  MemoryClear(regex->visited, wordCount * sizeof(u64));
+  for (u32 word = 0; word < wordCount; word++) {
+    for (u64 bits = from[word]; bits; bits &= bits - 1) {
+      struct regex_state *state = regex->states + word * 64 + (u32)__builtin_ctzll(bits);
+      if (state->type == REGEX_STATE_SET && (regex->nodes[state->node].set[byte / 64] & ((u64)1 << (byte % 64))))
+        RegexClosure(regex, state->next, kernel, 0, 0);
+    }
+  }
+
+  u64 flushCount = regex->flushCount;
+  u32 next = RegexDFAFrom(regex, kernel);
+  s32 entry = (s32)(next * regex->classCount) + 1;
+  if (regex->flags[next] & (REGEX_DFA_FLAG_MATCH | REGEX_DFA_FLAG_DEAD))
+    entry = -entry;
+  // state that is stepped from is gone when cache is flushed
+  if (flushCount == regex->flushCount)
+    regex->transitions[dfa * regex->classCount + classIndex] = entry;
+  return entry;
+}
+
+/*
+ * Runs DFA over bytes, without literal search.
+ * @return 1 when there is match anywhere in bytes
+ */
+internalfn b8
+RegexRun(struct regex *regex, u8 *bytes, u64 length)
+{
+  if (length == 0)
+    return regex->isEmptyMatch;
+  if (regex->beginDFA == U32_MAX) {
+    u32 beginDFA = RegexDFAFrom(regex, regex->beginKernel);
+    regex->beginDFA = beginDFA;
+  }
+  u32 dfa = regex->beginDFA;
+  if (regex->flags[dfa] & (REGEX_DFA_FLAG_MATCH | REGEX_DFA_FLAG_DEAD))
+    return (regex->flags[dfa] & REGEX_DFA_FLAG_MATCH) != 0;
+
+  u32 classCount = regex->classCount;
+  s32 *transitions = regex->transitions;
+  u32 row = dfa * classCount;
+  for (u64 index = 0; index < length; index++) {
+    u32 classIndex = regex->classes[bytes[index]];
+    s32 entry = transitions[row + classIndex];
+    if (entry > 0) {
+      row = (u32)entry - 1;
+      continue;
+    }
+
+    if (entry == 0)
+      entry = RegexDFAStep(regex, row / classCount, classIndex);
+    if (entry > 0) {
+      row = (u32)entry - 1;
+      continue;
+    }
+    dfa = ((u32)-entry - 1) / classCount;
+    return (regex->flags[dfa] & REGEX_DFA_FLAG_MATCH) != 0;
+  }
+  dfa = row / classCount;
+  return (regex->flags[dfa] & (REGEX_DFA_FLAG_MATCH | REGEX_DFA_FLAG_MATCH_AT_END)) != 0;
+}
+
+/*
+ * Compiles pattern. Pattern, NFA and DFA cache are all in arena.
+ *
+ * @param cacheSize bytes of arena for DFA states, cache is flushed and
+ *                  built again when they do not fit. DFA state takes 4 bytes
+ *                  per byte class and 8 bytes per 64 NFA states.
+ * @param errorIndex optional, on failure set to position of invalid syntax,
+ *                   length of pattern when it is too large or arena is full
+ * @return 0 on failure, arena is given back
+ *
+ * @code
+ *   struct regex regex;
+ *   if (!RegexCompile(arena, &StringFromLiteral("ERROR .* took [0-9]{4,}ms"), 64 * KILOBYTES, &regex, 0))
+ *     return 0;
+ *   struct string_cursor cursor = StringCursorFromString(&log);
+ *   for (struct string line = StringCursorConsumeMatchingLine(&cursor, &regex); !IsStringNull(&line);
+ *        line = StringCursorConsumeMatchingLine(&cursor, &regex))
+ *     ...
+ * @endcode
+ */
+internalfn b8
+RegexCompile(memory_arena *arena, struct string *pattern, u64 cacheSize, struct regex *regex, u64 *errorIndex)
+{
+  *regex = (struct regex){0};
+  memory_temp temp = MemoryTempBegin(arena);
+
+  // parse, every byte of pattern adds at most 3 nodes
+  struct regex_parser parser = {
+      .value = pattern->value,
+      .length = pattern->length,
+  };
+  if (pattern->length < U32_MAX / 4) {
+    parser.nodeCapacity = (u32)(3 * pattern->length + 2);
+    parser.nodes = RegexArenaPush(arena, parser.nodeCapacity * sizeof(struct regex_node));
+  }
+  if (!parser.nodes) {
+    if (errorIndex)
+      *errorIndex = pattern->length;
+    MemoryTempEnd(&temp);
+    return 0;
+  }
+  u32 root = RegexParseAlternate(&parser);
+  if (root == U32_MAX || parser.position != parser.length) {
+    // ')' without '('
+    if (errorIndex)
+      *errorIndex = parser.position;
+    MemoryTempEnd(&temp);
+    return 0;
+  }
+  regex->nodes = parser.nodes;
+
+  // NFA, match state is first
+  u64 stateCount = RegexNodeStateCount(parser.nodes, root) + 1;
+  regex->states = stateCount <= REGEX_STATE_MAX ? RegexArenaPush(arena, stateCount * sizeof(struct regex_state)) : 0;
+  u8 *literalBuffer = RegexArenaPush(arena, pattern->length);
+  if (!regex->states || (pattern->length != 0 && !literalBuffer)) {
+    if (errorIndex)
+      *errorIndex = pattern->length;
+    MemoryTempEnd(&temp);
+    return 0;
+  }
+  RegexAddState(regex, REGEX_STATE_MATCH, 0, 0, 0);
+  regex->startState = RegexCompileNode(regex, root, 0);
+  debug_assert(regex->stateCount == stateCount);
+
+  // literal
+  struct regex_literal literal = {.buffer = literalBuffer};
+  RegexLiteralWalk(parser.nodes, root, &literal);
+  regex->literal = StringFromBuffer(literalBuffer + literal.bestStart, literal.bestLength);
+  regex->isLiteralOnly = !literal.isBroken && literal.bestLength != 0 && literal.bestLength == literal.length;
+
+  // byte classes, bytes that are in and out of same sets
+  b8 isBoundary[256] = {0};
+  for (u32 index = 0; index < regex->stateCount; index++) {
+    struct regex_state *state = regex->states + index;
+    if (state->type != REGEX_STATE_SET)
+      continue;
+    u64 *set = parser.nodes[state->node].set;
+    for (u32 byte = 1; byte < 256; byte++) {
+      u64 isIn = (set[byte / 64] >> (byte % 64)) & 1;
+      u64 isPreviousIn = (set[(byte - 1) / 64] >> ((byte - 1) % 64)) & 1;
+      if (isIn != isPreviousIn)
+        isBoundary[byte] = 1;
+    }
+  }
+  for (u32 byte = 0; byte < 256; byte++) {
+    if (byte != 0 && isBoundary[byte])
+      regex->classCount++;
+    regex->classes[byte] = (u8)regex->classCount;
+    if (byte == 0 || isBoundary[byte])
+      regex->classBytes[regex->classCount] = (u8)byte;
+  }
+  regex->classCount++;
+
+  // scratch
+  u32 wordCount = (regex->stateCount + 63) / 64;
+  regex->wordCount = wordCount;
+  u64 *kernels = RegexArenaPush(arena, 5 * wordCount * sizeof(u64));
+  regex->stack = RegexArenaPush(arena, (2 * regex->stateCount + 1) * sizeof(u32));
+
+  // DFA cache
+  u64 stateSize = regex->classCount * sizeof(s32) + wordCount * sizeof(u64) + sizeof(u8) + 2 * sizeof(u32);
+  u64 dfaCapacity = cacheSize / stateSize;
+  // row offsets must fit in transition entry
+  if (dfaCapacity > U32_MAX / 4 / regex->classCount)
+    dfaCapacity = U32_MAX / 4 / regex->classCount;
+  u64 hashCapacity = 1;
+  while (hashCapacity * 2 <= 2 * dfaCapacity)
+    hashCapacity *= 2;
+  if (dfaCapacity > hashCapacity * 3 / 4)
+    dfaCapacity = hashCapacity * 3 / 4;
+  regex->transitions = RegexArenaPush(arena, dfaCapacity * regex->classCount * sizeof(s32));
+  regex->kernels = RegexArenaPush(arena, dfaCapacity * wordCount * sizeof(u64));
+  regex->flags = RegexArenaPush(arena, dfaCapacity);
+  regex->hashTable = RegexArenaPush(arena, hashCapacity * sizeof(u32));
+  if (!kernels || !regex->stack || dfaCapacity < 2 || !regex->transitions || !regex->kernels || !regex->flags ||
+      !regex->hashTable) {
+    if (errorIndex)
+      *errorIndex = pattern->length;
+    MemoryTempEnd(&temp);
+    return 0;
+  }
+  regex->dfaCapacity = (u32)dfaCapacity;
+  regex->hashMask = (u32)hashCapacity - 1;
+
+  regex->beginKernel = kernels;
+  regex->anywhereKernel = kernels + wordCount;
+  regex->kernel = kernels + 2 * wordCount;
+  regex->endKernel = kernels + 3 * wordCount;
+  regex->visited = kernels + 4 * wordCount;
+  MemoryClear(kernels, 5 * wordCount * sizeof(u64));
+  RegexClosure(regex, regex->startState, regex->beginKernel, 1, 0);
+  MemoryClear(regex->visited, wordCount * sizeof(u64));
+  RegexClosure(regex, regex->startState, regex->anywhereKernel, 0, 0);
+  for (u32 word = 0; word < wordCount; word++)
+    regex->beginKernel[word] |= regex->anywhereKernel[word];
+  // only in empty string both '^' and '$' hold everywhere, kernel of DFA
+  // state does not know whether it is at start, so it is decided here
+  MemoryClear(regex->visited, wordCount * sizeof(u64));
+  RegexClosure(regex, regex->startState, regex->endKernel, 1, 1);
+  // match state is first
+  regex->isEmptyMatch = (regex->endKernel[0] & 1) != 0;
+
+  RegexFlush(regex);
+  regex->flushCount = 0;
+  return 1;
+}
+
+/*
+ * @return 1 when regex matches anywhere in string
+ */
+internalfn b8
+RegexIsMatch(struct regex *regex, struct string *string)
+{
+  if (regex->literal.length != 0) {
+    u64 index;
+    if (!StringIndexOf(string, &regex->literal, &index))
+      return 0;
+    if (regex->isLiteralOnly)
+      return 1;
+  }
+  return RegexRun(regex, string->value, string->length);
+}
+
+/*
+ * Finds next line that regex matches. Lines end with '\n', '^' and '$'
+ * match at start and end of line. When regex has literal, only lines that
+ * contain it are run through DFA.
+ *
+ * @return line without '\n', cursor is moved after it,
+ *         null when no remaining line matches, cursor is moved to end
+ */
+internalfn struct string
+StringCursorConsumeMatchingLine(struct string_cursor *cursor, struct regex *regex)
+{
+  u8 *source = cursor->source->value;
+  u64 sourceLength = cursor->source->length;
+  struct string newline = StringFromLiteral("\n");
+
+  while (cursor->position < sourceLength) {
+    struct string remaining = StringCursorExtractRemaining(cursor);
+    u64 lineStart = cursor->position;
+    if (regex->literal.length != 0) {
+      u64 literalIndex;
+      if (!StringIndexOf(&remaining, &regex->literal, &literalIndex))
+        break;
+      lineStart += literalIndex;
+      while (lineStart > cursor->position && source[lineStart - 1] != '\n')
+        lineStart--;
+    }
+
+    struct string rest = StringFromBuffer(source + lineStart, sourceLength - lineStart);
+    u64 lineLength = rest.length;
+    StringIndexOf(&rest, &newline, &lineLength);
+    struct string line = StringFromBuffer(rest.value, lineLength);
+    cursor->position = lineStart + lineLength + (lineLength < rest.length);
+
+    if (regex->isLiteralOnly || RegexRun(regex, line.value, line.length))
+      return line;
+  }
+
+  cursor->position = sourceLength;
+  return StringNull();
+}
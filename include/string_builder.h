@@ -164,14 +164,317 @@ StringBuilderAppendF32(string_builder *stringBuilder, f32 value, u32 fractionCou
   debug_assert(stringBuilder->length <= outBuffer->length);
 }
 
+/*
+ * Appends every byte of string as two lowercase hex digits.
+ * e.g. checksums, keys
+ */
+static inline void
+StringBuilderAppendHexEncoded(string_builder *stringBuilder, struct string *string)
+{
+  struct string *outBuffer = stringBuilder->outBuffer;
+  struct string remaining = StringFromBuffer(outBuffer->value + stringBuilder->length,
+                                             outBuffer->length - stringBuilder->length);
+  struct string hex = HexEncode(&remaining, string);
+  debug_assert(!IsStringNull(&hex) && "out buffer is too small");
+  stringBuilder->length += hex.length;
+}
+
+/*
+ * Appends string encoded as base64, directly into out buffer.
+ * @see Base64Encode()
+ */
+static inline void
+StringBuilderAppendBase64Encoded(string_builder *stringBuilder, struct string *string,
+                                 enum base64_alphabet alphabet)
+{
+  struct string *outBuffer = stringBuilder->outBuffer;
+  struct string remaining = StringFromBuffer(outBuffer->value + stringBuilder->length,
+                                             outBuffer->length - stringBuilder->length);
+  struct string text = Base64Encode(&remaining, string, alphabet);
+  debug_assert(!IsStringNull(&text) && "out buffer is too small");
+  stringBuilder->length += text.length;
+}
+
+/*
+ * Appends bytes decoded from base64, directly into out buffer.
+ * Nothing is appended on failure.
+ * @see Base64Decode()
+ * @return true if string is valid base64
+ */
+static inline b8
+StringBuilderAppendBase64Decoded(string_builder *stringBuilder, struct string *string,
+                                 enum base64_alphabet alphabet, u64 *errorIndex)
+{
+  struct string *outBuffer = stringBuilder->outBuffer;
+  struct string remaining = StringFromBuffer(outBuffer->value + stringBuilder->length,
+                                             outBuffer->length - stringBuilder->length);
+  debug_assert(Base64DecodedLength(string, alphabet) <= remaining.length && "out buffer is too small");
+  struct string bytes = Base64Decode(&remaining, string, alphabet, errorIndex);
+  if (IsStringNull(&bytes))
+    return 0;
+  stringBuilder->length += bytes.length;
+  return 1;
+}
+
+/*
+ * Appends duration with every unit that is not zero, e.g. "1min30sec5ms".
+ * @see FormatDuration()
+ */
+static inline void
+StringBuilderAppendDuration(string_builder *stringBuilder, struct duration *duration)
+{
+  struct string *outBuffer = stringBuilder->outBuffer;
+  struct string remaining = StringFromBuffer(outBuffer->value + stringBuilder->length,
+                                             outBuffer->length - stringBuilder->length);
+  struct string text = FormatDuration(&remaining, duration);
+  if (IsStringNull(&text)) {
+    // formatter needs more room than it writes
+    u8 buffer[48];
+    struct string stringBuffer = StringFromBuffer(buffer, sizeof(buffer));
+    text = FormatDuration(&stringBuffer, duration);
+    StringBuilderAppendString(stringBuilder, &text);
+    return;
+  }
+  stringBuilder->length += text.length;
+}
+
+/*
+ * Appends duration in largest unit with fixed fraction, e.g. "1.234ms".
+ * @see FormatDurationFixed()
+ */
+static inline void
+StringBuilderAppendDurationFixed(string_builder *stringBuilder, struct duration *duration, u32 fractionCount)
+{
+  struct string *outBuffer = stringBuilder->outBuffer;
+  struct string remaining = StringFromBuffer(outBuffer->value + stringBuilder->length,
+                                             outBuffer->length - stringBuilder->length);
+  struct string text = FormatDurationFixed(&remaining, duration, fractionCount);
+  if (IsStringNull(&text)) {
+    // formatter needs more room than it writes
+    u8 buffer[48];
+    struct string stringBuffer = StringFromBuffer(buffer, sizeof(buffer));
+    text = FormatDurationFixed(&stringBuffer, duration, fractionCount);
+    StringBuilderAppendString(stringBuilder, &text);
+    return;
+  }
+  stringBuilder->length += text.length;
+}
+
+/*
+ * Appends timestamp as RFC 3339 in UTC, directly into out buffer.
+ * @see FormatTimestamp()
+ */
+static inline void
+StringBuilderAppendTimestamp(string_builder *stringBuilder, struct timestamp *timestamp, u32 fractionCount)
+{
+  struct string *outBuffer = stringBuilder->outBuffer;
+  struct string remaining = StringFromBuffer(outBuffer->value + stringBuilder->length,
+                                             outBuffer->length - stringBuilder->length);
+  struct string text = FormatTimestamp(&remaining, timestamp, fractionCount);
+  debug_assert(!IsStringNull(&text) && "out buffer is too small");
+  stringBuilder->length += text.length;
+}
+
+/*
+ * Appends path joined to base directory with one separator between them.
+ * When path is absolute it is appended as is, base is ignored.
+ * Nothing is normalized, see PathNormalize().
+ *
+ * @code
+ *   // "/usr/lib/libc.so"
+ *   PathJoin(sb, &StringFromLiteral("/usr/lib/"), &StringFromLiteral("libc.so"));
+ * @endcode
+ */
+static inline void
+PathJoin(string_builder *stringBuilder, struct string *base, struct string *path)
+{
+  if (IsPathAbsolute(path) || base->length == 0) {
+    StringBuilderAppendString(stringBuilder, path);
+    return;
+  }
+
+  StringBuilderAppendString(stringBuilder, base);
+  if (path->length == 0)
+    return;
+
+  struct string *outBuffer = stringBuilder->outBuffer;
+  if (!IsPathSeparator(base->value[base->length - 1])) {
+    debug_assert(stringBuilder->length < outBuffer->length && "out buffer is too small");
+    outBuffer->value[stringBuilder->length++] = PATH_SEPARATOR;
+  }
+  StringBuilderAppendString(stringBuilder, path);
+}
+
+enum string_builder_radix {
+  // same output as StringBuilderAppendU64()
+  STRING_BUILDER_RADIX_DECIMAL,
+  // same output as StringBuilderAppendHex()
+  STRING_BUILDER_RADIX_HEX,
+  // hex zero padded to width of element, 8 digits for u32, 16 digits for u64
+  STRING_BUILDER_RADIX_HEX_FIXED,
+};
+
+/*
+ * Writes value as digits to dest.
+ * dest must be able to hold 20 bytes.
+ * @param fixedHexDigitCount used for STRING_BUILDER_RADIX_HEX_FIXED
+ * @return count of written bytes
+ */
+static inline u64
+StringBuilderFormatArrayElement(u8 *dest, u64 value, enum string_builder_radix radix, u64 fixedHexDigitCount)
+{
+  if (radix == STRING_BUILDER_RADIX_DECIMAL) {
+    comptime u8 digitPairs[] = "00010203040506070809"
+                                  "10111213141516171819"
+                                  "20212223242526272829"
+                                  "30313233343536373839"
+                                  "40414243444546474849"
+                                  "50515253545556575859"
+                                  "60616263646566676869"
+                                  "70717273747576777879"
+                                  "80818283848586878889"
+                                  "90919293949596979899";
+    comptime u64 powersOf10[] = {
+        1ull,                   10ull,                   100ull,
+        1000ull,                10000ull,                100000ull,
+        1000000ull,             10000000ull,             100000000ull,
+        1000000000ull,          10000000000ull,          100000000000ull,
+        1000000000000ull,       10000000000000ull,       100000000000000ull,
+        1000000000000000ull,    10000000000000000ull,    100000000000000000ull,
+        1000000000000000000ull, 10000000000000000000ull,
+    };
+
+    // log10(value) ≈ log2(value) * 1233 / 4096
+    u64 estimate = ((u64)(bsrl(value | 1) + 1) * 1233) >> 12;
+    u64 digitCount = estimate + 1 - (u64)(value < powersOf10[estimate]);
+    if (value == 0)
+      digitCount = 1;
+
+    u8 *digit = dest + digitCount;
+    while (value >= 100) {
+      u64 pair = value % 100;
+      value /= 100;
+      digit -= 2;
+      digit[0] = digitPairs[2 * pair + 0];
+      digit[1] = digitPairs[2 * pair + 1];
+    }
+    if (value >= 10) {
+      digit -= 2;
+      digit[0] = digitPairs[2 * value + 0];
+      digit[1] = digitPairs[2 * value + 1];
+    } else {
+      digit -= 1;
+      digit[0] = (u8)('0' + value);
+    }
+    return digitCount;
+  }
+
+  u64 digitCount = fixedHexDigitCount;
+  if (radix == STRING_BUILDER_RADIX_HEX) {
+    // same widths as FormatHex()
+    s64 n = bsrl(value | 1);
+    digitCount = n < 8 ? 2 : n < 16 ? 4 : n < 32 ? 8 : 16;
+  }
+
+  for (u64 index = digitCount; index > 0; index--) {
+    dest[index - 1] = (u8)("0123456789abcdef"[value & 15]);
+    value >>= 4;
+  }
+  return digitCount;
+}
+
+/*
+ * Appends values with prefix before each one and separator between them.
+ * Output is same as appending each value one by one, but whole array is
+ * formatted in one loop with one capacity check.
+ * Out buffer must have room for worst case, which is every value having maximum
+ * count of digits.
+ *
+ * @param separator optional
+ * @param prefix optional, e.g. "0x"
+ *
+ * @code
+ *   // 0x0000000a, 0x000000ff
+ *   StringBuilderAppendU32Array(sb, values, 2, &StringFromLiteral(", "), &StringFromLiteral("0x"),
+ *                               STRING_BUILDER_RADIX_HEX_FIXED);
+ * @endcode
+ */
+static inline void
+StringBuilderAppendU32Array(string_builder *stringBuilder, u32 *values, u64 count, struct string *separator,
+                            struct string *prefix, enum string_builder_radix radix)
+{
+  struct string *outBuffer = stringBuilder->outBuffer;
+  struct string noString = StringNull();
+  if (!separator)
+    separator = &noString;
+  if (!prefix)
+    prefix = &noString;
+  if (count == 0)
+    return;
+
+  u64 maximumDigitCount = radix == STRING_BUILDER_RADIX_DECIMAL ? 10 /* 4294967295 */ : 8 /* ffffffff */;
+  u64 maximumLength = count * (prefix->length + maximumDigitCount) + (count - 1) * separator->length;
+  debug_assert(stringBuilder->length + maximumLength <= outBuffer->length && "out buffer is too small");
+  (void)maximumLength;
+
+  u8 *dest = outBuffer->value + stringBuilder->length;
+  for (u64 index = 0; index < count; index++) {
+    if (index != 0 && separator->length != 0) {
+      MemoryCopy(dest, separator->value, separator->length);
+      dest += separator->length;
+    }
+    if (prefix->length != 0) {
+      MemoryCopy(dest, prefix->value, prefix->length);
+      dest += prefix->length;
+    }
+    dest += StringBuilderFormatArrayElement(dest, (u64)values[index], radix, 8);
+  }
+
+  stringBuilder->length = (u64)(dest - outBuffer->value);
+}
+
+/*
+ * Same as StringBuilderAppendU32Array(), but with u64 elements.
+ * @see StringBuilderAppendU32Array()
+ */
+static inline void
+StringBuilderAppendU64Array(string_builder *stringBuilder, u64 *values, u64 count, struct string *separator,
+                            struct string *prefix, enum string_builder_radix radix)
+{
+  struct string *outBuffer = stringBuilder->outBuffer;
+  struct string noString = StringNull();
+  if (!separator)
+    separator = &noString;
+  if (!prefix)
+    prefix = &noString;
+  if (count == 0)
+    return;
+
+  u64 maximumDigitCount = radix == STRING_BUILDER_RADIX_DECIMAL ? 20 /* 18446744073709551615 */ : 16;
+  u64 maximumLength = count * (prefix->length + maximumDigitCount) + (count - 1) * separator->length;
+  debug_assert(stringBuilder->length + maximumLength <= outBuffer->length && "out buffer is too small");
+  (void)maximumLength;
+
+  u8 *dest = outBuffer->value + stringBuilder->length;
+  for (u64 index = 0; index < count; index++) {
+    if (index != 0 && separator->length != 0) {
+      MemoryCopy(dest, separator->value, separator->length);
+      dest += separator->length;
+    }
+    if (prefix->length != 0) {
+      MemoryCopy(dest, prefix->value, prefix->length);
+      dest += prefix->length;
+    }
+    dest += StringBuilderFormatArrayElement(dest, values[index], radix, 16);
+  }
+
+  stringBuilder->length = (u64)(dest - outBuffer->value);
+}
+
 static void
 StringBuilderAppendHexDump(string_builder *sb, struct string *string)
 {
   struct string_cursor cursor = StringCursorFromString(string);
-  u8 offsetBuffer[8];
-  struct string offsetBufferString = StringFromBuffer(offsetBuffer, ARRAY_COUNT(offsetBuffer));
-  u8 hexBuffer[2];
-  struct string hexBufferString = StringFromBuffer(hexBuffer, ARRAY_COUNT(hexBuffer));
 
   while (!IsStringCursorAtEnd(&cursor)) {
     if (cursor.position == 0) {
@@ -179,38 +482,39 @@ StringBuilderAppendHexDump(string_builder *sb, struct string *string)
       StringBuilderAppendString(sb, &header);
     }
 
-    // offset
-    struct string offsetText = FormatHex(&offsetBufferString, cursor.position);
-    for (u32 offsetTextPrefixIndex = 0; offsetTextPrefixIndex < offsetBufferString.length - offsetText.length;
-         offsetTextPrefixIndex++) {
-      // offset length must be 8, so fill prefix with zeros
-      StringBuilderAppendStringLiteral(sb, "0");
-    }
-    StringBuilderAppendString(sb, &offsetText);
+    // offset, length must be 8
+    u32 offset = (u32)cursor.position;
+    u8 offsetBytes[4] = {(u8)(offset >> 24), (u8)(offset >> 16), (u8)(offset >> 8), (u8)offset};
+    struct string offsetBytesString = StringFromBuffer(offsetBytes, ARRAY_COUNT(offsetBytes));
+    StringBuilderAppendHexEncoded(sb, &offsetBytesString);
 
     StringBuilderAppendStringLiteral(sb, " ");
 
     // hex
     u64 width = 16;
     struct string substring = StringCursorConsumeSubstring(&cursor, width);
-    for (u64 substringIndex = 0; substringIndex < substring.length; substringIndex++) {
-      u8 character = *(substring.value + substringIndex);
-      struct string hexText = FormatHex(&hexBufferString, (u64)character);
-      debug_assert(hexText.length == 2);
-      StringBuilderAppendString(sb, &hexText);
-
-      StringBuilderAppendStringLiteral(sb, " ");
-
-      if (substringIndex + 1 == 8)
-        StringBuilderAppendStringLiteral(sb, " ");
-    }
+    u8 hexBuffer[32];
+    struct string hexBufferString = StringFromBuffer(hexBuffer, ARRAY_COUNT(hexBuffer));
+    struct string hexText = HexEncode(&hexBufferString, &substring);
+
+    // "xx " per byte, extra space after 8th byte, empty bytes aligns ascii to right
+    u8 columnBuffer[3 * 16 + 1];
+    u64 columnLength = 0;
+    for (u64 index = 0; index < width; index++) {
+      if (index < substring.length) {
+        columnBuffer[columnLength++] = hexText.value[2 * index + 0];
+        columnBuffer[columnLength++] = hexText.value[2 * index + 1];
+      } else {
+        columnBuffer[columnLength++] = ' ';
+        columnBuffer[columnLength++] = ' ';
+      }
+      columnBuffer[columnLength++] = ' ';
 
-    for (u64 index = 0; index < width - substring.length; index++) {
-      // align ascii to right
-      StringBuilderAppendStringLiteral(sb, "   ");
-      if (index + substring.length + 1 == 8)
-        StringBuilderAppendStringLiteral(sb, " ");
+      if (index + 1 == 8)
+        columnBuffer[columnLength++] = ' ';
     }
+    struct string column = StringFromBuffer(columnBuffer, columnLength);
+    StringBuilderAppendString(sb, &column);
 
     // ascii input
     StringBuilderAppendStringLiteral(sb, "|");
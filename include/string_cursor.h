@@ -435,3 +435,666 @@ StringCursorAdvanceAfterLast(struct string_cursor *cursor, struct string *search
   cursor->position += before.length + search->length;
   return 1;
 }
+
+enum string_line_index_flag {
+  STRING_LINE_INDEX_FLAG_NONE = 0,
+  // '\r' before '\n' is not part of line
+  STRING_LINE_INDEX_FLAG_CRLF = (1 << 0),
+};
+
+/*
+ * Start offsets of every line in source.
+ * Line n is [offsets[n], offsets[n + 1] - 1), last newline of source does NOT
+ * start new line.
+ * @see StringLineIndexFrom()
+ */
+struct string_line_index {
+  struct string *source;
+  // count + 1 offsets, last one is sentinel
+  u64 *offsets;
+  u64 count;
+  u32 flags;
+  u8 _padding[4];
+};
+
+/*
+ * @param block at least 64 bytes
+ * @return bit n is set when block[n] is equal to byte
+ */
+internalfn u64
+ByteEqualMask64(u8 *block, u8 byte)
+{
+#if defined(__AVX2__)
+  __m256i search = _mm256_set1_epi8((char)byte);
+  u64 low = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i *)block), search));
+  u64 high = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i *)(block + 32)), search));
+  return low | (high << 32);
+#elif defined(__SSE2__)
+  __m128i search = _mm_set1_epi8((char)byte);
+  u64 mask = 0;
+  for (u32 index = 0; index < 4; index++) {
+    __m128i chunk = _mm_loadu_si128((__m128i *)(block + index * 16));
+    mask |= (u64)(u32)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, search)) << (index * 16);
+  }
+  return mask;
+#else
+  u64 mask = 0;
+  for (u32 index = 0; index < 64; index++)
+    mask |= (u64)(block[index] == byte) << index;
+  return mask;
+#endif
+}
+
+/*
+ * Scans source once and writes start offset of every line into arena.
+ * Offsets are written into free space of arena and only what is used is kept.
+ * @param flags see enum string_line_index_flag
+ * @return true if all offsets fit into arena
+ *         false otherwise, arena is left untouched
+ * @code
+ *   struct string_line_index index;
+ *   if (StringLineIndexFrom(arena, &text, STRING_LINE_INDEX_FLAG_CRLF, &index)) {
+ *     struct string line = StringLineIndexGetLine(&index, 41);
+ *     struct string_cursor cursor = StringCursorFromLine(&index, 41);
+ *   }
+ * @endcode
+ */
+internalfn b8
+StringLineIndexFrom(memory_arena *arena, struct string *source, u32 flags, struct string_line_index *index)
+{
+  memory_temp temp = MemoryTempBegin(arena);
+  u64 *offsets = MemoryArenaPushAligned(arena, 0, sizeof(*offsets));
+  u64 capacity = arena->used < arena->total ? (arena->total - arena->used) / sizeof(*offsets) : 0;
+  if (capacity == 0) {
+    MemoryTempEnd(&temp);
+    return 0;
+  }
+
+  u64 count = 0;
+  offsets[count++] = 0;
+
+  u64 position = 0;
+  for (; position + 64 <= source->length; position += 64) {
+    u64 mask = ByteEqualMask64(source->value + position, '\n');
+    if (mask == 0)
+      continue;
+
+    if (count + (u64)__builtin_popcountll(mask) > capacity) {
+      MemoryTempEnd(&temp);
+      return 0;
+    }
+
+    // extract set bits, each newline starts next line
+    do {
+      offsets[count++] = position + (u64)__builtin_ctzll(mask) + 1;
+      mask &= mask - 1;
+    } while (mask);
+  }
+
+  for (; position < source->length; position++) {
+    if (source->value[position] != '\n')
+      continue;
+
+    if (count == capacity) {
+      MemoryTempEnd(&temp);
+      return 0;
+    }
+    offsets[count++] = position + 1;
+  }
+
+  // when source does not end with newline, last line ends at end of source
+  if (source->length != 0 && source->value[source->length - 1] != '\n') {
+    if (count == capacity) {
+      MemoryTempEnd(&temp);
+      return 0;
+    }
+    offsets[count++] = source->length + 1;
+  }
+
+  arena->used += count * sizeof(*offsets);
+
+  *index = (struct string_line_index){
+      .source = source,
+      .offsets = offsets,
+      .count = count - 1,
+      .flags = flags,
+  };
+  return 1;
+}
+
+/*
+ * @param lineIndex starts from 0
+ * @return text of line without newline
+ *         null if line not exists
+ */
+internalfn struct string
+StringLineIndexGetLine(struct string_line_index *index, u64 lineIndex)
+{
+  if (lineIndex >= index->count)
+    return StringNull();
+
+  u64 start = index->offsets[lineIndex];
+  u64 end = index->offsets[lineIndex + 1] - 1;
+  // end is at newline unless it is last line without one
+  b8 isNewline = end < index->source->length;
+  if ((index->flags & STRING_LINE_INDEX_FLAG_CRLF) && isNewline && end > start && index->source->value[end - 1] == '\r')
+    end--;
+
+  return StringFromBuffer(index->source->value + start, end - start);
+}
+
+/*
+ * @param lineIndex starts from 0
+ * @return cursor at start of line
+ *         at end of source if line not exists
+ */
+internalfn struct string_cursor
+StringCursorFromLine(struct string_line_index *index, u64 lineIndex)
+{
+  struct string_cursor cursor = StringCursorFromString(index->source);
+  if (lineIndex >= index->count)
+    cursor.position = index->source->length;
+  else
+    cursor.position = index->offsets[lineIndex];
+  return cursor;
+}
+
+/*
+ * @return bit n is xor of bits [0, n], e.g. set between opening and closing
+ *         quotes
+ */
+internalfn u64
+PrefixXor64(u64 bits)
+{
+#if defined(__PCLMUL__)
+  // carry-less multiply by all ones
+  __m128i product = _mm_clmulepi64_si128(_mm_set_epi64x(0, (s64)bits), _mm_set1_epi8(-1), 0);
+  return (u64)_mm_cvtsi128_si64(product);
+#else
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+  return bits;
+#endif
+}
+
+enum csv_token {
+  // No complete field left, see CSVReaderRefill() if input is streamed
+  CSV_TOKEN_END,
+  // Field followed by delimiter
+  CSV_TOKEN_FIELD,
+  // Field that ends record
+  CSV_TOKEN_LAST_FIELD,
+  // Misplaced or unterminated quote, see errorPosition
+  CSV_TOKEN_ERROR,
+};
+
+/*
+ * RFC 4180 reader that yields fields without copying.
+ * Input is scanned 64 bytes at a time into bitmask of delimiters and newlines
+ * that are not in quotes.
+ * @see CSVReaderFrom()
+ */
+struct csv_reader {
+  // at start of next field
+  struct string_cursor cursor;
+  // structurals not yet consumed of block [blockEnd - 64, blockEnd)
+  u64 structurals;
+  u64 blockEnd;
+  // all ones when previous block ended in quotes
+  u64 quoteCarry;
+  // 1 when last byte of previous block ends field or is quote
+  u64 fieldStartCarry;
+  // misplaced quote or start of malformed field, U64_MAX if none found
+  u64 errorPosition;
+  enum csv_token lastToken;
+  u8 delimiter;
+  b8 isFinal;
+  // last field was in quotes, see CSVFieldUnescape()
+  b8 isQuoted;
+  u8 _padding[1];
+};
+
+/*
+ * Continues reading from chunk.
+ * Fields returned before are not valid if their memory is reused.
+ * @param chunk must start with CSVReaderRemaining() of previous chunk
+ * @param isFinal true when no more input follows
+ */
+internalfn void
+CSVReaderRefill(struct csv_reader *reader, struct string *chunk, b8 isFinal)
+{
+  reader->cursor = StringCursorFromString(chunk);
+  reader->structurals = 0;
+  reader->blockEnd = 0;
+  reader->quoteCarry = 0;
+  reader->fieldStartCarry = 1;
+  reader->errorPosition = U64_MAX;
+  reader->isFinal = isFinal;
+}
+
+/*
+ * @param delimiter ',' for CSV, '\t' for TSV
+ * @param isFinal true when chunk is whole input
+ * @code
+ *   struct csv_reader reader = CSVReaderFrom(&text, ',', 1);
+ *   struct string field;
+ *   enum csv_token token;
+ *   while ((token = CSVReaderNext(&reader, &field)) != CSV_TOKEN_END) {
+ *     if (token == CSV_TOKEN_ERROR)
+ *       break;
+ *     if (reader.isQuoted)
+ *       field = CSVFieldUnescape(&field);
+ *     // ...
+ *     if (token == CSV_TOKEN_LAST_FIELD)
+ *       // record ended
+ *   }
+ * @endcode
+ */
+internalfn struct csv_reader
+CSVReaderFrom(struct string *chunk, u8 delimiter, b8 isFinal)
+{
+  debug_assert(delimiter != '"' && delimiter != '\n' && delimiter != '\r');
+  struct csv_reader reader = {
+      .delimiter = delimiter,
+      .lastToken = CSV_TOKEN_END,
+  };
+  CSVReaderRefill(&reader, chunk, isFinal);
+  return reader;
+}
+
+/*
+ * @return unconsumed input, starts at field that is not complete in chunk
+ */
+internalfn struct string
+CSVReaderRemaining(struct csv_reader *reader)
+{
+  return StringCursorExtractRemaining(&reader->cursor);
+}
+
+internalfn void
+CSVReaderLoadBlock(struct csv_reader *reader)
+{
+  struct string *source = reader->cursor.source;
+  u64 blockStart = reader->blockEnd;
+  u8 *block = source->value + blockStart;
+
+  u64 validMask = U64_MAX;
+  u8 tail[64];
+  if (blockStart + 64 > source->length) {
+    u64 length = source->length - blockStart;
+    MemoryClear(tail, sizeof(tail));
+    MemoryCopy(tail, block, length);
+    block = tail;
+    validMask = ((u64)1 << length) - 1;
+  }
+
+  u64 quotes = ByteEqualMask64(block, '"') & validMask;
+  u64 separators = (ByteEqualMask64(block, reader->delimiter) | ByteEqualMask64(block, '\n')) & validMask;
+
+  // opening quote bit and bits in quotes are set, "" toggles twice
+  u64 inQuote = PrefixXor64(quotes) ^ reader->quoteCarry;
+  reader->quoteCarry = (u64)((s64)inQuote >> 63);
+  u64 structurals = separators & ~inQuote;
+
+  // opening quote must start field or follow closing quote in ""
+  u64 fieldStarts = ((structurals | quotes) << 1) | reader->fieldStartCarry;
+  reader->fieldStartCarry = (structurals | quotes) >> 63;
+  u64 errors = quotes & inQuote & ~fieldStarts;
+  if (errors && reader->errorPosition == U64_MAX)
+    reader->errorPosition = blockStart + (u64)__builtin_ctzll(errors);
+
+  reader->structurals = structurals;
+  reader->blockEnd = blockStart + 64;
+}
+
+internalfn enum csv_token
+CSVReaderError(struct csv_reader *reader, u64 position)
+{
+  if (position < reader->errorPosition)
+    reader->errorPosition = position;
+  reader->lastToken = CSV_TOKEN_ERROR;
+  return CSV_TOKEN_ERROR;
+}
+
+/*
+ * @param field text of field, outer quotes are removed when isQuoted is set,
+ *              but "" inside is kept, see CSVFieldUnescape()
+ * @return see enum csv_token
+ */
+internalfn enum csv_token
+CSVReaderNext(struct csv_reader *reader, struct string *field)
+{
+  if (reader->lastToken == CSV_TOKEN_ERROR)
+    return CSV_TOKEN_ERROR;
+
+  struct string *source = reader->cursor.source;
+  u64 start = reader->cursor.position;
+  u64 end;
+  enum csv_token token;
+
+  while (reader->structurals == 0 && reader->blockEnd < source->length)
+    CSVReaderLoadBlock(reader);
+
+  if (reader->structurals != 0) {
+    end = reader->blockEnd - 64 + (u64)__builtin_ctzll(reader->structurals);
+    reader->structurals &= reader->structurals - 1;
+    if (reader->errorPosition < end)
+      return CSVReaderError(reader, reader->errorPosition);
+
+    reader->cursor.position = end + 1;
+    token = source->value[end] == '\n' ? CSV_TOKEN_LAST_FIELD : CSV_TOKEN_FIELD;
+    // CRLF
+    if (token == CSV_TOKEN_LAST_FIELD && end > start && source->value[end - 1] == '\r')
+      end--;
+  } else {
+    // last field has no delimiter or newline after it
+    if (!reader->isFinal)
+      return CSV_TOKEN_END;
+    if (reader->quoteCarry)
+      return CSVReaderError(reader, start);
+    if (reader->errorPosition != U64_MAX)
+      return CSVReaderError(reader, reader->errorPosition);
+    if (start == source->length && reader->lastToken != CSV_TOKEN_FIELD) {
+      reader->lastToken = CSV_TOKEN_END;
+      return CSV_TOKEN_END;
+    }
+
+    end = source->length;
+    reader->cursor.position = end;
+    token = CSV_TOKEN_LAST_FIELD;
+  }
+
+  *field = StringFromBuffer(source->value + start, end - start);
+  reader->isQuoted = field->length != 0 && field->value[0] == '"';
+  if (reader->isQuoted) {
+    if (field->length < 2 || field->value[field->length - 1] != '"')
+      return CSVReaderError(reader, start);
+    field->value++;
+    field->length -= 2;
+  }
+
+  reader->lastToken = token;
+  return token;
+}
+
+/*
+ * Replaces "" with " in quoted field, in place.
+ * @return unescaped field
+ */
+internalfn struct string
+CSVFieldUnescape(struct string *field)
+{
+  u64 index;
+  struct string search = StringFromLiteral("\"\"");
+  if (!StringIndexOf(field, &search, &index))
+    return *field;
+
+  u8 *value = field->value;
+  u64 length = index;
+  while (index < field->length) {
+    u8 character = value[index];
+    value[length++] = character;
+    index += character == '"' ? 2 : 1;
+  }
+  return StringFromBuffer(value, length);
+}
+
+/*
+ * Reads next bytes of input into buffer.
+ * @return count of bytes read, 0 at end of input, U64_MAX on failure
+ */
+typedef u64 (*string_stream_read)(void *context, u8 *buffer, u64 length);
+
+/*
+ * Cursor over input that is read from source in pieces, e.g. file or pipe,
+ * so input of any size is parsed in memory of window.
+ * On refill unconsumed text is moved to start of window and free part is
+ * filled from source. Strings returned point into window, they are NOT valid
+ * after next call that may refill.
+ * @see StringStreamFrom()
+ */
+struct string_stream {
+  struct string window;
+  // bytes [0, length) of window are read from source
+  u64 length;
+  // position in window
+  u64 position;
+  // position in input of start of window
+  u64 offset;
+  string_stream_read read;
+  void *context;
+  // source has no more input
+  b8 isEnd;
+  // source failed, isEnd is also set
+  b8 isFailed;
+  u8 _padding[6];
+};
+
+/*
+ * @param window memory that input is read into, longest text consumed at once
+ *               must fit in it
+ * @param context passed to read as is
+ * @code
+ *   struct string_cursor source = StringCursorFromString(&input);
+ *   struct string_stream stream = StringStreamFrom(&window, StringStreamReadFromCursor, &source);
+ *   while (1) {
+ *     struct string line = StringStreamConsumeThrough(&stream, &StringFromLiteral("\n"));
+ *     if (IsStringNull(&line))
+ *       break;
+ *     // ...
+ *   }
+ * @endcode
+ */
+internalfn struct string_stream
+StringStreamFrom(struct string *window, string_stream_read read, void *context)
+{
+  debug_assert(window->length != 0);
+  return (struct string_stream){
+      .window = *window,
+      .read = read,
+      .context = context,
+  };
+}
+
+/*
+ * Source that consumes bytes of cursor, see string_stream_read.
+ * @param context struct string_cursor
+ */
+internalfn u64
+StringStreamReadFromCursor(void *context, u8 *buffer, u64 length)
+{
+  struct string_cursor *cursor = context;
+  struct string substring = StringCursorConsumeSubstring(cursor, length);
+  MemoryCopy(buffer, substring.value, substring.length);
+  return substring.length;
+}
+
+internalfn u64
+StringStreamRemainingLength(struct string_stream *stream)
+{
+  return stream->length - stream->position;
+}
+
+/*
+ * Moves unconsumed text to start of window and reads from source into rest
+ * of window.
+ * @return 1 when new bytes are read, 0 at end of input or when window is full
+ */
+internalfn b8
+StringStreamRefill(struct string_stream *stream)
+{
+  if (stream->isEnd)
+    return 0;
+
+  if (stream->position != 0) {
+    u64 remainingLength = StringStreamRemainingLength(stream);
+    MemoryMove(stream->window.value, stream->window.value + stream->position, remainingLength);
+    stream->offset += stream->position;
+    stream->length = remainingLength;
+    stream->position = 0;
+  }
+
+  u64 capacity = stream->window.length - stream->length;
+  if (capacity == 0)
+    return 0;
+
+  u64 readCount = stream->read(stream->context, stream->window.value + stream->length, capacity);
+  if (readCount == U64_MAX) {
+    stream->isFailed = 1;
+    readCount = 0;
+  }
+  if (readCount == 0) {
+    stream->isEnd = 1;
+    return 0;
+  }
+
+  debug_assert(readCount <= capacity);
+  stream->length += readCount;
+  return 1;
+}
+
+/*
+ * Refills until remaining text is at least length bytes long.
+ * @return 1 when it is, 0 at end of input or when length does not fit in
+ *         window
+ */
+internalfn b8
+StringStreamEnsure(struct string_stream *stream, u64 length)
+{
+  while (StringStreamRemainingLength(stream) < length) {
+    if (!StringStreamRefill(stream))
+      return 0;
+  }
+  return 1;
+}
+
+/*
+ * @return 1 when all input is consumed
+ */
+internalfn b8
+IsStringStreamAtEnd(struct string_stream *stream)
+{
+  return !StringStreamEnsure(stream, 1);
+}
+
+/*
+ * Finds first occurence of search text in remaining text, refilling as
+ * needed. Text that is searched is not searched again after refill.
+ * @param index position in window, only set when found
+ * @return 1 when found, 0 at end of input or when text before and including
+ *         search text does not fit in window
+ */
+internalfn b8
+StringStreamIndexOf(struct string_stream *stream, struct string *search, u64 *index)
+{
+  if (search->length == 0)
+    return 0;
+
+  // bytes after position that search text can NOT start at
+  u64 searched = 0;
+  while (1) {
+    u64 start = stream->position + searched;
+    struct string unsearched = StringFromBuffer(stream->window.value + start, stream->length - start);
+    u64 found;
+    if (StringIndexOf(&unsearched, search, &found)) {
+      *index = start + found;
+      return 1;
+    }
+
+    if (unsearched.length >= search->length)
+      searched += unsearched.length - search->length + 1;
+    if (!StringStreamRefill(stream))
+      return 0;
+  }
+}
+
+/*
+ * @return prefix is at start of remaining text, cursor does NOT advance
+ */
+internalfn b8
+StringStreamPeekStartsWith(struct string_stream *stream, struct string *prefix)
+{
+  if (!StringStreamEnsure(stream, prefix->length))
+    return 0;
+  return IsMemoryEqual(stream->window.value + stream->position, prefix->value, prefix->length);
+}
+
+/*
+ * @return next length bytes, less at end of input or when length does not
+ *         fit in window
+ */
+internalfn struct string
+StringStreamConsumeSubstring(struct string_stream *stream, u64 length)
+{
+  StringStreamEnsure(stream, length);
+  if (length > StringStreamRemainingLength(stream))
+    length = StringStreamRemainingLength(stream);
+  struct string substring = StringFromBuffer(stream->window.value + stream->position, length);
+  stream->position += length;
+  return substring;
+}
+
+/*
+ * Same as StringCursorConsumeUntil(), search text may span refills.
+ * @return text before first occurence of search text
+ *         empty if remaining text starts with search text
+ *         null if search text not found, or it is not found in window when
+ *         isEnd is not set
+ */
+internalfn struct string
+StringStreamConsumeUntil(struct string_stream *stream, struct string *search)
+{
+  u64 index;
+  if (!StringStreamIndexOf(stream, search, &index))
+    return StringNull();
+
+  struct string result = StringFromBuffer(stream->window.value + stream->position, index - stream->position);
+  stream->position = index;
+  return result;
+}
+
+/*
+ * Same as StringCursorConsumeThrough(), search text may span refills.
+ * @return text including first occurrence of search text
+ *         null if search text not found, or it is not found in window when
+ *         isEnd is not set
+ */
+internalfn struct string
+StringStreamConsumeThrough(struct string_stream *stream, struct string *search)
+{
+  struct string result = StringStreamConsumeUntil(stream, search);
+  if (IsStringNull(&result))
+    return result;
+
+  result.length += search->length;
+  stream->position += search->length;
+  return result;
+}
+
+/*
+ * Same as StringCursorConsumeUntilOrRest(), except rest that does not fit in
+ * window is returned in pieces. Piece never ends with part of search text, so
+ * search text is found when StringStreamPeekStartsWith() after it is true.
+ * @return text before first occurence of search text
+ *         empty if remaining text starts with search text
+ *         remaining text, or part of it, if search text not found
+ */
+internalfn struct string
+StringStreamConsumeUntilOrRest(struct string_stream *stream, struct string *search)
+{
+  struct string result = StringStreamConsumeUntil(stream, search);
+  if (!IsStringNull(&result))
+    return result;
+
+  u64 length = StringStreamRemainingLength(stream);
+  if (!stream->isEnd && search->length != 0) {
+    // window is full, keep bytes that may start search text
+    debug_assert(length >= search->length);
+    length -= search->length - 1;
+  }
+  return StringStreamConsumeSubstring(stream, length);
+}
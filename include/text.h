@@ -5,6 +5,10 @@
 #include "memory.h"
 #include "type.h"
 
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 struct string {
   u8 *value;
   u64 length;
@@ -144,6 +148,37 @@ IsStringNotEqual(struct string *left, struct string *right)
   return !IsStringEqual(left, right);
 }
 
+/*
+ * Compares bytes in order, 8 at a time. Shorter string comes first when it
+ * is prefix of other. Null string is same as empty string.
+ * @return negative when left comes first, positive when right comes first,
+ *         0 when equal
+ */
+static inline s32
+StringCompare(struct string *left, struct string *right)
+{
+  u64 length = left->length < right->length ? left->length : right->length;
+  u64 index = 0;
+  for (; index + 8 <= length; index += 8) {
+    u64 leftBytes, rightBytes;
+    MemoryCopy(&leftBytes, left->value + index, sizeof(leftBytes));
+    MemoryCopy(&rightBytes, right->value + index, sizeof(rightBytes));
+    if (leftBytes != rightBytes) {
+      // first different byte decides, it is highest in big endian
+      leftBytes = __builtin_bswap64(leftBytes);
+      rightBytes = __builtin_bswap64(rightBytes);
+      return leftBytes < rightBytes ? -1 : 1;
+    }
+  }
+
+  for (; index < length; index++) {
+    if (left->value[index] != right->value[index])
+      return left->value[index] < right->value[index] ? -1 : 1;
+  }
+
+  return left->length < right->length ? -1 : left->length > right->length ? 1 : 0;
+}
+
 static u8
 ToLowerASCII(u8 character)
 {
@@ -229,59 +264,157 @@ IsStringEndsWith(struct string *string, struct string *search)
   return 1;
 }
 
-static struct string
-StringStripWhitespace(struct string *string)
+/*
+ * Horizontal tab, line feed, vertical tab, form feed, carriage return, space.
+ */
+comptime b8 IS_WHITESPACE[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0, // 0x00
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x10
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x20
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x30
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x40
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x50
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x60
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x70
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x80
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x90
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xa0
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xb0
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xc0
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xd0
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xe0
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xf0
+};
+
+static inline b8
+IsWhitespace(u8 character)
+{
+  return IS_WHITESPACE[character];
+}
+
+#if defined(__AVX2__)
+/*
+ * Bit is set for every byte that is NOT whitespace.
+ */
+static inline u32
+NonWhitespaceMask32(u8 *bytes)
+{
+  __m256i input = _mm256_loadu_si256((__m256i *)bytes);
+  // [\t, \r] is [0x09, 0x0d], after subtracting 0x09 unsigned compare to 4
+  __m256i controlOffset = _mm256_sub_epi8(input, _mm256_set1_epi8(0x09));
+  __m256i isControl = _mm256_cmpeq_epi8(_mm256_min_epu8(controlOffset, _mm256_set1_epi8(4)), controlOffset);
+  __m256i isSpace = _mm256_cmpeq_epi8(input, _mm256_set1_epi8(' '));
+  return ~(u32)_mm256_movemask_epi8(_mm256_or_si256(isControl, isSpace));
+}
+#elif defined(__SSE2__)
+/*
+ * Bit is set for every byte that is NOT whitespace.
+ */
+static inline u32
+NonWhitespaceMask32(u8 *bytes)
+{
+  u32 mask = 0;
+  for (u32 half = 0; half < 2; half++) {
+    __m128i input = _mm_loadu_si128((__m128i *)(bytes + 16 * half));
+    // [\t, \r] is [0x09, 0x0d], after subtracting 0x09 unsigned compare to 4
+    __m128i controlOffset = _mm_sub_epi8(input, _mm_set1_epi8(0x09));
+    __m128i isControl = _mm_cmpeq_epi8(_mm_min_epu8(controlOffset, _mm_set1_epi8(4)), controlOffset);
+    __m128i isSpace = _mm_cmpeq_epi8(input, _mm_set1_epi8(' '));
+    mask |= (u32)_mm_movemask_epi8(_mm_or_si128(isControl, isSpace)) << (16 * half);
+  }
+  return ~mask;
+}
+#endif
+
+/*
+ * Removes whitespace from start of string.
+ * @return sub string, null if string is empty or only whitespace
+ */
+static inline struct string
+StringStripLeft(struct string *string)
 {
   struct string result = StringNull();
   if (!string || string->length == 0)
     return result;
 
-  b8 whitespace[U8_MAX] = {
-      // horizontal tab, line feed, vertical tab, form feed, carriage return, space
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0, // 0x00
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x10
-      1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x20
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x30
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x40
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x50
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x60
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x70
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x80
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x90
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xa0
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xb0
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xc0
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xd0
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xe0
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0     // 0xf0
-  };
+  u8 *bytes = string->value;
+  u64 length = string->length;
+  u64 start = 0;
 
-  u64 position = 0;
-  while (position < string->length) {
-    u8 character = string->value[position];
-    if (!whitespace[character])
-      break;
-    position++;
+#if defined(__SSE2__)
+  for (; start + 32 <= length; start += 32) {
+    u32 mask = NonWhitespaceMask32(bytes + start);
+    if (mask != 0) {
+      start += (u64)__builtin_ctz(mask);
+      goto found;
+    }
   }
-  u64 start = position;
+#endif
 
-  position = string->length - 1;
-  while (position > start) {
-    u8 character = string->value[position];
-    if (!whitespace[character])
-      break;
-    position--;
+  while (start < length && IsWhitespace(bytes[start]))
+    start++;
+
+#if defined(__SSE2__)
+found:
+#endif
+  if (start == length)
+    return result;
+
+  result.value = bytes + start;
+  result.length = length - start;
+  return result;
+}
+
+/*
+ * Removes whitespace from end of string.
+ * @return sub string, null if string is empty or only whitespace
+ */
+static inline struct string
+StringStripRight(struct string *string)
+{
+  struct string result = StringNull();
+  if (!string || string->length == 0)
+    return result;
+
+  u8 *bytes = string->value;
+  u64 end = string->length;
+
+#if defined(__SSE2__)
+  for (; end >= 32; end -= 32) {
+    u32 mask = NonWhitespaceMask32(bytes + end - 32);
+    if (mask != 0) {
+      // last non-whitespace byte is highest set bit
+      end -= (u64)__builtin_clz(mask);
+      goto found;
+    }
   }
-  u64 end = position + 1;
+#endif
 
-  if (end == start)
+  while (end > 0 && IsWhitespace(bytes[end - 1]))
+    end--;
+
+#if defined(__SSE2__)
+found:
+#endif
+  if (end == 0)
     return result;
 
-  result.value = string->value + start;
-  result.length = end - start;
+  result.value = bytes;
+  result.length = end;
   return result;
 }
 
+/*
+ * Removes whitespace from both ends of string.
+ * @return sub string, null if string is empty or only whitespace
+ */
+static inline struct string
+StringStripWhitespace(struct string *string)
+{
+  struct string left = StringStripLeft(string);
+  return StringStripRight(&left);
+}
+
 struct duration {
   u64 ns;
 };
@@ -494,6 +627,211 @@ ParseDuration(struct string *string, struct duration *duration)
   return 1;
 }
 
+/*
+ * Writes value below 1000 without leading zeros. Always stores 3 bytes.
+ * Divisions are multiply and shift, exact below 1024.
+ * @return count of digits
+ */
+static inline u64
+DurationWriteSmall(u8 *dest, u32 value)
+{
+  u32 hundreds = (value * 41) >> 12;
+  u32 rest = value - hundreds * 100;
+  u32 tens = (rest * 103) >> 10;
+  u32 ones = rest - tens * 10;
+  u64 position = 0;
+  dest[position] = (u8)('0' + hundreds);
+  position += (u64)(value >= 100);
+  dest[position] = (u8)('0' + tens);
+  position += (u64)(value >= 10);
+  dest[position] = (u8)('0' + ones);
+  return position + 1;
+}
+
+/*
+ * Writes value below 1000 as 3 digits with leading zeros.
+ */
+static inline void
+DurationWritePadded(u8 *dest, u32 value)
+{
+  u32 hundreds = (value * 41) >> 12;
+  u32 rest = value - hundreds * 100;
+  u32 tens = (rest * 103) >> 10;
+  dest[0] = (u8)('0' + hundreds);
+  dest[1] = (u8)('0' + tens);
+  dest[2] = (u8)('0' + rest - tens * 10);
+}
+
+/*
+ * Writes value without leading zeros. Always stores at least 3 bytes.
+ * @return count of digits
+ */
+static inline u64
+DurationWriteDigits(u8 *dest, u64 value)
+{
+  if (value < 1000)
+    return DurationWriteSmall(dest, (u32)value);
+
+  // groups of 3 digits, last group first
+  u32 groups[7];
+  u32 groupCount = 0;
+  while (value >= 1000) {
+    u64 quotient = value / 1000;
+    groups[groupCount++] = (u32)(value - quotient * 1000);
+    value = quotient;
+  }
+
+  u64 count = DurationWriteSmall(dest, (u32)value);
+  while (groupCount != 0) {
+    DurationWritePadded(dest + count, groups[--groupCount]);
+    count += 3;
+  }
+  return count;
+}
+
+/*
+ * Formats duration with every unit that is not zero, e.g. "1min30sec5ms".
+ * Units are same as ParseDuration(). Zero is formatted as "0".
+ * Units are split with 32-bit multiply and shift instead of division.
+ * Zero units after the largest one are written then overwritten instead of
+ * branched around.
+ *
+ * @param buffer must hold at least 48 bytes, more than the output because
+ *               skipped units are written too
+ * @return string in buffer, null when buffer is too small
+ */
+static inline struct string
+FormatDuration(struct string *buffer, struct duration *duration)
+{
+  struct string result = StringNull();
+  if (!buffer || buffer->length < 48)
+    return result;
+  u8 *out = buffer->value;
+
+  u64 ns = duration->ns;
+  if (ns == 0) {
+    out[0] = '0';
+    result.value = out;
+    result.length = 1;
+    return result;
+  }
+
+  // only these two are 64-bit, compiler turns them into multiply high
+  u64 seconds = ns / 1000000000;
+  u64 minutes = seconds / 60;
+  u32 nanoseconds = (u32)(ns - seconds * 1000000000);
+  // below 2^29
+  u32 totalMinutes = (u32)minutes;
+
+  u32 hours = (u32)(((u64)totalMinutes * 0x88888889) >> 37);
+  u32 days = (u32)(((u64)hours * 0xaaaaaaab) >> 36);
+  // exact for days below 2^32 / 3
+  u32 weeks = (u32)(((u64)days * 0x24924925) >> 32);
+  u32 milliseconds = (u32)(((u64)nanoseconds * 0x431bde83) >> 50);
+  u32 microseconds = nanoseconds - milliseconds * 1000000;
+  u32 microsecondsOnly = (u32)(((u64)microseconds * 0x10624dd3) >> 38);
+
+  u32 values[] = {
+      weeks,
+      days - weeks * 7,
+      hours - days * 24,
+      totalMinutes - hours * 60,
+      (u32)(seconds - minutes * 60),
+      milliseconds,
+      microsecondsOnly,
+      microseconds - microsecondsOnly * 1000,
+  };
+  // padded to 4 bytes so each is copied with one store
+  comptime u8 units[][4] = {"wk", "day", "hr", "min", "sec", "ms", "us", "ns"};
+  comptime u8 unitLengths[] = {2, 3, 2, 3, 3, 2, 2, 2};
+
+  // units before largest one that is not zero are not visited
+  u32 first = 7 - (u32)(ns >= 1000) - (u32)(ns >= 1000000) - (u32)(ns >= 1000000000) - (u32)(minutes != 0) -
+              (u32)(hours != 0) - (u32)(days != 0) - (u32)(weeks != 0);
+  u64 position = 0;
+  if (first == 0) {
+    position = DurationWriteDigits(out, weeks);
+    out[position++] = 'w';
+    out[position++] = 'k';
+    first = 1;
+  }
+  for (u32 index = first; index < ARRAY_COUNT(values); index++) {
+    // all below 1000
+    u64 count = DurationWriteSmall(out + position, values[index]);
+    MemoryCopy(out + position + count, (u8 *)units[index], 4);
+    // unit is kept only when it is not zero
+    position += (count + unitLengths[index]) & -(u64)(values[index] != 0);
+  }
+
+  result.value = out;
+  result.length = position;
+  return result;
+}
+
+/*
+ * Formats duration in largest unit that fits with fixed count of fraction
+ * digits, e.g. "1.234ms", "12.500us", "3.000sec". Below one microsecond
+ * it is whole nanoseconds, e.g. "850ns". Fraction is truncated, not
+ * rounded.
+ *
+ * @param buffer must hold at least 48 bytes
+ * @param fractionCount digits after '.', at most 9, 0 writes no '.'
+ * @return string in buffer, null when buffer is too small
+ */
+static inline struct string
+FormatDurationFixed(struct string *buffer, struct duration *duration, u32 fractionCount)
+{
+  struct string result = StringNull();
+  debug_assert(fractionCount <= 9);
+  if (!buffer || buffer->length < 48)
+    return result;
+  u8 *out = buffer->value;
+
+  u64 ns = duration->ns;
+  u64 integer;
+  // fraction as 9 digits
+  u32 fraction;
+  struct string unit;
+  if (ns < 1000) {
+    u64 position = DurationWriteSmall(out, (u32)ns);
+    out[position++] = 'n';
+    out[position++] = 's';
+    result.value = out;
+    result.length = position;
+    return result;
+  } else if (ns < 1000000) {
+    integer = ((u64)(u32)ns * 0x10624dd3) >> 38;
+    fraction = ((u32)ns - (u32)integer * 1000) * 1000000;
+    unit = StringFromLiteral("us");
+  } else if (ns < 1000000000) {
+    integer = ((u64)(u32)ns * 0x431bde83) >> 50;
+    fraction = ((u32)ns - (u32)integer * 1000000) * 1000;
+    unit = StringFromLiteral("ms");
+  } else {
+    integer = ns / 1000000000;
+    fraction = (u32)(ns - integer * 1000000000);
+    unit = StringFromLiteral("sec");
+  }
+
+  u64 position = DurationWriteDigits(out, integer);
+  if (fractionCount != 0) {
+    out[position++] = '.';
+    u32 millions = (u32)(((u64)fraction * 0x431bde83) >> 50);
+    u32 rest = fraction - millions * 1000000;
+    u32 thousands = (u32)(((u64)rest * 0x10624dd3) >> 38);
+    DurationWritePadded(out + position, millions);
+    DurationWritePadded(out + position + 3, thousands);
+    DurationWritePadded(out + position + 6, rest - thousands * 1000);
+    position += fractionCount;
+  }
+  MemoryCopy(out + position, unit.value, unit.length);
+  position += unit.length;
+
+  result.value = out;
+  result.length = position;
+  return result;
+}
+
 static inline b8
 IsDurationLessThan(struct duration *left, struct duration *right)
 {
@@ -524,6 +862,266 @@ IsDurationEqual(struct duration *left, struct duration *right)
   return left->ns == right->ns;
 }
 
+/*
+ * Point in time as nanoseconds since 1970-01-01T00:00:00Z, leap seconds are
+ * not counted. Range is 1677-09-21 to 2262-04-11.
+ */
+struct timestamp {
+  s64 ns;
+};
+
+/*
+ * Days since 1970-01-01 of date in proleptic Gregorian calendar.
+ * Comparisons are turned into arithmetic, so there are no branches.
+ * src: http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+ *
+ * @param year 0 to 9999
+ * @param month 1 to 12
+ * @param day 1 to 31
+ */
+static inline s64
+DaysFromCivil(u32 year, u32 month, u32 day)
+{
+  // year starts at March, so leap day is last day of it
+  u32 isJanuaryOrFebruary = month <= 2;
+  // 400 years are added to keep year positive, they are 146097 days
+  u32 shiftedYear = year + 400 - isJanuaryOrFebruary;
+  u32 era = shiftedYear / 400;
+  u32 yearOfEra = shiftedYear - era * 400;
+  // March is 0, February is 11
+  u32 shiftedMonth = month + 12 * isJanuaryOrFebruary - 3;
+  u32 dayOfYear = (153 * shiftedMonth + 2) / 5 + day - 1;
+  u32 dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return (s64)era * 146097 + (s64)dayOfEra - 719468 - 146097;
+}
+
+/*
+ * Inverse of DaysFromCivil().
+ * src: http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+ *
+ * @param days since 1970-01-01, at least -719468 which is 0000-03-01
+ */
+static inline void
+CivilFromDays(s64 days, u32 *year, u32 *month, u32 *day)
+{
+  debug_assert(days >= -719468);
+  u64 daysSinceStart = (u64)(days + 719468);
+  u32 era = (u32)(daysSinceStart / 146097);
+  u32 dayOfEra = (u32)(daysSinceStart - (u64)era * 146097);
+  u32 yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+  u32 dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  u32 shiftedMonth = (5 * dayOfYear + 2) / 153;
+  u32 isJanuaryOrFebruary = shiftedMonth >= 10;
+  *day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+  *month = shiftedMonth + 3 - 12 * isJanuaryOrFebruary;
+  *year = era * 400 + yearOfEra + isJanuaryOrFebruary;
+}
+
+/*
+ * Checks that every byte of chunk at digit positions is '0' to '9' and
+ * every other byte is same as template.
+ * @param template '0' at digit positions
+ * @param digitMask 0xff at digit positions
+ * @param ignoreMask 0xff at positions that are checked by caller
+ * @return digits at digit positions, other bytes 0. U64_MAX when chunk
+ *         does not match template.
+ */
+static inline u64
+TimestampMatchDigits(u64 chunk, u64 template, u64 digitMask, u64 ignoreMask)
+{
+  u64 highNibbles = 0xf0f0f0f0f0f0f0f0 & digitMask;
+  u64 checkMask = (highNibbles | ~digitMask) & ~ignoreMask;
+  // high nibble of digit is 3, it stays 3 when 6 is added only for '0' to '9'
+  b8 isMatching = ((chunk & checkMask) == (template & checkMask)) &
+                  (((chunk + (0x0606060606060606 & digitMask)) & highNibbles) == (0x3030303030303030 & digitMask));
+  return isMatching ? (chunk & 0x0f0f0f0f0f0f0f0f & digitMask) : U64_MAX;
+}
+
+/*
+ * Parses RFC 3339 timestamp, e.g. "2024-03-09T14:05:59.123456789Z" or
+ * "2024-03-09 16:05:59+02:00". 'T' may also be 't' or space, 'Z' may be
+ * 'z'. Fraction of second may have 1 to 9 digits, more are truncated.
+ * Second may be 60 for leap second, it is counted as first second of next
+ * minute.
+ * Date and time are checked 8 bytes at a time, digits are combined with
+ * multiplications instead of loop.
+ *
+ * @return 1 when string is timestamp in range of struct timestamp
+ *
+ * @code
+ *   struct timestamp timestamp;
+ *   if (ParseTimestamp(&StringFromLiteral("1970-01-01T00:00:01.5Z"), &timestamp)) {
+ *     // timestamp.ns == 1500000000
+ *   }
+ * @endcode
+ */
+static inline b8
+ParseTimestamp(struct string *string, struct timestamp *timestamp)
+{
+  // "YYYY-MM-DDTHH:MM:SSZ"
+  if (!string || IsStringNull(string) || string->length < 20)
+    return 0;
+  u8 *bytes = string->value;
+
+  // "YYYY-MM-", byte 0 is first
+  u64 date;
+  MemoryCopy(&date, bytes, sizeof(date));
+  date = TimestampMatchDigits(date, 0x2d30302d30303030, 0x00ffff00ffffffff, 0);
+  // "DDTHH:MM", 'T' is checked below
+  u64 time;
+  MemoryCopy(&time, bytes + 8, sizeof(time));
+  time = TimestampMatchDigits(time, 0x30303a3030003030, 0xffff00ffff00ffff, 0x0000000000ff0000);
+  u8 separator = bytes[10] | 0x20;
+  if (date == U64_MAX || time == U64_MAX || (separator != 't' && separator != ' ') || bytes[16] != ':' ||
+      (u8)(bytes[17] - '0') > 9 || (u8)(bytes[18] - '0') > 9)
+    return 0;
+
+  // tens and ones of each pair are combined, byte 0 holds first pair
+  date = date * 10 + (date >> 8);
+  time = time * 10 + (time >> 8);
+  u32 year = (u32)(date & 0xff) * 100 + (u32)((date >> 16) & 0xff);
+  u32 month = (u32)((date >> 40) & 0xff);
+  u32 day = (u32)(time & 0xff);
+  u32 hour = (u32)((time >> 24) & 0xff);
+  u32 minute = (u32)((time >> 48) & 0xff);
+  u32 second = (u32)(bytes[17] - '0') * 10 + (u32)(bytes[18] - '0');
+
+  comptime u8 daysInMonth[] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  u32 isLeapYear = ((year % 4 == 0) & (year % 100 != 0)) | (year % 400 == 0);
+  u32 monthIndex = month <= 12 ? month : 0;
+  u32 dayCount = daysInMonth[monthIndex] + (u32)(isLeapYear & (month == 2));
+  if ((month - 1 > 11) | (day - 1 >= dayCount) | (hour > 23) | (minute > 59) | (second > 60))
+    return 0;
+
+  u64 position = 19;
+  u64 fraction = 0;
+  if (bytes[position] == '.') {
+    position++;
+    u64 digitCount = 0;
+    if (string->length - position >= 8) {
+      u64 chunk;
+      MemoryCopy(&chunk, bytes + position, sizeof(chunk));
+      // bytes that are not digits, carry only goes to later bytes
+      u64 nonDigits = ((chunk & 0xf0f0f0f0f0f0f0f0) ^ 0x3030303030303030) |
+                      (((chunk + 0x0606060606060606) & 0xf0f0f0f0f0f0f0f0) ^ 0x3030303030303030);
+      digitCount = nonDigits ? (u64)__builtin_ctzll(nonDigits) / 8 : 8;
+      if (digitCount != 0) {
+        // leading digits are moved to end, zeros before them do not change value
+        u64 digits = (chunk & 0x0f0f0f0f0f0f0f0f) << (64 - digitCount * 8);
+        digits = (digits * 10 + (digits >> 8)) & 0x00ff00ff00ff00ff;
+        digits = (digits * 100 + (digits >> 16)) & 0x0000ffff0000ffff;
+        fraction = (digits * 10000 + (digits >> 32)) & 0xffffffff;
+      }
+    }
+    // rest of digits
+    u64 end = position + digitCount;
+    for (; end < string->length && (u8)(bytes[end] - '0') <= 9; end++) {
+      if (end - position < 9)
+        fraction = fraction * 10 + (u64)(bytes[end] - '0');
+    }
+    u64 fractionDigitCount = end - position;
+    if (fractionDigitCount == 0)
+      return 0;
+    comptime u32 scales[] = {1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1};
+    fraction *= scales[fractionDigitCount < 9 ? fractionDigitCount : 9];
+    position = end;
+  }
+
+  s64 offset = 0;
+  if (position < string->length && (bytes[position] | 0x20) == 'z') {
+    position++;
+  } else if (string->length - position >= 6 && (bytes[position] == '+' || bytes[position] == '-') &&
+             bytes[position + 3] == ':') {
+    u8 *zone = bytes + position;
+    u8 digits[] = {(u8)(zone[1] - '0'), (u8)(zone[2] - '0'), (u8)(zone[4] - '0'), (u8)(zone[5] - '0')};
+    if (digits[0] > 9 || digits[1] > 9 || digits[2] > 9 || digits[3] > 9)
+      return 0;
+    u32 offsetHour = (u32)digits[0] * 10 + digits[1];
+    u32 offsetMinute = (u32)digits[2] * 10 + digits[3];
+    if (offsetHour > 23 || offsetMinute > 59)
+      return 0;
+    offset = (s64)(offsetHour * 3600 + offsetMinute * 60);
+    if (zone[0] == '-')
+      offset = -offset;
+    position += 6;
+  } else {
+    return 0;
+  }
+  if (position != string->length)
+    return 0;
+
+  s64 seconds = DaysFromCivil(year, month, day) * 86400 + (s64)(hour * 3600 + minute * 60 + second) - offset;
+  // S64_MAX is 9223372036.854775807 seconds
+  if (seconds < -9223372036 || seconds > 9223372035)
+    return 0;
+
+  timestamp->ns = seconds * 1000000000 + (s64)fraction;
+  return 1;
+}
+
+/*
+ * Formats timestamp as RFC 3339 in UTC, e.g. "2024-03-09T14:05:59.123Z".
+ * Fraction of second is truncated, not rounded.
+ * @param buffer must hold at least 30 bytes when fractionCount is 9
+ * @param fractionCount digits after '.', at most 9, 0 writes no '.'
+ * @return string in buffer, null when buffer is too small
+ */
+static inline struct string
+FormatTimestamp(struct string *buffer, struct timestamp *timestamp, u32 fractionCount)
+{
+  struct string result = StringNull();
+  debug_assert(fractionCount <= 9);
+  u64 length = 20 + (u64)(fractionCount != 0) + fractionCount;
+  if (!buffer || buffer->length < length)
+    return result;
+
+  // floor division, so that time of day is positive before 1970
+  s64 seconds = timestamp->ns / 1000000000;
+  s64 nanoseconds = timestamp->ns - seconds * 1000000000;
+  seconds -= nanoseconds < 0;
+  nanoseconds += 1000000000 * (nanoseconds < 0);
+  s64 days = seconds / 86400;
+  s64 secondOfDay = seconds - days * 86400;
+  days -= secondOfDay < 0;
+  secondOfDay += 86400 * (secondOfDay < 0);
+
+  u32 year, month, day;
+  CivilFromDays(days, &year, &month, &day);
+  u32 hour = (u32)secondOfDay / 3600;
+  u32 minute = (u32)secondOfDay / 60 % 60;
+  u32 second = (u32)secondOfDay % 60;
+
+  u8 *out = buffer->value;
+  u32 pairs[] = {year / 100, year % 100, month, day, hour, minute, second};
+  u8 *pairOut[] = {out, out + 2, out + 5, out + 8, out + 11, out + 14, out + 17};
+  for (u32 index = 0; index < ARRAY_COUNT(pairs); index++) {
+    pairOut[index][0] = (u8)('0' + pairs[index] / 10);
+    pairOut[index][1] = (u8)('0' + pairs[index] % 10);
+  }
+  out[4] = '-';
+  out[7] = '-';
+  out[10] = 'T';
+  out[13] = ':';
+  out[16] = ':';
+
+  u64 position = 19;
+  if (fractionCount != 0) {
+    out[position++] = '.';
+    u32 fraction = (u32)nanoseconds;
+    for (u32 digitIndex = 9; digitIndex > 0; digitIndex--) {
+      if (digitIndex <= fractionCount)
+        out[position + digitIndex - 1] = (u8)('0' + fraction % 10);
+      fraction /= 10;
+    }
+    position += fractionCount;
+  }
+  out[position++] = 'Z';
+
+  result.value = out;
+  result.length = position;
+  return result;
+}
+
 static inline b8
 ParseU64(struct string *string, u64 *value)
 {
@@ -566,48 +1164,844 @@ ParseU64(struct string *string, u64 *value)
 }
 
 /*
- * Format u64 into string buffer
- * string buffer must at least able to hold 1 bytes, at most 20 bytes.
+ * Unsigned integer large enough to hold every decimal that ParseF64() compares
+ * exactly, limbs are little endian.
  */
-static inline struct string
-FormatU64(struct string *stringBuffer, u64 value)
+struct big_uint {
+  u32 limbs[128];
+  u32 count;
+};
+
+static inline void
+BigUintMultiplyAdd(struct big_uint *big, u32 factor, u32 addend)
 {
-  // max 18446744073709551615
-  struct string result = StringNull();
-  if (!stringBuffer || stringBuffer->length == 0)
-    return result;
+  u64 carry = addend;
+  for (u32 index = 0; index < big->count; index++) {
+    u64 product = (u64)big->limbs[index] * factor + carry;
+    big->limbs[index] = (u32)product;
+    carry = product >> 32;
+  }
+  if (carry != 0) {
+    debug_assert(big->count < ARRAY_COUNT(big->limbs));
+    big->limbs[big->count++] = (u32)carry;
+  }
+}
 
-  u64 powersOf10[] = {
-      1ull,                    // 10^0
-      10ull,                   // 10^1
-      100ull,                  // 10^2
-      1000ull,                 // 10^3
-      10000ull,                // 10^4
-      100000ull,               // 10^5
-      1000000ull,              // 10^6
-      10000000ull,             // 10^7
-      100000000ull,            // 10^8
-      1000000000ull,           // 10^9
-      10000000000ull,          // 10^10
-      100000000000ull,         // 10^11
-      1000000000000ull,        // 10^12
-      10000000000000ull,       // 10^13
-      100000000000000ull,      // 10^14
-      1000000000000000ull,     // 10^15
-      10000000000000000ull,    // 10^16
-      100000000000000000ull,   // 10^17
-      1000000000000000000ull,  // 10^18
-      10000000000000000000ull, // 10^19
-  };
+static inline void
+BigUintMultiplyPow5(struct big_uint *big, u32 power)
+{
+  // 5^13 is largest power that fits in u32
+  for (; power >= 13; power -= 13)
+    BigUintMultiplyAdd(big, 1220703125, 0);
+  u32 factor = 1;
+  for (; power > 0; power--)
+    factor *= 5;
+  if (factor != 1)
+    BigUintMultiplyAdd(big, factor, 0);
+}
 
-  u64 countOfDigits = 1;
-  while (countOfDigits < ARRAY_COUNT(powersOf10) && value >= powersOf10[countOfDigits])
-    countOfDigits++;
+static inline void
+BigUintShiftLeft(struct big_uint *big, u32 shift)
+{
+  if (big->count == 0)
+    return;
+
+  u32 limbShift = shift / 32;
+  u32 bitShift = shift % 32;
+  debug_assert(big->count + limbShift + 1 <= ARRAY_COUNT(big->limbs));
+  big->limbs[big->count] = 0;
+  for (u32 index = big->count + 1; index > 0; index--) {
+    u32 limb = big->limbs[index - 1];
+    u32 lower = index >= 2 && bitShift != 0 ? big->limbs[index - 2] >> (32 - bitShift) : 0;
+    big->limbs[index - 1 + limbShift] = (limb << bitShift) | lower;
+  }
+  for (u32 index = 0; index < limbShift; index++)
+    big->limbs[index] = 0;
+  big->count += limbShift + 1;
+  while (big->count > 0 && big->limbs[big->count - 1] == 0)
+    big->count--;
+}
 
-  if (countOfDigits > stringBuffer->length)
-    return result;
+/*
+ * @return -1, 0 or 1 when left is less, equal or greater than right
+ */
+static inline s32
+BigUintCompare(struct big_uint *left, struct big_uint *right)
+{
+  if (left->count != right->count)
+    return left->count < right->count ? -1 : 1;
+  for (u32 index = left->count; index > 0; index--) {
+    u32 leftLimb = left->limbs[index - 1];
+    u32 rightLimb = right->limbs[index - 1];
+    if (leftLimb != rightLimb)
+      return leftLimb < rightLimb ? -1 : 1;
+  }
+  return 0;
+}
 
-  u64 index = 0;
+/*
+ * Decimal digits of ParseF64() input, value is digits * 10^exponent.
+ */
+struct f64_decimal {
+  s64 exponent;
+  // count of digits from first non-zero one
+  s32 digitCount;
+  struct big_uint digits;
+};
+
+/*
+ * Halfway points between doubles have at most 767 significant digits, digits
+ * after this many only matter when they are not all zero.
+ */
+#define F64_DECIMAL_DIGIT_MAX 800
+
+static inline void
+F64DecimalFrom(struct f64_decimal *decimal, u8 *integer, u64 integerLength, u8 *fraction, u64 fractionLength,
+               s64 exponent)
+{
+  struct big_uint *digits = &decimal->digits;
+  digits->count = 0;
+  s32 digitCount = 0;
+  b8 isTruncated = 0;
+  // digits are collected 9 at a time, 10^9 fits in u32
+  u32 chunk = 0;
+  u32 chunkFactor = 1;
+
+  u8 *spans[] = {integer, fraction};
+  u64 spanLengths[] = {integerLength, fractionLength};
+  for (u32 spanIndex = 0; spanIndex < ARRAY_COUNT(spans); spanIndex++) {
+    b8 isFraction = spanIndex == 1;
+    for (u64 index = 0; index < spanLengths[spanIndex]; index++) {
+      u8 digit = (u8)(spans[spanIndex][index] - '0');
+      if (digitCount == F64_DECIMAL_DIGIT_MAX) {
+        isTruncated |= digit != 0;
+        exponent += !isFraction;
+        continue;
+      }
+
+      exponent -= isFraction;
+      if (digitCount == 0 && digit == 0)
+        continue;
+      digitCount++;
+      chunk = chunk * 10 + digit;
+      chunkFactor *= 10;
+      if (chunkFactor == 1000000000) {
+        BigUintMultiplyAdd(digits, chunkFactor, chunk);
+        chunk = 0;
+        chunkFactor = 1;
+      }
+    }
+  }
+
+  // any digit after last one that is kept moves value off halfway point
+  if (isTruncated) {
+    chunk = chunk * 10 + 1;
+    chunkFactor *= 10;
+    exponent--;
+    digitCount++;
+  }
+  if (chunkFactor != 1)
+    BigUintMultiplyAdd(digits, chunkFactor, chunk);
+
+  decimal->exponent = exponent;
+  decimal->digitCount = digitCount;
+}
+
+/*
+ * Compares decimal with mantissa * 2^binaryExponent exactly.
+ * @return -1, 0 or 1 when decimal is less, equal or greater
+ */
+static inline s32
+F64DecimalCompare(struct f64_decimal *decimal, u64 mantissa, s64 binaryExponent)
+{
+  struct big_uint left = decimal->digits;
+  struct big_uint right = {.limbs = {(u32)mantissa, (u32)(mantissa >> 32)}, .count = 2};
+  while (right.count > 0 && right.limbs[right.count - 1] == 0)
+    right.count--;
+
+  // digits * 5^e * 2^e against mantissa * 2^b
+  s64 exponent = decimal->exponent;
+  if (exponent >= 0)
+    BigUintMultiplyPow5(&left, (u32)exponent);
+  else
+    BigUintMultiplyPow5(&right, (u32)-exponent);
+
+  s64 shift = exponent - binaryExponent;
+  if (shift >= 0)
+    BigUintShiftLeft(&left, (u32)shift);
+  else
+    BigUintShiftLeft(&right, (u32)-shift);
+
+  return BigUintCompare(&left, &right);
+}
+
+/*
+ * Point halfway between adjacent non-negative doubles lower and upper, as
+ * mantissa * 2^binaryExponent. Upper can be infinity, which is taken as 2^1024.
+ */
+static inline void
+F64Halfway(f64 lower, f64 upper, u64 *mantissa, s64 *binaryExponent)
+{
+  f64 values[] = {lower, upper};
+  u64 mantissas[2];
+  s64 exponents[2];
+  for (u32 index = 0; index < ARRAY_COUNT(values); index++) {
+    u64 bits;
+    MemoryCopy(&bits, values + index, sizeof(bits));
+    u64 biasedExponent = bits >> 52;
+    mantissas[index] = bits & (((u64)1 << 52) - 1);
+    exponents[index] = -1074;
+    if (biasedExponent != 0) {
+      mantissas[index] |= (u64)1 << 52;
+      exponents[index] = (s64)biasedExponent - 1075;
+    }
+  }
+
+  // exponents differ at most by 1
+  s64 exponent = exponents[0] < exponents[1] ? exponents[0] : exponents[1];
+  *mantissa = (mantissas[0] << (exponents[0] - exponent)) + (mantissas[1] << (exponents[1] - exponent));
+  *binaryExponent = exponent - 1;
+}
+
+static inline f64
+F64FromBits(u64 bits)
+{
+  f64 value;
+  MemoryCopy(&value, &bits, sizeof(value));
+  return value;
+}
+
+static inline u64
+F64ToBits(f64 value)
+{
+  u64 bits;
+  MemoryCopy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+/*
+ * 5^q for q in [-342, 308], normalized so that highest bit is set, as 128-bit
+ * high, low pairs. Truncated for positive q, rounded up for negative q.
+ * @see F64FromDecimalEiselLemire()
+ */
+comptime u64 F64_POWERS_OF_5[][2] = {
+    {0xeef453d6923bd65a, 0x113faa2906a13b3f}, {0x9558b4661b6565f8, 0x4ac7ca59a424c507},
+    {0xbaaee17fa23ebf76, 0x5d79bcf00d2df649}, {0xe95a99df8ace6f53, 0xf4d82c2c107973dc},
+    {0x91d8a02bb6c10594, 0x79071b9b8a4be869}, {0xb64ec836a47146f9, 0x9748e2826cdee284},
+    {0xe3e27a444d8d98b7, 0xfd1b1b2308169b25}, {0x8e6d8c6ab0787f72, 0xfe30f0f5e50e20f7},
+    {0xb208ef855c969f4f, 0xbdbd2d335e51a935}, {0xde8b2b66b3bc4723, 0xad2c788035e61382},
+    {0x8b16fb203055ac76, 0x4c3bcb5021afcc31}, {0xaddcb9e83c6b1793, 0xdf4abe242a1bbf3d},
+    {0xd953e8624b85dd78, 0xd71d6dad34a2af0d}, {0x87d4713d6f33aa6b, 0x8672648c40e5ad68},
+    {0xa9c98d8ccb009506, 0x680efdaf511f18c2}, {0xd43bf0effdc0ba48, 0x0212bd1b2566def2},
+    {0x84a57695fe98746d, 0x014bb630f7604b57}, {0xa5ced43b7e3e9188, 0x419ea3bd35385e2d},
+    {0xcf42894a5dce35ea, 0x52064cac828675b9}, {0x818995ce7aa0e1b2, 0x7343efebd1940993},
+    {0xa1ebfb4219491a1f, 0x1014ebe6c5f90bf8}, {0xca66fa129f9b60a6, 0xd41a26e077774ef6},
+    {0xfd00b897478238d0, 0x8920b098955522b4}, {0x9e20735e8cb16382, 0x55b46e5f5d5535b0},
+    {0xc5a890362fddbc62, 0xeb2189f734aa831d}, {0xf712b443bbd52b7b, 0xa5e9ec7501d523e4},
+    {0x9a6bb0aa55653b2d, 0x47b233c92125366e}, {0xc1069cd4eabe89f8, 0x999ec0bb696e840a},
+    {0xf148440a256e2c76, 0xc00670ea43ca250d}, {0x96cd2a865764dbca, 0x380406926a5e5728},
+    {0xbc807527ed3e12bc, 0xc605083704f5ecf2}, {0xeba09271e88d976b, 0xf7864a44c633682e},
+    {0x93445b8731587ea3, 0x7ab3ee6afbe0211d}, {0xb8157268fdae9e4c, 0x5960ea05bad82964},
+    {0xe61acf033d1a45df, 0x6fb92487298e33bd}, {0x8fd0c16206306bab, 0xa5d3b6d479f8e056},
+    {0xb3c4f1ba87bc8696, 0x8f48a4899877186c}, {0xe0b62e2929aba83c, 0x331acdabfe94de87},
+    {0x8c71dcd9ba0b4925, 0x9ff0c08b7f1d0b14}, {0xaf8e5410288e1b6f, 0x07ecf0ae5ee44dd9},
+    {0xdb71e91432b1a24a, 0xc9e82cd9f69d6150}, {0x892731ac9faf056e, 0xbe311c083a225cd2},
+    {0xab70fe17c79ac6ca, 0x6dbd630a48aaf406}, {0xd64d3d9db981787d, 0x092cbbccdad5b108},
+    {0x85f0468293f0eb4e, 0x25bbf56008c58ea5}, {0xa76c582338ed2621, 0xaf2af2b80af6f24e},
+    {0xd1476e2c07286faa, 0x1af5af660db4aee1}, {0x82cca4db847945ca, 0x50d98d9fc890ed4d},
+    {0xa37fce126597973c, 0xe50ff107bab528a0}, {0xcc5fc196fefd7d0c, 0x1e53ed49a96272c8},
+    {0xff77b1fcbebcdc4f, 0x25e8e89c13bb0f7a}, {0x9faacf3df73609b1, 0x77b191618c54e9ac},
+    {0xc795830d75038c1d, 0xd59df5b9ef6a2417}, {0xf97ae3d0d2446f25, 0x4b0573286b44ad1d},
+    {0x9becce62836ac577, 0x4ee367f9430aec32}, {0xc2e801fb244576d5, 0x229c41f793cda73f},
+    {0xf3a20279ed56d48a, 0x6b43527578c1110f}, {0x9845418c345644d6, 0x830a13896b78aaa9},
+    {0xbe5691ef416bd60c, 0x23cc986bc656d553}, {0xedec366b11c6cb8f, 0x2cbfbe86b7ec8aa8},
+    {0x94b3a202eb1c3f39, 0x7bf7d71432f3d6a9}, {0xb9e08a83a5e34f07, 0xdaf5ccd93fb0cc53},
+    {0xe858ad248f5c22c9, 0xd1b3400f8f9cff68}, {0x91376c36d99995be, 0x23100809b9c21fa1},
+    {0xb58547448ffffb2d, 0xabd40a0c2832a78a}, {0xe2e69915b3fff9f9, 0x16c90c8f323f516c},
+    {0x8dd01fad907ffc3b, 0xae3da7d97f6792e3}, {0xb1442798f49ffb4a, 0x99cd11cfdf41779c},
+    {0xdd95317f31c7fa1d, 0x40405643d711d583}, {0x8a7d3eef7f1cfc52, 0x482835ea666b2572},
+    {0xad1c8eab5ee43b66, 0xda3243650005eecf}, {0xd863b256369d4a40, 0x90bed43e40076a82},
+    {0x873e4f75e2224e68, 0x5a7744a6e804a291}, {0xa90de3535aaae202, 0x711515d0a205cb36},
+    {0xd3515c2831559a83, 0x0d5a5b44ca873e03}, {0x8412d9991ed58091, 0xe858790afe9486c2},
+    {0xa5178fff668ae0b6, 0x626e974dbe39a872}, {0xce5d73ff402d98e3, 0xfb0a3d212dc8128f},
+    {0x80fa687f881c7f8e, 0x7ce66634bc9d0b99}, {0xa139029f6a239f72, 0x1c1fffc1ebc44e80},
+    {0xc987434744ac874e, 0xa327ffb266b56220}, {0xfbe9141915d7a922, 0x4bf1ff9f0062baa8},
+    {0x9d71ac8fada6c9b5, 0x6f773fc3603db4a9}, {0xc4ce17b399107c22, 0xcb550fb4384d21d3},
+    {0xf6019da07f549b2b, 0x7e2a53a146606a48}, {0x99c102844f94e0fb, 0x2eda7444cbfc426d},
+    {0xc0314325637a1939, 0xfa911155fefb5308}, {0xf03d93eebc589f88, 0x793555ab7eba27ca},
+    {0x96267c7535b763b5, 0x4bc1558b2f3458de}, {0xbbb01b9283253ca2, 0x9eb1aaedfb016f16},
+    {0xea9c227723ee8bcb, 0x465e15a979c1cadc}, {0x92a1958a7675175f, 0x0bfacd89ec191ec9},
+    {0xb749faed14125d36, 0xcef980ec671f667b}, {0xe51c79a85916f484, 0x82b7e12780e7401a},
+    {0x8f31cc0937ae58d2, 0xd1b2ecb8b0908810}, {0xb2fe3f0b8599ef07, 0x861fa7e6dcb4aa15},
+    {0xdfbdcece67006ac9, 0x67a791e093e1d49a}, {0x8bd6a141006042bd, 0xe0c8bb2c5c6d24e0},
+    {0xaecc49914078536d, 0x58fae9f773886e18}, {0xda7f5bf590966848, 0xaf39a475506a899e},
+    {0x888f99797a5e012d, 0x6d8406c952429603}, {0xaab37fd7d8f58178, 0xc8e5087ba6d33b83},
+    {0xd5605fcdcf32e1d6, 0xfb1e4a9a90880a64}, {0x855c3be0a17fcd26, 0x5cf2eea09a55067f},
+    {0xa6b34ad8c9dfc06f, 0xf42faa48c0ea481e}, {0xd0601d8efc57b08b, 0xf13b94daf124da26},
+    {0x823c12795db6ce57, 0x76c53d08d6b70858}, {0xa2cb1717b52481ed, 0x54768c4b0c64ca6e},
+    {0xcb7ddcdda26da268, 0xa9942f5dcf7dfd09}, {0xfe5d54150b090b02, 0xd3f93b35435d7c4c},
+    {0x9efa548d26e5a6e1, 0xc47bc5014a1a6daf}, {0xc6b8e9b0709f109a, 0x359ab6419ca1091b},
+    {0xf867241c8cc6d4c0, 0xc30163d203c94b62}, {0x9b407691d7fc44f8, 0x79e0de63425dcf1d},
+    {0xc21094364dfb5636, 0x985915fc12f542e4}, {0xf294b943e17a2bc4, 0x3e6f5b7b17b2939d},
+    {0x979cf3ca6cec5b5a, 0xa705992ceecf9c42}, {0xbd8430bd08277231, 0x50c6ff782a838353},
+    {0xece53cec4a314ebd, 0xa4f8bf5635246428}, {0x940f4613ae5ed136, 0x871b7795e136be99},
+    {0xb913179899f68584, 0x28e2557b59846e3f}, {0xe757dd7ec07426e5, 0x331aeada2fe589cf},
+    {0x9096ea6f3848984f, 0x3ff0d2c85def7621}, {0xb4bca50b065abe63, 0x0fed077a756b53a9},
+    {0xe1ebce4dc7f16dfb, 0xd3e8495912c62894}, {0x8d3360f09cf6e4bd, 0x64712dd7abbbd95c},
+    {0xb080392cc4349dec, 0xbd8d794d96aacfb3}, {0xdca04777f541c567, 0xecf0d7a0fc5583a0},
+    {0x89e42caaf9491b60, 0xf41686c49db57244}, {0xac5d37d5b79b6239, 0x311c2875c522ced5},
+    {0xd77485cb25823ac7, 0x7d633293366b828b}, {0x86a8d39ef77164bc, 0xae5dff9c02033197},
+    {0xa8530886b54dbdeb, 0xd9f57f830283fdfc}, {0xd267caa862a12d66, 0xd072df63c324fd7b},
+    {0x8380dea93da4bc60, 0x4247cb9e59f71e6d}, {0xa46116538d0deb78, 0x52d9be85f074e608},
+    {0xcd795be870516656, 0x67902e276c921f8b}, {0x806bd9714632dff6, 0x00ba1cd8a3db53b6},
+    {0xa086cfcd97bf97f3, 0x80e8a40eccd228a4}, {0xc8a883c0fdaf7df0, 0x6122cd128006b2cd},
+    {0xfad2a4b13d1b5d6c, 0x796b805720085f81}, {0x9cc3a6eec6311a63, 0xcbe3303674053bb0},
+    {0xc3f490aa77bd60fc, 0xbedbfc4411068a9c}, {0xf4f1b4d515acb93b, 0xee92fb5515482d44},
+    {0x991711052d8bf3c5, 0x751bdd152d4d1c4a}, {0xbf5cd54678eef0b6, 0xd262d45a78a0635d},
+    {0xef340a98172aace4, 0x86fb897116c87c34}, {0x9580869f0e7aac0e, 0xd45d35e6ae3d4da0},
+    {0xbae0a846d2195712, 0x8974836059cca109}, {0xe998d258869facd7, 0x2bd1a438703fc94b},
+    {0x91ff83775423cc06, 0x7b6306a34627ddcf}, {0xb67f6455292cbf08, 0x1a3bc84c17b1d542},
+    {0xe41f3d6a7377eeca, 0x20caba5f1d9e4a93}, {0x8e938662882af53e, 0x547eb47b7282ee9c},
+    {0xb23867fb2a35b28d, 0xe99e619a4f23aa43}, {0xdec681f9f4c31f31, 0x6405fa00e2ec94d4},
+    {0x8b3c113c38f9f37e, 0xde83bc408dd3dd04}, {0xae0b158b4738705e, 0x9624ab50b148d445},
+    {0xd98ddaee19068c76, 0x3badd624dd9b0957}, {0x87f8a8d4cfa417c9, 0xe54ca5d70a80e5d6},
+    {0xa9f6d30a038d1dbc, 0x5e9fcf4ccd211f4c}, {0xd47487cc8470652b, 0x7647c3200069671f},
+    {0x84c8d4dfd2c63f3b, 0x29ecd9f40041e073}, {0xa5fb0a17c777cf09, 0xf468107100525890},
+    {0xcf79cc9db955c2cc, 0x7182148d4066eeb4}, {0x81ac1fe293d599bf, 0xc6f14cd848405530},
+    {0xa21727db38cb002f, 0xb8ada00e5a506a7c}, {0xca9cf1d206fdc03b, 0xa6d90811f0e4851c},
+    {0xfd442e4688bd304a, 0x908f4a166d1da663}, {0x9e4a9cec15763e2e, 0x9a598e4e043287fe},
+    {0xc5dd44271ad3cdba, 0x40eff1e1853f29fd}, {0xf7549530e188c128, 0xd12bee59e68ef47c},
+    {0x9a94dd3e8cf578b9, 0x82bb74f8301958ce}, {0xc13a148e3032d6e7, 0xe36a52363c1faf01},
+    {0xf18899b1bc3f8ca1, 0xdc44e6c3cb279ac1}, {0x96f5600f15a7b7e5, 0x29ab103a5ef8c0b9},
+    {0xbcb2b812db11a5de, 0x7415d448f6b6f0e7}, {0xebdf661791d60f56, 0x111b495b3464ad21},
+    {0x936b9fcebb25c995, 0xcab10dd900beec34}, {0xb84687c269ef3bfb, 0x3d5d514f40eea742},
+    {0xe65829b3046b0afa, 0x0cb4a5a3112a5112}, {0x8ff71a0fe2c2e6dc, 0x47f0e785eaba72ab},
+    {0xb3f4e093db73a093, 0x59ed216765690f56}, {0xe0f218b8d25088b8, 0x306869c13ec3532c},
+    {0x8c974f7383725573, 0x1e414218c73a13fb}, {0xafbd2350644eeacf, 0xe5d1929ef90898fa},
+    {0xdbac6c247d62a583, 0xdf45f746b74abf39}, {0x894bc396ce5da772, 0x6b8bba8c328eb783},
+    {0xab9eb47c81f5114f, 0x066ea92f3f326564}, {0xd686619ba27255a2, 0xc80a537b0efefebd},
+    {0x8613fd0145877585, 0xbd06742ce95f5f36}, {0xa798fc4196e952e7, 0x2c48113823b73704},
+    {0xd17f3b51fca3a7a0, 0xf75a15862ca504c5}, {0x82ef85133de648c4, 0x9a984d73dbe722fb},
+    {0xa3ab66580d5fdaf5, 0xc13e60d0d2e0ebba}, {0xcc963fee10b7d1b3, 0x318df905079926a8},
+    {0xffbbcfe994e5c61f, 0xfdf17746497f7052}, {0x9fd561f1fd0f9bd3, 0xfeb6ea8bedefa633},
+    {0xc7caba6e7c5382c8, 0xfe64a52ee96b8fc0}, {0xf9bd690a1b68637b, 0x3dfdce7aa3c673b0},
+    {0x9c1661a651213e2d, 0x06bea10ca65c084e}, {0xc31bfa0fe5698db8, 0x486e494fcff30a62},
+    {0xf3e2f893dec3f126, 0x5a89dba3c3efccfa}, {0x986ddb5c6b3a76b7, 0xf89629465a75e01c},
+    {0xbe89523386091465, 0xf6bbb397f1135823}, {0xee2ba6c0678b597f, 0x746aa07ded582e2c},
+    {0x94db483840b717ef, 0xa8c2a44eb4571cdc}, {0xba121a4650e4ddeb, 0x92f34d62616ce413},
+    {0xe896a0d7e51e1566, 0x77b020baf9c81d17}, {0x915e2486ef32cd60, 0x0ace1474dc1d122e},
+    {0xb5b5ada8aaff80b8, 0x0d819992132456ba}, {0xe3231912d5bf60e6, 0x10e1fff697ed6c69},
+    {0x8df5efabc5979c8f, 0xca8d3ffa1ef463c1}, {0xb1736b96b6fd83b3, 0xbd308ff8a6b17cb2},
+    {0xddd0467c64bce4a0, 0xac7cb3f6d05ddbde}, {0x8aa22c0dbef60ee4, 0x6bcdf07a423aa96b},
+    {0xad4ab7112eb3929d, 0x86c16c98d2c953c6}, {0xd89d64d57a607744, 0xe871c7bf077ba8b7},
+    {0x87625f056c7c4a8b, 0x11471cd764ad4972}, {0xa93af6c6c79b5d2d, 0xd598e40d3dd89bcf},
+    {0xd389b47879823479, 0x4aff1d108d4ec2c3}, {0x843610cb4bf160cb, 0xcedf722a585139ba},
+    {0xa54394fe1eedb8fe, 0xc2974eb4ee658828}, {0xce947a3da6a9273e, 0x733d226229feea32},
+    {0x811ccc668829b887, 0x0806357d5a3f525f}, {0xa163ff802a3426a8, 0xca07c2dcb0cf26f7},
+    {0xc9bcff6034c13052, 0xfc89b393dd02f0b5}, {0xfc2c3f3841f17c67, 0xbbac2078d443ace2},
+    {0x9d9ba7832936edc0, 0xd54b944b84aa4c0d}, {0xc5029163f384a931, 0x0a9e795e65d4df11},
+    {0xf64335bcf065d37d, 0x4d4617b5ff4a16d5}, {0x99ea0196163fa42e, 0x504bced1bf8e4e45},
+    {0xc06481fb9bcf8d39, 0xe45ec2862f71e1d6}, {0xf07da27a82c37088, 0x5d767327bb4e5a4c},
+    {0x964e858c91ba2655, 0x3a6a07f8d510f86f}, {0xbbe226efb628afea, 0x890489f70a55368b},
+    {0xeadab0aba3b2dbe5, 0x2b45ac74ccea842e}, {0x92c8ae6b464fc96f, 0x3b0b8bc90012929d},
+    {0xb77ada0617e3bbcb, 0x09ce6ebb40173744}, {0xe55990879ddcaabd, 0xcc420a6a101d0515},
+    {0x8f57fa54c2a9eab6, 0x9fa946824a12232d}, {0xb32df8e9f3546564, 0x47939822dc96abf9},
+    {0xdff9772470297ebd, 0x59787e2b93bc56f7}, {0x8bfbea76c619ef36, 0x57eb4edb3c55b65a},
+    {0xaefae51477a06b03, 0xede622920b6b23f1}, {0xdab99e59958885c4, 0xe95fab368e45eced},
+    {0x88b402f7fd75539b, 0x11dbcb0218ebb414}, {0xaae103b5fcd2a881, 0xd652bdc29f26a119},
+    {0xd59944a37c0752a2, 0x4be76d3346f0495f}, {0x857fcae62d8493a5, 0x6f70a4400c562ddb},
+    {0xa6dfbd9fb8e5b88e, 0xcb4ccd500f6bb952}, {0xd097ad07a71f26b2, 0x7e2000a41346a7a7},
+    {0x825ecc24c873782f, 0x8ed400668c0c28c8}, {0xa2f67f2dfa90563b, 0x728900802f0f32fa},
+    {0xcbb41ef979346bca, 0x4f2b40a03ad2ffb9}, {0xfea126b7d78186bc, 0xe2f610c84987bfa8},
+    {0x9f24b832e6b0f436, 0x0dd9ca7d2df4d7c9}, {0xc6ede63fa05d3143, 0x91503d1c79720dbb},
+    {0xf8a95fcf88747d94, 0x75a44c6397ce912a}, {0x9b69dbe1b548ce7c, 0xc986afbe3ee11aba},
+    {0xc24452da229b021b, 0xfbe85badce996168}, {0xf2d56790ab41c2a2, 0xfae27299423fb9c3},
+    {0x97c560ba6b0919a5, 0xdccd879fc967d41a}, {0xbdb6b8e905cb600f, 0x5400e987bbc1c920},
+    {0xed246723473e3813, 0x290123e9aab23b68}, {0x9436c0760c86e30b, 0xf9a0b6720aaf6521},
+    {0xb94470938fa89bce, 0xf808e40e8d5b3e69}, {0xe7958cb87392c2c2, 0xb60b1d1230b20e04},
+    {0x90bd77f3483bb9b9, 0xb1c6f22b5e6f48c2}, {0xb4ecd5f01a4aa828, 0x1e38aeb6360b1af3},
+    {0xe2280b6c20dd5232, 0x25c6da63c38de1b0}, {0x8d590723948a535f, 0x579c487e5a38ad0e},
+    {0xb0af48ec79ace837, 0x2d835a9df0c6d851}, {0xdcdb1b2798182244, 0xf8e431456cf88e65},
+    {0x8a08f0f8bf0f156b, 0x1b8e9ecb641b58ff}, {0xac8b2d36eed2dac5, 0xe272467e3d222f3f},
+    {0xd7adf884aa879177, 0x5b0ed81dcc6abb0f}, {0x86ccbb52ea94baea, 0x98e947129fc2b4e9},
+    {0xa87fea27a539e9a5, 0x3f2398d747b36224}, {0xd29fe4b18e88640e, 0x8eec7f0d19a03aad},
+    {0x83a3eeeef9153e89, 0x1953cf68300424ac}, {0xa48ceaaab75a8e2b, 0x5fa8c3423c052dd7},
+    {0xcdb02555653131b6, 0x3792f412cb06794d}, {0x808e17555f3ebf11, 0xe2bbd88bbee40bd0},
+    {0xa0b19d2ab70e6ed6, 0x5b6aceaeae9d0ec4}, {0xc8de047564d20a8b, 0xf245825a5a445275},
+    {0xfb158592be068d2e, 0xeed6e2f0f0d56712}, {0x9ced737bb6c4183d, 0x55464dd69685606b},
+    {0xc428d05aa4751e4c, 0xaa97e14c3c26b886}, {0xf53304714d9265df, 0xd53dd99f4b3066a8},
+    {0x993fe2c6d07b7fab, 0xe546a8038efe4029}, {0xbf8fdb78849a5f96, 0xde98520472bdd033},
+    {0xef73d256a5c0f77c, 0x963e66858f6d4440}, {0x95a8637627989aad, 0xdde7001379a44aa8},
+    {0xbb127c53b17ec159, 0x5560c018580d5d52}, {0xe9d71b689dde71af, 0xaab8f01e6e10b4a6},
+    {0x9226712162ab070d, 0xcab3961304ca70e8}, {0xb6b00d69bb55c8d1, 0x3d607b97c5fd0d22},
+    {0xe45c10c42a2b3b05, 0x8cb89a7db77c506a}, {0x8eb98a7a9a5b04e3, 0x77f3608e92adb242},
+    {0xb267ed1940f1c61c, 0x55f038b237591ed3}, {0xdf01e85f912e37a3, 0x6b6c46dec52f6688},
+    {0x8b61313bbabce2c6, 0x2323ac4b3b3da015}, {0xae397d8aa96c1b77, 0xabec975e0a0d081a},
+    {0xd9c7dced53c72255, 0x96e7bd358c904a21}, {0x881cea14545c7575, 0x7e50d64177da2e54},
+    {0xaa242499697392d2, 0xdde50bd1d5d0b9e9}, {0xd4ad2dbfc3d07787, 0x955e4ec64b44e864},
+    {0x84ec3c97da624ab4, 0xbd5af13bef0b113e}, {0xa6274bbdd0fadd61, 0xecb1ad8aeacdd58e},
+    {0xcfb11ead453994ba, 0x67de18eda5814af2}, {0x81ceb32c4b43fcf4, 0x80eacf948770ced7},
+    {0xa2425ff75e14fc31, 0xa1258379a94d028d}, {0xcad2f7f5359a3b3e, 0x096ee45813a04330},
+    {0xfd87b5f28300ca0d, 0x8bca9d6e188853fc}, {0x9e74d1b791e07e48, 0x775ea264cf55347e},
+    {0xc612062576589dda, 0x95364afe032a819e}, {0xf79687aed3eec551, 0x3a83ddbd83f52205},
+    {0x9abe14cd44753b52, 0xc4926a9672793543}, {0xc16d9a0095928a27, 0x75b7053c0f178294},
+    {0xf1c90080baf72cb1, 0x5324c68b12dd6339}, {0x971da05074da7bee, 0xd3f6fc16ebca5e04},
+    {0xbce5086492111aea, 0x88f4bb1ca6bcf585}, {0xec1e4a7db69561a5, 0x2b31e9e3d06c32e6},
+    {0x9392ee8e921d5d07, 0x3aff322e62439fd0}, {0xb877aa3236a4b449, 0x09befeb9fad487c3},
+    {0xe69594bec44de15b, 0x4c2ebe687989a9b4}, {0x901d7cf73ab0acd9, 0x0f9d37014bf60a11},
+    {0xb424dc35095cd80f, 0x538484c19ef38c95}, {0xe12e13424bb40e13, 0x2865a5f206b06fba},
+    {0x8cbccc096f5088cb, 0xf93f87b7442e45d4}, {0xafebff0bcb24aafe, 0xf78f69a51539d749},
+    {0xdbe6fecebdedd5be, 0xb573440e5a884d1c}, {0x89705f4136b4a597, 0x31680a88f8953031},
+    {0xabcc77118461cefc, 0xfdc20d2b36ba7c3e}, {0xd6bf94d5e57a42bc, 0x3d32907604691b4d},
+    {0x8637bd05af6c69b5, 0xa63f9a49c2c1b110}, {0xa7c5ac471b478423, 0x0fcf80dc33721d54},
+    {0xd1b71758e219652b, 0xd3c36113404ea4a9}, {0x83126e978d4fdf3b, 0x645a1cac083126ea},
+    {0xa3d70a3d70a3d70a, 0x3d70a3d70a3d70a4}, {0xcccccccccccccccc, 0xcccccccccccccccd},
+    {0x8000000000000000, 0x0000000000000000}, {0xa000000000000000, 0x0000000000000000},
+    {0xc800000000000000, 0x0000000000000000}, {0xfa00000000000000, 0x0000000000000000},
+    {0x9c40000000000000, 0x0000000000000000}, {0xc350000000000000, 0x0000000000000000},
+    {0xf424000000000000, 0x0000000000000000}, {0x9896800000000000, 0x0000000000000000},
+    {0xbebc200000000000, 0x0000000000000000}, {0xee6b280000000000, 0x0000000000000000},
+    {0x9502f90000000000, 0x0000000000000000}, {0xba43b74000000000, 0x0000000000000000},
+    {0xe8d4a51000000000, 0x0000000000000000}, {0x9184e72a00000000, 0x0000000000000000},
+    {0xb5e620f480000000, 0x0000000000000000}, {0xe35fa931a0000000, 0x0000000000000000},
+    {0x8e1bc9bf04000000, 0x0000000000000000}, {0xb1a2bc2ec5000000, 0x0000000000000000},
+    {0xde0b6b3a76400000, 0x0000000000000000}, {0x8ac7230489e80000, 0x0000000000000000},
+    {0xad78ebc5ac620000, 0x0000000000000000}, {0xd8d726b7177a8000, 0x0000000000000000},
+    {0x878678326eac9000, 0x0000000000000000}, {0xa968163f0a57b400, 0x0000000000000000},
+    {0xd3c21bcecceda100, 0x0000000000000000}, {0x84595161401484a0, 0x0000000000000000},
+    {0xa56fa5b99019a5c8, 0x0000000000000000}, {0xcecb8f27f4200f3a, 0x0000000000000000},
+    {0x813f3978f8940984, 0x4000000000000000}, {0xa18f07d736b90be5, 0x5000000000000000},
+    {0xc9f2c9cd04674ede, 0xa400000000000000}, {0xfc6f7c4045812296, 0x4d00000000000000},
+    {0x9dc5ada82b70b59d, 0xf020000000000000}, {0xc5371912364ce305, 0x6c28000000000000},
+    {0xf684df56c3e01bc6, 0xc732000000000000}, {0x9a130b963a6c115c, 0x3c7f400000000000},
+    {0xc097ce7bc90715b3, 0x4b9f100000000000}, {0xf0bdc21abb48db20, 0x1e86d40000000000},
+    {0x96769950b50d88f4, 0x1314448000000000}, {0xbc143fa4e250eb31, 0x17d955a000000000},
+    {0xeb194f8e1ae525fd, 0x5dcfab0800000000}, {0x92efd1b8d0cf37be, 0x5aa1cae500000000},
+    {0xb7abc627050305ad, 0xf14a3d9e40000000}, {0xe596b7b0c643c719, 0x6d9ccd05d0000000},
+    {0x8f7e32ce7bea5c6f, 0xe4820023a2000000}, {0xb35dbf821ae4f38b, 0xdda2802c8a800000},
+    {0xe0352f62a19e306e, 0xd50b2037ad200000}, {0x8c213d9da502de45, 0x4526f422cc340000},
+    {0xaf298d050e4395d6, 0x9670b12b7f410000}, {0xdaf3f04651d47b4c, 0x3c0cdd765f114000},
+    {0x88d8762bf324cd0f, 0xa5880a69fb6ac800}, {0xab0e93b6efee0053, 0x8eea0d047a457a00},
+    {0xd5d238a4abe98068, 0x72a4904598d6d880}, {0x85a36366eb71f041, 0x47a6da2b7f864750},
+    {0xa70c3c40a64e6c51, 0x999090b65f67d924}, {0xd0cf4b50cfe20765, 0xfff4b4e3f741cf6d},
+    {0x82818f1281ed449f, 0xbff8f10e7a8921a4}, {0xa321f2d7226895c7, 0xaff72d52192b6a0d},
+    {0xcbea6f8ceb02bb39, 0x9bf4f8a69f764490}, {0xfee50b7025c36a08, 0x02f236d04753d5b4},
+    {0x9f4f2726179a2245, 0x01d762422c946590}, {0xc722f0ef9d80aad6, 0x424d3ad2b7b97ef5},
+    {0xf8ebad2b84e0d58b, 0xd2e0898765a7deb2}, {0x9b934c3b330c8577, 0x63cc55f49f88eb2f},
+    {0xc2781f49ffcfa6d5, 0x3cbf6b71c76b25fb}, {0xf316271c7fc3908a, 0x8bef464e3945ef7a},
+    {0x97edd871cfda3a56, 0x97758bf0e3cbb5ac}, {0xbde94e8e43d0c8ec, 0x3d52eeed1cbea317},
+    {0xed63a231d4c4fb27, 0x4ca7aaa863ee4bdd}, {0x945e455f24fb1cf8, 0x8fe8caa93e74ef6a},
+    {0xb975d6b6ee39e436, 0xb3e2fd538e122b44}, {0xe7d34c64a9c85d44, 0x60dbbca87196b616},
+    {0x90e40fbeea1d3a4a, 0xbc8955e946fe31cd}, {0xb51d13aea4a488dd, 0x6babab6398bdbe41},
+    {0xe264589a4dcdab14, 0xc696963c7eed2dd1}, {0x8d7eb76070a08aec, 0xfc1e1de5cf543ca2},
+    {0xb0de65388cc8ada8, 0x3b25a55f43294bcb}, {0xdd15fe86affad912, 0x49ef0eb713f39ebe},
+    {0x8a2dbf142dfcc7ab, 0x6e3569326c784337}, {0xacb92ed9397bf996, 0x49c2c37f07965404},
+    {0xd7e77a8f87daf7fb, 0xdc33745ec97be906}, {0x86f0ac99b4e8dafd, 0x69a028bb3ded71a3},
+    {0xa8acd7c0222311bc, 0xc40832ea0d68ce0c}, {0xd2d80db02aabd62b, 0xf50a3fa490c30190},
+    {0x83c7088e1aab65db, 0x792667c6da79e0fa}, {0xa4b8cab1a1563f52, 0x577001b891185938},
+    {0xcde6fd5e09abcf26, 0xed4c0226b55e6f86}, {0x80b05e5ac60b6178, 0x544f8158315b05b4},
+    {0xa0dc75f1778e39d6, 0x696361ae3db1c721}, {0xc913936dd571c84c, 0x03bc3a19cd1e38e9},
+    {0xfb5878494ace3a5f, 0x04ab48a04065c723}, {0x9d174b2dcec0e47b, 0x62eb0d64283f9c76},
+    {0xc45d1df942711d9a, 0x3ba5d0bd324f8394}, {0xf5746577930d6500, 0xca8f44ec7ee36479},
+    {0x9968bf6abbe85f20, 0x7e998b13cf4e1ecb}, {0xbfc2ef456ae276e8, 0x9e3fedd8c321a67e},
+    {0xefb3ab16c59b14a2, 0xc5cfe94ef3ea101e}, {0x95d04aee3b80ece5, 0xbba1f1d158724a12},
+    {0xbb445da9ca61281f, 0x2a8a6e45ae8edc97}, {0xea1575143cf97226, 0xf52d09d71a3293bd},
+    {0x924d692ca61be758, 0x593c2626705f9c56}, {0xb6e0c377cfa2e12e, 0x6f8b2fb00c77836c},
+    {0xe498f455c38b997a, 0x0b6dfb9c0f956447}, {0x8edf98b59a373fec, 0x4724bd4189bd5eac},
+    {0xb2977ee300c50fe7, 0x58edec91ec2cb657}, {0xdf3d5e9bc0f653e1, 0x2f2967b66737e3ed},
+    {0x8b865b215899f46c, 0xbd79e0d20082ee74}, {0xae67f1e9aec07187, 0xecd8590680a3aa11},
+    {0xda01ee641a708de9, 0xe80e6f4820cc9495}, {0x884134fe908658b2, 0x3109058d147fdcdd},
+    {0xaa51823e34a7eede, 0xbd4b46f0599fd415}, {0xd4e5e2cdc1d1ea96, 0x6c9e18ac7007c91a},
+    {0x850fadc09923329e, 0x03e2cf6bc604ddb0}, {0xa6539930bf6bff45, 0x84db8346b786151c},
+    {0xcfe87f7cef46ff16, 0xe612641865679a63}, {0x81f14fae158c5f6e, 0x4fcb7e8f3f60c07e},
+    {0xa26da3999aef7749, 0xe3be5e330f38f09d}, {0xcb090c8001ab551c, 0x5cadf5bfd3072cc5},
+    {0xfdcb4fa002162a63, 0x73d9732fc7c8f7f6}, {0x9e9f11c4014dda7e, 0x2867e7fddcdd9afa},
+    {0xc646d63501a1511d, 0xb281e1fd541501b8}, {0xf7d88bc24209a565, 0x1f225a7ca91a4226},
+    {0x9ae757596946075f, 0x3375788de9b06958}, {0xc1a12d2fc3978937, 0x0052d6b1641c83ae},
+    {0xf209787bb47d6b84, 0xc0678c5dbd23a49a}, {0x9745eb4d50ce6332, 0xf840b7ba963646e0},
+    {0xbd176620a501fbff, 0xb650e5a93bc3d898}, {0xec5d3fa8ce427aff, 0xa3e51f138ab4cebe},
+    {0x93ba47c980e98cdf, 0xc66f336c36b10137}, {0xb8a8d9bbe123f017, 0xb80b0047445d4184},
+    {0xe6d3102ad96cec1d, 0xa60dc059157491e5}, {0x9043ea1ac7e41392, 0x87c89837ad68db2f},
+    {0xb454e4a179dd1877, 0x29babe4598c311fb}, {0xe16a1dc9d8545e94, 0xf4296dd6fef3d67a},
+    {0x8ce2529e2734bb1d, 0x1899e4a65f58660c}, {0xb01ae745b101e9e4, 0x5ec05dcff72e7f8f},
+    {0xdc21a1171d42645d, 0x76707543f4fa1f73}, {0x899504ae72497eba, 0x6a06494a791c53a8},
+    {0xabfa45da0edbde69, 0x0487db9d17636892}, {0xd6f8d7509292d603, 0x45a9d2845d3c42b6},
+    {0x865b86925b9bc5c2, 0x0b8a2392ba45a9b2}, {0xa7f26836f282b732, 0x8e6cac7768d7141e},
+    {0xd1ef0244af2364ff, 0x3207d795430cd926}, {0x8335616aed761f1f, 0x7f44e6bd49e807b8},
+    {0xa402b9c5a8d3a6e7, 0x5f16206c9c6209a6}, {0xcd036837130890a1, 0x36dba887c37a8c0f},
+    {0x802221226be55a64, 0xc2494954da2c9789}, {0xa02aa96b06deb0fd, 0xf2db9baa10b7bd6c},
+    {0xc83553c5c8965d3d, 0x6f92829494e5acc7}, {0xfa42a8b73abbf48c, 0xcb772339ba1f17f9},
+    {0x9c69a97284b578d7, 0xff2a760414536efb}, {0xc38413cf25e2d70d, 0xfef5138519684aba},
+    {0xf46518c2ef5b8cd1, 0x7eb258665fc25d69}, {0x98bf2f79d5993802, 0xef2f773ffbd97a61},
+    {0xbeeefb584aff8603, 0xaafb550ffacfd8fa}, {0xeeaaba2e5dbf6784, 0x95ba2a53f983cf38},
+    {0x952ab45cfa97a0b2, 0xdd945a747bf26183}, {0xba756174393d88df, 0x94f971119aeef9e4},
+    {0xe912b9d1478ceb17, 0x7a37cd5601aab85d}, {0x91abb422ccb812ee, 0xac62e055c10ab33a},
+    {0xb616a12b7fe617aa, 0x577b986b314d6009}, {0xe39c49765fdf9d94, 0xed5a7e85fda0b80b},
+    {0x8e41ade9fbebc27d, 0x14588f13be847307}, {0xb1d219647ae6b31c, 0x596eb2d8ae258fc8},
+    {0xde469fbd99a05fe3, 0x6fca5f8ed9aef3bb}, {0x8aec23d680043bee, 0x25de7bb9480d5854},
+    {0xada72ccc20054ae9, 0xaf561aa79a10ae6a}, {0xd910f7ff28069da4, 0x1b2ba1518094da04},
+    {0x87aa9aff79042286, 0x90fb44d2f05d0842}, {0xa99541bf57452b28, 0x353a1607ac744a53},
+    {0xd3fa922f2d1675f2, 0x42889b8997915ce8}, {0x847c9b5d7c2e09b7, 0x69956135febada11},
+    {0xa59bc234db398c25, 0x43fab9837e699095}, {0xcf02b2c21207ef2e, 0x94f967e45e03f4bb},
+    {0x8161afb94b44f57d, 0x1d1be0eebac278f5}, {0xa1ba1ba79e1632dc, 0x6462d92a69731732},
+    {0xca28a291859bbf93, 0x7d7b8f7503cfdcfe}, {0xfcb2cb35e702af78, 0x5cda735244c3d43e},
+    {0x9defbf01b061adab, 0x3a0888136afa64a7}, {0xc56baec21c7a1916, 0x088aaa1845b8fdd0},
+    {0xf6c69a72a3989f5b, 0x8aad549e57273d45}, {0x9a3c2087a63f6399, 0x36ac54e2f678864b},
+    {0xc0cb28a98fcf3c7f, 0x84576a1bb416a7dd}, {0xf0fdf2d3f3c30b9f, 0x656d44a2a11c51d5},
+    {0x969eb7c47859e743, 0x9f644ae5a4b1b325}, {0xbc4665b596706114, 0x873d5d9f0dde1fee},
+    {0xeb57ff22fc0c7959, 0xa90cb506d155a7ea}, {0x9316ff75dd87cbd8, 0x09a7f12442d588f2},
+    {0xb7dcbf5354e9bece, 0x0c11ed6d538aeb2f}, {0xe5d3ef282a242e81, 0x8f1668c8a86da5fa},
+    {0x8fa475791a569d10, 0xf96e017d694487bc}, {0xb38d92d760ec4455, 0x37c981dcc395a9ac},
+    {0xe070f78d3927556a, 0x85bbe253f47b1417}, {0x8c469ab843b89562, 0x93956d7478ccec8e},
+    {0xaf58416654a6babb, 0x387ac8d1970027b2}, {0xdb2e51bfe9d0696a, 0x06997b05fcc0319e},
+    {0x88fcf317f22241e2, 0x441fece3bdf81f03}, {0xab3c2fddeeaad25a, 0xd527e81cad7626c3},
+    {0xd60b3bd56a5586f1, 0x8a71e223d8d3b074}, {0x85c7056562757456, 0xf6872d5667844e49},
+    {0xa738c6bebb12d16c, 0xb428f8ac016561db}, {0xd106f86e69d785c7, 0xe13336d701beba52},
+    {0x82a45b450226b39c, 0xecc0024661173473}, {0xa34d721642b06084, 0x27f002d7f95d0190},
+    {0xcc20ce9bd35c78a5, 0x31ec038df7b441f4}, {0xff290242c83396ce, 0x7e67047175a15271},
+    {0x9f79a169bd203e41, 0x0f0062c6e984d386}, {0xc75809c42c684dd1, 0x52c07b78a3e60868},
+    {0xf92e0c3537826145, 0xa7709a56ccdf8a82}, {0x9bbcc7a142b17ccb, 0x88a66076400bb691},
+    {0xc2abf989935ddbfe, 0x6acff893d00ea435}, {0xf356f7ebf83552fe, 0x0583f6b8c4124d43},
+    {0x98165af37b2153de, 0xc3727a337a8b704a}, {0xbe1bf1b059e9a8d6, 0x744f18c0592e4c5c},
+    {0xeda2ee1c7064130c, 0x1162def06f79df73}, {0x9485d4d1c63e8be7, 0x8addcb5645ac2ba8},
+    {0xb9a74a0637ce2ee1, 0x6d953e2bd7173692}, {0xe8111c87c5c1ba99, 0xc8fa8db6ccdd0437},
+    {0x910ab1d4db9914a0, 0x1d9c9892400a22a2}, {0xb54d5e4a127f59c8, 0x2503beb6d00cab4b},
+    {0xe2a0b5dc971f303a, 0x2e44ae64840fd61d}, {0x8da471a9de737e24, 0x5ceaecfed289e5d2},
+    {0xb10d8e1456105dad, 0x7425a83e872c5f47}, {0xdd50f1996b947518, 0xd12f124e28f77719},
+    {0x8a5296ffe33cc92f, 0x82bd6b70d99aaa6f}, {0xace73cbfdc0bfb7b, 0x636cc64d1001550b},
+    {0xd8210befd30efa5a, 0x3c47f7e05401aa4e}, {0x8714a775e3e95c78, 0x65acfaec34810a71},
+    {0xa8d9d1535ce3b396, 0x7f1839a741a14d0d}, {0xd31045a8341ca07c, 0x1ede48111209a050},
+    {0x83ea2b892091e44d, 0x934aed0aab460432}, {0xa4e4b66b68b65d60, 0xf81da84d5617853f},
+    {0xce1de40642e3f4b9, 0x36251260ab9d668e}, {0x80d2ae83e9ce78f3, 0xc1d72b7c6b426019},
+    {0xa1075a24e4421730, 0xb24cf65b8612f81f}, {0xc94930ae1d529cfc, 0xdee033f26797b627},
+    {0xfb9b7cd9a4a7443c, 0x169840ef017da3b1}, {0x9d412e0806e88aa5, 0x8e1f289560ee864e},
+    {0xc491798a08a2ad4e, 0xf1a6f2bab92a27e2}, {0xf5b5d7ec8acb58a2, 0xae10af696774b1db},
+    {0x9991a6f3d6bf1765, 0xacca6da1e0a8ef29}, {0xbff610b0cc6edd3f, 0x17fd090a58d32af3},
+    {0xeff394dcff8a948e, 0xddfc4b4cef07f5b0}, {0x95f83d0a1fb69cd9, 0x4abdaf101564f98e},
+    {0xbb764c4ca7a4440f, 0x9d6d1ad41abe37f1}, {0xea53df5fd18d5513, 0x84c86189216dc5ed},
+    {0x92746b9be2f8552c, 0x32fd3cf5b4e49bb4}, {0xb7118682dbb66a77, 0x3fbc8c33221dc2a1},
+    {0xe4d5e82392a40515, 0x0fabaf3feaa5334a}, {0x8f05b1163ba6832d, 0x29cb4d87f2a7400e},
+    {0xb2c71d5bca9023f8, 0x743e20e9ef511012}, {0xdf78e4b2bd342cf6, 0x914da9246b255416},
+    {0x8bab8eefb6409c1a, 0x1ad089b6c2f7548e}, {0xae9672aba3d0c320, 0xa184ac2473b529b1},
+    {0xda3c0f568cc4f3e8, 0xc9e5d72d90a2741e}, {0x8865899617fb1871, 0x7e2fa67c7a658892},
+    {0xaa7eebfb9df9de8d, 0xddbb901b98feeab7}, {0xd51ea6fa85785631, 0x552a74227f3ea565},
+    {0x8533285c936b35de, 0xd53a88958f87275f}, {0xa67ff273b8460356, 0x8a892abaf368f137},
+    {0xd01fef10a657842c, 0x2d2b7569b0432d85}, {0x8213f56a67f6b29b, 0x9c3b29620e29fc73},
+    {0xa298f2c501f45f42, 0x8349f3ba91b47b8f}, {0xcb3f2f7642717713, 0x241c70a936219a73},
+    {0xfe0efb53d30dd4d7, 0xed238cd383aa0110}, {0x9ec95d1463e8a506, 0xf4363804324a40aa},
+    {0xc67bb4597ce2ce48, 0xb143c6053edcd0d5}, {0xf81aa16fdc1b81da, 0xdd94b7868e94050a},
+    {0x9b10a4e5e9913128, 0xca7cf2b4191c8326}, {0xc1d4ce1f63f57d72, 0xfd1c2f611f63a3f0},
+    {0xf24a01a73cf2dccf, 0xbc633b39673c8cec}, {0x976e41088617ca01, 0xd5be0503e085d813},
+    {0xbd49d14aa79dbc82, 0x4b2d8644d8a74e18}, {0xec9c459d51852ba2, 0xddf8e7d60ed1219e},
+    {0x93e1ab8252f33b45, 0xcabb90e5c942b503}, {0xb8da1662e7b00a17, 0x3d6a751f3b936243},
+    {0xe7109bfba19c0c9d, 0x0cc512670a783ad4}, {0x906a617d450187e2, 0x27fb2b80668b24c5},
+    {0xb484f9dc9641e9da, 0xb1f9f660802dedf6}, {0xe1a63853bbd26451, 0x5e7873f8a0396973},
+    {0x8d07e33455637eb2, 0xdb0b487b6423e1e8}, {0xb049dc016abc5e5f, 0x91ce1a9a3d2cda62},
+    {0xdc5c5301c56b75f7, 0x7641a140cc7810fb}, {0x89b9b3e11b6329ba, 0xa9e904c87fcb0a9d},
+    {0xac2820d9623bf429, 0x546345fa9fbdcd44}, {0xd732290fbacaf133, 0xa97c177947ad4095},
+    {0x867f59a9d4bed6c0, 0x49ed8eabcccc485d}, {0xa81f301449ee8c70, 0x5c68f256bfff5a74},
+    {0xd226fc195c6a2f8c, 0x73832eec6fff3111}, {0x83585d8fd9c25db7, 0xc831fd53c5ff7eab},
+    {0xa42e74f3d032f525, 0xba3e7ca8b77f5e55}, {0xcd3a1230c43fb26f, 0x28ce1bd2e55f35eb},
+    {0x80444b5e7aa7cf85, 0x7980d163cf5b81b3}, {0xa0555e361951c366, 0xd7e105bcc332621f},
+    {0xc86ab5c39fa63440, 0x8dd9472bf3fefaa7}, {0xfa856334878fc150, 0xb14f98f6f0feb951},
+    {0x9c935e00d4b9d8d2, 0x6ed1bf9a569f33d3}, {0xc3b8358109e84f07, 0x0a862f80ec4700c8},
+    {0xf4a642e14c6262c8, 0xcd27bb612758c0fa}, {0x98e7e9cccfbd7dbd, 0x8038d51cb897789c},
+    {0xbf21e44003acdd2c, 0xe0470a63e6bd56c3}, {0xeeea5d5004981478, 0x1858ccfce06cac74},
+    {0x95527a5202df0ccb, 0x0f37801e0c43ebc8}, {0xbaa718e68396cffd, 0xd30560258f54e6ba},
+    {0xe950df20247c83fd, 0x47c6b82ef32a2069}, {0x91d28b7416cdd27e, 0x4cdc331d57fa5441},
+    {0xb6472e511c81471d, 0xe0133fe4adf8e952}, {0xe3d8f9e563a198e5, 0x58180fddd97723a6},
+    {0x8e679c2f5e44ff8f, 0x570f09eaa7ea7648},
+};
+#define F64_POWER_OF_5_MIN -342
+#define F64_POWER_OF_5_MAX 308
+
+/*
+ * Rounds mantissa * 10^exponent to nearest double with Eisel-Lemire algorithm.
+ * Mantissa is multiplied with 128-bit approximation of 5^exponent, top 55
+ * bits of product decide rounding unless bits below them are too close to
+ * halfway point to tell.
+ * @param mantissa not 0
+ * @return 0 when result can not be decided, subnormal or exact halfway point
+ * @see https://arxiv.org/abs/2101.11408
+ */
+static inline b8
+F64FromDecimalEiselLemire(u64 mantissa, s64 exponent, f64 *result)
+{
+  if (exponent < F64_POWER_OF_5_MIN) {
+    *result = 0;
+    return 1;
+  }
+  if (exponent > F64_POWER_OF_5_MAX) {
+    // infinity
+    *result = F64FromBits((u64)0x7ff << 52);
+    return 1;
+  }
+
+  u32 leadingZeroCount = (u32)__builtin_clzll(mantissa);
+  mantissa <<= leadingZeroCount;
+
+  const u64 *power5 = F64_POWERS_OF_5[exponent - F64_POWER_OF_5_MIN];
+  __uint128_t product = (__uint128_t)mantissa * power5[0];
+  u64 high = (u64)(product >> 64);
+  u64 low = (u64)product;
+  // bits below top 55 are all ones, low half of power may carry into them
+  if ((high & 0x1ff) == 0x1ff) {
+    u64 carry = (u64)(((__uint128_t)mantissa * power5[1]) >> 64);
+    low += carry;
+    high += low < carry;
+  }
+  if (low == U64_MAX)
+    return 0;
+
+  u64 upperBit = high >> 63;
+  u64 shift = upperBit + 64 - 52 - 3;
+  u64 result53 = high >> shift;
+  // floor(log2(10^exponent)) + 63 + bias
+  s64 biasedExponent = ((217706 * exponent) >> 16) + 63 + (s64)upperBit - leadingZeroCount + 1023;
+  if (biasedExponent <= 0)
+    return 0;
+  if (low <= 1 && (result53 & 3) == 1 && (result53 << shift) == high)
+    return 0;
+
+  result53 += result53 & 1;
+  result53 >>= 1;
+  if (result53 >= ((u64)1 << 53)) {
+    result53 = (u64)1 << 52;
+    biasedExponent++;
+  }
+  if (biasedExponent >= 0x7ff) {
+    *result = F64FromBits((u64)0x7ff << 52);
+    return 1;
+  }
+
+  *result = F64FromBits(((u64)biasedExponent << 52) | (result53 & (((u64)1 << 52) - 1)));
+  return 1;
+}
+
+/*
+ * Parses decimal number with optional sign, fraction and exponent.
+ * e.g. "-12.5e-3", "3.", ".5", "1E10"
+ * Result is correctly rounded, ties to even. First 19 digits are read into
+ * u64, then:
+ *   - up to 2^53 with exponent in [-22, 22], it is exact product or quotient
+ *     of two doubles (Clinger's fast path)
+ *   - otherwise Eisel-Lemire algorithm rounds it, when more digits follow
+ *     result must be same for mantissa and mantissa + 1
+ *   - when that can not decide, approximation is corrected one ulp at a time
+ *     by comparing every digit with halfway point between doubles as big
+ *     integers
+ */
+static inline b8
+ParseF64(struct string *string, f64 *value)
+{
+  if (!string || IsStringNull(string) || IsStringEmpty(string))
+    return 0;
+
+  u8 *cursor = string->value;
+  u8 *end = string->value + string->length;
+
+  b8 isNegative = 0;
+  if (*cursor == '-' || *cursor == '+') {
+    isNegative = *cursor == '-';
+    cursor++;
+  }
+
+  // only first 19 digits are kept, it fits in u64
+  u64 mantissa = 0;
+  u32 mantissaDigitCount = 0;
+  s64 exponent = 0;
+  // non-zero digit is dropped from mantissa
+  b8 isTruncated = 0;
+
+  u8 *integer = cursor;
+  for (; cursor < end && (u8)(*cursor - '0') < 10; cursor++) {
+    if (mantissaDigitCount < 19) {
+      mantissa = mantissa * 10 + (u8)(*cursor - '0');
+      mantissaDigitCount += mantissa != 0;
+    } else {
+      isTruncated |= *cursor != '0';
+      exponent++;
+    }
+  }
+  u64 integerLength = (u64)(cursor - integer);
+
+  u8 *fraction = cursor;
+  u64 fractionLength = 0;
+  if (cursor < end && *cursor == '.') {
+    cursor++;
+    fraction = cursor;
+    for (; cursor < end && (u8)(*cursor - '0') < 10; cursor++) {
+      if (mantissaDigitCount < 19) {
+        mantissa = mantissa * 10 + (u8)(*cursor - '0');
+        mantissaDigitCount += mantissa != 0;
+        exponent--;
+      } else {
+        isTruncated |= *cursor != '0';
+      }
+    }
+    fractionLength = (u64)(cursor - fraction);
+  }
+
+  if (integerLength + fractionLength == 0)
+    return 0;
+
+  s64 explicitExponent = 0;
+  if (cursor < end && (*cursor == 'e' || *cursor == 'E')) {
+    cursor++;
+    b8 isExponentNegative = 0;
+    if (cursor < end && (*cursor == '-' || *cursor == '+')) {
+      isExponentNegative = *cursor == '-';
+      cursor++;
+    }
+
+    if (cursor == end)
+      return 0;
+
+    s64 exponentValue = 0;
+    for (; cursor < end && (u8)(*cursor - '0') < 10; cursor++) {
+      // beyond this every value is either 0 or infinity
+      if (exponentValue < 100000)
+        exponentValue = exponentValue * 10 + (u8)(*cursor - '0');
+    }
+    explicitExponent = isExponentNegative ? -exponentValue : exponentValue;
+    exponent += explicitExponent;
+  }
+
+  if (cursor != end)
+    return 0;
+
+  // exactly representable in f64
+  comptime f64 powersOf10[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+  };
+  s64 powerMax = ARRAY_COUNT(powersOf10) - 1;
+
+  f64 result = 0;
+  b8 isDecided = 1;
+  if (mantissa == 0) {
+    result = 0;
+  } else if (!isTruncated && mantissa <= ((u64)1 << 53) && exponent >= -powerMax && exponent <= powerMax) {
+    result = (f64)mantissa;
+    if (exponent >= 0)
+      result *= powersOf10[exponent];
+    else
+      result /= powersOf10[-exponent];
+  } else {
+    // dropped digits are between mantissa and mantissa + 1
+    f64 upper;
+    isDecided = F64FromDecimalEiselLemire(mantissa, exponent, &result) &&
+                (!isTruncated || (F64FromDecimalEiselLemire(mantissa + 1, exponent, &upper) && upper == result));
+  }
+
+  if (!isDecided) {
+    struct f64_decimal decimal;
+    F64DecimalFrom(&decimal, integer, integerLength, fraction, fractionLength, explicitExponent);
+
+    // value is in [10^(count + e - 1), 10^(count + e))
+    s64 magnitude = decimal.digitCount + decimal.exponent;
+    if (magnitude <= -324) {
+      result = 0;
+    } else if (magnitude >= 310) {
+      // infinity
+      result = F64FromBits((u64)0x7ff << 52);
+    } else {
+      // approximation that is off by few ulps
+      result = (f64)mantissa;
+      while (exponent > powerMax) {
+        result *= powersOf10[powerMax];
+        exponent -= powerMax;
+      }
+      while (exponent < -powerMax) {
+        result /= powersOf10[powerMax];
+        exponent += powerMax;
+      }
+      if (exponent > 0)
+        result *= powersOf10[exponent];
+      else if (exponent < 0)
+        result /= powersOf10[-exponent];
+
+      u64 maxBits = F64ToBits(F64_MAX);
+      u64 bits = F64ToBits(result);
+      if (bits > maxBits)
+        bits = maxBits;
+      if (bits == 0)
+        bits = 1;
+
+      u64 halfwayMantissa;
+      s64 halfwayExponent;
+      F64Halfway(F64FromBits(bits), F64FromBits(bits + 1), &halfwayMantissa, &halfwayExponent);
+      s32 comparison = F64DecimalCompare(&decimal, halfwayMantissa, halfwayExponent);
+      if (comparison > 0 || (comparison == 0 && (bits & 1))) {
+        // up, infinity is one after F64_MAX
+        do {
+          bits++;
+          if (bits > maxBits)
+            break;
+          F64Halfway(F64FromBits(bits), F64FromBits(bits + 1), &halfwayMantissa, &halfwayExponent);
+          comparison = F64DecimalCompare(&decimal, halfwayMantissa, halfwayExponent);
+        } while (comparison > 0 || (comparison == 0 && (bits & 1)));
+      } else {
+        // down, ties go to even one
+        while (bits > 0) {
+          F64Halfway(F64FromBits(bits - 1), F64FromBits(bits), &halfwayMantissa, &halfwayExponent);
+          comparison = F64DecimalCompare(&decimal, halfwayMantissa, halfwayExponent);
+          if (comparison > 0 || (comparison == 0 && !(bits & 1)))
+            break;
+          bits--;
+        }
+      }
+      result = F64FromBits(bits);
+    }
+  }
+
+  *value = isNegative ? -result : result;
+  return 1;
+}
+
+/*
+ * Format u64 into string buffer
+ * string buffer must at least able to hold 1 bytes, at most 20 bytes.
+ */
+static inline struct string
+FormatU64(struct string *stringBuffer, u64 value)
+{
+  // max 18446744073709551615
+  struct string result = StringNull();
+  if (!stringBuffer || stringBuffer->length == 0)
+    return result;
+
+  u64 powersOf10[] = {
+      1ull,                    // 10^0
+      10ull,                   // 10^1
+      100ull,                  // 10^2
+      1000ull,                 // 10^3
+      10000ull,                // 10^4
+      100000ull,               // 10^5
+      1000000ull,              // 10^6
+      10000000ull,             // 10^7
+      100000000ull,            // 10^8
+      1000000000ull,           // 10^9
+      10000000000ull,          // 10^10
+      100000000000ull,         // 10^11
+      1000000000000ull,        // 10^12
+      10000000000000ull,       // 10^13
+      100000000000000ull,      // 10^14
+      1000000000000000ull,     // 10^15
+      10000000000000000ull,    // 10^16
+      100000000000000000ull,   // 10^17
+      1000000000000000000ull,  // 10^18
+      10000000000000000000ull, // 10^19
+  };
+
+  u64 countOfDigits = 1;
+  while (countOfDigits < ARRAY_COUNT(powersOf10) && value >= powersOf10[countOfDigits])
+    countOfDigits++;
+
+  if (countOfDigits > stringBuffer->length)
+    return result;
+
+  u64 index = 0;
   while (countOfDigits > 0) {
     u64 power = powersOf10[countOfDigits - 1];
     u64 digit = value / power;
@@ -738,6 +2132,29 @@ FormatF32Slow(struct string *stringBuffer, f32 value, u32 fractionCount)
   return result;
 }
 
+/*
+ * Maps ASCII character to its hexadecimal digit value.
+ * -1 means character is not a hexadecimal digit.
+ */
+comptime s8 ASCIItoHEX[256] = {
+    -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x00
+    -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x10
+    -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x20
+    0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, -1, -1, -1, -1, -1, -1, // 0x30
+    -1,  0xa, 0xb, 0xc, 0xd, 0xe, 0xf, -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x40
+    -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x50
+    -1,  0xA, 0xB, 0xC, 0xD, 0xE, 0xF, -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x60
+    -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x70
+    -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x80
+    -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x90
+    -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0xa0
+    -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0xb0
+    -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0xc0
+    -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0xd0
+    -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0xe0
+    -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1  // 0xf0
+};
+
 static inline b8
 ParseHex(struct string *string, u64 *value)
 {
@@ -747,24 +2164,6 @@ ParseHex(struct string *string, u64 *value)
 
   u64 parsed = 0;
   for (u64 index = 0; index < string->length; index++) {
-    comptime s8 ASCIItoHEX[256] = {
-        -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x00
-        -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x10
-        -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x20
-        0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9, -1, -1, -1, -1, -1, -1, // 0x30
-        -1,  0xa, 0xb, 0xc, 0xd, 0xe, 0xf, -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x40
-        -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x50
-        -1,  0xA, 0xB, 0xC, 0xD, 0xE, 0xF, -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x60
-        -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x70
-        -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x80
-        -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0x90
-        -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0xa0
-        -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0xb0
-        -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0xc0
-        -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0xd0
-        -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1, -1, // 0xe0
-        -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1,  -1, -1, -1, -1, -1      // 0xf0
-    };
     u8 digitCharacter = string->value[index];
     s8 digit = ASCIItoHEX[digitCharacter];
 
@@ -856,221 +2255,3601 @@ FormatHex(struct string *buffer, u64 value)
   return result;
 }
 
+/*
+ * Encodes every byte of input as two lowercase hex digits.
+ *
+ * @param buffer needs at least 2 * input length bytes
+ * @return sub string from buffer, null on failure
+ *
+ * @code
+ *   struct string checksum = StringFromBuffer(checksumBytes, 32);
+ *   struct string hexBuffer = StringFromBuffer(hexBytes, 64);
+ *   struct string hex = HexEncode(&hexBuffer, &checksum);
+ * @endcode
+ */
 static inline struct string
-PathGetDirectory(struct string *path)
+HexEncode(struct string *buffer, struct string *input)
 {
-  struct string directory = StringNull();
+  struct string result = StringNull();
+  if (!buffer || !input || IsStringNull(input) || buffer->length / 2 < input->length)
+    return result;
 
-  if (!path || !path->value || path->length == 0)
-    return directory;
+  u8 *src = input->value;
+  u8 *dest = buffer->value;
+  u64 index = 0;
 
-  u64 lastSlashIndex = path->length - 1;
-  while (1) {
-#if IS_PLATFORM_WINDOWS
-    if (path->value[lastSlashIndex] == '\\')
-#else
-    if (path->value[lastSlashIndex] == '/')
+#if defined(__AVX2__)
+  {
+    __m256i digits = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+                                      '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    __m256i nibbleMask = _mm256_set1_epi8(0x0f);
+    for (; index + 32 <= input->length; index += 32) {
+      __m256i bytes = _mm256_loadu_si256((__m256i *)(src + index));
+      __m256i high = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibbleMask));
+      __m256i low = _mm256_shuffle_epi8(digits, _mm256_and_si256(bytes, nibbleMask));
+      // unpack interleaves within 128-bit lanes, so put lanes back in order
+      __m256i first = _mm256_unpacklo_epi8(high, low);
+      __m256i second = _mm256_unpackhi_epi8(high, low);
+      _mm256_storeu_si256((__m256i *)(dest + 2 * index), _mm256_permute2x128_si256(first, second, 0x20));
+      _mm256_storeu_si256((__m256i *)(dest + 2 * index + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+  }
 #endif
-      break;
 
-    // if slash not found
-    if (lastSlashIndex == 0)
-      return directory;
+#if defined(__SSE2__)
+  {
+    __m128i nibbleMask = _mm_set1_epi8(0x0f);
+#if defined(__SSSE3__)
+    __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+#else
+    __m128i nine = _mm_set1_epi8(9);
+    __m128i zero = _mm_set1_epi8('0');
+    __m128i letterOffset = _mm_set1_epi8('a' - '0' - 10);
+#endif
+    for (; index + 16 <= input->length; index += 16) {
+      __m128i bytes = _mm_loadu_si128((__m128i *)(src + index));
+      __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibbleMask);
+      __m128i low = _mm_and_si128(bytes, nibbleMask);
+#if defined(__SSSE3__)
+      high = _mm_shuffle_epi8(digits, high);
+      low = _mm_shuffle_epi8(digits, low);
+#else
+      // nibble + '0' + (nibble > 9 ? 'a' - '0' - 10 : 0)
+      high = _mm_add_epi8(_mm_add_epi8(high, zero), _mm_and_si128(_mm_cmpgt_epi8(high, nine), letterOffset));
+      low = _mm_add_epi8(_mm_add_epi8(low, zero), _mm_and_si128(_mm_cmpgt_epi8(low, nine), letterOffset));
+#endif
+      _mm_storeu_si128((__m128i *)(dest + 2 * index), _mm_unpacklo_epi8(high, low));
+      _mm_storeu_si128((__m128i *)(dest + 2 * index + 16), _mm_unpackhi_epi8(high, low));
+    }
+  }
+#endif
 
-    lastSlashIndex--;
+  u8 *digit = dest + 2 * index;
+  for (; index < input->length; index++) {
+    u8 byte = src[index];
+    *digit++ = (u8)("0123456789abcdef"[byte >> 4]);
+    *digit++ = (u8)("0123456789abcdef"[byte & 15]);
   }
 
-  directory.value = path->value;
-  directory.length = lastSlashIndex;
-  if (directory.length == 0)
-    directory.length++;
-  return directory;
+  result.value = buffer->value;
+  result.length = 2 * input->length;
+  return result;
 }
 
 /*
- * Splits string into multiple strings.
- * When splits array is empty, number of parts string can be split returned in splitCount.
- * @param string string to be split
- * @param splitCount how many different parts are in string. [1,∞]
- * @param splits pointer to array of strings.
- * @return 1 when string can be split into parts, 0 otherwise.
- * @code
- *   u64 splitCount;
- *   string *separator = &StringFromLiteral(" ");
- *   if (!StringSplit(string, separator, &splitCount, 0))
- *     return;
- *   string *splits = MemoryArenaPush(arena, sizeof(*splits) * splitCount);
- *   StringSplit(string, separator, &splitCount, splits);
- * @endcode
+ * Decodes pairs of hex digits into bytes.
+ * Both lowercase and uppercase digits are accepted.
+ *
+ * @param buffer needs at least input length / 2 bytes
+ * @param errorIndex optional, on failure set to position of first character that
+ *                   is not a hex digit. When input has odd length and all
+ *                   characters are hex digits, it is set to input length.
+ * @return sub string from buffer, null on failure
  */
-static inline b8
-StringSplit(struct string *string, struct string *separator, u64 *splitCount, struct string *splits)
+static inline struct string
+HexDecode(struct string *buffer, struct string *input, u64 *errorIndex)
 {
-  debug_assert(splitCount && "only splits can be null");
-
-  if (!string || !splitCount)
-    return 0;
+  struct string result = StringNull();
+  if (!buffer || !input || IsStringNull(input) || buffer->length < input->length / 2)
+    return result;
 
-  b8 isCalculatingSplitCount = splits == 0;
-  if (isCalculatingSplitCount) {
-    u64 count = 0;
-    for (u64 index = 0; index < string->length;) {
-      struct string substring = StringFromBuffer(string->value + index, separator->length);
+  u8 *src = input->value;
+  u8 *dest = buffer->value;
+  u64 pairCount = input->length / 2;
+  u64 index = 0;
+  u64 invalidIndex = input->length;
 
-      if (separator->length > string->length - index) {
-        if (count == 0)
-          // no separator found
-          return 0;
-        break;
+#if defined(__AVX2__)
+  {
+    __m256i zero = _mm256_set1_epi8('0');
+    __m256i nine = _mm256_set1_epi8(9);
+    __m256i lowercase = _mm256_set1_epi8(0x20);
+    __m256i letterA = _mm256_set1_epi8('a');
+    __m256i five = _mm256_set1_epi8(5);
+    __m256i ten = _mm256_set1_epi8(10);
+    __m256i lowByte = _mm256_set1_epi16(0x00ff);
+    for (; index + 32 <= pairCount; index += 32) {
+      __m256i values[2];
+      u64 invalidMask = 0;
+      for (u32 half = 0; half < 2; half++) {
+        __m256i characters = _mm256_loadu_si256((__m256i *)(src + 2 * index + 32 * half));
+        __m256i digit = _mm256_sub_epi8(characters, zero);
+        __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, nine), digit);
+        __m256i letter = _mm256_sub_epi8(_mm256_or_si256(characters, lowercase), letterA);
+        __m256i isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, five), letter);
+        __m256i value = _mm256_or_si256(_mm256_and_si256(digit, isDigit),
+                                        _mm256_and_si256(_mm256_add_epi8(letter, ten), isLetter));
+        u32 validMask = (u32)_mm256_movemask_epi8(_mm256_or_si256(isDigit, isLetter));
+        invalidMask |= (u64)(~validMask) << (32 * half);
+        // (high nibble, low nibble) byte pair into one byte in u16
+        values[half] = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(value, lowByte), 4),
+                                       _mm256_srli_epi16(value, 8));
       }
 
-      if (IsStringEqual(&substring, separator)) {
-        count++;
-        index += separator->length;
-      } else {
-        index++;
+      if (invalidMask) {
+        invalidIndex = 2 * index + (u64)__builtin_ctzll(invalidMask);
+        goto failure;
       }
+
+      // pack works within 128-bit lanes, so put lanes back in order
+      __m256i packed = _mm256_packus_epi16(values[0], values[1]);
+      _mm256_storeu_si256((__m256i *)(dest + index), _mm256_permute4x64_epi64(packed, 0xd8));
     }
-    *splitCount = count + 1;
-  } else {
-    u64 startIndex = 0;
-    u64 splitIndex = 0;
+  }
+#endif
 
-    for (u64 index = 0; index < string->length;) {
-      struct string substring = StringFromBuffer(string->value + index, separator->length);
-      if (separator->length > string->length - index)
-        break;
+#if defined(__SSE2__)
+  {
+    __m128i zero = _mm_set1_epi8('0');
+    __m128i nine = _mm_set1_epi8(9);
+    __m128i lowercase = _mm_set1_epi8(0x20);
+    __m128i letterA = _mm_set1_epi8('a');
+    __m128i five = _mm_set1_epi8(5);
+    __m128i ten = _mm_set1_epi8(10);
+    __m128i lowByte = _mm_set1_epi16(0x00ff);
+    for (; index + 16 <= pairCount; index += 16) {
+      __m128i values[2];
+      u32 invalidMask = 0;
+      for (u32 half = 0; half < 2; half++) {
+        __m128i characters = _mm_loadu_si128((__m128i *)(src + 2 * index + 16 * half));
+        __m128i digit = _mm_sub_epi8(characters, zero);
+        __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, nine), digit);
+        __m128i letter = _mm_sub_epi8(_mm_or_si128(characters, lowercase), letterA);
+        __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, five), letter);
+        __m128i value =
+            _mm_or_si128(_mm_and_si128(digit, isDigit), _mm_and_si128(_mm_add_epi8(letter, ten), isLetter));
+        u32 validMask = (u32)_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter));
+        invalidMask |= (~validMask & 0xffff) << (16 * half);
+        values[half] = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(value, lowByte), 4), _mm_srli_epi16(value, 8));
+      }
 
-      if (IsStringEqual(&substring, separator)) {
-        struct string split = StringFromBuffer(string->value + startIndex, index - startIndex);
-        if (split.length == 0)
-          split.value = 0;
-        *(splits + splitIndex) = split;
-        splitIndex++;
-        index += separator->length;
-        startIndex = index;
-      } else {
-        index++;
+      if (invalidMask) {
+        invalidIndex = 2 * index + (u64)__builtin_ctz(invalidMask);
+        goto failure;
       }
+
+      _mm_storeu_si128((__m128i *)(dest + index), _mm_packus_epi16(values[0], values[1]));
+    }
+  }
+#endif
+
+  for (; index < pairCount; index++) {
+    s8 high = ASCIItoHEX[src[2 * index + 0]];
+    s8 low = ASCIItoHEX[src[2 * index + 1]];
+    if ((high | low) < 0) {
+      invalidIndex = 2 * index + (u64)(high >= 0);
+      goto failure;
+    }
+    dest[index] = (u8)((high << 4) | low);
+  }
+
+  if (input->length % 2 != 0) {
+    if (ASCIItoHEX[src[input->length - 1]] < 0)
+      invalidIndex = input->length - 1;
+    goto failure;
+  }
+
+  result.value = buffer->value;
+  result.length = pairCount;
+  return result;
+
+failure:
+  if (errorIndex)
+    *errorIndex = invalidIndex;
+  return result;
+}
+
+enum base64_alphabet {
+  // A-Z a-z 0-9 + /, padded with '=' to multiple of 4, RFC 4648 section 4
+  BASE64_ALPHABET_STANDARD,
+  // A-Z a-z 0-9 - _, without padding, RFC 4648 section 5
+  BASE64_ALPHABET_URL,
+};
+
+/*
+ * Byte values for decoding, -1 for characters not in alphabet.
+ */
+comptime s8 ASCIItoBASE64[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0x00
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0x10
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63, // 0x20
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1, // 0x30
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, // 0x40
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1, // 0x50
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, // 0x60
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1, // 0x70
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0x80
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0x90
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0xa0
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0xb0
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0xc0
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0xd0
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0xe0
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1  // 0xf0
+};
+
+comptime s8 ASCIItoBASE64URL[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0x00
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0x10
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, // 0x20
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1, // 0x30
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, // 0x40
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, 63, // 0x50
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, // 0x60
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1, // 0x70
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0x80
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0x90
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0xa0
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0xb0
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0xc0
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0xd0
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0xe0
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1  // 0xf0
+};
+/*
+ * @return count of characters Base64Encode() writes for length bytes
+ */
+static inline u64
+Base64EncodedLength(u64 length, enum base64_alphabet alphabet)
+{
+  if (alphabet == BASE64_ALPHABET_STANDARD)
+    return (length + 2) / 3 * 4;
+  return length / 3 * 4 + (length % 3 == 0 ? 0 : length % 3 + 1);
+}
+
+/*
+ * @return count of bytes Base64Decode() writes for input,
+ *         exact when input is valid
+ */
+static inline u64
+Base64DecodedLength(struct string *input, enum base64_alphabet alphabet)
+{
+  u64 length = input->length;
+  if (alphabet == BASE64_ALPHABET_STANDARD) {
+    u64 padding = 0;
+    if (length >= 4 && length % 4 == 0)
+      padding = (u64)(input->value[length - 1] == '=') + (u64)(input->value[length - 2] == '=');
+    return length / 4 * 3 - padding;
+  }
+  return length / 4 * 3 + (length % 4 <= 1 ? 0 : length % 4 - 1);
+}
+
+/*
+ * Encodes input as base64.
+ * 12 bytes per 16 byte vector are spread to 6-bit indexes with multiplies,
+ * then indexes are turned into characters with one table lookup.
+ *
+ * @param buffer needs at least Base64EncodedLength() bytes
+ * @return sub string from buffer, null on failure
+ *
+ * @code
+ *   u64 length = Base64EncodedLength(payload.length, BASE64_ALPHABET_STANDARD);
+ *   struct string buffer = StringFromBuffer(MemoryArenaPush(arena, length), length);
+ *   struct string text = Base64Encode(&buffer, &payload, BASE64_ALPHABET_STANDARD);
+ * @endcode
+ */
+static inline struct string
+Base64Encode(struct string *buffer, struct string *input, enum base64_alphabet alphabet)
+{
+  struct string result = StringNull();
+  if (!buffer || !input || IsStringNull(input) || buffer->length < Base64EncodedLength(input->length, alphabet))
+    return result;
+
+  b8 isURL = alphabet == BASE64_ALPHABET_URL;
+  u8 *characters = isURL ? (u8 *)"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+                         : (u8 *)"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  u8 *src = input->value;
+  u8 *dest = buffer->value;
+  u64 index = 0;
+
+#if defined(__AVX2__)
+  {
+    // bytes 1 0 2 1 of each group of 3 into one u32
+    __m256i spread = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, //
+                                      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    // index 0-25 -> 13, 26-51 -> 0, 52-61 -> 1-10, 62 -> 11, 63 -> 12
+    __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                    '0' - 52, '0' - 52, '0' - 52, (char)(characters[62] - 62),
+                                    (char)(characters[63] - 63), 'A', 0, 0);
+    __m256i offsetTable = _mm256_broadcastsi128_si256(offsets);
+    // reads 28 bytes for 24
+    for (; index + 28 <= input->length; index += 24) {
+      __m256i bytes = _mm256_inserti128_si256(
+          _mm256_castsi128_si256(_mm_loadu_si128((__m128i *)(src + index))),
+          _mm_loadu_si128((__m128i *)(src + index + 12)), 1);
+      bytes = _mm256_shuffle_epi8(bytes, spread);
+      __m256i first = _mm256_mulhi_epu16(_mm256_and_si256(bytes, _mm256_set1_epi32(0x0fc0fc00)),
+                                         _mm256_set1_epi32(0x04000040));
+      __m256i second = _mm256_mullo_epi16(_mm256_and_si256(bytes, _mm256_set1_epi32(0x003f03f0)),
+                                          _mm256_set1_epi32(0x01000010));
+      __m256i indexes = _mm256_or_si256(first, second);
+
+      __m256i range = _mm256_subs_epu8(indexes, _mm256_set1_epi8(51));
+      range = _mm256_or_si256(range, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), indexes),
+                                                      _mm256_set1_epi8(13)));
+      __m256i text = _mm256_add_epi8(indexes, _mm256_shuffle_epi8(offsetTable, range));
+      _mm256_storeu_si256((__m256i *)(dest + index / 3 * 4), text);
+    }
+  }
+#endif
+
+#if defined(__SSSE3__)
+  {
+    __m128i spread = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                    '0' - 52, '0' - 52, '0' - 52, (char)(characters[62] - 62),
+                                    (char)(characters[63] - 63), 'A', 0, 0);
+    // reads 16 bytes for 12
+    for (; index + 16 <= input->length; index += 12) {
+      __m128i bytes = _mm_shuffle_epi8(_mm_loadu_si128((__m128i *)(src + index)), spread);
+      __m128i first = _mm_mulhi_epu16(_mm_and_si128(bytes, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+      __m128i second = _mm_mullo_epi16(_mm_and_si128(bytes, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+      __m128i indexes = _mm_or_si128(first, second);
+
+      __m128i range = _mm_subs_epu8(indexes, _mm_set1_epi8(51));
+      range = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indexes), _mm_set1_epi8(13)));
+      __m128i text = _mm_add_epi8(indexes, _mm_shuffle_epi8(offsets, range));
+      _mm_storeu_si128((__m128i *)(dest + index / 3 * 4), text);
+    }
+  }
+#endif
+
+  u8 *character = dest + index / 3 * 4;
+  for (; index + 3 <= input->length; index += 3) {
+    u32 group = (u32)src[index] << 16 | (u32)src[index + 1] << 8 | (u32)src[index + 2];
+    *character++ = characters[(group >> 18) & 63];
+    *character++ = characters[(group >> 12) & 63];
+    *character++ = characters[(group >> 6) & 63];
+    *character++ = characters[group & 63];
+  }
+
+  u64 remaining = input->length - index;
+  if (remaining != 0) {
+    u32 group = (u32)src[index] << 16 | (remaining == 2 ? (u32)src[index + 1] << 8 : 0);
+    *character++ = characters[(group >> 18) & 63];
+    *character++ = characters[(group >> 12) & 63];
+    if (remaining == 2)
+      *character++ = characters[(group >> 6) & 63];
+    else if (!isURL)
+      *character++ = '=';
+    if (!isURL)
+      *character++ = '=';
+  }
+
+  result.value = buffer->value;
+  result.length = (u64)(character - buffer->value);
+  return result;
+}
+
+/*
+ * Decodes base64 input strictly. Characters outside of alphabet, whitespace,
+ * missing or misplaced padding and nonzero unused bits in last character are
+ * rejected.
+ * Characters are validated and translated with nibble lookups 16 or 32 at a
+ * time, then packed to bytes with multiply-add.
+ *
+ * @param buffer needs at least Base64DecodedLength() bytes
+ * @param errorIndex optional, on failure set to position of first invalid
+ *                   character. When length of input is invalid, it is set to
+ *                   input length.
+ * @return sub string from buffer, null on failure
+ */
+static inline struct string
+Base64Decode(struct string *buffer, struct string *input, enum base64_alphabet alphabet, u64 *errorIndex)
+{
+  struct string result = StringNull();
+  if (!buffer || !input || IsStringNull(input) || buffer->length < Base64DecodedLength(input, alphabet))
+    return result;
+
+  b8 isURL = alphabet == BASE64_ALPHABET_URL;
+  const s8 *table = isURL ? ASCIItoBASE64URL : ASCIItoBASE64;
+  u8 *src = input->value;
+  u8 *dest = buffer->value;
+  u64 length = input->length;
+  u64 index = 0;
+  u64 invalidIndex = length;
+
+  // last group may be short or padded, it is decoded on its own
+  u64 lastLength = length % 4;
+  if (isURL ? lastLength == 1 : lastLength != 0)
+    goto failure;
+  if (lastLength == 0 && length != 0)
+    lastLength = 4;
+  u64 bodyLength = length - lastLength;
+
+#if defined(__SSSE3__)
+  {
+    u64 decodedLength = Base64DecodedLength(input, alphabet);
+    // character is valid when its bits in both tables do not overlap
+    // bit 0x10 rejects high nibbles that have no valid character
+    __m128i lowTable = isURL ? _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x3b,
+                                             0x3b, 0x3a, 0x3b, 0x33)
+                             : _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a,
+                                             0x1b, 0x1b, 0x1b, 0x1a);
+    __m128i highTable = isURL ? _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x20, 0x10, 0x10, 0x10, 0x10,
+                                              0x10, 0x10, 0x10, 0x10)
+                              : _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10,
+                                              0x10, 0x10, 0x10, 0x10);
+    // added to character by high nibble, one character of alphabet shares
+    // high nibble with others and is moved to its own slot
+    __m128i offsetTable = isURL ? _mm_setr_epi8(0, 0, 17, 4, -65, -65, -71, -71, -32, 0, 0, 0, 0, 0, 0, 0)
+                                : _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    __m128i moved = _mm_set1_epi8((char)(isURL ? '_' : '/'));
+    __m128i movedSlot = _mm_set1_epi8((char)(isURL ? 8 - 5 : 1 - 2));
+    __m128i nibbleMask = _mm_set1_epi8(0x0f);
+    // packs 4 x 6 bits into 3 bytes in each u32
+    __m128i merge = _mm_set1_epi32(0x01400140);
+    __m128i combine = _mm_set1_epi32(0x00011000);
+    __m128i gather = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+#if defined(__AVX2__)
+    {
+      __m256i lowTable256 = _mm256_broadcastsi128_si256(lowTable);
+      __m256i highTable256 = _mm256_broadcastsi128_si256(highTable);
+      __m256i offsetTable256 = _mm256_broadcastsi128_si256(offsetTable);
+      __m256i gather256 = _mm256_broadcastsi128_si256(gather);
+      __m256i lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+      // writes 32 bytes for 24
+      for (; index + 32 <= bodyLength && index / 4 * 3 + 32 <= decodedLength; index += 32) {
+        __m256i text = _mm256_loadu_si256((__m256i *)(src + index));
+        __m256i high = _mm256_and_si256(_mm256_srli_epi32(text, 4), _mm256_broadcastsi128_si256(nibbleMask));
+        __m256i low = _mm256_and_si256(text, _mm256_broadcastsi128_si256(nibbleMask));
+        __m256i invalid =
+            _mm256_and_si256(_mm256_shuffle_epi8(lowTable256, low), _mm256_shuffle_epi8(highTable256, high));
+        if (_mm256_movemask_epi8(_mm256_cmpgt_epi8(invalid, _mm256_setzero_si256())))
+          break;
+
+        __m256i slot = _mm256_add_epi8(
+            high, _mm256_and_si256(_mm256_cmpeq_epi8(text, _mm256_broadcastsi128_si256(moved)),
+                                   _mm256_broadcastsi128_si256(movedSlot)));
+        __m256i values = _mm256_add_epi8(text, _mm256_shuffle_epi8(offsetTable256, slot));
+        values = _mm256_maddubs_epi16(values, _mm256_broadcastsi128_si256(merge));
+        values = _mm256_madd_epi16(values, _mm256_broadcastsi128_si256(combine));
+        values = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(values, gather256), lanes);
+        _mm256_storeu_si256((__m256i *)(dest + index / 4 * 3), values);
+      }
+    }
+#endif
+
+    // writes 16 bytes for 12
+    for (; index + 16 <= bodyLength && index / 4 * 3 + 16 <= decodedLength; index += 16) {
+      __m128i text = _mm_loadu_si128((__m128i *)(src + index));
+      __m128i high = _mm_and_si128(_mm_srli_epi32(text, 4), nibbleMask);
+      __m128i low = _mm_and_si128(text, nibbleMask);
+      __m128i invalid = _mm_and_si128(_mm_shuffle_epi8(lowTable, low), _mm_shuffle_epi8(highTable, high));
+      if (_mm_movemask_epi8(_mm_cmpgt_epi8(invalid, _mm_setzero_si128())))
+        break;
+
+      __m128i slot = _mm_add_epi8(high, _mm_and_si128(_mm_cmpeq_epi8(text, moved), movedSlot));
+      __m128i values = _mm_add_epi8(text, _mm_shuffle_epi8(offsetTable, slot));
+      values = _mm_madd_epi16(_mm_maddubs_epi16(values, merge), combine);
+      _mm_storeu_si128((__m128i *)(dest + index / 4 * 3), _mm_shuffle_epi8(values, gather));
+    }
+  }
+#endif
+
+  u8 *byte = dest + index / 4 * 3;
+  for (; index < bodyLength; index += 4) {
+    s8 values[4] = {table[src[index]], table[src[index + 1]], table[src[index + 2]], table[src[index + 3]]};
+    if ((values[0] | values[1] | values[2] | values[3]) < 0) {
+      for (u32 valueIndex = 0; valueIndex < 4; valueIndex++) {
+        if (values[valueIndex] < 0) {
+          invalidIndex = index + valueIndex;
+          break;
+        }
+      }
+      goto failure;
+    }
+
+    u32 group = (u32)values[0] << 18 | (u32)values[1] << 12 | (u32)values[2] << 6 | (u32)values[3];
+    *byte++ = (u8)(group >> 16);
+    *byte++ = (u8)(group >> 8);
+    *byte++ = (u8)group;
+  }
+
+  if (lastLength != 0) {
+    // "xx==", "xxx=" and "xxxx", or "xx", "xxx" without padding
+    u64 characterCount = lastLength;
+    if (!isURL)
+      characterCount = src[length - 2] == '=' ? 2 : src[length - 1] == '=' ? 3 : 4;
+    if (!isURL && characterCount == 2 && src[length - 1] != '=') {
+      invalidIndex = length - 1;
+      goto failure;
+    }
+
+    u32 group = 0;
+    for (u64 characterIndex = 0; characterIndex < characterCount; characterIndex++) {
+      s8 value = table[src[index + characterIndex]];
+      if (value < 0) {
+        invalidIndex = index + characterIndex;
+        goto failure;
+      }
+      group |= (u32)value << (18 - 6 * characterIndex);
+    }
+
+    // bits past last byte must be zero so that encoding is unique
+    u32 unusedBits = characterCount == 2 ? (group & 0xffff) : characterCount == 3 ? (group & 0xff) : 0;
+    if (unusedBits) {
+      invalidIndex = index + characterCount - 1;
+      goto failure;
+    }
+
+    *byte++ = (u8)(group >> 16);
+    if (characterCount >= 3)
+      *byte++ = (u8)(group >> 8);
+    if (characterCount == 4)
+      *byte++ = (u8)group;
+  }
+
+  result.value = buffer->value;
+  result.length = (u64)(byte - buffer->value);
+  return result;
+
+failure:
+  if (errorIndex)
+    *errorIndex = invalidIndex;
+  return result;
+}
+
+#if IS_PLATFORM_WINDOWS
+#define PATH_SEPARATOR '\\'
+#else
+#define PATH_SEPARATOR '/'
+#endif
+
+/*
+ * Windows accepts both '\' and '/', other platforms only '/'.
+ */
+static inline b8
+IsPathSeparator(u8 character)
+{
+  return character == '/' || character == PATH_SEPARATOR;
+}
+
+/*
+ * @return position of first separator, length if there is none
+ */
+static inline u64
+PathIndexOfSeparator(u8 *bytes, u64 length)
+{
+  u64 index = 0;
+
+#if defined(__AVX2__)
+  {
+    __m256i slashes = _mm256_set1_epi8('/');
+    __m256i separators = _mm256_set1_epi8(PATH_SEPARATOR);
+    for (; index + 32 <= length; index += 32) {
+      __m256i chunk = _mm256_loadu_si256((__m256i *)(bytes + index));
+      u32 mask = (u32)_mm256_movemask_epi8(
+          _mm256_or_si256(_mm256_cmpeq_epi8(chunk, slashes), _mm256_cmpeq_epi8(chunk, separators)));
+      if (mask)
+        return index + (u64)__builtin_ctz(mask);
+    }
+  }
+#endif
+
+#if defined(__SSE2__)
+  {
+    __m128i slashes = _mm_set1_epi8('/');
+    __m128i separators = _mm_set1_epi8(PATH_SEPARATOR);
+    for (; index + 16 <= length; index += 16) {
+      __m128i chunk = _mm_loadu_si128((__m128i *)(bytes + index));
+      u32 mask = (u32)_mm_movemask_epi8(
+          _mm_or_si128(_mm_cmpeq_epi8(chunk, slashes), _mm_cmpeq_epi8(chunk, separators)));
+      if (mask)
+        return index + (u64)__builtin_ctz(mask);
+    }
+  }
+#endif
+
+  for (; index < length; index++) {
+    if (IsPathSeparator(bytes[index]))
+      break;
+  }
+  return index;
+}
+
+/*
+ * @return position of last separator, length if there is none
+ */
+static inline u64
+PathLastIndexOfSeparator(u8 *bytes, u64 length)
+{
+  // position after bytes that are not searched yet
+  u64 end = length;
+
+#if defined(__AVX2__)
+  {
+    __m256i slashes = _mm256_set1_epi8('/');
+    __m256i separators = _mm256_set1_epi8(PATH_SEPARATOR);
+    for (; end >= 32; end -= 32) {
+      __m256i chunk = _mm256_loadu_si256((__m256i *)(bytes + end - 32));
+      u32 mask = (u32)_mm256_movemask_epi8(
+          _mm256_or_si256(_mm256_cmpeq_epi8(chunk, slashes), _mm256_cmpeq_epi8(chunk, separators)));
+      if (mask)
+        return end - 1 - (u64)__builtin_clz(mask);
+    }
+  }
+#endif
+
+#if defined(__SSE2__)
+  {
+    __m128i slashes = _mm_set1_epi8('/');
+    __m128i separators = _mm_set1_epi8(PATH_SEPARATOR);
+    for (; end >= 16; end -= 16) {
+      __m128i chunk = _mm_loadu_si128((__m128i *)(bytes + end - 16));
+      u32 mask = (u32)_mm_movemask_epi8(
+          _mm_or_si128(_mm_cmpeq_epi8(chunk, slashes), _mm_cmpeq_epi8(chunk, separators)));
+      // mask has 16 bits
+      if (mask)
+        return end - 1 - ((u64)__builtin_clz(mask) - 16);
+    }
+  }
+#endif
+
+  while (end != 0) {
+    end--;
+    if (IsPathSeparator(bytes[end]))
+      return end;
+  }
+  return length;
+}
+
+/*
+ * Length of root that path starts with, e.g. 1 for "/usr", 0 for "usr".
+ * On Windows also 3 for "C:\Users" and 2 for "C:Users".
+ */
+static inline u64
+PathRootLength(struct string *path)
+{
+  if (!path || path->length == 0)
+    return 0;
+
+#if IS_PLATFORM_WINDOWS
+  u8 drive = (u8)(path->value[0] | 0x20);
+  if (path->length >= 2 && drive >= 'a' && drive <= 'z' && path->value[1] == ':')
+    return (path->length >= 3 && IsPathSeparator(path->value[2])) ? 3 : 2;
+#endif
+
+  return IsPathSeparator(path->value[0]) ? 1 : 0;
+}
+
+/*
+ * @return 1 when path starts at root, e.g. "/usr" or "C:\Users"
+ */
+static inline b8
+IsPathAbsolute(struct string *path)
+{
+  u64 rootLength = PathRootLength(path);
+  return rootLength != 0 && IsPathSeparator(path->value[rootLength - 1]);
+}
+
+static inline struct string
+PathGetDirectory(struct string *path)
+{
+  struct string directory = StringNull();
+
+  if (!path || !path->value || path->length == 0)
+    return directory;
+
+  u64 lastSlashIndex = PathLastIndexOfSeparator(path->value, path->length);
+  // if slash not found
+  if (lastSlashIndex == path->length)
+    return directory;
+
+  directory.value = path->value;
+  directory.length = lastSlashIndex;
+  if (directory.length == 0)
+    directory.length++;
+  return directory;
+}
+
+struct path_iterator {
+  struct string *path;
+  u64 position;
+};
+
+/*
+ * Iterates components of path without copying them. Root and empty
+ * components from repeated or trailing separators are skipped, so
+ * "/usr//lib/" yields "usr" and "lib".
+ * @see IsPathAbsolute()
+ *
+ * @code
+ *   struct path_iterator iterator = PathIteratorFrom(&path);
+ *   struct string component;
+ *   while (PathIteratorNext(&iterator, &component)) {
+ *     ...
+ *   }
+ * @endcode
+ */
+static inline struct path_iterator
+PathIteratorFrom(struct string *path)
+{
+  debug_assert(path != 0);
+  return (struct path_iterator){
+      .path = path,
+      .position = PathRootLength(path),
+  };
+}
+
+/*
+ * @param component next component of path
+ * @return 1 when there is a component, 0 when all path is iterated
+ */
+static inline b8
+PathIteratorNext(struct path_iterator *iterator, struct string *component)
+{
+  struct string *path = iterator->path;
+  while (iterator->position < path->length && IsPathSeparator(path->value[iterator->position]))
+    iterator->position++;
+  if (iterator->position >= path->length)
+    return 0;
+
+  u8 *start = path->value + iterator->position;
+  u64 length = PathIndexOfSeparator(start, path->length - iterator->position);
+  iterator->position += length;
+  *component = StringFromBuffer(start, length);
+  return 1;
+}
+
+/*
+ * Normalizes path lexically in place. Repeated separators are collapsed,
+ * "." components and trailing separators are removed, and ".." removes
+ * component before it. Leading ".." is kept for relative paths and dropped
+ * at root. Symbolic links are not resolved, so "a/link/.." may name a
+ * different directory after normalization.
+ * Components are joined with PATH_SEPARATOR. Path that is already normal is
+ * not changed.
+ *
+ * @return normalized path, which starts at same place as input,
+ *         "." when nothing is left of relative path,
+ *         null when path is null or empty
+ *
+ * @code
+ *   // path is "/usr//./local/../lib/", normalized is "/usr/lib"
+ *   struct string normalized = PathNormalize(&path);
+ * @endcode
+ */
+static inline struct string
+PathNormalize(struct string *path)
+{
+  struct string result = StringNull();
+  if (!path || IsStringNull(path) || path->length == 0)
+    return result;
+
+  u8 *value = path->value;
+  u64 rootLength = PathRootLength(path);
+  b8 isAbsolute = IsPathAbsolute(path);
+  if (isAbsolute && value[rootLength - 1] != PATH_SEPARATOR)
+    value[rootLength - 1] = PATH_SEPARATOR;
+  u64 write = rootLength;
+
+  struct path_iterator iterator = PathIteratorFrom(path);
+  struct string component;
+  while (PathIteratorNext(&iterator, &component)) {
+    if (component.length == 1 && component.value[0] == '.')
+      continue;
+
+    if (component.length == 2 && component.value[0] == '.' && component.value[1] == '.') {
+      // start of last written component
+      u64 last = rootLength;
+      if (write > rootLength) {
+        u64 separatorIndex = PathLastIndexOfSeparator(value + rootLength, write - rootLength);
+        if (separatorIndex != write - rootLength)
+          last = rootLength + separatorIndex + 1;
+      }
+      b8 isLastParent = write - last == 2 && value[last] == '.' && value[last + 1] == '.';
+      if (write > rootLength && !isLastParent) {
+        // remove separator before it too
+        write = last > rootLength ? last - 1 : rootLength;
+        continue;
+      }
+      if (isAbsolute)
+        continue;
+    }
+
+    if (write > rootLength)
+      value[write++] = PATH_SEPARATOR;
+    if (value + write != component.value)
+      MemoryMove(value + write, component.value, component.length);
+    write += component.length;
+  }
+
+  if (write == 0) {
+    value[0] = '.';
+    write = 1;
+  }
+
+  result.value = value;
+  result.length = write;
+  return result;
+}
+
+/*
+ * Finds first occurence of search text in string.
+ * Candidates are filtered by comparing first and last byte of search text
+ * 16 or 32 positions at a time, only matching candidates are compared fully.
+ * @param index position of first occurence, only set when found
+ * @return 1 when search text found, 0 otherwise
+ */
+static inline b8
+StringIndexOf(struct string *string, struct string *search, u64 *index)
+{
+  if (!string || !search || search->length == 0 || string->length < search->length)
+    return 0;
+
+  u8 *haystack = string->value;
+  u8 *needle = search->value;
+  u64 needleLength = search->length;
+  // position after last possible start of search text
+  u64 end = string->length - needleLength + 1;
+  u8 first = needle[0];
+  u8 last = needle[needleLength - 1];
+  u64 position = 0;
+
+#if defined(__AVX2__)
+  {
+    __m256i firstBytes = _mm256_set1_epi8((char)first);
+    __m256i lastBytes = _mm256_set1_epi8((char)last);
+    for (; position + 32 <= end; position += 32) {
+      __m256i blockFirst = _mm256_loadu_si256((__m256i *)(haystack + position));
+      __m256i blockLast = _mm256_loadu_si256((__m256i *)(haystack + position + needleLength - 1));
+      u32 mask = (u32)_mm256_movemask_epi8(
+          _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, firstBytes), _mm256_cmpeq_epi8(blockLast, lastBytes)));
+      while (mask) {
+        u64 candidate = position + (u64)__builtin_ctz(mask);
+        if (needleLength <= 2 || IsMemoryEqual(haystack + candidate + 1, needle + 1, needleLength - 2)) {
+          *index = candidate;
+          return 1;
+        }
+        mask &= mask - 1;
+      }
+    }
+  }
+#endif
+
+#if defined(__SSE2__)
+  {
+    __m128i firstBytes = _mm_set1_epi8((char)first);
+    __m128i lastBytes = _mm_set1_epi8((char)last);
+    for (; position + 16 <= end; position += 16) {
+      __m128i blockFirst = _mm_loadu_si128((__m128i *)(haystack + position));
+      __m128i blockLast = _mm_loadu_si128((__m128i *)(haystack + position + needleLength - 1));
+      u32 mask = (u32)_mm_movemask_epi8(
+          _mm_and_si128(_mm_cmpeq_epi8(blockFirst, firstBytes), _mm_cmpeq_epi8(blockLast, lastBytes)));
+      while (mask) {
+        u64 candidate = position + (u64)__builtin_ctz(mask);
+        if (needleLength <= 2 || IsMemoryEqual(haystack + candidate + 1, needle + 1, needleLength - 2)) {
+          *index = candidate;
+          return 1;
+        }
+        mask &= mask - 1;
+      }
+    }
+  }
+#endif
+
+  for (; position < end; position++) {
+    if (haystack[position] != first || haystack[position + needleLength - 1] != last)
+      continue;
+    if (needleLength <= 2 || IsMemoryEqual(haystack + position + 1, needle + 1, needleLength - 2)) {
+      *index = position;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * Strips whitespace from both ends of every line in place, e.g. before
+ * parsing config or CSV. Lines are separated by line feed, carriage return is
+ * stripped as whitespace. Empty lines are kept so line numbers do not change.
+ * @return sub string of string with stripped lines, null if nothing is left
+ */
+static inline struct string
+StringStripLines(struct string *string)
+{
+  if (!string || string->length == 0)
+    return StringNull();
+
+  struct string *newline = &StringFromLiteral("\n");
+  u8 *output = string->value;
+  u64 position = 0;
+  while (1) {
+    struct string rest = StringFromBuffer(string->value + position, string->length - position);
+    u64 lineLength;
+    b8 isNewlineFound = StringIndexOf(&rest, newline, &lineLength);
+    if (!isNewlineFound)
+      lineLength = rest.length;
+
+    struct string line = StringFromBuffer(rest.value, lineLength);
+    struct string stripped = StringStripWhitespace(&line);
+    if (stripped.length != 0) {
+      MemoryMove(output, stripped.value, stripped.length);
+      output += stripped.length;
+    }
+
+    if (!isNewlineFound)
+      break;
+
+    *output++ = '\n';
+    position += lineLength + 1;
+  }
+
+  u64 length = (u64)(output - string->value);
+  if (length == 0)
+    return StringNull();
+  return StringFromBuffer(string->value, length);
+}
+
+/*
+ * Splits string into multiple strings.
+ * When splits array is empty, number of parts string can be split returned in splitCount.
+ * @param string string to be split
+ * @param splitCount how many different parts are in string. [1,∞]
+ * @param splits pointer to array of strings.
+ * @return 1 when string can be split into parts, 0 otherwise.
+ * @code
+ *   u64 splitCount;
+ *   string *separator = &StringFromLiteral(" ");
+ *   if (!StringSplit(string, separator, &splitCount, 0))
+ *     return;
+ *   string *splits = MemoryArenaPush(arena, sizeof(*splits) * splitCount);
+ *   StringSplit(string, separator, &splitCount, splits);
+ * @endcode
+ * @see StringSplitIteratorFrom() for splitting in one pass without array of parts
+ */
+static inline b8
+StringSplit(struct string *string, struct string *separator, u64 *splitCount, struct string *splits)
+{
+  debug_assert(splitCount && "only splits can be null");
+
+  if (!string || !splitCount)
+    return 0;
+
+  b8 isCalculatingSplitCount = splits == 0;
+  if (isCalculatingSplitCount) {
+    u64 count = 0;
+    for (u64 index = 0; index < string->length;) {
+      struct string substring = StringFromBuffer(string->value + index, separator->length);
+
+      if (separator->length > string->length - index) {
+        if (count == 0)
+          // no separator found
+          return 0;
+        break;
+      }
+
+      if (IsStringEqual(&substring, separator)) {
+        count++;
+        index += separator->length;
+      } else {
+        index++;
+      }
+    }
+    *splitCount = count + 1;
+  } else {
+    u64 startIndex = 0;
+    u64 splitIndex = 0;
+
+    for (u64 index = 0; index < string->length;) {
+      struct string substring = StringFromBuffer(string->value + index, separator->length);
+      if (separator->length > string->length - index)
+        break;
+
+      if (IsStringEqual(&substring, separator)) {
+        struct string split = StringFromBuffer(string->value + startIndex, index - startIndex);
+        if (split.length == 0)
+          split.value = 0;
+        *(splits + splitIndex) = split;
+        splitIndex++;
+        index += separator->length;
+        startIndex = index;
+      } else {
+        index++;
+      }
+    }
+
+    // last one
+    struct string lastSplit = StringFromBuffer(string->value + startIndex, string->length - startIndex);
+    if (lastSplit.length == 0)
+      lastSplit.value = 0;
+    *(splits + splitIndex) = lastSplit;
+    debug_assert(splitIndex + 1 == *splitCount);
+  }
+
+  return 1;
+}
+
+static inline b8
+StringSplitBySpace(struct string *string, u64 *splitCount, struct string *splits)
+{
+  return StringSplit(string, &StringFromLiteral(" "), splitCount, splits);
+}
+
+enum string_split_flag {
+  STRING_SPLIT_FLAG_NONE = 0,
+  // Do not yield empty parts, e.g. when separators are next to each other.
+  // Skipped parts are not counted as split.
+  STRING_SPLIT_FLAG_SKIP_EMPTY = (1 << 0),
+};
+
+struct string_split_iterator {
+  struct string *string;
+  struct string *separator;
+  u64 position;
+  // 0 means no limit
+  u64 maxSplitCount;
+  u64 splitCount;
+  u32 flags;
+  b8 isDone;
+  u8 _padding[3];
+};
+
+typedef struct string_split_iterator string_split_iterator;
+
+/*
+ * Splits string into parts one at a time, without counting them first.
+ * Parts are same as StringSplit(), empty ones are null strings.
+ * Unlike StringSplit(), a string without separator yields itself as only part.
+ * @param maxSplitCount after this many splits rest of string is yielded as last part.
+ *                      0 means no limit.
+ * @param flags see enum string_split_flag
+ * @code
+ *   struct string_split_iterator iterator = StringSplitIteratorFrom(string, &StringFromLiteral(" "), 0, 0);
+ *   struct string split;
+ *   while (StringSplitIteratorNext(&iterator, &split)) {
+ *     ...
+ *   }
+ * @endcode
+ */
+static inline struct string_split_iterator
+StringSplitIteratorFrom(struct string *string, struct string *separator, u64 maxSplitCount, u32 flags)
+{
+  debug_assert(string != 0 && separator != 0 && separator->length != 0);
+  return (struct string_split_iterator){
+      .string = string,
+      .separator = separator,
+      .position = 0,
+      .maxSplitCount = maxSplitCount,
+      .splitCount = 0,
+      .flags = flags,
+      .isDone = 0,
+  };
+}
+
+/*
+ * @param split next part of string
+ * @return 1 when there is a part, 0 when all string is split
+ */
+static inline b8
+StringSplitIteratorNext(struct string_split_iterator *iterator, struct string *split)
+{
+  if (iterator->isDone)
+    return 0;
+
+  struct string *string = iterator->string;
+  struct string *separator = iterator->separator;
+  b8 isSkippingEmpty = (iterator->flags & STRING_SPLIT_FLAG_SKIP_EMPTY) != 0;
+
+  if (isSkippingEmpty) {
+    while (string->length - iterator->position >= separator->length &&
+           IsMemoryEqual(string->value + iterator->position, separator->value, separator->length))
+      iterator->position += separator->length;
+
+    if (iterator->position == string->length) {
+      iterator->isDone = 1;
+      return 0;
+    }
+  }
+
+  struct string remaining = {
+      .value = string->value + iterator->position,
+      .length = string->length - iterator->position,
+  };
+  b8 isLimitReached = iterator->maxSplitCount != 0 && iterator->splitCount == iterator->maxSplitCount;
+  u64 index;
+  if (isLimitReached || !StringIndexOf(&remaining, separator, &index)) {
+    // last part
+    iterator->isDone = 1;
+    iterator->position = string->length;
+    *split = remaining;
+  } else {
+    iterator->splitCount++;
+    iterator->position += index + separator->length;
+    *split = StringFromBuffer(remaining.value, index);
+  }
+
+  if (split->length == 0)
+    split->value = 0;
+  return 1;
+}
+
+struct string_cut {
+  struct string before;
+  struct string after;
+  b8 ok;
+  u8 _padding[7];
+};
+typedef struct string_cut string_cut;
+
+static inline struct string_cut
+StringCut(struct string *string, struct string *separator)
+{
+  struct string_cut result = {
+      .ok = 0,
+  };
+  if (!string)
+    return result;
+
+  for (u64 index = 0; index < string->length; index++) {
+    struct string substring = StringFromBuffer(string->value + index, separator->length);
+    if (separator->length > string->length - index)
+      break;
+
+    if (IsStringEqual(&substring, separator)) {
+      result.ok = 1;
+      result.before = StringFromBuffer(string->value, index);
+      result.after =
+          StringFromBuffer(string->value + (index + separator->length), string->length - (index + separator->length));
+      break;
+    }
+  }
+
+  return result;
+}
+
+enum percent_decode_flag {
+  PERCENT_DECODE_FLAG_NONE = 0,
+  // '+' is decoded as space, as in query strings of HTML forms
+  PERCENT_DECODE_FLAG_PLUS_AS_SPACE = (1 << 0),
+};
+
+/*
+ * @param plus '+' when plus is decoded, '%' otherwise
+ * @return position of first '%' or plus, length if there is none
+ */
+static inline u64
+PercentDecodeIndexOfEscape(u8 *bytes, u64 length, u8 plus)
+{
+  u64 index = 0;
+
+#if defined(__AVX2__)
+  {
+    __m256i percents = _mm256_set1_epi8('%');
+    __m256i pluses = _mm256_set1_epi8((char)plus);
+    for (; index + 32 <= length; index += 32) {
+      __m256i chunk = _mm256_loadu_si256((__m256i *)(bytes + index));
+      u32 mask = (u32)_mm256_movemask_epi8(
+          _mm256_or_si256(_mm256_cmpeq_epi8(chunk, percents), _mm256_cmpeq_epi8(chunk, pluses)));
+      if (mask)
+        return index + (u64)__builtin_ctz(mask);
+    }
+  }
+#endif
+
+#if defined(__SSE2__)
+  {
+    __m128i percents = _mm_set1_epi8('%');
+    __m128i pluses = _mm_set1_epi8((char)plus);
+    for (; index + 16 <= length; index += 16) {
+      __m128i chunk = _mm_loadu_si128((__m128i *)(bytes + index));
+      u32 mask = (u32)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, percents), _mm_cmpeq_epi8(chunk, pluses)));
+      if (mask)
+        return index + (u64)__builtin_ctz(mask);
+    }
+  }
+#endif
+
+  for (; index < length; index++) {
+    if (bytes[index] == '%' || bytes[index] == plus)
+      break;
+  }
+  return index;
+}
+
+/*
+ * Decodes %XX sequences in place. Runs without escapes are found 16 or 32
+ * bytes at a time and moved as one block.
+ * On failure string is left partially decoded.
+ *
+ * @param flags see enum percent_decode_flag
+ * @param errorIndex optional, on failure set to position of '%' that is not
+ *                   followed by two hex digits
+ * @return decoded string, which starts at same place as input,
+ *         null on failure
+ *
+ * @code
+ *   // "a b/c"
+ *   struct string decoded = PercentDecode(&string, PERCENT_DECODE_FLAG_PLUS_AS_SPACE, 0);
+ * @endcode
+ */
+static inline struct string
+PercentDecode(struct string *string, u32 flags, u64 *errorIndex)
+{
+  struct string result = StringNull();
+  if (!string || IsStringNull(string))
+    return result;
+
+  u8 *value = string->value;
+  u64 length = string->length;
+  u8 plus = (flags & PERCENT_DECODE_FLAG_PLUS_AS_SPACE) ? '+' : '%';
+
+  u64 read = PercentDecodeIndexOfEscape(value, length, plus);
+  u64 write = read;
+  while (read < length) {
+    if (value[read] == '+') {
+      value[write++] = ' ';
+      read++;
+    } else {
+      s8 high = read + 2 < length ? ASCIItoHEX[value[read + 1]] : -1;
+      s8 low = read + 2 < length ? ASCIItoHEX[value[read + 2]] : -1;
+      if ((high | low) < 0) {
+        if (errorIndex)
+          *errorIndex = read;
+        return result;
+      }
+      value[write++] = (u8)((high << 4) | low);
+      read += 3;
+    }
+
+    u64 runLength = PercentDecodeIndexOfEscape(value + read, length - read, plus);
+    MemoryMove(value + write, value + read, runLength);
+    write += runLength;
+    read += runLength;
+  }
+
+  result.value = value;
+  result.length = write;
+  return result;
+}
+
+enum url_character_class {
+  // ALPHA DIGIT + - .
+  URL_CHARACTER_CLASS_SCHEME = (1 << 0),
+  // unreserved, sub-delims, ':'
+  URL_CHARACTER_CLASS_USER_INFO = (1 << 1),
+  // unreserved, sub-delims
+  URL_CHARACTER_CLASS_HOST = (1 << 2),
+  // unreserved, sub-delims, ':', '@', '/'
+  URL_CHARACTER_CLASS_PATH = (1 << 3),
+  // path characters and '?', also used for fragment
+  URL_CHARACTER_CLASS_QUERY = (1 << 4),
+};
+
+/*
+ * Classes of each character, see enum url_character_class.
+ */
+comptime u8 URL_CHARACTER_CLASSES[256] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x00
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x10
+    0x00, 0x1e, 0x00, 0x00, 0x1e, 0x00, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1f, 0x1e, 0x1f, 0x1f, 0x18, // 0x20
+    0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1a, 0x1e, 0x00, 0x1e, 0x00, 0x10, // 0x30
+    0x18, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, // 0x40
+    0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x1e, // 0x50
+    0x00, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, // 0x60
+    0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x1f, 0x00, 0x00, 0x00, 0x1e, 0x00, // 0x70
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x80
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x90
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0xa0
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0xb0
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0xc0
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0xd0
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0xe0
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  // 0xf0
+};
+/*
+ * Components of URL. They point into parsed string, nothing is decoded.
+ * Missing components are null strings, present ones may be empty,
+ * e.g. "http://host?" has empty query.
+ */
+struct url {
+  struct string scheme;
+  // without '@', e.g. "user:password"
+  struct string userInfo;
+  // without brackets for IPv6 address
+  struct string host;
+  // digits only
+  struct string port;
+  struct string path;
+  // without '?'
+  struct string query;
+  // without '#'
+  struct string fragment;
+};
+
+/*
+ * @return 1 if every character of component is in class and every '%' is
+ *         followed by two hex digits
+ */
+static inline b8
+URLValidateComponent(struct string *component, u8 characterClass, u8 *start, u64 *errorIndex)
+{
+  for (u64 index = 0; index < component->length; index++) {
+    u8 character = component->value[index];
+    if (character == '%' && characterClass != URL_CHARACTER_CLASS_SCHEME && index + 2 < component->length &&
+        (ASCIItoHEX[component->value[index + 1]] | ASCIItoHEX[component->value[index + 2]]) >= 0) {
+      index += 2;
+      continue;
+    }
+
+    if (!(URL_CHARACTER_CLASSES[character] & characterClass)) {
+      if (errorIndex)
+        *errorIndex = (u64)(component->value + index - start);
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/*
+ * @return 1 if address is IPv6 address as in RFC 3986, 8 groups of 1 to 4 hex
+ *         digits, at most one "::" for one or more zero groups and dotted
+ *         quad only as last two groups, e.g. "::ffff:192.0.2.1"
+ */
+static inline b8
+URLValidateIPv6(struct string *address, u8 *start, u64 *errorIndex)
+{
+  u8 *value = address->value;
+  u64 length = address->length;
+  u64 groupCount = 0;
+  b8 isCompressed = 0;
+  u64 index = 0;
+  if (length >= 2 && value[0] == ':' && value[1] == ':') {
+    isCompressed = 1;
+    index = 2;
+  }
+
+  while (index < length) {
+    u64 groupStart = index;
+    while (index < length && ASCIItoHEX[value[index]] >= 0)
+      index++;
+
+    if (index < length && value[index] == '.') {
+      // dotted quad, 4 decimal octets without leading zeros
+      index = groupStart;
+      for (u32 octet = 0; octet < 4; octet++) {
+        if (octet != 0) {
+          if (index == length || value[index] != '.')
+            goto error;
+          index++;
+        }
+        u64 octetStart = index;
+        u32 number = 0;
+        while (index < length && (u8)(value[index] - '0') <= 9 && index - octetStart < 3)
+          number = number * 10 + (u32)(value[index++] - '0');
+        if (index == octetStart || number > 255 || (value[octetStart] == '0' && index - octetStart > 1)) {
+          index = octetStart;
+          goto error;
+        }
+      }
+      if (index != length)
+        goto error;
+      groupCount += 2;
+      break;
+    }
+
+    if (index == groupStart || index - groupStart > 4) {
+      index = index == groupStart ? index : groupStart + 4;
+      goto error;
+    }
+    groupCount++;
+    if (index == length)
+      break;
+    if (value[index] != ':')
+      goto error;
+    index++;
+    if (index < length && value[index] == ':') {
+      if (isCompressed)
+        goto error;
+      isCompressed = 1;
+      index++;
+    } else if (index == length) {
+      goto error;
+    }
+  }
+
+  if (isCompressed ? groupCount <= 7 : groupCount == 8)
+    return 1;
+  index = length;
+
+error:
+  if (errorIndex)
+    *errorIndex = (u64)(value + index - start);
+  return 0;
+}
+
+/*
+ * Parses absolute URL or relative reference as in RFC 3986, e.g.
+ * "https://user@example.com:8080/a/b?x=1#top", "//example.com/",
+ * "/index.html?q=2" and "[::1]" in "http://[::1]:80/".
+ * Characters are validated, but percent escapes are not decoded.
+ * @see PercentDecode()
+ *
+ * @param errorIndex optional, on failure set to position of first invalid
+ *                   character
+ * @return 1 when string is valid URL
+ */
+static inline b8
+URLParse(struct string *string, struct url *url, u64 *errorIndex)
+{
+  *url = (struct url){0};
+  if (!string || IsStringNull(string))
+    return 0;
+
+  u8 *start = string->value;
+  u64 length = string->length;
+  u64 position = 0;
+
+  // scheme is before ':' that comes before any of "/?#"
+  for (u64 index = 0; index < length; index++) {
+    u8 character = start[index];
+    if (character == '/' || character == '?' || character == '#')
+      break;
+    if (character == ':') {
+      url->scheme = StringFromBuffer(start, index);
+      // must start with letter
+      u8 first = index != 0 ? (u8)(start[0] | 0x20) : 0;
+      if (first < 'a' || first > 'z') {
+        if (errorIndex)
+          *errorIndex = 0;
+        return 0;
+      }
+      if (!URLValidateComponent(&url->scheme, URL_CHARACTER_CLASS_SCHEME, start, errorIndex))
+        return 0;
+      position = index + 1;
+      break;
+    }
+  }
+
+  // authority
+  if (position + 2 <= length && start[position] == '/' && start[position + 1] == '/') {
+    position += 2;
+    u64 end = position;
+    while (end < length && start[end] != '/' && start[end] != '?' && start[end] != '#')
+      end++;
+    struct string authority = StringFromBuffer(start + position, end - position);
+
+    u64 atIndex;
+    if (StringIndexOf(&authority, &StringFromLiteral("@"), &atIndex)) {
+      url->userInfo = StringFromBuffer(authority.value, atIndex);
+      if (!URLValidateComponent(&url->userInfo, URL_CHARACTER_CLASS_USER_INFO, start, errorIndex))
+        return 0;
+      authority = StringFromBuffer(authority.value + atIndex + 1, authority.length - atIndex - 1);
+    }
+
+    u64 hostLength = authority.length;
+    if (authority.length != 0 && authority.value[0] == '[') {
+      // IPv6 address
+      u64 closeIndex = 1;
+      while (closeIndex < authority.length && authority.value[closeIndex] != ']') {
+        u8 character = authority.value[closeIndex];
+        if (ASCIItoHEX[character] < 0 && character != ':' && character != '.') {
+          if (errorIndex)
+            *errorIndex = (u64)(authority.value + closeIndex - start);
+          return 0;
+        }
+        closeIndex++;
+      }
+      if (closeIndex == authority.length) {
+        if (errorIndex)
+          *errorIndex = (u64)(authority.value + closeIndex - start);
+        return 0;
+      }
+      url->host = StringFromBuffer(authority.value + 1, closeIndex - 1);
+      if (!URLValidateIPv6(&url->host, start, errorIndex))
+        return 0;
+      hostLength = closeIndex + 1;
+    } else {
+      for (hostLength = 0; hostLength < authority.length && authority.value[hostLength] != ':'; hostLength++)
+        ;
+      url->host = StringFromBuffer(authority.value, hostLength);
+      if (!URLValidateComponent(&url->host, URL_CHARACTER_CLASS_HOST, start, errorIndex))
+        return 0;
+    }
+
+    if (hostLength < authority.length) {
+      if (authority.value[hostLength] != ':') {
+        if (errorIndex)
+          *errorIndex = (u64)(authority.value + hostLength - start);
+        return 0;
+      }
+      url->port = StringFromBuffer(authority.value + hostLength + 1, authority.length - hostLength - 1);
+      for (u64 index = 0; index < url->port.length; index++) {
+        u8 digit = url->port.value[index];
+        if (digit < '0' || digit > '9') {
+          if (errorIndex)
+            *errorIndex = (u64)(url->port.value + index - start);
+          return 0;
+        }
+      }
+    }
+
+    position = end;
+  }
+
+  u64 end = position;
+  while (end < length && start[end] != '?' && start[end] != '#')
+    end++;
+  url->path = StringFromBuffer(start + position, end - position);
+  if (!URLValidateComponent(&url->path, URL_CHARACTER_CLASS_PATH, start, errorIndex))
+    return 0;
+  position = end;
+
+  if (position < length && start[position] == '?') {
+    position++;
+    end = position;
+    while (end < length && start[end] != '#')
+      end++;
+    url->query = StringFromBuffer(start + position, end - position);
+    if (!URLValidateComponent(&url->query, URL_CHARACTER_CLASS_QUERY, start, errorIndex))
+      return 0;
+    position = end;
+  }
+
+  if (position < length) {
+    // '#'
+    position++;
+    url->fragment = StringFromBuffer(start + position, length - position);
+    if (!URLValidateComponent(&url->fragment, URL_CHARACTER_CLASS_QUERY, start, errorIndex))
+      return 0;
+  }
+
+  return 1;
+}
+
+struct url_query_iterator {
+  struct string query;
+  u64 position;
+};
+
+/*
+ * Iterates "key=value" parameters of query separated by '&'.
+ * Empty parameters are skipped. Keys and values are not decoded.
+ *
+ * @code
+ *   struct url_query_iterator iterator = URLQueryIteratorFrom(&url.query);
+ *   struct string key, value;
+ *   while (URLQueryIteratorNext(&iterator, &key, &value)) {
+ *     key = PercentDecode(&key, PERCENT_DECODE_FLAG_PLUS_AS_SPACE, 0);
+ *     ...
+ *   }
+ * @endcode
+ */
+static inline struct url_query_iterator
+URLQueryIteratorFrom(struct string *query)
+{
+  return (struct url_query_iterator){.query = *query, .position = 0};
+}
+
+/*
+ * @param value null when parameter has no '=', empty when it is "key="
+ * @return 1 when there is a parameter, 0 when all query is iterated
+ */
+static inline b8
+URLQueryIteratorNext(struct url_query_iterator *iterator, struct string *key, struct string *value)
+{
+  struct string *query = &iterator->query;
+  while (iterator->position < query->length && query->value[iterator->position] == '&')
+    iterator->position++;
+  if (iterator->position >= query->length)
+    return 0;
+
+  struct string remaining = StringFromBuffer(query->value + iterator->position, query->length - iterator->position);
+  u64 parameterLength = remaining.length;
+  StringIndexOf(&remaining, &StringFromLiteral("&"), &parameterLength);
+  struct string parameter = StringFromBuffer(remaining.value, parameterLength);
+  iterator->position += parameterLength;
+
+  u64 equalIndex;
+  if (StringIndexOf(&parameter, &StringFromLiteral("="), &equalIndex)) {
+    *key = StringFromBuffer(parameter.value, equalIndex);
+    *value = StringFromBuffer(parameter.value + equalIndex + 1, parameter.length - equalIndex - 1);
+  } else {
+    *key = parameter;
+    *value = StringNull();
+  }
+  return 1;
+}
+
+struct string_iterator {
+  struct string *string;
+  u64 index;
+};
+
+static inline struct string_iterator
+StringIteratorFrom(struct string *string)
+{
+  debug_assert(string != 0 && string->length != 0 && "null/empty string given to iterate");
+  return (struct string_iterator){
+      .string = string,
+      .index = 0,
+  };
+}
+
+static inline b8
+StringIteratorHasNext(struct string_iterator *iterator)
+{
+  return iterator->index < iterator->string->length;
+}
+
+static inline u32
+StringIteratorNext(struct string_iterator *iterator)
+{
+  u8 *bytes = iterator->string->value + iterator->index;
+
+  u8 byte = *bytes;
+  b8 v01 = ((byte & 0b10000000) >> 7) & ((byte & 0b01000000) >> 6);
+  b8 v2 = (byte & 0b00100000) >> 5;
+  b8 v3 = (byte & 0b00010000) >> 4;
+  u8 codepointWidth = 1 + (u8)((v01 << v2) | (v01 & v3));
+
+  u32 codepoint = byte & (0b01111111 >> (codepointWidth & -v01));
+  for (u8 byteIndex = 1; byteIndex < codepointWidth; byteIndex++) {
+    byte = *(bytes + byteIndex);
+    codepoint <<= 6;
+    codepoint |= (byte & 0b00111111);
+  }
+
+  iterator->index += codepointWidth;
+  return codepoint;
+}
+
+/*
+ * Counts codepoints in UTF-8 encoded string.
+ * Every byte that is not a continuation byte (10xxxxxx) starts a codepoint,
+ * so for valid UTF-8 counting them gives the codepoint count.
+ */
+static inline u64
+StringLength(struct string *string)
+{
+  u64 length = 0;
+  u8 *bytes = string->value;
+  u64 index = 0;
+
+#if defined(__AVX2__)
+  // continuation bytes are [0x80, 0xbf] which is [-128, -65] as signed
+  __m256i continuationMax = _mm256_set1_epi8(-65);
+  for (; index + 64 <= string->length; index += 64) {
+    __m256i low = _mm256_loadu_si256((__m256i *)(bytes + index));
+    __m256i high = _mm256_loadu_si256((__m256i *)(bytes + index + 32));
+    u64 lowMask = (u32)_mm256_movemask_epi8(_mm256_cmpgt_epi8(low, continuationMax));
+    u64 highMask = (u32)_mm256_movemask_epi8(_mm256_cmpgt_epi8(high, continuationMax));
+    length += (u64)__builtin_popcountll(lowMask | (highMask << 32));
+  }
+#endif
+
+#if defined(__SSE2__)
+  __m128i continuationMax128 = _mm_set1_epi8(-65);
+  for (; index + 32 <= string->length; index += 32) {
+    __m128i low = _mm_loadu_si128((__m128i *)(bytes + index));
+    __m128i high = _mm_loadu_si128((__m128i *)(bytes + index + 16));
+    u32 lowMask = (u32)_mm_movemask_epi8(_mm_cmpgt_epi8(low, continuationMax128));
+    u32 highMask = (u32)_mm_movemask_epi8(_mm_cmpgt_epi8(high, continuationMax128));
+    length += (u64)__builtin_popcount(lowMask | (highMask << 16));
+  }
+#endif
+
+  for (; index < string->length; index++) {
+    u8 byte = bytes[index];
+    length += (byte & 0b11000000) != 0b10000000;
+  }
+
+  return length;
+}
+
+/*
+ * UTF-8 validation using lookup algorithm by John Keiser and Daniel Lemire.
+ * Every byte pair is classified by high nibble of first byte, low nibble of
+ * first byte and high nibble of second byte. Each table marks which errors
+ * are possible for that nibble, a byte pair is invalid when all three agree.
+ * Vector paths are chosen at compile time, build with -Dmarch=native (or
+ * haswell for AVX2) to use them, default x86-64 build only has SSE2.
+ * @see https://arxiv.org/abs/2010.03090
+ */
+enum utf8_error {
+  // 11______ 0_______
+  // 11______ 11______
+  UTF8_ERROR_TOO_SHORT = (1 << 0),
+  // 0_______ 10______
+  UTF8_ERROR_TOO_LONG = (1 << 1),
+  // 11100000 100_____
+  UTF8_ERROR_OVERLONG_3 = (1 << 2),
+  // 11110100 1001____
+  // 11110100 101_____
+  // 11110101 1001____
+  // 11110101 101_____
+  // 1111011_ 1001____
+  // 1111011_ 101_____
+  // 11111___ 1001____
+  // 11111___ 101_____
+  UTF8_ERROR_TOO_LARGE = (1 << 3),
+  // 11101101 101_____
+  UTF8_ERROR_SURROGATE = (1 << 4),
+  // 1100000_ 10______
+  UTF8_ERROR_OVERLONG_2 = (1 << 5),
+  // 11110101 1000____
+  // 1111011_ 1000____
+  // 11111___ 1000____
+  // and shares bit with
+  // 11110000 1000____
+  UTF8_ERROR_TOO_LARGE_1000 = (1 << 6),
+  UTF8_ERROR_OVERLONG_4 = (1 << 6),
+  // 10______ 10______
+  UTF8_ERROR_TWO_CONTINUATIONS = (1 << 7),
+  // errors that do not depend on low nibble of first byte
+  UTF8_ERROR_CARRY = UTF8_ERROR_TOO_SHORT | UTF8_ERROR_TOO_LONG | UTF8_ERROR_TWO_CONTINUATIONS,
+};
+
+comptime u8 UTF8_ERROR_BY_BYTE_1_HIGH[16] = {
+    // 0_______ ________ ASCII
+    UTF8_ERROR_TOO_LONG,
+    UTF8_ERROR_TOO_LONG,
+    UTF8_ERROR_TOO_LONG,
+    UTF8_ERROR_TOO_LONG,
+    UTF8_ERROR_TOO_LONG,
+    UTF8_ERROR_TOO_LONG,
+    UTF8_ERROR_TOO_LONG,
+    UTF8_ERROR_TOO_LONG,
+    // 10______ ________ continuation
+    UTF8_ERROR_TWO_CONTINUATIONS,
+    UTF8_ERROR_TWO_CONTINUATIONS,
+    UTF8_ERROR_TWO_CONTINUATIONS,
+    UTF8_ERROR_TWO_CONTINUATIONS,
+    // 1100____ ________ 2 byte lead
+    UTF8_ERROR_TOO_SHORT | UTF8_ERROR_OVERLONG_2,
+    // 1101____ ________ 2 byte lead
+    UTF8_ERROR_TOO_SHORT,
+    // 1110____ ________ 3 byte lead
+    UTF8_ERROR_TOO_SHORT | UTF8_ERROR_OVERLONG_3 | UTF8_ERROR_SURROGATE,
+    // 1111____ ________ 4+ byte lead
+    UTF8_ERROR_TOO_SHORT | UTF8_ERROR_TOO_LARGE | UTF8_ERROR_TOO_LARGE_1000 | UTF8_ERROR_OVERLONG_4,
+};
+
+comptime u8 UTF8_ERROR_BY_BYTE_1_LOW[16] = {
+    // ____0000 ________
+    UTF8_ERROR_CARRY | UTF8_ERROR_OVERLONG_3 | UTF8_ERROR_OVERLONG_2 | UTF8_ERROR_OVERLONG_4,
+    // ____0001 ________
+    UTF8_ERROR_CARRY | UTF8_ERROR_OVERLONG_2,
+    // ____001_ ________
+    UTF8_ERROR_CARRY,
+    UTF8_ERROR_CARRY,
+    // ____0100 ________
+    UTF8_ERROR_CARRY | UTF8_ERROR_TOO_LARGE,
+    // ____0101 ________
+    UTF8_ERROR_CARRY | UTF8_ERROR_TOO_LARGE | UTF8_ERROR_TOO_LARGE_1000,
+    // ____011_ ________
+    UTF8_ERROR_CARRY | UTF8_ERROR_TOO_LARGE | UTF8_ERROR_TOO_LARGE_1000,
+    UTF8_ERROR_CARRY | UTF8_ERROR_TOO_LARGE | UTF8_ERROR_TOO_LARGE_1000,
+    // ____1___ ________
+    UTF8_ERROR_CARRY | UTF8_ERROR_TOO_LARGE | UTF8_ERROR_TOO_LARGE_1000,
+    UTF8_ERROR_CARRY | UTF8_ERROR_TOO_LARGE | UTF8_ERROR_TOO_LARGE_1000,
+    UTF8_ERROR_CARRY | UTF8_ERROR_TOO_LARGE | UTF8_ERROR_TOO_LARGE_1000,
+    UTF8_ERROR_CARRY | UTF8_ERROR_TOO_LARGE | UTF8_ERROR_TOO_LARGE_1000,
+    UTF8_ERROR_CARRY | UTF8_ERROR_TOO_LARGE | UTF8_ERROR_TOO_LARGE_1000,
+    // ____1101 ________
+    UTF8_ERROR_CARRY | UTF8_ERROR_TOO_LARGE | UTF8_ERROR_TOO_LARGE_1000 | UTF8_ERROR_SURROGATE,
+    UTF8_ERROR_CARRY | UTF8_ERROR_TOO_LARGE | UTF8_ERROR_TOO_LARGE_1000,
+    UTF8_ERROR_CARRY | UTF8_ERROR_TOO_LARGE | UTF8_ERROR_TOO_LARGE_1000,
+};
+
+comptime u8 UTF8_ERROR_BY_BYTE_2_HIGH[16] = {
+    // ________ 0_______ ASCII
+    UTF8_ERROR_TOO_SHORT,
+    UTF8_ERROR_TOO_SHORT,
+    UTF8_ERROR_TOO_SHORT,
+    UTF8_ERROR_TOO_SHORT,
+    UTF8_ERROR_TOO_SHORT,
+    UTF8_ERROR_TOO_SHORT,
+    UTF8_ERROR_TOO_SHORT,
+    UTF8_ERROR_TOO_SHORT,
+    // ________ 1000____
+    UTF8_ERROR_TOO_LONG | UTF8_ERROR_OVERLONG_2 | UTF8_ERROR_TWO_CONTINUATIONS | UTF8_ERROR_OVERLONG_3 |
+        UTF8_ERROR_TOO_LARGE_1000 | UTF8_ERROR_OVERLONG_4,
+    // ________ 1001____
+    UTF8_ERROR_TOO_LONG | UTF8_ERROR_OVERLONG_2 | UTF8_ERROR_TWO_CONTINUATIONS | UTF8_ERROR_OVERLONG_3 |
+        UTF8_ERROR_TOO_LARGE,
+    // ________ 101_____
+    UTF8_ERROR_TOO_LONG | UTF8_ERROR_OVERLONG_2 | UTF8_ERROR_TWO_CONTINUATIONS | UTF8_ERROR_SURROGATE |
+        UTF8_ERROR_TOO_LARGE,
+    UTF8_ERROR_TOO_LONG | UTF8_ERROR_OVERLONG_2 | UTF8_ERROR_TWO_CONTINUATIONS | UTF8_ERROR_SURROGATE |
+        UTF8_ERROR_TOO_LARGE,
+    // ________ 11______ lead
+    UTF8_ERROR_TOO_SHORT,
+    UTF8_ERROR_TOO_SHORT,
+    UTF8_ERROR_TOO_SHORT,
+    UTF8_ERROR_TOO_SHORT,
+};
+
+/*
+ * Returns width of UTF-8 sequence that starts with byte, 0 if byte cannot
+ * start a well-formed sequence.
+ */
+static inline u32
+UTF8SequenceWidth(u8 byte)
+{
+  if (byte < 0x80)
+    return 1;
+  if (byte < 0xc2)
+    return 0;
+  if (byte < 0xe0)
+    return 2;
+  if (byte < 0xf0)
+    return 3;
+  if (byte < 0xf5)
+    return 4;
+  return 0;
+}
+
+/*
+ * Decodes one UTF-8 sequence, never reads past length.
+ * @param length bytes available, must be at least 1
+ * @return width of sequence, 0 if bytes do not start with a well-formed sequence
+ */
+static inline u32
+UTF8DecodeCodepoint(u8 *bytes, u64 length, u32 *codepoint)
+{
+  debug_assert(length > 0);
+  u8 byte = bytes[0];
+  if (byte < 0x80) {
+    *codepoint = byte;
+    return 1;
+  }
+
+  u32 width = UTF8SequenceWidth(byte);
+  if (width == 0 || width > length)
+    return 0;
+
+  u8 secondMin = 0x80;
+  u8 secondMax = 0xbf;
+  if (byte == 0xe0)
+    secondMin = 0xa0; // overlong
+  else if (byte == 0xed)
+    secondMax = 0x9f; // surrogate
+  else if (byte == 0xf0)
+    secondMin = 0x90; // overlong
+  else if (byte == 0xf4)
+    secondMax = 0x8f; // larger than U+10FFFF
+
+  u8 second = bytes[1];
+  if (second < secondMin || second > secondMax)
+    return 0;
+
+  u32 value = (u32)(byte & (0b01111111 >> width));
+  for (u32 byteIndex = 1; byteIndex < width; byteIndex++) {
+    u8 continuation = bytes[byteIndex];
+    if ((continuation & 0b11000000) != 0b10000000)
+      return 0;
+    value = (value << 6) | (continuation & 0b00111111);
+  }
+
+  *codepoint = value;
+  return width;
+}
+
+/*
+ * Encodes codepoint as UTF-8, dest needs at least 4 bytes.
+ * Codepoint must be a scalar value, not a surrogate and at most U+10FFFF.
+ * @return width of sequence
+ */
+static inline u32
+UTF8EncodeCodepoint(u8 *dest, u32 codepoint)
+{
+  if (codepoint < 0x80) {
+    dest[0] = (u8)codepoint;
+    return 1;
+  }
+
+  if (codepoint < 0x800) {
+    dest[0] = (u8)(0b11000000 | (codepoint >> 6));
+    dest[1] = (u8)(0b10000000 | (codepoint & 0b00111111));
+    return 2;
+  }
+
+  if (codepoint < 0x10000) {
+    dest[0] = (u8)(0b11100000 | (codepoint >> 12));
+    dest[1] = (u8)(0b10000000 | ((codepoint >> 6) & 0b00111111));
+    dest[2] = (u8)(0b10000000 | (codepoint & 0b00111111));
+    return 3;
+  }
+
+  dest[0] = (u8)(0b11110000 | (codepoint >> 18));
+  dest[1] = (u8)(0b10000000 | ((codepoint >> 12) & 0b00111111));
+  dest[2] = (u8)(0b10000000 | ((codepoint >> 6) & 0b00111111));
+  dest[3] = (u8)(0b10000000 | (codepoint & 0b00111111));
+  return 4;
+}
+
+/*
+ * Byte at a time validation, used for short inputs and to locate error that
+ * vectorized validation detected.
+ * @return index of first byte that does not start a well-formed sequence,
+ *         length when all bytes are well-formed
+ */
+static inline u64
+UTF8IndexOfInvalidScalar(u8 *bytes, u64 length)
+{
+  u64 index = 0;
+  while (index < length) {
+    u8 byte = bytes[index];
+    if (byte < 0x80) {
+#if defined(__SSE2__)
+      // skip ASCII
+      if (index + 16 <= length && _mm_movemask_epi8(_mm_loadu_si128((__m128i *)(bytes + index))) == 0) {
+        index += 16;
+        continue;
+      }
+#endif
+      index++;
+      continue;
+    }
+
+    u32 codepoint;
+    u32 width = UTF8DecodeCodepoint(bytes + index, length - index, &codepoint);
+    if (width == 0)
+      return index;
+
+    index += width;
+  }
+
+  return length;
+}
+
+#if defined(__AVX2__)
+static inline __m256i
+UTF8CheckBlock256(__m256i input, __m256i previous)
+{
+  __m256i lowNibbleMask = _mm256_set1_epi8(0x0f);
+  __m256i byte1HighTable = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i *)UTF8_ERROR_BY_BYTE_1_HIGH));
+  __m256i byte1LowTable = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i *)UTF8_ERROR_BY_BYTE_1_LOW));
+  __m256i byte2HighTable = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i *)UTF8_ERROR_BY_BYTE_2_HIGH));
+
+  // input shifted right by 1, 2 and 3 bytes with bytes from previous block
+  __m256i previousShifted = _mm256_permute2x128_si256(previous, input, 0x21);
+  __m256i previous1 = _mm256_alignr_epi8(input, previousShifted, 16 - 1);
+  __m256i previous2 = _mm256_alignr_epi8(input, previousShifted, 16 - 2);
+  __m256i previous3 = _mm256_alignr_epi8(input, previousShifted, 16 - 3);
+
+  __m256i byte1High =
+      _mm256_shuffle_epi8(byte1HighTable, _mm256_and_si256(_mm256_srli_epi16(previous1, 4), lowNibbleMask));
+  __m256i byte1Low = _mm256_shuffle_epi8(byte1LowTable, _mm256_and_si256(previous1, lowNibbleMask));
+  __m256i byte2High =
+      _mm256_shuffle_epi8(byte2HighTable, _mm256_and_si256(_mm256_srli_epi16(input, 4), lowNibbleMask));
+  __m256i specialCases = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+  // 3rd and 4th bytes of sequence must be continuation, 2 continuations in a row are only valid there
+  __m256i isThirdByte = _mm256_subs_epu8(previous2, _mm256_set1_epi8((char)(0xe0 - 0x80)));
+  __m256i isFourthByte = _mm256_subs_epu8(previous3, _mm256_set1_epi8((char)(0xf0 - 0x80)));
+  __m256i mustBeContinuation =
+      _mm256_and_si256(_mm256_or_si256(isThirdByte, isFourthByte), _mm256_set1_epi8((char)0x80));
+
+  return _mm256_xor_si256(mustBeContinuation, specialCases);
+}
+
+/*
+ * Non-zero where block ends with a sequence that needs bytes from next block.
+ */
+static inline __m256i
+UTF8IncompleteBlock256(__m256i input)
+{
+  __m256i maxValue = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                      -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)(0xf0 - 1), (char)(0xe0 - 1),
+                                      (char)(0xc0 - 1));
+  return _mm256_subs_epu8(input, maxValue);
+}
+#elif defined(__SSSE3__)
+static inline __m128i
+UTF8CheckBlock128(__m128i input, __m128i previous)
+{
+  __m128i lowNibbleMask = _mm_set1_epi8(0x0f);
+  __m128i byte1HighTable = _mm_loadu_si128((__m128i *)UTF8_ERROR_BY_BYTE_1_HIGH);
+  __m128i byte1LowTable = _mm_loadu_si128((__m128i *)UTF8_ERROR_BY_BYTE_1_LOW);
+  __m128i byte2HighTable = _mm_loadu_si128((__m128i *)UTF8_ERROR_BY_BYTE_2_HIGH);
+
+  // input shifted right by 1, 2 and 3 bytes with bytes from previous block
+  __m128i previous1 = _mm_alignr_epi8(input, previous, 16 - 1);
+  __m128i previous2 = _mm_alignr_epi8(input, previous, 16 - 2);
+  __m128i previous3 = _mm_alignr_epi8(input, previous, 16 - 3);
+
+  __m128i byte1High = _mm_shuffle_epi8(byte1HighTable, _mm_and_si128(_mm_srli_epi16(previous1, 4), lowNibbleMask));
+  __m128i byte1Low = _mm_shuffle_epi8(byte1LowTable, _mm_and_si128(previous1, lowNibbleMask));
+  __m128i byte2High = _mm_shuffle_epi8(byte2HighTable, _mm_and_si128(_mm_srli_epi16(input, 4), lowNibbleMask));
+  __m128i specialCases = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+  // 3rd and 4th bytes of sequence must be continuation, 2 continuations in a row are only valid there
+  __m128i isThirdByte = _mm_subs_epu8(previous2, _mm_set1_epi8((char)(0xe0 - 0x80)));
+  __m128i isFourthByte = _mm_subs_epu8(previous3, _mm_set1_epi8((char)(0xf0 - 0x80)));
+  __m128i mustBeContinuation = _mm_and_si128(_mm_or_si128(isThirdByte, isFourthByte), _mm_set1_epi8((char)0x80));
+
+  return _mm_xor_si128(mustBeContinuation, specialCases);
+}
+
+/*
+ * Non-zero where block ends with a sequence that needs bytes from next block.
+ */
+static inline __m128i
+UTF8IncompleteBlock128(__m128i input)
+{
+  __m128i maxValue = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)(0xf0 - 1),
+                                   (char)(0xe0 - 1), (char)(0xc0 - 1));
+  return _mm_subs_epu8(input, maxValue);
+}
+#endif
+
+/*
+ * Finds first byte in string that does not start a well-formed UTF-8 sequence.
+ * Overlong encodings, surrogates, codepoints above U+10FFFF, stray
+ * continuation bytes and truncated sequences are invalid.
+ * @param index position of first invalid byte, only set when found
+ * @return 1 if string is NOT valid UTF-8
+ * @see IsStringValidUTF8()
+ */
+static inline b8
+StringIndexOfInvalidUTF8(struct string *string, u64 *index)
+{
+  u8 *bytes = string->value;
+  u64 length = string->length;
+  u64 position = 0;
+
+#if defined(__AVX2__)
+  __m256i previous = _mm256_setzero_si256();
+  __m256i previousIncomplete = _mm256_setzero_si256();
+  for (; position + 64 <= length; position += 64) {
+    __m256i input0 = _mm256_loadu_si256((__m256i *)(bytes + position));
+    __m256i input1 = _mm256_loadu_si256((__m256i *)(bytes + position + 32));
+    __m256i error;
+    if (_mm256_movemask_epi8(_mm256_or_si256(input0, input1)) == 0) {
+      // ASCII is only invalid after truncated sequence
+      error = previousIncomplete;
+      previousIncomplete = _mm256_setzero_si256();
+    } else {
+      error = _mm256_or_si256(UTF8CheckBlock256(input0, previous), UTF8CheckBlock256(input1, input0));
+      previousIncomplete = UTF8IncompleteBlock256(input1);
+    }
+    if (!_mm256_testz_si256(error, error))
+      break;
+    previous = input1;
+  }
+#elif defined(__SSSE3__)
+  __m128i previous = _mm_setzero_si128();
+  __m128i previousIncomplete = _mm_setzero_si128();
+  for (; position + 64 <= length; position += 64) {
+    __m128i input0 = _mm_loadu_si128((__m128i *)(bytes + position));
+    __m128i input1 = _mm_loadu_si128((__m128i *)(bytes + position + 16));
+    __m128i input2 = _mm_loadu_si128((__m128i *)(bytes + position + 32));
+    __m128i input3 = _mm_loadu_si128((__m128i *)(bytes + position + 48));
+    __m128i error;
+    if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(input0, input1), _mm_or_si128(input2, input3))) == 0) {
+      // ASCII is only invalid after truncated sequence
+      error = previousIncomplete;
+      previousIncomplete = _mm_setzero_si128();
+    } else {
+      error = _mm_or_si128(_mm_or_si128(UTF8CheckBlock128(input0, previous), UTF8CheckBlock128(input1, input0)),
+                           _mm_or_si128(UTF8CheckBlock128(input2, input1), UTF8CheckBlock128(input3, input2)));
+      previousIncomplete = UTF8IncompleteBlock128(input3);
+    }
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) != 0xffff)
+      break;
+    previous = input3;
+  }
+#endif
+
+  /*
+   * Everything before position is well-formed except a sequence that may
+   * continue into position. Step back to its first byte, then scalar
+   * validation locates the error or checks the remaining tail.
+   */
+  u64 start = position >= 3 ? position - 3 : 0;
+  while (start < position && (bytes[start] & 0b11000000) == 0b10000000)
+    start++;
+
+  u64 invalidIndex = start + UTF8IndexOfInvalidScalar(bytes + start, length - start);
+  if (invalidIndex == length)
+    return 0;
+
+  *index = invalidIndex;
+  return 1;
+}
+
+/*
+ * Checks that string is well-formed UTF-8.
+ * StringIteratorNext() and StringLength() expect well-formed input, validate
+ * untrusted input first.
+ * @see StringIndexOfInvalidUTF8() for position of error
+ */
+static inline b8
+IsStringValidUTF8(struct string *string)
+{
+  u64 index;
+  return !StringIndexOfInvalidUTF8(string, &index);
+}
+
+/*
+ * Validates UTF-8 that arrives in chunks, e.g. from reading file or socket.
+ * Sequence that is split between chunks is kept until next chunk completes it.
+ * @code
+ *   struct utf8_validator validator = {0};
+ *   while (ReadChunk(&chunk)) {
+ *     if (!UTF8ValidatorUpdate(&validator, &chunk))
+ *       break; // validator.errorOffset
+ *   }
+ *   b8 isValid = UTF8ValidatorFinish(&validator);
+ * @endcode
+ */
+struct utf8_validator {
+  // bytes seen so far
+  u64 offset;
+  // only set when invalid
+  u64 errorOffset;
+  u8 pending[4];
+  u32 pendingLength;
+  b8 isInvalid;
+  u8 _padding[7];
+};
+
+typedef struct utf8_validator utf8_validator;
+
+/*
+ * @return 0 if data seen so far is not valid UTF-8, see validator->errorOffset
+ */
+static inline b8
+UTF8ValidatorUpdate(struct utf8_validator *validator, struct string *chunk)
+{
+  if (validator->isInvalid)
+    return 0;
+
+  u8 *bytes = chunk->value;
+  u64 length = chunk->length;
+  u64 position = 0;
+
+  // complete sequence left from previous chunk
+  if (validator->pendingLength != 0) {
+    u32 width = UTF8SequenceWidth(validator->pending[0]);
+    while (validator->pendingLength < width && position < length) {
+      validator->pending[validator->pendingLength] = bytes[position];
+      validator->pendingLength++;
+      position++;
+    }
+
+    if (validator->pendingLength < width) {
+      validator->offset += length;
+      return 1;
+    }
+
+    if (UTF8IndexOfInvalidScalar(validator->pending, width) != width) {
+      validator->isInvalid = 1;
+      validator->errorOffset = validator->offset - (width - position);
+      return 0;
+    }
+
+    validator->offset += position;
+    validator->pendingLength = 0;
+  }
+
+  // keep sequence that is cut at end of chunk
+  u64 end = length;
+  for (u64 back = 1; back <= 3 && back <= length - position; back++) {
+    u8 byte = bytes[length - back];
+    if ((byte & 0b11000000) == 0b10000000)
+      continue;
+
+    u32 width = UTF8SequenceWidth(byte);
+    if (width > back)
+      end = length - back;
+    break;
+  }
+
+  struct string body = StringFromBuffer(bytes + position, end - position);
+  u64 invalidIndex;
+  if (StringIndexOfInvalidUTF8(&body, &invalidIndex)) {
+    validator->isInvalid = 1;
+    validator->errorOffset = validator->offset + invalidIndex;
+    return 0;
+  }
+
+  for (u64 index = end; index < length; index++) {
+    validator->pending[validator->pendingLength] = bytes[index];
+    validator->pendingLength++;
+  }
+
+  validator->offset += length - position;
+  return 1;
+}
+
+/*
+ * Call after last chunk.
+ * @return 0 if data is not valid UTF-8, including sequence truncated at end
+ */
+static inline b8
+UTF8ValidatorFinish(struct utf8_validator *validator)
+{
+  if (validator->isInvalid)
+    return 0;
+
+  if (validator->pendingLength != 0) {
+    validator->isInvalid = 1;
+    validator->errorOffset = validator->offset - validator->pendingLength;
+    return 0;
+  }
+
+  return 1;
+}
+
+/*
+ * UTF-16LE encoded text, length is count of 16-bit code units.
+ */
+struct string_utf16 {
+  u16 *value;
+  u64 length;
+};
+
+typedef struct string_utf16 string_utf16;
+
+/*
+ * UTF-32 encoded text, length is count of codepoints.
+ */
+struct string_utf32 {
+  u32 *value;
+  u64 length;
+};
+
+typedef struct string_utf32 string_utf32;
+
+/*
+ * Widens 32 ASCII bytes to code units of given size in bytes, 2 or 4.
+ * @return 0 if any byte is not ASCII, nothing is written then
+ */
+static inline b8
+ASCIIWiden32(u8 *bytes, void *dest, u32 unitSize)
+{
+#if defined(__AVX2__)
+  __m256i input = _mm256_loadu_si256((__m256i *)bytes);
+  if (_mm256_movemask_epi8(input) != 0)
+    return 0;
+
+  __m128i low = _mm256_castsi256_si128(input);
+  __m128i high = _mm256_extracti128_si256(input, 1);
+  if (unitSize == sizeof(u16)) {
+    __m256i *output = dest;
+    _mm256_storeu_si256(output + 0, _mm256_cvtepu8_epi16(low));
+    _mm256_storeu_si256(output + 1, _mm256_cvtepu8_epi16(high));
+  } else {
+    __m256i *output = dest;
+    _mm256_storeu_si256(output + 0, _mm256_cvtepu8_epi32(low));
+    _mm256_storeu_si256(output + 1, _mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)));
+    _mm256_storeu_si256(output + 2, _mm256_cvtepu8_epi32(high));
+    _mm256_storeu_si256(output + 3, _mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)));
+  }
+  return 1;
+#elif defined(__SSE2__)
+  __m128i input[2] = {
+      _mm_loadu_si128((__m128i *)bytes),
+      _mm_loadu_si128((__m128i *)(bytes + 16)),
+  };
+  if (_mm_movemask_epi8(_mm_or_si128(input[0], input[1])) != 0)
+    return 0;
+
+  __m128i zero = _mm_setzero_si128();
+  __m128i *output = dest;
+  for (u32 inputIndex = 0; inputIndex < ARRAY_COUNT(input); inputIndex++) {
+    __m128i low = _mm_unpacklo_epi8(input[inputIndex], zero);
+    __m128i high = _mm_unpackhi_epi8(input[inputIndex], zero);
+    if (unitSize == sizeof(u16)) {
+      _mm_storeu_si128(output++, low);
+      _mm_storeu_si128(output++, high);
+    } else {
+      _mm_storeu_si128(output++, _mm_unpacklo_epi16(low, zero));
+      _mm_storeu_si128(output++, _mm_unpackhi_epi16(low, zero));
+      _mm_storeu_si128(output++, _mm_unpacklo_epi16(high, zero));
+      _mm_storeu_si128(output++, _mm_unpackhi_epi16(high, zero));
+    }
+  }
+  return 1;
+#else
+  u64 block;
+  u8 isASCII = 1;
+  for (u32 index = 0; index < 32; index += sizeof(block)) {
+    MemoryCopy(&block, bytes + index, sizeof(block));
+    isASCII &= (block & 0x8080808080808080) == 0;
+  }
+  if (!isASCII)
+    return 0;
+
+  for (u32 index = 0; index < 32; index++) {
+    if (unitSize == sizeof(u16))
+      ((u16 *)dest)[index] = bytes[index];
+    else
+      ((u32 *)dest)[index] = bytes[index];
+  }
+  return 1;
+#endif
+}
+
+/*
+ * Narrows 32 code units of given size in bytes, 2 or 4, to ASCII bytes.
+ * @return 0 if any unit is not ASCII, nothing is written then
+ */
+static inline b8
+ASCIINarrow32(void *units, u8 *dest, u32 unitSize)
+{
+#if defined(__SSE2__)
+  __m128i input[8];
+  u32 inputCount = unitSize == sizeof(u16) ? 4 : 8;
+  __m128i combined = _mm_setzero_si128();
+  for (u32 inputIndex = 0; inputIndex < inputCount; inputIndex++) {
+    input[inputIndex] = _mm_loadu_si128((__m128i *)units + inputIndex);
+    combined = _mm_or_si128(combined, input[inputIndex]);
+  }
+
+  __m128i nonASCIIMask = unitSize == sizeof(u16) ? _mm_set1_epi16((s16)0xff80) : _mm_set1_epi32((s32)0xffffff80);
+  __m128i nonASCII = _mm_and_si128(combined, nonASCIIMask);
+  if (_mm_movemask_epi8(_mm_cmpeq_epi8(nonASCII, _mm_setzero_si128())) != 0xffff)
+    return 0;
+
+  __m128i *output = (__m128i *)dest;
+  if (unitSize == sizeof(u16)) {
+    _mm_storeu_si128(output + 0, _mm_packus_epi16(input[0], input[1]));
+    _mm_storeu_si128(output + 1, _mm_packus_epi16(input[2], input[3]));
+  } else {
+    // values are below 0x80, signed saturation keeps them
+    _mm_storeu_si128(output + 0, _mm_packus_epi16(_mm_packs_epi32(input[0], input[1]),
+                                                  _mm_packs_epi32(input[2], input[3])));
+    _mm_storeu_si128(output + 1, _mm_packus_epi16(_mm_packs_epi32(input[4], input[5]),
+                                                  _mm_packs_epi32(input[6], input[7])));
+  }
+  return 1;
+#else
+  for (u32 index = 0; index < 32; index++) {
+    u32 unit = unitSize == sizeof(u16) ? ((u16 *)units)[index] : ((u32 *)units)[index];
+    if (unit >= 0x80)
+      return 0;
+  }
+
+  for (u32 index = 0; index < 32; index++) {
+    u32 unit = unitSize == sizeof(u16) ? ((u16 *)units)[index] : ((u32 *)units)[index];
+    dest[index] = (u8)unit;
+  }
+  return 1;
+#endif
+}
+
+/*
+ * Converts UTF-8 string to UTF-16LE, output is allocated from arena.
+ * @param errorIndex optional, on failure set to offset of first byte that
+ *                   does not start a well-formed sequence, string length
+ *                   when arena is full
+ * @return null on invalid input or when arena does not have 2 bytes per
+ *         byte of string, arena is left unchanged
+ * @see IsStringValidUTF8()
+ */
+static inline struct string_utf16
+StringToUTF16(memory_arena *arena, struct string *string, u64 *errorIndex)
+{
+  memory_temp temp = MemoryTempBegin(arena);
+  // every UTF-8 sequence needs at most as many code units as its width
+  u16 *output = MemoryArenaPushAligned(arena, 0, sizeof(*output));
+  if ((u64)((u8 *)output - arena->block) + sizeof(*output) * string->length > arena->total) {
+    if (errorIndex)
+      *errorIndex = string->length;
+    MemoryTempEnd(&temp);
+    return (struct string_utf16){.value = 0, .length = 0};
+  }
+  arena->used += sizeof(*output) * string->length;
+  u64 outputLength = 0;
+
+  u8 *bytes = string->value;
+  u64 length = string->length;
+  u64 index = 0;
+  while (index < length) {
+    if (bytes[index] < 0x80 && index + 32 <= length && ASCIIWiden32(bytes + index, output + outputLength, 2)) {
+      index += 32;
+      outputLength += 32;
+      continue;
+    }
+
+    u32 codepoint;
+    u32 width = UTF8DecodeCodepoint(bytes + index, length - index, &codepoint);
+    if (width == 0) {
+      if (errorIndex)
+        *errorIndex = index;
+      MemoryTempEnd(&temp);
+      return (struct string_utf16){.value = 0, .length = 0};
+    }
+
+    if (codepoint < 0x10000) {
+      output[outputLength++] = (u16)codepoint;
+    } else {
+      codepoint -= 0x10000;
+      output[outputLength++] = (u16)(0xd800 | (codepoint >> 10));
+      output[outputLength++] = (u16)(0xdc00 | (codepoint & 0x3ff));
+    }
+    index += width;
+  }
+
+  // give back unused part
+  arena->used = (u64)((u8 *)(output + outputLength) - arena->block);
+  return (struct string_utf16){.value = output, .length = outputLength};
+}
+
+/*
+ * Converts UTF-8 string to UTF-32, output is allocated from arena.
+ * @param errorIndex optional, on failure set to offset of first byte that
+ *                   does not start a well-formed sequence, string length
+ *                   when arena is full
+ * @return null on invalid input or when arena does not have 4 bytes per
+ *         byte of string, arena is left unchanged
+ */
+static inline struct string_utf32
+StringToUTF32(memory_arena *arena, struct string *string, u64 *errorIndex)
+{
+  memory_temp temp = MemoryTempBegin(arena);
+  // every UTF-8 sequence is at least 1 byte
+  u32 *output = MemoryArenaPushAligned(arena, 0, sizeof(*output));
+  if ((u64)((u8 *)output - arena->block) + sizeof(*output) * string->length > arena->total) {
+    if (errorIndex)
+      *errorIndex = string->length;
+    MemoryTempEnd(&temp);
+    return (struct string_utf32){.value = 0, .length = 0};
+  }
+  arena->used += sizeof(*output) * string->length;
+  u64 outputLength = 0;
+
+  u8 *bytes = string->value;
+  u64 length = string->length;
+  u64 index = 0;
+  while (index < length) {
+    if (bytes[index] < 0x80 && index + 32 <= length && ASCIIWiden32(bytes + index, output + outputLength, 4)) {
+      index += 32;
+      outputLength += 32;
+      continue;
+    }
+
+    u32 width = UTF8DecodeCodepoint(bytes + index, length - index, output + outputLength);
+    if (width == 0) {
+      if (errorIndex)
+        *errorIndex = index;
+      MemoryTempEnd(&temp);
+      return (struct string_utf32){.value = 0, .length = 0};
+    }
+
+    outputLength++;
+    index += width;
+  }
+
+  // give back unused part
+  arena->used = (u64)((u8 *)(output + outputLength) - arena->block);
+  return (struct string_utf32){.value = output, .length = outputLength};
+}
+
+/*
+ * Converts UTF-16LE string to UTF-8, output is allocated from arena.
+ * @param errorIndex optional, on failure set to index of first unpaired surrogate,
+ *                   string length when arena is full
+ * @return null on invalid input or when arena does not have 3 bytes per
+ *         code unit, arena is left unchanged
+ */
+static inline struct string
+StringFromUTF16(memory_arena *arena, struct string_utf16 *string, u64 *errorIndex)
+{
+  memory_temp temp = MemoryTempBegin(arena);
+  // every code unit needs at most 3 bytes, surrogate pair needs 4
+  u8 *output = arena->block + arena->used;
+  if (arena->used + 3 * string->length > arena->total) {
+    if (errorIndex)
+      *errorIndex = string->length;
+    return StringNull();
+  }
+  arena->used += 3 * string->length;
+  u64 outputLength = 0;
+
+  u16 *units = string->value;
+  u64 length = string->length;
+  u64 index = 0;
+  while (index < length) {
+    if (units[index] < 0x80 && index + 32 <= length && ASCIINarrow32(units + index, output + outputLength, 2)) {
+      index += 32;
+      outputLength += 32;
+      continue;
+    }
+
+    u32 codepoint = units[index];
+    u64 unitCount = 1;
+    if (codepoint >= 0xd800 && codepoint <= 0xdfff) {
+      u32 low = index + 1 < length ? units[index + 1] : 0;
+      if (codepoint > 0xdbff || low < 0xdc00 || low > 0xdfff) {
+        if (errorIndex)
+          *errorIndex = index;
+        MemoryTempEnd(&temp);
+        return StringNull();
+      }
+
+      codepoint = 0x10000 + (((codepoint - 0xd800) << 10) | (low - 0xdc00));
+      unitCount = 2;
+    }
+
+    outputLength += UTF8EncodeCodepoint(output + outputLength, codepoint);
+    index += unitCount;
+  }
+
+  // give back unused part
+  arena->used = (u64)(output + outputLength - arena->block);
+  return StringFromBuffer(output, outputLength);
+}
+
+/*
+ * Converts UTF-32 string to UTF-8, output is allocated from arena.
+ * @param errorIndex optional, on failure set to index of first surrogate or
+ *                   codepoint above U+10FFFF, string length when arena is full
+ * @return null on invalid input or when arena does not have 4 bytes per
+ *         codepoint, arena is left unchanged
+ */
+static inline struct string
+StringFromUTF32(memory_arena *arena, struct string_utf32 *string, u64 *errorIndex)
+{
+  memory_temp temp = MemoryTempBegin(arena);
+  u8 *output = arena->block + arena->used;
+  if (arena->used + 4 * string->length > arena->total) {
+    if (errorIndex)
+      *errorIndex = string->length;
+    return StringNull();
+  }
+  arena->used += 4 * string->length;
+  u64 outputLength = 0;
+
+  u32 *codepoints = string->value;
+  u64 length = string->length;
+  u64 index = 0;
+  while (index < length) {
+    if (codepoints[index] < 0x80 && index + 32 <= length &&
+        ASCIINarrow32(codepoints + index, output + outputLength, 4)) {
+      index += 32;
+      outputLength += 32;
+      continue;
+    }
+
+    u32 codepoint = codepoints[index];
+    if ((codepoint >= 0xd800 && codepoint <= 0xdfff) || codepoint > 0x10ffff) {
+      if (errorIndex)
+        *errorIndex = index;
+      MemoryTempEnd(&temp);
+      return StringNull();
+    }
+
+    outputLength += UTF8EncodeCodepoint(output + outputLength, codepoint);
+    index++;
+  }
+
+  // give back unused part
+  arena->used = (u64)(output + outputLength - arena->block);
+  return StringFromBuffer(output, outputLength);
+}
+
+enum string_iterator_flag {
+  STRING_ITERATOR_FLAG_NONE = 0,
+  // Never read past end of string. Malformed or truncated sequences are
+  // decoded as U+FFFD, skipping one byte.
+  STRING_ITERATOR_FLAG_BOUNDS_CHECKED = (1 << 0),
+};
+
+/*
+ * Decodes up to maxCount codepoints, runs of ASCII 32 at a time.
+ * Without STRING_ITERATOR_FLAG_BOUNDS_CHECKED it decodes like
+ * StringIteratorNext(), string must be well-formed UTF-8.
+ * @param flags see enum string_iterator_flag
+ * @return count of codepoints written, 0 when iterator has no more
+ * @code
+ *   u32 codepoints[64];
+ *   u64 count;
+ *   while ((count = StringIteratorNextBatch(&iterator, codepoints, ARRAY_COUNT(codepoints), 0))) {
+ *     ...
+ *   }
+ * @endcode
+ */
+static inline u64
+StringIteratorNextBatch(struct string_iterator *iterator, u32 *codepoints, u64 maxCount, u32 flags)
+{
+  u8 *bytes = iterator->string->value;
+  u64 length = iterator->string->length;
+  b8 isBoundsChecked = (flags & STRING_ITERATOR_FLAG_BOUNDS_CHECKED) != 0;
+
+  u64 count = 0;
+  while (count < maxCount && iterator->index < length) {
+    u64 index = iterator->index;
+    if (bytes[index] < 0x80 && index + 32 <= length && count + 32 <= maxCount &&
+        ASCIIWiden32(bytes + index, codepoints + count, sizeof(*codepoints))) {
+      iterator->index += 32;
+      count += 32;
+      continue;
+    }
+
+    if (!isBoundsChecked) {
+      codepoints[count++] = StringIteratorNext(iterator);
+      continue;
+    }
+
+    u32 width = UTF8DecodeCodepoint(bytes + index, length - index, codepoints + count);
+    if (width == 0) {
+      codepoints[count] = 0xfffd;
+      width = 1;
+    }
+    count++;
+    iterator->index += width;
+  }
+
+  return count;
+}
+
+/*
+ * Seeded 64-bit string hash.
+ * Up to 256 bytes it is wyhash (final version 4) by Wang Yi.
+ * Longer inputs are accumulated 64 bytes at a time into 8 lanes like XXH3 by
+ * Yann Collet, which vectorizes, then lanes are folded with wyhash's mix.
+ * Results are same with and without SIMD.
+ * @see https://github.com/wangyi-fudan/wyhash
+ * @see https://github.com/Cyan4973/xxHash
+ */
+comptime u64 STRING_HASH_WYHASH_SECRET[4] = {
+    0xa0761d6478bd642f,
+    0xe7037ed1a0b428db,
+    0x8ebc6af09c88c6e3,
+    0x589965cc75374cc3,
+};
+
+comptime u64 STRING_HASH_SECRET[25] = {
+    0x0dcf0d81a7c18c92, 0xdef642ba000d9f92, 0x029f011ba5454ab7, 0xd82d9783663161e5, 0xfe28af84aaf1efba,
+    0x1cc28236813ff061, 0x21f9c70a4630ad9b, 0x28678fbe409f5489, 0x0f4226997a3a123a, 0x806108b8950fad45,
+    0x83d08c987b0ebaf9, 0xea478b91cc02a7b7, 0xafd4d38c7d2793d7, 0x1198438f7fac7ee4, 0x2542dd4870755cb5,
+    0x7faf70117d7c8c40, 0x9ad07cc89a6d16f1, 0xa18114e9c183dff7, 0x3fb684e05e8e1411, 0x4c464d1424723654,
+    0x8f23a3841df8caea, 0x84cd79ce99a564e8, 0xa91e8d63e811569a, 0xb5b34c77fb9a7281, 0xa6cb773fdff8d0e2,
+};
+
+enum {
+  STRING_HASH_SHORT_MAX = 256,
+  STRING_HASH_STRIPE_SIZE = 64,
+  // stripes between scrambles, stripe n uses STRING_HASH_SECRET[n, n + 8)
+  STRING_HASH_STRIPES_PER_BLOCK = 16,
+  STRING_HASH_SCRAMBLE_SECRET_INDEX = 16,
+  STRING_HASH_LAST_STRIPE_SECRET_INDEX = 17,
+};
+
+/*
+ * Multiplies to 128-bit, folds high and low halves.
+ */
+#define STRING_HASH_MIX(a, b)                                                                                          \
+  ((u64)((__uint128_t)(a) * (__uint128_t)(b)) ^ (u64)(((__uint128_t)(a) * (__uint128_t)(b)) >> 64))
+
+// byte of literal, 0 past its end so unused branches never index out of bounds
+#define STRING_HASH_LITERAL_BYTE(literal, index)                                                                       \
+  ((u64)((index) < sizeof(literal) ? (u8)(literal)[(index) < sizeof(literal) ? (index) : 0] : 0))
+#define STRING_HASH_LITERAL_READ32(literal, index)                                                                     \
+  (STRING_HASH_LITERAL_BYTE(literal, index) | (STRING_HASH_LITERAL_BYTE(literal, (index) + 1) << 8) |                 \
+   (STRING_HASH_LITERAL_BYTE(literal, (index) + 2) << 16) | (STRING_HASH_LITERAL_BYTE(literal, (index) + 3) << 24))
+#define STRING_HASH_LITERAL_LENGTH(literal) ((u64)sizeof(literal) - 1)
+#define STRING_HASH_LITERAL_A(literal)                                                                                 \
+  (STRING_HASH_LITERAL_LENGTH(literal) >= 4                                                                            \
+       ? (STRING_HASH_LITERAL_READ32(literal, 0) << 32) |                                                              \
+             STRING_HASH_LITERAL_READ32(literal, (STRING_HASH_LITERAL_LENGTH(literal) >> 3) << 2)                       \
+   : STRING_HASH_LITERAL_LENGTH(literal) > 0                                                                           \
+       ? (STRING_HASH_LITERAL_BYTE(literal, 0) << 16) |                                                                \
+             (STRING_HASH_LITERAL_BYTE(literal, STRING_HASH_LITERAL_LENGTH(literal) >> 1) << 8) |                      \
+             STRING_HASH_LITERAL_BYTE(literal, STRING_HASH_LITERAL_LENGTH(literal) - 1)                                \
+       : 0)
+#define STRING_HASH_LITERAL_B(literal)                                                                                 \
+  (STRING_HASH_LITERAL_LENGTH(literal) >= 4                                                                            \
+       ? (STRING_HASH_LITERAL_READ32(literal, STRING_HASH_LITERAL_LENGTH(literal) - 4) << 32) |                        \
+             STRING_HASH_LITERAL_READ32(literal, STRING_HASH_LITERAL_LENGTH(literal) - 4 -                             \
+                                                     ((STRING_HASH_LITERAL_LENGTH(literal) >> 3) << 2))                \
+       : 0)
+#define STRING_HASH_SEED(seed)                                                                                         \
+  ((seed) ^ STRING_HASH_MIX((seed) ^ STRING_HASH_WYHASH_SECRET[0], STRING_HASH_WYHASH_SECRET[1]))
+#define STRING_HASH_SHORT(a, b, seed, length)                                                                          \
+  STRING_HASH_MIX((u64)(((__uint128_t)((a) ^ STRING_HASH_WYHASH_SECRET[1]) * ((b) ^ STRING_HASH_SEED(seed)))) ^      \
+                      STRING_HASH_WYHASH_SECRET[0] ^ (length),                                                         \
+                  (u64)(((__uint128_t)((a) ^ STRING_HASH_WYHASH_SECRET[1]) * ((b) ^ STRING_HASH_SEED(seed))) >> 64) ^  \
+                      STRING_HASH_WYHASH_SECRET[1])
+
+/*
+ * Same value as StringHash() of literal, but folds to a constant so it can be
+ * used in static initializers. Literals up to 16 bytes.
+ * @code
+ *   comptime u64 helpHash = StringHashLiteral("--help", 0);
+ * @endcode
+ */
+#define StringHashLiteral(literal, seed)                                                                               \
+  (STRING_HASH_SHORT(STRING_HASH_LITERAL_A(literal), STRING_HASH_LITERAL_B(literal), (u64)(seed),                      \
+                     STRING_HASH_LITERAL_LENGTH(literal)) +                                                            \
+   0 * sizeof(char[sizeof(literal) <= 17 ? 1 : -1]))
+
+static inline u64
+StringHashRead64(u8 *bytes)
+{
+  u64 value;
+  MemoryCopy(&value, bytes, sizeof(value));
+  return value;
+}
+
+static inline u64
+StringHashRead32(u8 *bytes)
+{
+  u32 value;
+  MemoryCopy(&value, bytes, sizeof(value));
+  return value;
+}
+
+static inline u64
+StringHashShort(u8 *bytes, u64 length, u64 seed)
+{
+  debug_assert(length <= STRING_HASH_SHORT_MAX);
+  u64 a;
+  u64 b;
+  if (length <= 16) {
+    if (length >= 4) {
+      u64 middle = (length >> 3) << 2;
+      a = (StringHashRead32(bytes) << 32) | StringHashRead32(bytes + middle);
+      b = (StringHashRead32(bytes + length - 4) << 32) | StringHashRead32(bytes + length - 4 - middle);
+    } else if (length > 0) {
+      a = ((u64)bytes[0] << 16) | ((u64)bytes[length >> 1] << 8) | bytes[length - 1];
+      b = 0;
+    } else {
+      a = 0;
+      b = 0;
     }
+    return STRING_HASH_SHORT(a, b, seed, length);
+  }
 
-    // last one
-    struct string lastSplit = StringFromBuffer(string->value + startIndex, string->length - startIndex);
-    if (lastSplit.length == 0)
-      lastSplit.value = 0;
-    *(splits + splitIndex) = lastSplit;
-    debug_assert(splitIndex + 1 == *splitCount);
+  seed = STRING_HASH_SEED(seed);
+  u64 remaining = length;
+  if (remaining > 48) {
+    u64 seed1 = seed;
+    u64 seed2 = seed;
+    do {
+      seed = STRING_HASH_MIX(StringHashRead64(bytes) ^ STRING_HASH_WYHASH_SECRET[1], StringHashRead64(bytes + 8) ^ seed);
+      seed1 = STRING_HASH_MIX(StringHashRead64(bytes + 16) ^ STRING_HASH_WYHASH_SECRET[2],
+                              StringHashRead64(bytes + 24) ^ seed1);
+      seed2 = STRING_HASH_MIX(StringHashRead64(bytes + 32) ^ STRING_HASH_WYHASH_SECRET[3],
+                              StringHashRead64(bytes + 40) ^ seed2);
+      bytes += 48;
+      remaining -= 48;
+    } while (remaining > 48);
+    seed ^= seed1 ^ seed2;
   }
 
-  return 1;
+  while (remaining > 16) {
+    seed = STRING_HASH_MIX(StringHashRead64(bytes) ^ STRING_HASH_WYHASH_SECRET[1], StringHashRead64(bytes + 8) ^ seed);
+    bytes += 16;
+    remaining -= 16;
+  }
+
+  a = StringHashRead64(bytes + remaining - 16) ^ STRING_HASH_WYHASH_SECRET[1];
+  b = StringHashRead64(bytes + remaining - 8) ^ seed;
+  __uint128_t product = (__uint128_t)a * b;
+  return STRING_HASH_MIX((u64)product ^ STRING_HASH_WYHASH_SECRET[0] ^ length,
+                         (u64)(product >> 64) ^ STRING_HASH_WYHASH_SECRET[1]);
 }
 
-static inline b8
-StringSplitBySpace(struct string *string, u64 *splitCount, struct string *splits)
+/*
+ * For each lane: lane += (u32)(data ^ key) * ((data ^ key) >> 32),
+ *                neighbour lane += data
+ * @param secret key of first stripe, next stripe key starts 1 lane later
+ */
+static inline void
+StringHashAccumulate(u64 lanes[8], u8 *stripes, u64 stripeCount, u64 *secret, u64 seed)
 {
-  return StringSplit(string, &StringFromLiteral(" "), splitCount, splits);
+#if defined(__AVX2__)
+  __m256i accumulator[2] = {
+      _mm256_loadu_si256((__m256i *)lanes),
+      _mm256_loadu_si256((__m256i *)lanes + 1),
+  };
+  __m256i seeds = _mm256_set1_epi64x((s64)seed);
+  for (u64 stripeIndex = 0; stripeIndex < stripeCount; stripeIndex++) {
+    u8 *stripe = stripes + stripeIndex * STRING_HASH_STRIPE_SIZE;
+    for (u32 half = 0; half < 2; half++) {
+      __m256i data = _mm256_loadu_si256((__m256i *)stripe + half);
+      __m256i key = _mm256_add_epi64(_mm256_loadu_si256((__m256i *)(secret + stripeIndex + 4 * half)), seeds);
+      __m256i dataKey = _mm256_xor_si256(data, key);
+      __m256i product = _mm256_mul_epu32(dataKey, _mm256_srli_epi64(dataKey, 32));
+      __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+      accumulator[half] = _mm256_add_epi64(accumulator[half], _mm256_add_epi64(product, swapped));
+    }
+  }
+  _mm256_storeu_si256((__m256i *)lanes, accumulator[0]);
+  _mm256_storeu_si256((__m256i *)lanes + 1, accumulator[1]);
+#elif defined(__SSE2__)
+  __m128i accumulator0 = _mm_loadu_si128((__m128i *)lanes + 0);
+  __m128i accumulator1 = _mm_loadu_si128((__m128i *)lanes + 1);
+  __m128i accumulator2 = _mm_loadu_si128((__m128i *)lanes + 2);
+  __m128i accumulator3 = _mm_loadu_si128((__m128i *)lanes + 3);
+  __m128i seeds = _mm_set1_epi64x((s64)seed);
+  for (u64 stripeIndex = 0; stripeIndex < stripeCount; stripeIndex++) {
+    __m128i *stripe = (__m128i *)(stripes + stripeIndex * STRING_HASH_STRIPE_SIZE);
+    __m128i *key = (__m128i *)(secret + stripeIndex);
+#define STRING_HASH_ACCUMULATE_SSE2(accumulator, index)                                                                \
+  {                                                                                                                    \
+    __m128i data = _mm_loadu_si128(stripe + (index));                                                                  \
+    __m128i dataKey = _mm_xor_si128(data, _mm_add_epi64(_mm_loadu_si128(key + (index)), seeds));                       \
+    __m128i product = _mm_mul_epu32(dataKey, _mm_srli_epi64(dataKey, 32));                                             \
+    __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));                                                \
+    accumulator = _mm_add_epi64(accumulator, _mm_add_epi64(product, swapped));                                         \
+  }
+    STRING_HASH_ACCUMULATE_SSE2(accumulator0, 0);
+    STRING_HASH_ACCUMULATE_SSE2(accumulator1, 1);
+    STRING_HASH_ACCUMULATE_SSE2(accumulator2, 2);
+    STRING_HASH_ACCUMULATE_SSE2(accumulator3, 3);
+#undef STRING_HASH_ACCUMULATE_SSE2
+  }
+  _mm_storeu_si128((__m128i *)lanes + 0, accumulator0);
+  _mm_storeu_si128((__m128i *)lanes + 1, accumulator1);
+  _mm_storeu_si128((__m128i *)lanes + 2, accumulator2);
+  _mm_storeu_si128((__m128i *)lanes + 3, accumulator3);
+#else
+  for (u64 stripeIndex = 0; stripeIndex < stripeCount; stripeIndex++) {
+    u8 *stripe = stripes + stripeIndex * STRING_HASH_STRIPE_SIZE;
+    for (u32 lane = 0; lane < 8; lane++) {
+      u64 data = StringHashRead64(stripe + 8 * lane);
+      u64 dataKey = data ^ (secret[stripeIndex + lane] + seed);
+      lanes[lane ^ 1] += data;
+      lanes[lane] += (dataKey & 0xffffffff) * (dataKey >> 32);
+    }
+  }
+#endif
 }
 
-struct string_cut {
-  b8 ok : 1;
-  struct string before;
-  struct string after;
-};
-typedef struct string_cut string_cut;
+/*
+ * Keeps lanes from growing only in high bits.
+ * For each lane: lane = (lane ^ (lane >> 47) ^ key) * prime
+ */
+static inline void
+StringHashScramble(u64 lanes[8], u64 seed)
+{
+  u64 *secret = (u64 *)STRING_HASH_SECRET + STRING_HASH_SCRAMBLE_SECRET_INDEX;
+  u32 prime = 0x9e3779b1;
+#if defined(__AVX2__)
+  __m256i seeds = _mm256_set1_epi64x((s64)seed);
+  __m256i primes = _mm256_set1_epi32((s32)prime);
+  for (u32 half = 0; half < 2; half++) {
+    __m256i lane = _mm256_loadu_si256((__m256i *)lanes + half);
+    __m256i key = _mm256_add_epi64(_mm256_loadu_si256((__m256i *)(secret + 4 * half)), seeds);
+    lane = _mm256_xor_si256(_mm256_xor_si256(lane, _mm256_srli_epi64(lane, 47)), key);
+    __m256i low = _mm256_mul_epu32(lane, primes);
+    __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(lane, 32), primes);
+    _mm256_storeu_si256((__m256i *)lanes + half, _mm256_add_epi64(low, _mm256_slli_epi64(high, 32)));
+  }
+#elif defined(__SSE2__)
+  __m128i seeds = _mm_set1_epi64x((s64)seed);
+  __m128i primes = _mm_set1_epi32((s32)prime);
+  for (u32 quarter = 0; quarter < 4; quarter++) {
+    __m128i lane = _mm_loadu_si128((__m128i *)lanes + quarter);
+    __m128i key = _mm_add_epi64(_mm_loadu_si128((__m128i *)(secret + 2 * quarter)), seeds);
+    lane = _mm_xor_si128(_mm_xor_si128(lane, _mm_srli_epi64(lane, 47)), key);
+    __m128i low = _mm_mul_epu32(lane, primes);
+    __m128i high = _mm_mul_epu32(_mm_srli_epi64(lane, 32), primes);
+    _mm_storeu_si128((__m128i *)lanes + quarter, _mm_add_epi64(low, _mm_slli_epi64(high, 32)));
+  }
+#else
+  for (u32 lane = 0; lane < 8; lane++) {
+    u64 value = lanes[lane];
+    value ^= value >> 47;
+    value ^= secret[lane] + seed;
+    lanes[lane] = value * prime;
+  }
+#endif
+}
 
-static inline struct string_cut
-StringCut(struct string *string, struct string *separator)
+/*
+ * Accumulates stripes, scrambling lanes after every block.
+ * @param blockStripeIndex stripes already accumulated in current block
+ */
+static inline void
+StringHashAccumulateStripes(u64 lanes[8], u64 *blockStripeIndex, u8 *stripes, u64 stripeCount, u64 seed)
 {
-  struct string_cut result = {
-      .ok = 0,
-  };
-  if (!string)
-    return result;
+  while (stripeCount > 0) {
+    u64 count = STRING_HASH_STRIPES_PER_BLOCK - *blockStripeIndex;
+    if (count > stripeCount)
+      count = stripeCount;
+
+    StringHashAccumulate(lanes, stripes, count, (u64 *)STRING_HASH_SECRET + *blockStripeIndex, seed);
+    stripes += count * STRING_HASH_STRIPE_SIZE;
+    stripeCount -= count;
+    *blockStripeIndex += count;
+
+    if (*blockStripeIndex == STRING_HASH_STRIPES_PER_BLOCK) {
+      StringHashScramble(lanes, seed);
+      *blockStripeIndex = 0;
+    }
+  }
+}
 
-  for (u64 index = 0; index < string->length; index++) {
-    struct string substring = StringFromBuffer(string->value + index, separator->length);
-    if (separator->length > string->length - index)
-      break;
+static inline u64
+StringHashMerge(u64 lanes[8], u8 *lastStripe, u64 length, u64 seed)
+{
+  StringHashAccumulate(lanes, lastStripe, 1, (u64 *)STRING_HASH_SECRET + STRING_HASH_LAST_STRIPE_SECRET_INDEX, seed);
 
-    if (IsStringEqual(&substring, separator)) {
-      result.ok = 1;
-      result.before = StringFromBuffer(string->value, index);
-      result.after =
-          StringFromBuffer(string->value + (index + separator->length), string->length - (index + separator->length));
-      break;
-    }
+  u64 result = length * 0x9e3779b185ebca87;
+  for (u32 pair = 0; pair < 4; pair++) {
+    result += STRING_HASH_MIX(lanes[2 * pair] ^ STRING_HASH_SECRET[2 * pair + 1],
+                              lanes[2 * pair + 1] ^ STRING_HASH_SECRET[2 * pair + 2]);
   }
 
+  result ^= result >> 37;
+  result *= 0x165667919e3779f9;
+  result ^= result >> 32;
   return result;
 }
 
-struct string_iterator {
-  struct string *string;
-  u64 index;
+#define STRING_HASH_LANES_INIT                                                                                         \
+  {                                                                                                                    \
+    0x00000000c2b2ae3d, 0x9e3779b185ebca87, 0xc2b2ae3d27d4eb4f, 0x165667b19e3779f9, 0x85ebca77c2b2ae63,                \
+        0x0000000085ebca77, 0x27d4eb2f165667c5, 0x000000009e3779b1                                                     \
+  }
+
+/*
+ * Seeded 64-bit hash of string, e.g. for hash maps, interning and dedup.
+ * Not for cryptography.
+ * @see StringHashLiteral() for compile-time form, struct string_hasher for chunked input
+ */
+static inline u64
+StringHash(struct string *string, u64 seed)
+{
+  u8 *bytes = string->value;
+  u64 length = string->length;
+  if (length <= STRING_HASH_SHORT_MAX)
+    return StringHashShort(bytes, length, seed);
+
+  u64 lanes[8] = STRING_HASH_LANES_INIT;
+  u64 blockStripeIndex = 0;
+  // last stripe is always accumulated at merge, even when it is full
+  StringHashAccumulateStripes(lanes, &blockStripeIndex, bytes, (length - 1) / STRING_HASH_STRIPE_SIZE, seed);
+  return StringHashMerge(lanes, bytes + length - STRING_HASH_STRIPE_SIZE, length, seed);
+}
+
+/*
+ * Hashes input that arrives in chunks, same result as StringHash() of all
+ * chunks joined.
+ * @code
+ *   struct string_hasher hasher = StringHasherFrom(seed);
+ *   while (ReadChunk(&chunk))
+ *     StringHasherUpdate(&hasher, &chunk);
+ *   u64 hash = StringHasherDigest(&hasher);
+ * @endcode
+ */
+struct string_hasher {
+  u64 lanes[8];
+  u64 seed;
+  u64 length;
+  u64 blockStripeIndex;
+  u64 bufferLength;
+  // when lanes are in use, its end holds last accumulated stripe
+  u8 buffer[STRING_HASH_SHORT_MAX];
 };
 
-static inline struct string_iterator
-StringIteratorFrom(struct string *string)
+typedef struct string_hasher string_hasher;
+
+static inline struct string_hasher
+StringHasherFrom(u64 seed)
 {
-  debug_assert(string != 0 && string->length != 0 && "null/empty string given to iterate");
-  return (struct string_iterator){
-      .string = string,
-      .index = 0,
+  return (struct string_hasher){
+      .lanes = STRING_HASH_LANES_INIT,
+      .seed = seed,
   };
 }
 
+static inline void
+StringHasherUpdate(struct string_hasher *hasher, struct string *chunk)
+{
+  u8 *bytes = chunk->value;
+  u64 remaining = chunk->length;
+  hasher->length += remaining;
+
+  u64 bufferSize = ARRAY_COUNT(hasher->buffer);
+  u64 bufferStripeCount = bufferSize / STRING_HASH_STRIPE_SIZE;
+  if (hasher->bufferLength + remaining <= bufferSize) {
+    MemoryCopy(hasher->buffer + hasher->bufferLength, bytes, remaining);
+    hasher->bufferLength += remaining;
+    return;
+  }
+
+  // stripe is accumulated only when there are bytes after it
+  if (hasher->bufferLength != 0) {
+    u64 fill = bufferSize - hasher->bufferLength;
+    MemoryCopy(hasher->buffer + hasher->bufferLength, bytes, fill);
+    bytes += fill;
+    remaining -= fill;
+    StringHashAccumulateStripes(hasher->lanes, &hasher->blockStripeIndex, hasher->buffer, bufferStripeCount,
+                                hasher->seed);
+    hasher->bufferLength = 0;
+  }
+
+  if (remaining > bufferSize) {
+    u64 stripeCount = (remaining - 1) / STRING_HASH_STRIPE_SIZE;
+    StringHashAccumulateStripes(hasher->lanes, &hasher->blockStripeIndex, bytes, stripeCount, hasher->seed);
+    bytes += stripeCount * STRING_HASH_STRIPE_SIZE;
+    remaining -= stripeCount * STRING_HASH_STRIPE_SIZE;
+    MemoryCopy(hasher->buffer + bufferSize - STRING_HASH_STRIPE_SIZE, bytes - STRING_HASH_STRIPE_SIZE,
+               STRING_HASH_STRIPE_SIZE);
+  }
+
+  MemoryCopy(hasher->buffer, bytes, remaining);
+  hasher->bufferLength = remaining;
+}
+
+static inline u64
+StringHasherDigest(struct string_hasher *hasher)
+{
+  if (hasher->length <= STRING_HASH_SHORT_MAX)
+    return StringHashShort(hasher->buffer, hasher->length, hasher->seed);
+
+  u64 lanes[8];
+  MemoryCopy(lanes, hasher->lanes, sizeof(lanes));
+  u64 blockStripeIndex = hasher->blockStripeIndex;
+  u64 bufferLength = hasher->bufferLength;
+  StringHashAccumulateStripes(lanes, &blockStripeIndex, hasher->buffer, (bufferLength - 1) / STRING_HASH_STRIPE_SIZE,
+                              hasher->seed);
+
+  u8 lastStripe[STRING_HASH_STRIPE_SIZE];
+  if (bufferLength >= STRING_HASH_STRIPE_SIZE) {
+    MemoryCopy(lastStripe, hasher->buffer + bufferLength - STRING_HASH_STRIPE_SIZE, STRING_HASH_STRIPE_SIZE);
+  } else {
+    // rest is from end of buffer, which was accumulated before
+    u64 previousLength = STRING_HASH_STRIPE_SIZE - bufferLength;
+    MemoryCopy(lastStripe, hasher->buffer + ARRAY_COUNT(hasher->buffer) - previousLength, previousLength);
+    MemoryCopy(lastStripe + previousLength, hasher->buffer, bufferLength);
+  }
+
+  return StringHashMerge(lanes, lastStripe, hasher->length, hasher->seed);
+}
+
+/*
+ * Defines function that maps string to value, in place of chained
+ * IsStringEqual() calls, e.g. for command line options or protocol verbs.
+ * LIST is X-macro of X(value, "literal"), literals can have any length.
+ * Generated function switches on length, so compiler builds jump table over
+ * lengths up to STRING_SWITCH_LENGTH_MAX. In each case only literals of that
+ * length are left after constant folding, and they are compared with
+ * constant-length memcmp, which is few word compares for short literals.
+ * Longer literals are compared one by one in default case.
+ * @code
+ *   #define OPTION_LIST(X) X(OPTION_HELP, "-h") X(OPTION_HELP, "--help")
+ *   STRING_SWITCH(ParseOption, enum option, OPTION_LIST, OPTION_UNKNOWN)
+ *
+ *   switch (ParseOption(&argument)) {
+ *   case OPTION_HELP: ...
+ *   }
+ * @endcode
+ */
+#define STRING_SWITCH(functionName, valueType, LIST, defaultValue)                                                     \
+  static inline valueType functionName(struct string *string)                                                          \
+  {                                                                                                                    \
+    if (!string)                                                                                                       \
+      return defaultValue;                                                                                             \
+                                                                                                                       \
+    u64 length = string->length;                                                                                       \
+    u8 *bytes = string->value;                                                                                         \
+    switch (length) {                                                                                                  \
+      STRING_SWITCH_CASE_8(LIST, 0)                                                                                    \
+      STRING_SWITCH_CASE_8(LIST, 8)                                                                                    \
+      STRING_SWITCH_CASE_8(LIST, 16)                                                                                   \
+      STRING_SWITCH_CASE_8(LIST, 24)                                                                                   \
+    default:                                                                                                           \
+      LIST(STRING_SWITCH_COMPARE)                                                                                      \
+      break;                                                                                                           \
+    }                                                                                                                  \
+    return defaultValue;                                                                                               \
+  }
+
+// longest length that has its own case, longer ones share default case
+#define STRING_SWITCH_LENGTH_MAX 31
+#define STRING_SWITCH_CASE(LIST, caseLength)                                                                           \
+  case caseLength:                                                                                                     \
+    LIST(STRING_SWITCH_COMPARE)                                                                                        \
+    break;
+#define STRING_SWITCH_CASE_8(LIST, firstLength)                                                                        \
+  STRING_SWITCH_CASE(LIST, (firstLength) + 0)                                                                          \
+  STRING_SWITCH_CASE(LIST, (firstLength) + 1)                                                                          \
+  STRING_SWITCH_CASE(LIST, (firstLength) + 2)                                                                          \
+  STRING_SWITCH_CASE(LIST, (firstLength) + 3)                                                                          \
+  STRING_SWITCH_CASE(LIST, (firstLength) + 4)                                                                          \
+  STRING_SWITCH_CASE(LIST, (firstLength) + 5)                                                                          \
+  STRING_SWITCH_CASE(LIST, (firstLength) + 6)                                                                          \
+  STRING_SWITCH_CASE(LIST, (firstLength) + 7)
+// length of literal is constant, so in each case compiler drops literals of other lengths
+#define STRING_SWITCH_COMPARE(tag, literal)                                                                            \
+  if (length == sizeof(literal) - 1 &&                                                                                 \
+      (sizeof(literal) == 1 || IsMemoryEqual(bytes, (literal), sizeof(literal) - 1)))                                  \
+    return tag;
+
+struct string_sort_entry {
+  // next 8 bytes of string from current depth, first byte in highest bits,
+  // zero padded when string ends
+  u64 prefix;
+  struct string string;
+};
+
+/*
+ * @return next 8 bytes of string starting at depth as big endian number,
+ *         so that comparing numbers compares bytes in order
+ */
+static inline u64
+StringSortPrefix(struct string *string, u64 depth)
+{
+  u64 prefix = 0;
+  if (depth + sizeof(prefix) <= string->length)
+    MemoryCopy(&prefix, string->value + depth, sizeof(prefix));
+  else if (depth < string->length)
+    MemoryCopy(&prefix, string->value + depth, string->length - depth);
+  return __builtin_bswap64(prefix);
+}
+
+static inline void
+StringSortSwap(struct string_sort_entry *left, struct string_sort_entry *right)
+{
+  struct string_sort_entry temp = *left;
+  *left = *right;
+  *right = temp;
+}
+
+/*
+ * Multikey quicksort of entries whose strings are same up to depth.
+ * Entries are split into less, equal and greater than pivot by 8 bytes of
+ * prefix at once. Only equal part goes 8 bytes deeper, its prefixes are
+ * loaded again.
+ * Two smaller parts are sorted in recursion and largest one in loop, so
+ * recursion is at most log2(count) deep, also for long common prefixes.
+ */
+static void
+StringSortEntries(struct string_sort_entry *entries, u64 count, u64 depth)
+{
+  while (count > 1) {
+    if (count <= 16) {
+      for (u64 index = 1; index < count; index++) {
+        struct string_sort_entry entry = entries[index];
+        u64 position = index;
+        while (position > 0) {
+          struct string_sort_entry *previous = entries + position - 1;
+          if (previous->prefix < entry.prefix)
+            break;
+          if (previous->prefix == entry.prefix) {
+            struct string left = StringFromBuffer(previous->string.value + depth, previous->string.length - depth);
+            struct string right = StringFromBuffer(entry.string.value + depth, entry.string.length - depth);
+            if (StringCompare(&left, &right) <= 0)
+              break;
+          }
+          entries[position] = *previous;
+          position--;
+        }
+        entries[position] = entry;
+      }
+      return;
+    }
+
+    // median of three
+    u64 a = entries[0].prefix;
+    u64 b = entries[count / 2].prefix;
+    u64 c = entries[count - 1].prefix;
+    u64 pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+
+    // [0, less) < pivot, [less, index) == pivot, (greater, count) > pivot
+    u64 less = 0;
+    u64 index = 0;
+    u64 greater = count;
+    while (index < greater) {
+      u64 prefix = entries[index].prefix;
+      if (prefix < pivot) {
+        StringSortSwap(entries + less, entries + index);
+        less++;
+        index++;
+      } else if (prefix > pivot) {
+        greater--;
+        StringSortSwap(entries + index, entries + greater);
+      } else {
+        index++;
+      }
+    }
+
+    // strings that end in these 8 bytes are prefix of longer ones, shorter first
+    struct string_sort_entry *equal = entries + less;
+    u64 equalCount = greater - less;
+    u64 endedCount = 0;
+    for (u64 equalIndex = 0; equalIndex < equalCount; equalIndex++) {
+      if (equal[equalIndex].string.length <= depth + 8)
+        StringSortSwap(equal + endedCount++, equal + equalIndex);
+    }
+    for (u64 endedIndex = 1; endedIndex < endedCount; endedIndex++) {
+      struct string_sort_entry entry = equal[endedIndex];
+      u64 position = endedIndex;
+      for (; position > 0 && equal[position - 1].string.length > entry.string.length; position--)
+        equal[position] = equal[position - 1];
+      equal[position] = entry;
+    }
+    for (u64 equalIndex = endedCount; equalIndex < equalCount; equalIndex++)
+      equal[equalIndex].prefix = StringSortPrefix(&equal[equalIndex].string, depth + 8);
+
+    struct string_sort_part {
+      struct string_sort_entry *entries;
+      u64 count;
+      u64 depth;
+    } parts[] = {
+        {.entries = entries, .count = less, .depth = depth},
+        {.entries = equal + endedCount, .count = equalCount - endedCount, .depth = depth + 8},
+        {.entries = entries + greater, .count = count - greater, .depth = depth},
+    };
+    u32 largest = 0;
+    for (u32 partIndex = 1; partIndex < ARRAY_COUNT(parts); partIndex++) {
+      if (parts[partIndex].count > parts[largest].count)
+        largest = partIndex;
+    }
+    for (u32 partIndex = 0; partIndex < ARRAY_COUNT(parts); partIndex++) {
+      if (partIndex != largest)
+        StringSortEntries(parts[partIndex].entries, parts[partIndex].count, parts[partIndex].depth);
+    }
+
+    entries = parts[largest].entries;
+    count = parts[largest].count;
+    depth = parts[largest].depth;
+  }
+}
+
+/*
+ * Sorts strings in lexicographic order of bytes, same order as
+ * StringCompare().
+ * Comparisons work on 8 byte prefixes that are copied next to each string,
+ * so most of them do not touch string bytes.
+ *
+ * @param arena used for count * 24 bytes while sorting, given back after
+ * @return 0 if arena does not have enough space, strings are untouched then
+ *
+ * @see StringSortPartition() for sorting on many threads
+ */
 static inline b8
-StringIteratorHasNext(struct string_iterator *iterator)
+StringSort(memory_arena *arena, struct string *strings, u64 count)
 {
-  return iterator->index < iterator->string->length;
+  memory_temp temp = MemoryTempBegin(arena);
+  struct string_sort_entry *entries = MemoryArenaPushAligned(arena, 0, sizeof(u64));
+  if ((u64)((u8 *)entries - arena->block) + count * sizeof(*entries) > arena->total) {
+    MemoryTempEnd(&temp);
+    return 0;
+  }
+  arena->used += count * sizeof(*entries);
+
+  for (u64 index = 0; index < count; index++) {
+    entries[index].prefix = StringSortPrefix(strings + index, 0);
+    entries[index].string = strings[index];
+  }
+
+  StringSortEntries(entries, count, 0);
+
+  for (u64 index = 0; index < count; index++)
+    strings[index] = entries[index].string;
+
+  MemoryTempEnd(&temp);
+  return 1;
 }
 
-static inline u32
-StringIteratorNext(struct string_iterator *iterator)
+/*
+ * First pass of most significant byte radix sort. Moves strings into
+ * buckets by first byte, empty strings first. Buckets do not depend on each
+ * other, so each one can be sorted by StringSort() on its own thread with
+ * its own arena.
+ *
+ * @param bucketStarts bucket n is [bucketStarts[n], bucketStarts[n + 1]),
+ *                     bucket 0 is empty strings, bucket 1 + n is first byte n
+ * @return 0 if arena does not have enough space for copy of strings
+ *
+ * @code
+ *   u64 bucketStarts[258];
+ *   StringSortPartition(arena, strings, count, bucketStarts);
+ *   // on workers
+ *   for (u32 bucket = 1; bucket < 257; bucket++)
+ *     StringSort(workerArena, strings + bucketStarts[bucket], bucketStarts[bucket + 1] - bucketStarts[bucket]);
+ * @endcode
+ */
+static inline b8
+StringSortPartition(memory_arena *arena, struct string *strings, u64 count, u64 bucketStarts[258])
 {
-  u8 *bytes = iterator->string->value + iterator->index;
+  memory_temp temp = MemoryTempBegin(arena);
+  struct string *copy = MemoryArenaPushAligned(arena, 0, sizeof(u64));
+  if ((u64)((u8 *)copy - arena->block) + count * sizeof(*copy) > arena->total) {
+    MemoryTempEnd(&temp);
+    return 0;
+  }
+  arena->used += count * sizeof(*copy);
 
-  u8 byte = *bytes;
-  b8 v01 = ((byte & 0b10000000) >> 7) & ((byte & 0b01000000) >> 6);
-  b8 v2 = (byte & 0b00100000) >> 5;
-  b8 v3 = (byte & 0b00010000) >> 4;
-  u8 codepointWidth = 1 + (u8)((v01 << v2) | (v01 & v3));
+  for (u32 bucket = 0; bucket < 258; bucket++)
+    bucketStarts[bucket] = 0;
+  for (u64 index = 0; index < count; index++) {
+    struct string *string = strings + index;
+    bucketStarts[string->length == 0 ? 1 : 2 + (u32)string->value[0]]++;
+  }
+  for (u32 bucket = 1; bucket < 258; bucket++)
+    bucketStarts[bucket] += bucketStarts[bucket - 1];
 
-  u32 codepoint = byte & (0b01111111 >> (codepointWidth & -v01));
-  for (u8 byteIndex = 1; byteIndex < codepointWidth; byteIndex++) {
-    byte = *(bytes + byteIndex);
-    codepoint <<= 6;
-    codepoint |= (byte & 0b00111111);
+  // bucketStarts[n] is write position of bucket n, after moving it is start
+  // of bucket n + 1, so starts are shifted back
+  MemoryCopy(copy, strings, count * sizeof(*copy));
+  for (u64 index = 0; index < count; index++) {
+    struct string *string = copy + index;
+    strings[bucketStarts[string->length == 0 ? 0 : 1 + (u32)string->value[0]]++] = *string;
   }
+  for (u32 bucket = 257; bucket > 0; bucket--)
+    bucketStarts[bucket] = bucketStarts[bucket - 1];
+  bucketStarts[0] = 0;
 
-  iterator->index += codepointWidth;
-  return codepoint;
+  MemoryTempEnd(&temp);
+  return 1;
 }
 
+/*
+ * Edit distance of pattern of at most 64 bytes to text, one bit per pattern
+ * byte (Myers, Hyyrö).
+ * @param peq bit i of peq[c] is set when pattern byte i is c
+ * @return distance, maxDistance + 1 when it is greater than maxDistance
+ */
 static inline u64
-StringLength(struct string *string)
+StringEditDistanceWord(u64 *peq, u64 patternLength, struct string *text, u64 maxDistance)
 {
-  u64 length = 0;
+  u64 lastRow = (u64)1 << (patternLength - 1);
+  u64 positive = ~(u64)0;
+  u64 negative = 0;
+  u64 score = patternLength;
+  for (u64 index = 0; index < text->length; index++) {
+    u64 equal = peq[text->value[index]];
+    u64 vertical = equal | negative;
+    u64 horizontal = (((equal & positive) + positive) ^ positive) | equal;
+    u64 horizontalPositive = negative | ~(horizontal | positive);
+    u64 horizontalNegative = positive & horizontal;
+    score += (horizontalPositive & lastRow) != 0;
+    score -= (horizontalNegative & lastRow) != 0;
+
+    // every remaining byte lowers distance by at most 1
+    u64 remaining = text->length - index - 1;
+    if (score > maxDistance + remaining)
+      return maxDistance + 1;
+
+    // top row of table is 0, 1, 2, ..., so it always grows by one
+    horizontalPositive = (horizontalPositive << 1) | 1;
+    horizontalNegative <<= 1;
+    positive = horizontalNegative | ~(vertical | horizontalPositive);
+    negative = horizontalPositive & vertical;
+  }
+  return score;
+}
+
+/*
+ * Advances one 64 row block of edit distance table by one column.
+ * @param horizontalIn difference of cell above block, -1, 0 or +1
+ * @param row difference is returned for this row, top bit except in last
+ *            block
+ * @return difference of row to cell on its left, -1, 0 or +1
+ */
+static inline s64
+StringEditDistanceAdvanceBlock(u64 *positive, u64 *negative, u64 equal, s64 horizontalIn, u64 row)
+{
+  u64 isInNegative = horizontalIn < 0;
+  u64 isInPositive = horizontalIn > 0;
+  u64 vertical = equal | *negative;
+  equal |= isInNegative;
+  u64 horizontal = (((equal & *positive) + *positive) ^ *positive) | equal;
+  u64 horizontalPositive = *negative | ~(horizontal | *positive);
+  u64 horizontalNegative = *positive & horizontal;
+  s64 horizontalOut = (s64)((horizontalPositive & row) != 0) - (s64)((horizontalNegative & row) != 0);
+
+  horizontalPositive = (horizontalPositive << 1) | isInPositive;
+  horizontalNegative = (horizontalNegative << 1) | isInNegative;
+  *positive = horizontalNegative | ~(vertical | horizontalPositive);
+  *negative = horizontalPositive & vertical;
+  return horizontalOut;
+}
 
-  for (u64 index = 0; index < string->length; length++) {
-    u8 character = *(string->value + index);
+/*
+ * Edit distance of pattern longer than 64 bytes to text, 64 rows per block.
+ * Only blocks that can hold cells not greater than max distance are
+ * computed (Ukkonen's band, as in edlib). Block below is started when bottom
+ * cell of last block is within max distance. First and last block are
+ * dropped when all of their cells are over. Cells above first block stay
+ * over max distance, they are taken as growing by 1 per column, which only
+ * changes cells that are over max distance anyway.
+ *
+ * @param peq bit i of peq[c * blockCount + b] is set when pattern byte
+ *            64 * b + i is c
+ * @param blocks 3 * blockCount values of scratch memory
+ */
+static inline u64
+StringEditDistanceBlocks(u64 *peq, u64 blockCount, u64 patternLength, struct string *text, u64 maxDistance,
+                         u64 *blocks)
+{
+  u64 *positives = blocks;
+  u64 *negatives = blocks + blockCount;
+  // value of bottom cell of each block, row of pattern length for last block
+  u64 *scores = blocks + 2 * blockCount;
+  u64 lastRow = (u64)1 << ((patternLength - 1) % 64);
+  comptime u64 BOTTOM_ROW = (u64)1 << 63;
+
+  // first column is 0, 1, 2, ..., rows after max distance are over it
+  u64 firstBlock = 0;
+  u64 lastBlock = maxDistance / 64 < blockCount - 1 ? maxDistance / 64 : blockCount - 1;
+  for (u64 block = 0; block <= lastBlock; block++) {
+    positives[block] = ~(u64)0;
+    negatives[block] = 0;
+    scores[block] = block == blockCount - 1 ? patternLength : (block + 1) * 64;
+  }
 
-#if 1
-    b8 v01 = ((character & 0b10000000) >> 7) & ((character & 0b01000000) >> 6);
-    b8 v2 = (character & 0b00100000) >> 5;
-    b8 v3 = (character & 0b00010000) >> 4;
+  for (u64 index = 0; index < text->length; index++) {
+    u64 *equal = peq + text->value[index] * blockCount;
+    s64 horizontal = 1;
+    for (u64 block = firstBlock; block <= lastBlock; block++) {
+      u64 row = block == blockCount - 1 ? lastRow : BOTTOM_ROW;
+      horizontal =
+          StringEditDistanceAdvanceBlock(positives + block, negatives + block, equal[block], horizontal, row);
+      scores[block] = (u64)((s64)scores[block] + horizontal);
+    }
 
-    index += 1 + (u64)((v01 << v2) | (v01 & v3));
-#else
-    // unoptimized
-    b8 v0 = (character & 0b10000000) >> 7;
-    b8 v1 = (character & 0b01000000) >> 6;
-    b8 v2 = (character & 0b00100000) >> 5;
-    b8 v3 = (character & 0b00010000) >> 4;
+    // cells of next block can be within max distance only through bottom
+    // cell of last block, in this column or in previous one
+    while (lastBlock < blockCount - 1 &&
+           (scores[lastBlock] <= maxDistance || (u64)((s64)scores[lastBlock] - horizontal) <= maxDistance)) {
+      u64 previousScore = (u64)((s64)scores[lastBlock] - horizontal);
+      lastBlock++;
+      // values in previous column are not known, going down from bottom
+      // cell of block above is upper bound
+      positives[lastBlock] = ~(u64)0;
+      negatives[lastBlock] = 0;
+      u64 row = lastBlock == blockCount - 1 ? lastRow : BOTTOM_ROW;
+      u64 rowCount = lastBlock == blockCount - 1 ? (patternLength - 1) % 64 + 1 : 64;
+      horizontal = StringEditDistanceAdvanceBlock(positives + lastBlock, negatives + lastBlock, equal[lastBlock],
+                                                  horizontal, row);
+      scores[lastBlock] = (u64)((s64)(previousScore + rowCount) + horizontal);
+    }
 
-    index += 1 + (u64)(v0 * v1) + (u64)(v0 * v1 * v2) + (u64)(v0 * v1 * v2 * v3);
-#endif
+    // cells in block differ by at most 1 per row
+    while (lastBlock > firstBlock && scores[lastBlock] >= maxDistance + 64)
+      lastBlock--;
+    while (firstBlock < lastBlock && scores[firstBlock] >= maxDistance + 64)
+      firstBlock++;
+    if (scores[firstBlock] >= maxDistance + 64)
+      return maxDistance + 1;
+
+    // every remaining byte lowers distance by at most 1
+    u64 remaining = text->length - index - 1;
+    if (lastBlock == blockCount - 1 && scores[lastBlock] > maxDistance + remaining)
+      return maxDistance + 1;
   }
 
-  return length;
+  if (lastBlock != blockCount - 1 || scores[lastBlock] > maxDistance)
+    return maxDistance + 1;
+  return scores[lastBlock];
+}
+
+/*
+ * Levenshtein distance, count of byte insertions, deletions and
+ * substitutions that turn left into right. Table of dynamic programming is
+ * computed 64 cells at a time with bit operations.
+ *
+ * @param arena used when both strings are longer than 64 bytes, given back
+ *              after. Can be 0 otherwise.
+ * @param maxDistance computing stops once distance is known to be greater,
+ *                    U64_MAX for no limit
+ * @param distance maxDistance + 1 when distance is greater than maxDistance
+ * @return 0 if arena does not have enough space
+ *
+ * @code
+ *   // "did you mean"
+ *   u64 distance;
+ *   if (StringEditDistance(0, &input, &command, 2, &distance) && distance <= 2)
+ *     ...
+ * @endcode
+ */
+static inline b8
+StringEditDistance(memory_arena *arena, struct string *left, struct string *right, u64 maxDistance, u64 *distance)
+{
+  // shorter one is pattern, so it takes fewer blocks
+  struct string *pattern = left->length <= right->length ? left : right;
+  struct string *text = left->length <= right->length ? right : left;
+
+  // distance is never greater than length of longer string
+  if (maxDistance > text->length)
+    maxDistance = text->length;
+  if (text->length - pattern->length > maxDistance) {
+    *distance = maxDistance + 1;
+    return 1;
+  }
+  if (pattern->length == 0) {
+    *distance = text->length;
+    return 1;
+  }
+
+  if (pattern->length <= 64) {
+    u64 peq[256] = {0};
+    for (u64 index = 0; index < pattern->length; index++)
+      peq[pattern->value[index]] |= (u64)1 << index;
+    *distance = StringEditDistanceWord(peq, pattern->length, text, maxDistance);
+    return 1;
+  }
+
+  u64 blockCount = (pattern->length + 63) / 64;
+  u64 size = (256 + 3) * blockCount * sizeof(u64);
+  memory_temp temp = MemoryTempBegin(arena);
+  u64 *peq = MemoryArenaPushAligned(arena, 0, sizeof(u64));
+  if ((u64)((u8 *)peq - arena->block) + size > arena->total) {
+    MemoryTempEnd(&temp);
+    return 0;
+  }
+  arena->used += size;
+
+  MemoryClear(peq, 256 * blockCount * sizeof(u64));
+  for (u64 index = 0; index < pattern->length; index++)
+    peq[pattern->value[index] * blockCount + index / 64] |= (u64)1 << (index % 64);
+  *distance = StringEditDistanceBlocks(peq, blockCount, pattern->length, text, maxDistance, peq + 256 * blockCount);
+
+  MemoryTempEnd(&temp);
+  return 1;
+}
+
+/*
+ * Edit distance of query to each candidate. Bits of query are prepared
+ * once for all candidates.
+ * @see StringEditDistance()
+ *
+ * @param arena used for (256 + 3) * 8 bytes per 64 bytes of query, given
+ *              back after
+ * @param distances count values, maxDistance + 1 for candidates that are
+ *                  farther
+ * @return 0 if arena does not have enough space
+ */
+static inline b8
+StringEditDistanceBatch(memory_arena *arena, struct string *query, struct string *candidates, u64 count,
+                        u64 maxDistance, u64 *distances)
+{
+  u64 blockCount = query->length == 0 ? 1 : (query->length + 63) / 64;
+  u64 size = (256 + 3) * blockCount * sizeof(u64);
+  memory_temp temp = MemoryTempBegin(arena);
+  u64 *peq = MemoryArenaPushAligned(arena, 0, sizeof(u64));
+  if ((u64)((u8 *)peq - arena->block) + size > arena->total) {
+    MemoryTempEnd(&temp);
+    return 0;
+  }
+  arena->used += size;
+
+  MemoryClear(peq, 256 * blockCount * sizeof(u64));
+  for (u64 index = 0; index < query->length; index++)
+    peq[query->value[index] * blockCount + index / 64] |= (u64)1 << (index % 64);
+
+  for (u64 candidateIndex = 0; candidateIndex < count; candidateIndex++) {
+    struct string *candidate = candidates + candidateIndex;
+    u64 longerLength = candidate->length > query->length ? candidate->length : query->length;
+    u64 shorterLength = candidate->length > query->length ? query->length : candidate->length;
+    u64 limit = maxDistance < longerLength ? maxDistance : longerLength;
+    if (longerLength - shorterLength > limit)
+      distances[candidateIndex] = limit + 1;
+    else if (query->length == 0)
+      distances[candidateIndex] = candidate->length;
+    else if (blockCount == 1)
+      distances[candidateIndex] = StringEditDistanceWord(peq, query->length, candidate, limit);
+    else
+      distances[candidateIndex] =
+          StringEditDistanceBlocks(peq, blockCount, query->length, candidate, limit, peq + 256 * blockCount);
+  }
+
+  MemoryTempEnd(&temp);
+  return 1;
 }
@@ -0,0 +1,281 @@
+#include "platform.h"
+// platform.h must be first, it selects POSIX features
+#include "glob.h"
+#include "string_builder.h"
+
+#define TEST_ERROR_LIST(X)                                                                                             \
+  X(GLOB_TEST_ERROR_MATCH, "GlobMatch: Path must match pattern as expected")                                           \
+  X(GLOB_TEST_ERROR_MATCH_MANY, "GlobMatch: First matching pattern of many must be found")                             \
+  X(GLOB_TEST_ERROR_COMPILE_INVALID, "GlobCompile: Invalid pattern must fail")                                         \
+  X(GLOB_TEST_ERROR_COMPILE_OUT_OF_MEMORY, "GlobCompile: Must fail and leave arena untouched when full")
+
+enum glob_test_error {
+  GLOB_TEST_ERROR_NONE = 0,
+#define X(tag, message) tag,
+  TEST_ERROR_LIST(X)
+#undef X
+
+  // src: https://mesonbuild.com/Unit-tests.html#skipped-tests-and-hard-errors
+  // For the default exitcode testing protocol, the GNU standard approach in
+  // this case is to exit the program with error code 77. Meson will detect this
+  // and report these tests as skipped rather than failed. This behavior was
+  // added in version 0.37.0.
+  MESON_TEST_SKIP = 77,
+  // In addition, sometimes a test fails set up so that it should fail even if
+  // it is marked as an expected failure. The GNU standard approach in this case
+  // is to exit the program with error code 99. Again, Meson will detect this
+  // and report these tests as ERROR, ignoring the setting of should_fail. This
+  // behavior was added in version 0.50.0.
+  MESON_TEST_FAILED_TO_SET_UP = 99,
+};
+
+internalfn void
+StringBuilderAppendErrorMessage(struct string_builder *stringBuilder, enum glob_test_error errorCode)
+{
+  struct error {
+    enum glob_test_error code;
+    struct string message;
+  } errors[] = {
+#define XX(tag, msg) {.code = tag, .message = StringFromLiteral(msg)},
+      TEST_ERROR_LIST(XX)
+#undef XX
+  };
+
+  struct string message = StringFromLiteral("Unknown error");
+  for (u32 index = 0; index < ARRAY_COUNT(errors); index++) {
+    struct error *error = errors + index;
+    if (error->code == errorCode) {
+      message = error->message;
+      break;
+    }
+  }
+
+  StringBuilderAppendString(stringBuilder, &message);
+}
+
+int
+main(void)
+{
+  enum glob_test_error errorCode = GLOB_TEST_ERROR_NONE;
+
+  // setup
+  enum { KILOBYTES = (1 << 10) };
+  u8 stackBuffer[8 * KILOBYTES];
+  memory_arena stackMemory = {
+      .block = stackBuffer,
+      .total = ARRAY_COUNT(stackBuffer),
+  };
+
+  string_builder *sb = MakeStringBuilder(&stackMemory, 1024, 32);
+
+  static u8 globBuffer[64 * KILOBYTES];
+
+  // b8 GlobMatch(struct glob *glob, struct string *path, u64 *patternIndex)
+  {
+    struct test_case {
+      struct string pattern;
+      struct string path;
+      b8 expected;
+    } testCases[] = {
+        {.pattern = StringFromLiteral(""), .path = StringFromLiteral(""), .expected = 1},
+        {.pattern = StringFromLiteral(""), .path = StringFromLiteral("a"), .expected = 0},
+        {.pattern = StringFromLiteral("abc"), .path = StringFromLiteral("abc"), .expected = 1},
+        {.pattern = StringFromLiteral("abc"), .path = StringFromLiteral("abcd"), .expected = 0},
+        {.pattern = StringFromLiteral("*"), .path = StringFromLiteral(""), .expected = 1},
+        {.pattern = StringFromLiteral("*"), .path = StringFromLiteral("a/b"), .expected = 0},
+        {.pattern = StringFromLiteral("*.log"), .path = StringFromLiteral("server.log"), .expected = 1},
+        {.pattern = StringFromLiteral("*.log"), .path = StringFromLiteral(".log"), .expected = 1},
+        {.pattern = StringFromLiteral("*.log"), .path = StringFromLiteral("server.log.1"), .expected = 0},
+        {.pattern = StringFromLiteral("*.log"), .path = StringFromLiteral("var/server.log"), .expected = 0},
+        {.pattern = StringFromLiteral("a*b*c"), .path = StringFromLiteral("aXbYbZc"), .expected = 1},
+        {.pattern = StringFromLiteral("a*b*c"), .path = StringFromLiteral("aXcYb"), .expected = 0},
+        {.pattern = StringFromLiteral("file?.txt"), .path = StringFromLiteral("file1.txt"), .expected = 1},
+        {.pattern = StringFromLiteral("file?.txt"), .path = StringFromLiteral("file.txt"), .expected = 0},
+        {.pattern = StringFromLiteral("a?b"), .path = StringFromLiteral("a/b"), .expected = 0},
+        {.pattern = StringFromLiteral("[a-c]x"), .path = StringFromLiteral("bx"), .expected = 1},
+        {.pattern = StringFromLiteral("[a-c]x"), .path = StringFromLiteral("dx"), .expected = 0},
+        {.pattern = StringFromLiteral("[!a-c]x"), .path = StringFromLiteral("dx"), .expected = 1},
+        {.pattern = StringFromLiteral("[^a-c]x"), .path = StringFromLiteral("ax"), .expected = 0},
+        {.pattern = StringFromLiteral("[!a]"), .path = StringFromLiteral("/"), .expected = 0},
+        {.pattern = StringFromLiteral("[]]"), .path = StringFromLiteral("]"), .expected = 1},
+        {.pattern = StringFromLiteral("[a-]"), .path = StringFromLiteral("-"), .expected = 1},
+        {.pattern = StringFromLiteral("\\*"), .path = StringFromLiteral("*"), .expected = 1},
+        {.pattern = StringFromLiteral("\\*"), .path = StringFromLiteral("a"), .expected = 0},
+        {.pattern = StringFromLiteral("**"), .path = StringFromLiteral("a/b/c"), .expected = 1},
+        {.pattern = StringFromLiteral("**/tmp/*"), .path = StringFromLiteral("tmp/a"), .expected = 1},
+        {.pattern = StringFromLiteral("**/tmp/*"), .path = StringFromLiteral("x/y/tmp/a"), .expected = 1},
+        {.pattern = StringFromLiteral("**/tmp/*"), .path = StringFromLiteral("x/ytmp/a"), .expected = 0},
+        {.pattern = StringFromLiteral("**/tmp/*"), .path = StringFromLiteral("x/tmp/a/b"), .expected = 0},
+        {.pattern = StringFromLiteral("a/**/b"), .path = StringFromLiteral("a/b"), .expected = 1},
+        {.pattern = StringFromLiteral("a/**/b"), .path = StringFromLiteral("a/x/y/b"), .expected = 1},
+        {.pattern = StringFromLiteral("a/**/b"), .path = StringFromLiteral("a/xb"), .expected = 0},
+        {.pattern = StringFromLiteral("a/**"), .path = StringFromLiteral("a/x/y"), .expected = 1},
+        {.pattern = StringFromLiteral("a/**"), .path = StringFromLiteral("a"), .expected = 0},
+        {.pattern = StringFromLiteral("a**b"), .path = StringFromLiteral("a/b"), .expected = 0},
+        {.pattern = StringFromLiteral("**/*.c"), .path = StringFromLiteral("src/lib/text.c"), .expected = 1},
+        {.pattern = StringFromLiteral("**/*.c"), .path = StringFromLiteral("text.c"), .expected = 1},
+        {.pattern = StringFromLiteral("**/*.c"), .path = StringFromLiteral("src/text.h"), .expected = 0},
+        {.pattern = StringFromLiteral("a/**/**/b"), .path = StringFromLiteral("a/b"), .expected = 1},
+        {.pattern = StringFromLiteral("a/**/**/b"), .path = StringFromLiteral("a/x/b"), .expected = 1},
+        {.pattern = StringFromLiteral("**/x*/*"), .path = StringFromLiteral("x/xy/z"), .expected = 1},
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+      memory_arena arena = {.block = globBuffer, .total = sizeof(globBuffer)};
+
+      struct glob glob;
+      b8 isCompiled = GlobCompile(&arena, &testCase->pattern, 1, &glob, 0);
+      u64 patternIndex = U64_MAX;
+      b8 got = isCompiled && GlobMatch(&glob, &testCase->path, &patternIndex);
+      if (!isCompiled || got != testCase->expected || (got && patternIndex != 0)) {
+        errorCode = GLOB_TEST_ERROR_MATCH;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  pattern: ");
+        StringBuilderAppendString(sb, &testCase->pattern);
+        StringBuilderAppendStringLiteral(sb, "\n     path: ");
+        StringBuilderAppendString(sb, &testCase->path);
+        StringBuilderAppendStringLiteral(sb, "\n expected: ");
+        struct string *expected = testCase->expected ? &StringFromLiteral("match") : &StringFromLiteral("no match");
+        StringBuilderAppendString(sb, expected);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // many patterns, state vector longer than one word
+  {
+    struct string patterns[] = {
+        StringFromLiteral("build/**"),
+        StringFromLiteral("**/node_modules/**"),
+        StringFromLiteral("**/*.[oa]"),
+        StringFromLiteral("docs/very/long/directory/name/that/takes/many/states/*.md"),
+        StringFromLiteral("**/generated/**/*.pb.[ch]"),
+        StringFromLiteral("**/*.log"),
+        StringFromLiteral("**"),
+    };
+    struct test_case {
+      struct string path;
+      u64 expected;
+    } testCases[] = {
+        {.path = StringFromLiteral("build/text.o"), .expected = 0},
+        {.path = StringFromLiteral("web/node_modules/x/index.js"), .expected = 1},
+        {.path = StringFromLiteral("src/text.o"), .expected = 2},
+        {.path = StringFromLiteral("docs/very/long/directory/name/that/takes/many/states/README.md"), .expected = 3},
+        {.path = StringFromLiteral("proto/generated/v1/api.pb.c"), .expected = 4},
+        {.path = StringFromLiteral("var/server.log"), .expected = 5},
+        {.path = StringFromLiteral("src/text.c"), .expected = 6},
+    };
+
+    memory_arena arena = {.block = globBuffer, .total = sizeof(globBuffer)};
+    struct glob glob;
+    b8 isCompiled = GlobCompile(&arena, patterns, ARRAY_COUNT(patterns), &glob, 0);
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+      u64 patternIndex = U64_MAX;
+      if (!isCompiled || glob.wordCount < 2 || !GlobMatch(&glob, &testCase->path, &patternIndex) ||
+          patternIndex != testCase->expected) {
+        errorCode = GLOB_TEST_ERROR_MATCH_MANY;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n      path: ");
+        StringBuilderAppendString(sb, &testCase->path);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendU64(sb, testCase->expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendU64(sb, patternIndex);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // directory of path from PathGetDirectory(), "" when there is none
+  {
+    struct test_case {
+      struct string path;
+      b8 expected;
+    } testCases[] = {
+        {.path = StringFromLiteral("build/lib/text.o"), .expected = 1},
+        {.path = StringFromLiteral("build/text.o"), .expected = 0},
+        {.path = StringFromLiteral("src/.cache/text.c"), .expected = 1},
+        {.path = StringFromLiteral("src/text.c"), .expected = 0},
+        {.path = StringFromLiteral("text.c"), .expected = 1},
+    };
+    struct string patterns[] = {
+        StringFromLiteral("build/**"),
+        StringFromLiteral("**/.cache"),
+        StringFromLiteral(""),
+    };
+    memory_arena arena = {.block = globBuffer, .total = sizeof(globBuffer)};
+    struct glob glob;
+    b8 isCompiled = GlobCompile(&arena, patterns, ARRAY_COUNT(patterns), &glob, 0);
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+      struct string directory = PathGetDirectory(&testCase->path);
+      b8 got = isCompiled && GlobMatch(&glob, &directory, 0);
+      if (got != testCase->expected) {
+        errorCode = GLOB_TEST_ERROR_MATCH;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  directory of: ");
+        StringBuilderAppendString(sb, &testCase->path);
+        StringBuilderAppendStringLiteral(sb, "\n      expected: ");
+        struct string *expected = testCase->expected ? &StringFromLiteral("match") : &StringFromLiteral("no match");
+        StringBuilderAppendString(sb, expected);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // b8 GlobCompile(memory_arena *arena, struct string *patterns, u64 patternCount, struct glob *glob,
+  //                u64 *errorIndex)
+  {
+    struct string testCases[] = {
+        StringFromLiteral("[abc"),
+        StringFromLiteral("[!]"),
+        StringFromLiteral("abc\\"),
+        StringFromLiteral("[a\\"),
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct string patterns[] = {StringFromLiteral("*.c"), testCases[testCaseIndex]};
+      memory_arena arena = {.block = globBuffer, .total = sizeof(globBuffer)};
+      struct glob glob;
+      u64 errorIndex = 0;
+      if (GlobCompile(&arena, patterns, ARRAY_COUNT(patterns), &glob, &errorIndex) || errorIndex != 1 ||
+          arena.used != 0) {
+        errorCode = GLOB_TEST_ERROR_COMPILE_INVALID;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  pattern: ");
+        StringBuilderAppendString(sb, testCases + testCaseIndex);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+
+    memory_arena smallMemory = {.block = globBuffer, .total = KILOBYTES};
+    struct glob glob;
+    u64 errorIndex = 0;
+    if (GlobCompile(&smallMemory, &StringFromLiteral("*.c"), 1, &glob, &errorIndex) || errorIndex != 1 ||
+        smallMemory.used != 0) {
+      errorCode = GLOB_TEST_ERROR_COMPILE_OUT_OF_MEMORY;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+  }
+
+  return (int)errorCode;
+}
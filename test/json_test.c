@@ -0,0 +1,581 @@
+#include "platform.h"
+// platform.h must be first, it selects POSIX features
+#include "json.h"
+#include "string_builder.h"
+
+#define TEST_ERROR_LIST(X)                                                                                             \
+  X(JSON_TEST_ERROR_ESCAPED_MASK, "JSONEscapedMask64: Escaped bytes must match backslash series")                      \
+  X(JSON_TEST_ERROR_PARSE_EXPECTED_TRUE, "JSONParse: Valid document must be parsed into expected tape")                \
+  X(JSON_TEST_ERROR_PARSE_EXPECTED_FALSE, "JSONParse: Invalid document must fail at expected position")                \
+  X(JSON_TEST_ERROR_PARSE_LONG_STRINGS, "JSONParse: Strings crossing blocks must match strings written")               \
+  X(JSON_TEST_ERROR_PARSE_OUT_OF_MEMORY, "JSONParse: Must fail and leave arena untouched when full")                   \
+  X(JSON_TEST_ERROR_GET_VALUE, "JSONObjectGet/JSONArrayGet: Value must match expected")                                \
+  X(JSON_TEST_ERROR_UNESCAPE, "JSONUnescape: Decoded string must match expected")                                      \
+  X(JSON_TEST_ERROR_APPEND_STRING, "StringBuilderAppendJSONString: Escaped string must match expected")                \
+  X(JSON_TEST_ERROR_WRITER, "JSONWriter: Written document must match expected")
+
+enum json_test_error {
+  JSON_TEST_ERROR_NONE = 0,
+#define X(tag, message) tag,
+  TEST_ERROR_LIST(X)
+#undef X
+
+  // src: https://mesonbuild.com/Unit-tests.html#skipped-tests-and-hard-errors
+  // For the default exitcode testing protocol, the GNU standard approach in
+  // this case is to exit the program with error code 77. Meson will detect this
+  // and report these tests as skipped rather than failed. This behavior was
+  // added in version 0.37.0.
+  MESON_TEST_SKIP = 77,
+  // In addition, sometimes a test fails set up so that it should fail even if
+  // it is marked as an expected failure. The GNU standard approach in this case
+  // is to exit the program with error code 99. Again, Meson will detect this
+  // and report these tests as ERROR, ignoring the setting of should_fail. This
+  // behavior was added in version 0.50.0.
+  MESON_TEST_FAILED_TO_SET_UP = 99,
+};
+
+internalfn void
+StringBuilderAppendErrorMessage(struct string_builder *stringBuilder, enum json_test_error errorCode)
+{
+  struct error {
+    enum json_test_error code;
+    struct string message;
+  } errors[] = {
+#define XX(tag, msg) {.code = tag, .message = StringFromLiteral(msg)},
+      TEST_ERROR_LIST(XX)
+#undef XX
+  };
+
+  struct string message = StringFromLiteral("Unknown error");
+  for (u32 index = 0; index < ARRAY_COUNT(errors); index++) {
+    struct error *error = errors + index;
+    if (error->code == errorCode) {
+      message = error->message;
+      break;
+    }
+  }
+
+  StringBuilderAppendString(stringBuilder, &message);
+}
+
+/*
+ * Writes value back as minified JSON.
+ * @return value after this one
+ */
+internalfn struct json_value *
+StringBuilderAppendJSONValue(string_builder *sb, struct json_value *value)
+{
+  if (value->type == JSON_TYPE_STRING) {
+    StringBuilderAppendStringLiteral(sb, "\"");
+    StringBuilderAppendString(sb, &value->text);
+    StringBuilderAppendStringLiteral(sb, "\"");
+    return value + 1;
+  }
+
+  if (value->type != JSON_TYPE_ARRAY && value->type != JSON_TYPE_OBJECT) {
+    StringBuilderAppendString(sb, &value->text);
+    return value + 1;
+  }
+
+  b8 isObject = value->type == JSON_TYPE_OBJECT;
+  StringBuilderAppendString(sb, isObject ? &StringFromLiteral("{") : &StringFromLiteral("["));
+  struct json_value *child = value + 1;
+  for (u32 index = 0; index < value->count; index++) {
+    if (index != 0)
+      StringBuilderAppendStringLiteral(sb, ",");
+    if (isObject) {
+      child = StringBuilderAppendJSONValue(sb, child);
+      StringBuilderAppendStringLiteral(sb, ":");
+    }
+    child = StringBuilderAppendJSONValue(sb, child);
+  }
+  StringBuilderAppendString(sb, isObject ? &StringFromLiteral("}") : &StringFromLiteral("]"));
+
+  debug_assert(child == value + value->size);
+  return child;
+}
+
+int
+main(void)
+{
+  enum json_test_error errorCode = JSON_TEST_ERROR_NONE;
+
+  // setup
+  enum { KILOBYTES = (1 << 10) };
+  u8 stackBuffer[8 * KILOBYTES];
+  memory_arena stackMemory = {
+      .block = stackBuffer,
+      .total = ARRAY_COUNT(stackBuffer),
+  };
+
+  string_builder *sb = MakeStringBuilder(&stackMemory, 1024, 32);
+
+  static u8 tapeBuffer[64 * KILOBYTES];
+
+  // u64 JSONEscapedMask64(u64 backslashes, u64 *isNextEscaped)
+  {
+    u64 random = 0x9e3779b97f4a7c15;
+    for (u32 trial = 0; trial < 1000; trial++) {
+      // mostly backslashes, to have long series crossing blocks
+      u64 blocks[4];
+      for (u32 blockIndex = 0; blockIndex < ARRAY_COUNT(blocks); blockIndex++) {
+        random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+        u64 first = random;
+        random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+        blocks[blockIndex] = first | random;
+      }
+
+      b8 isEscaped = 0;
+      u64 isNextEscaped = 0;
+      for (u32 blockIndex = 0; blockIndex < ARRAY_COUNT(blocks); blockIndex++) {
+        u64 backslashes = blocks[blockIndex];
+        u64 expected = 0;
+        for (u32 bit = 0; bit < 64; bit++) {
+          b8 isBackslash = (backslashes >> bit) & 1;
+          if (isEscaped) {
+            expected |= (u64)1 << bit;
+            isEscaped = 0;
+          } else if (isBackslash) {
+            isEscaped = 1;
+          }
+        }
+
+        u64 got = JSONEscapedMask64(backslashes, &isNextEscaped);
+        if (got != expected) {
+          errorCode = JSON_TEST_ERROR_ESCAPED_MASK;
+
+          StringBuilderAppendErrorMessage(sb, errorCode);
+          StringBuilderAppendStringLiteral(sb, "\n  backslashes: 0x");
+          StringBuilderAppendHex(sb, backslashes);
+          StringBuilderAppendStringLiteral(sb, "\n     expected: 0x");
+          StringBuilderAppendHex(sb, expected);
+          StringBuilderAppendStringLiteral(sb, "\n          got: 0x");
+          StringBuilderAppendHex(sb, got);
+          StringBuilderAppendStringLiteral(sb, "\n");
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+          break;
+        }
+      }
+    }
+  }
+
+  // b8 JSONParse(memory_arena *arena, struct string *source, struct json_tape *tape, u64 *errorIndex)
+  {
+    struct test_case {
+      struct string input;
+      struct string expected;
+    } testCases[] = {
+        {
+            .input = StringFromLiteral("  {\"a\": 1, \"b\" : [true, false, null],\n \"c\": {\"d\": \"e\\\"f\"}}  "),
+            .expected = StringFromLiteral("{\"a\":1,\"b\":[true,false,null],\"c\":{\"d\":\"e\\\"f\"}}"),
+        },
+        {.input = StringFromLiteral("[]"), .expected = StringFromLiteral("[]")},
+        {.input = StringFromLiteral("{ }"), .expected = StringFromLiteral("{}")},
+        {.input = StringFromLiteral("[[],[{}],[[1]]]"), .expected = StringFromLiteral("[[],[{}],[[1]]]")},
+        {.input = StringFromLiteral("\"x\""), .expected = StringFromLiteral("\"x\"")},
+        {.input = StringFromLiteral("\"\""), .expected = StringFromLiteral("\"\"")},
+        {.input = StringFromLiteral(" -0.5e+10 "), .expected = StringFromLiteral("-0.5e+10")},
+        {
+            .input = StringFromLiteral("[\"\\\\\",\"\\\\\\\"\"]"),
+            .expected = StringFromLiteral("[\"\\\\\",\"\\\\\\\"\"]"),
+        },
+        {.input = StringFromLiteral("[\"{\\\"a\\\":[1]}\"]"), .expected = StringFromLiteral("[\"{\\\"a\\\":[1]}\"]")},
+        {.input = StringFromLiteral("{\"κλειδί\":\"こんにちは\"}"), .expected = StringFromLiteral("{\"κλειδί\":\"こんにちは\"}")},
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+      memory_arena arena = {.block = tapeBuffer, .total = sizeof(tapeBuffer)};
+
+      struct json_tape tape;
+      u64 errorIndex = 0;
+      b8 isParsed = JSONParse(&arena, &testCase->input, &tape, &errorIndex);
+      struct string got = StringNull();
+      if (isParsed) {
+        StringBuilderAppendJSONValue(sb, tape.values);
+        got = StringBuilderFlush(sb);
+      }
+
+      if (!isParsed || !IsStringEqual(&got, &testCase->expected) || tape.values->size != tape.count ||
+          arena.used != tape.count * sizeof(*tape.values)) {
+        errorCode = JSON_TEST_ERROR_PARSE_EXPECTED_TRUE;
+
+        u8 gotBuffer[128];
+        MemoryCopy(gotBuffer, got.value, got.length);
+        got.value = gotBuffer;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n     input: ");
+        StringBuilderAppendString(sb, &testCase->input);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendString(sb, &testCase->expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        if (isParsed)
+          StringBuilderAppendString(sb, &got);
+        else {
+          StringBuilderAppendStringLiteral(sb, "error at ");
+          StringBuilderAppendU64(sb, errorIndex);
+        }
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // b8 JSONParse(memory_arena *arena, struct string *source, struct json_tape *tape, u64 *errorIndex)
+  {
+    struct test_case {
+      struct string input;
+      u64 expected;
+    } testCases[] = {
+        {.input = StringFromLiteral(""), .expected = 0},
+        {.input = StringFromLiteral("   "), .expected = 3},
+        {.input = StringFromLiteral("{\"a\" 1}"), .expected = 5},
+        {.input = StringFromLiteral("{\"a\":1,}"), .expected = 7},
+        {.input = StringFromLiteral("{1:2}"), .expected = 1},
+        {.input = StringFromLiteral("[1,]"), .expected = 3},
+        {.input = StringFromLiteral("[1 2]"), .expected = 3},
+        {.input = StringFromLiteral("[1,2}"), .expected = 4},
+        {.input = StringFromLiteral("{\"a\":1"), .expected = 6},
+        {.input = StringFromLiteral("[1]]"), .expected = 3},
+        {.input = StringFromLiteral("[01]"), .expected = 1},
+        {.input = StringFromLiteral("[1.]"), .expected = 1},
+        {.input = StringFromLiteral("[+1]"), .expected = 1},
+        {.input = StringFromLiteral("[tru]"), .expected = 1},
+        {.input = StringFromLiteral("[\"a\"b]"), .expected = 4},
+        {.input = StringFromLiteral("\"abc"), .expected = 4},
+        {.input = StringFromLiteral("\"abc\\\""), .expected = 6},
+        {.input = StringFromLiteral("\"a\tb\""), .expected = 2},
+        {.input = StringFromLiteral("[\"\xff\"]"), .expected = 2},
+        {.input = StringFromLiteral("[\"\\q\"]"), .expected = 3},
+        {.input = StringFromLiteral("[\"\\u12\"]"), .expected = 3},
+        {.input = StringFromLiteral("[\"\\u12g4\"]"), .expected = 3},
+        {.input = StringFromLiteral("[\"\\u12"), .expected = 3},
+        // backslash is last byte of block, escape is first byte of next one
+        {.input = StringFromLiteral("[\"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\\x\"]"), .expected = 64},
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+      memory_arena arena = {.block = tapeBuffer, .total = sizeof(tapeBuffer)};
+
+      struct json_tape tape;
+      u64 errorIndex = U64_MAX;
+      b8 isParsed = JSONParse(&arena, &testCase->input, &tape, &errorIndex);
+      if (isParsed || errorIndex != testCase->expected || arena.used != 0) {
+        errorCode = JSON_TEST_ERROR_PARSE_EXPECTED_FALSE;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n     input: ");
+        StringBuilderAppendString(sb, &testCase->input);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendU64(sb, testCase->expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        if (isParsed)
+          StringBuilderAppendStringLiteral(sb, "parsed");
+        else
+          StringBuilderAppendU64(sb, errorIndex);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // Strings with escapes and structural characters crossing 64 byte blocks
+  {
+    struct string pieces[] = {
+        StringFromLiteral("a"),   StringFromLiteral("\\\\"), StringFromLiteral("\\\""),
+        StringFromLiteral(","),   StringFromLiteral("]"),    StringFromLiteral(" "),
+        StringFromLiteral("\\n"), StringFromLiteral("{"),
+    };
+    enum { STRING_COUNT = 64, STRING_MAX = 40 };
+    struct string strings[STRING_COUNT];
+    static u8 input[STRING_COUNT * (STRING_MAX + 4) + 2];
+    u64 inputLength = 0;
+
+    u64 random = 0x9e3779b97f4a7c15;
+    input[inputLength++] = '[';
+    for (u32 stringIndex = 0; stringIndex < STRING_COUNT; stringIndex++) {
+      if (stringIndex != 0)
+        input[inputLength++] = ',';
+      input[inputLength++] = '"';
+      strings[stringIndex].value = input + inputLength;
+      u64 length = 0;
+      while (1) {
+        random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+        struct string *piece = pieces + random % ARRAY_COUNT(pieces);
+        if (length + piece->length > STRING_MAX || random % 11 == 0)
+          break;
+        MemoryCopy(input + inputLength, piece->value, piece->length);
+        inputLength += piece->length;
+        length += piece->length;
+      }
+      strings[stringIndex].length = length;
+      input[inputLength++] = '"';
+    }
+    input[inputLength++] = ']';
+
+    struct string source = StringFromBuffer(input, inputLength);
+    memory_arena arena = {.block = tapeBuffer, .total = sizeof(tapeBuffer)};
+    struct json_tape tape;
+    b8 isEqual = JSONParse(&arena, &source, &tape, 0) && tape.count == STRING_COUNT + 1 &&
+                 tape.values->count == STRING_COUNT;
+    for (u32 stringIndex = 0; isEqual && stringIndex < STRING_COUNT; stringIndex++) {
+      struct json_value *value = tape.values + 1 + stringIndex;
+      isEqual = value->type == JSON_TYPE_STRING && IsStringEqual(&value->text, strings + stringIndex);
+    }
+
+    if (!isEqual) {
+      errorCode = JSON_TEST_ERROR_PARSE_LONG_STRINGS;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+
+    // Out of memory
+    arena = (memory_arena){.block = tapeBuffer, .total = 256};
+    if (JSONParse(&arena, &source, &tape, 0) || arena.used != 0) {
+      errorCode = JSON_TEST_ERROR_PARSE_OUT_OF_MEMORY;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+  }
+
+  // struct json_value *JSONObjectGet(struct json_value *object, struct string *key)
+  // struct json_value *JSONArrayGet(struct json_value *array, u64 index)
+  {
+    struct string input = StringFromLiteral("{\"u\": 18446744073709551615, \"s\": -9223372036854775808, \"f\": 2.5,"
+                                            " \"b\": true, \"n\": null, \"a\": [10, {\"x\": [20]}, 30]}");
+    memory_arena arena = {.block = tapeBuffer, .total = sizeof(tapeBuffer)};
+    struct json_tape tape;
+    b8 isEqual = JSONParse(&arena, &input, &tape, 0);
+
+    struct json_value *root = tape.values;
+    u64 u = 0;
+    s64 s = 0;
+    f64 f = 0;
+    b8 b = 0;
+    isEqual = isEqual && JSONValueGetU64(JSONObjectGet(root, &StringFromLiteral("u")), &u) && u == U64_MAX;
+    isEqual = isEqual && JSONValueGetS64(JSONObjectGet(root, &StringFromLiteral("s")), &s) && s == S64_MIN;
+    isEqual = isEqual && JSONValueGetF64(JSONObjectGet(root, &StringFromLiteral("f")), &f) && f == 2.5;
+    isEqual = isEqual && JSONValueGetBoolean(JSONObjectGet(root, &StringFromLiteral("b")), &b) && b == 1;
+    isEqual = isEqual && JSONObjectGet(root, &StringFromLiteral("n"))->type == JSON_TYPE_NULL;
+    isEqual = isEqual && !JSONValueGetU64(JSONObjectGet(root, &StringFromLiteral("f")), &u);
+    isEqual = isEqual && JSONObjectGet(root, &StringFromLiteral("missing")) == 0;
+
+    struct json_value *array = isEqual ? JSONObjectGet(root, &StringFromLiteral("a")) : 0;
+    isEqual = isEqual && array->count == 3 && JSONValueGetU64(JSONArrayGet(array, 2), &u) && u == 30;
+    isEqual = isEqual && JSONArrayGet(array, 3) == 0;
+    struct json_value *x = isEqual ? JSONObjectGet(JSONArrayGet(array, 1), &StringFromLiteral("x")) : 0;
+    isEqual = isEqual && x && JSONValueGetU64(JSONArrayGet(x, 0), &u) && u == 20;
+
+    if (!isEqual) {
+      errorCode = JSON_TEST_ERROR_GET_VALUE;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+  }
+
+  // struct string JSONUnescape(struct string *string)
+  {
+    struct test_case {
+      struct string input;
+      struct string expected;
+    } testCases[] = {
+        {.input = StringFromLiteral("plain"), .expected = StringFromLiteral("plain")},
+        {.input = StringFromLiteral("a\\nb\\t\\\"\\\\\\/"), .expected = StringFromLiteral("a\nb\t\"\\/")},
+        {.input = StringFromLiteral("caf\\u00e9"), .expected = StringFromLiteral("café")},
+        {.input = StringFromLiteral("\\u3053\\u3093"), .expected = StringFromLiteral("こん")},
+        {.input = StringFromLiteral("\\ud83d\\ude00!"), .expected = StringFromLiteral("😀!")},
+        {.input = StringFromLiteral("\\x"), .expected = StringNull()},
+        {.input = StringFromLiteral("a\\"), .expected = StringNull()},
+        {.input = StringFromLiteral("\\u12"), .expected = StringNull()},
+        {.input = StringFromLiteral("\\udc00"), .expected = StringNull()},
+        {.input = StringFromLiteral("\\ud83d"), .expected = StringNull()},
+        {.input = StringFromLiteral("\\ud83d\\u0041"), .expected = StringNull()},
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      u8 buffer[32];
+      MemoryCopy(buffer, testCase->input.value, testCase->input.length);
+      struct string input = StringFromBuffer(buffer, testCase->input.length);
+      struct string got = JSONUnescape(&input);
+      if (IsStringNull(&got) != IsStringNull(&testCase->expected) ||
+          (!IsStringNull(&got) && !IsStringEqual(&got, &testCase->expected))) {
+        errorCode = JSON_TEST_ERROR_UNESCAPE;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n     input: ");
+        StringBuilderAppendString(sb, &testCase->input);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendString(sb, &testCase->expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendString(sb, &got);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // void StringBuilderAppendJSONString(string_builder *stringBuilder, struct string *string)
+  {
+    struct test_case {
+      struct string input;
+      struct string expected;
+    } testCases[] = {
+        {.input = StringFromLiteral(""), .expected = StringFromLiteral("\"\"")},
+        {.input = StringFromLiteral("plain"), .expected = StringFromLiteral("\"plain\"")},
+        {.input = StringFromLiteral("a\"b\\c/"), .expected = StringFromLiteral("\"a\\\"b\\\\c/\"")},
+        {.input = StringFromLiteral("\b\f\n\r\t"), .expected = StringFromLiteral("\"\\b\\f\\n\\r\\t\"")},
+        {.input = StringFromLiteral("\x01\x1f\x7f"), .expected = StringFromLiteral("\"\\u0001\\u001f\x7f\"")},
+        {.input = StringFromLiteral("café ¢ ܜ 😀"), .expected = StringFromLiteral("\"café ¢ ܜ 😀\"")},
+        {
+            .input = StringFromLiteral("0123456789abcdef0123456789abcdef0123456789"),
+            .expected = StringFromLiteral("\"0123456789abcdef0123456789abcdef0123456789\""),
+        },
+        {
+            .input = StringFromLiteral("0123456789abcdef0123456789abcde\n0123456789\""),
+            .expected = StringFromLiteral("\"0123456789abcdef0123456789abcde\\n0123456789\\\"\""),
+        },
+        {
+            .input = StringFromLiteral("\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n"),
+            .expected = StringFromLiteral("\"\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n"
+                                          "\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\""),
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      StringBuilderAppendJSONString(sb, &testCase->input);
+      struct string got = StringBuilderFlush(sb);
+      if (!IsStringEqual(&got, &testCase->expected)) {
+        errorCode = JSON_TEST_ERROR_APPEND_STRING;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n     input: ");
+        StringBuilderAppendString(sb, &testCase->input);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendString(sb, &testCase->expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendString(sb, &got);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+
+    // every byte value must come back same after parse and unescape
+    u8 input[256];
+    for (u32 index = 0; index < ARRAY_COUNT(input); index++)
+      input[index] = (u8)index;
+    // stay valid UTF-8
+    struct string inputString = StringFromBuffer(input, 0x80);
+
+    StringBuilderAppendJSONString(sb, &inputString);
+    struct string written = StringBuilderFlush(sb);
+    memory_arena arena = {.block = tapeBuffer, .total = ARRAY_COUNT(tapeBuffer)};
+    struct json_tape tape;
+    struct string got = StringNull();
+    if (JSONParse(&arena, &written, &tape, 0) && tape.values[0].type == JSON_TYPE_STRING)
+      got = JSONUnescape(&tape.values[0].text);
+    if (IsStringNull(&got) || !IsStringEqual(&got, &inputString)) {
+      errorCode = JSON_TEST_ERROR_APPEND_STRING;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n  all ascii bytes must round trip, written: ");
+      StringBuilderAppendString(sb, &written);
+      StringBuilderAppendStringLiteral(sb, "\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+  }
+
+  // struct json_writer JSONWriterFrom(string_builder *stringBuilder)
+  {
+    struct json_writer writer = JSONWriterFrom(sb);
+    JSONWriterBeginObject(&writer);
+    JSONWriterKey(&writer, &StringFromLiteral("name"));
+    JSONWriterString(&writer, &StringFromLiteral("line\n\"quoted\""));
+    JSONWriterKey(&writer, &StringFromLiteral("empty"));
+    JSONWriterBeginObject(&writer);
+    JSONWriterEndObject(&writer);
+    JSONWriterKey(&writer, &StringFromLiteral("values"));
+    JSONWriterBeginArray(&writer);
+    JSONWriterU64(&writer, 18446744073709551615ull);
+    JSONWriterS64(&writer, S64_MIN);
+    JSONWriterS64(&writer, 42);
+    JSONWriterF32(&writer, 1.5f, 2);
+    JSONWriterF32(&writer, -0.25f, 2);
+    JSONWriterF32(&writer, 1.0f / 0.0f, 2);
+    JSONWriterBoolean(&writer, 1);
+    JSONWriterBoolean(&writer, 0);
+    JSONWriterNull(&writer);
+    JSONWriterBeginArray(&writer);
+    JSONWriterEndArray(&writer);
+    JSONWriterBeginArray(&writer);
+    JSONWriterBeginObject(&writer);
+    JSONWriterKey(&writer, &StringFromLiteral("a"));
+    JSONWriterU64(&writer, 1);
+    JSONWriterEndObject(&writer);
+    JSONWriterEndArray(&writer);
+    JSONWriterEndArray(&writer);
+    JSONWriterKey(&writer, &StringFromLiteral("last"));
+    JSONWriterU64(&writer, 0);
+    JSONWriterEndObject(&writer);
+
+    struct string expected = StringFromLiteral("{\"name\":\"line\\n\\\"quoted\\\"\",\"empty\":{},\"values\":["
+                                               "18446744073709551615,-9223372036854775808,42,1.50,-0.25,null,"
+                                               "true,false,null,[],[{\"a\":1}]],\"last\":0}");
+    struct string got = StringBuilderFlush(sb);
+
+    memory_arena arena = {.block = tapeBuffer, .total = ARRAY_COUNT(tapeBuffer)};
+    struct json_tape tape;
+    if (writer.depth != 0 || !IsStringEqual(&got, &expected) || !JSONParse(&arena, &got, &tape, 0)) {
+      errorCode = JSON_TEST_ERROR_WRITER;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+      StringBuilderAppendString(sb, &expected);
+      StringBuilderAppendStringLiteral(sb, "\n       got: ");
+      StringBuilderAppendString(sb, &got);
+      StringBuilderAppendStringLiteral(sb, "\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+
+    // top level values are written without separators
+    writer = JSONWriterFrom(sb);
+    JSONWriterU64(&writer, 7);
+    expected = StringFromLiteral("7");
+    got = StringBuilderFlush(sb);
+    if (!IsStringEqual(&got, &expected)) {
+      errorCode = JSON_TEST_ERROR_WRITER;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+      StringBuilderAppendString(sb, &expected);
+      StringBuilderAppendStringLiteral(sb, "\n       got: ");
+      StringBuilderAppendString(sb, &got);
+      StringBuilderAppendStringLiteral(sb, "\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+  }
+
+  return (int)errorCode;
+}
@@ -0,0 +1,438 @@
+#include "platform.h"
+// platform.h must be first, it selects POSIX features
+#include "lz.h"
+#include "string_builder.h"
+
+#define TEST_ERROR_LIST(X)                                                                                             \
+  X(LZ_TEST_ERROR_ROUND_TRIP, "LZCompress: Decompressed input must equal input")                                      \
+  X(LZ_TEST_ERROR_RATIO, "LZCompress: Repetitive input must be compressed")                                            \
+  X(LZ_TEST_ERROR_KNOWN_BLOCK, "LZDecompress: Block in LZ4 format must be decompressed as expected")                   \
+  X(LZ_TEST_ERROR_MALFORMED, "LZDecompress: Malformed block must fail at expected position")                           \
+  X(LZ_TEST_ERROR_CORRUPTED, "LZDecompress: Corrupted block must fail or stay in bounds")                              \
+  X(LZ_TEST_ERROR_OUT_OF_MEMORY, "LZCompress: Must fail and leave arena untouched when full")                          \
+  X(LZ_TEST_ERROR_FRAME, "LZFrameReaderNext: Frame read in chunks must equal input written in pieces")                 \
+  X(LZ_TEST_ERROR_FRAME_MALFORMED, "LZFrameReaderNext: Malformed frame must fail")
+
+enum lz_test_error {
+  LZ_TEST_ERROR_NONE = 0,
+#define X(tag, message) tag,
+  TEST_ERROR_LIST(X)
+#undef X
+
+  // src: https://mesonbuild.com/Unit-tests.html#skipped-tests-and-hard-errors
+  // For the default exitcode testing protocol, the GNU standard approach in
+  // this case is to exit the program with error code 77. Meson will detect this
+  // and report these tests as skipped rather than failed. This behavior was
+  // added in version 0.37.0.
+  MESON_TEST_SKIP = 77,
+  // In addition, sometimes a test fails set up so that it should fail even if
+  // it is marked as an expected failure. The GNU standard approach in this case
+  // is to exit the program with error code 99. Again, Meson will detect this
+  // and report these tests as ERROR, ignoring the setting of should_fail. This
+  // behavior was added in version 0.50.0.
+  MESON_TEST_FAILED_TO_SET_UP = 99,
+};
+
+internalfn void
+StringBuilderAppendErrorMessage(struct string_builder *stringBuilder, enum lz_test_error errorCode)
+{
+  struct error {
+    enum lz_test_error code;
+    struct string message;
+  } errors[] = {
+#define XX(tag, msg) {.code = tag, .message = StringFromLiteral(msg)},
+      TEST_ERROR_LIST(XX)
+#undef XX
+  };
+
+  struct string message = StringFromLiteral("Unknown error");
+  for (u32 index = 0; index < ARRAY_COUNT(errors); index++) {
+    struct error *error = errors + index;
+    if (error->code == errorCode) {
+      message = error->message;
+      break;
+    }
+  }
+
+  StringBuilderAppendString(stringBuilder, &message);
+}
+
+struct chunked_source {
+  struct string_cursor cursor;
+  u64 chunkSize;
+};
+
+// string_stream_read that reads at most chunkSize bytes at once
+internalfn u64
+ChunkedSourceRead(void *context, u8 *buffer, u64 length)
+{
+  struct chunked_source *source = context;
+  return StringStreamReadFromCursor(&source->cursor, buffer, Minimum(length, source->chunkSize));
+}
+
+int
+main(void)
+{
+  enum lz_test_error errorCode = LZ_TEST_ERROR_NONE;
+
+  // setup
+  enum { KILOBYTES = (1 << 10) };
+  u8 stackBuffer[8 * KILOBYTES];
+  memory_arena stackMemory = {
+      .block = stackBuffer,
+      .total = ARRAY_COUNT(stackBuffer),
+  };
+
+  string_builder *sb = MakeStringBuilder(&stackMemory, 1024, 32);
+
+  static u8 lzBuffer[2048 * KILOBYTES];
+
+  // inputs: text, runs, periodic patterns, random bytes and their mixes
+  enum { INPUT_MAX = 200 * KILOBYTES };
+  static u8 inputBuffer[INPUT_MAX];
+  u64 random = 0x9e3779b97f4a7c15;
+#define NEXT_RANDOM() (random ^= random << 13, random ^= random >> 7, random ^= random << 17)
+  {
+    struct string words[] = {
+        StringFromLiteral("INFO "),   StringFromLiteral("request "), StringFromLiteral("/api/users "),
+        StringFromLiteral("took "),   StringFromLiteral("12ms\n"),   StringFromLiteral("ERROR "),
+        StringFromLiteral("timeout"), StringFromLiteral(", "),       StringFromLiteral("0x0002cca4"),
+    };
+    u64 length = 0;
+    while (length < INPUT_MAX) {
+      u64 kind = NEXT_RANDOM() % 8;
+      if (kind < 5) {
+        struct string *word = words + NEXT_RANDOM() % ARRAY_COUNT(words);
+        for (u64 index = 0; index < word->length && length < INPUT_MAX; index++)
+          inputBuffer[length++] = word->value[index];
+      } else if (kind == 5) {
+        // run of same byte or short period, up to 300 bytes
+        u64 period = 1 + NEXT_RANDOM() % 20;
+        u64 runLength = NEXT_RANDOM() % 300;
+        for (u64 index = 0; index < runLength && length < INPUT_MAX; index++)
+          inputBuffer[length++] = (u8)('a' + index % period);
+      } else {
+        u64 randomLength = NEXT_RANDOM() % 64;
+        for (u64 index = 0; index < randomLength && length < INPUT_MAX; index++)
+          inputBuffer[length++] = (u8)NEXT_RANDOM();
+      }
+    }
+  }
+
+  // struct string LZCompress(memory_arena *arena, struct string *input, u32 searchDepth)
+  // struct string LZDecompress(memory_arena *arena, struct string *compressed, u64 decompressedLength,
+  //                            u64 *errorIndex)
+  {
+    static u8 randomBuffer[70 * KILOBYTES];
+    for (u64 index = 0; index < ARRAY_COUNT(randomBuffer); index++)
+      randomBuffer[index] = (u8)NEXT_RANDOM();
+    static u8 runBuffer[70 * KILOBYTES];
+    for (u64 index = 0; index < ARRAY_COUNT(runBuffer); index++)
+      runBuffer[index] = 'x';
+
+    struct string inputs[] = {
+        StringFromLiteral(""),
+        StringFromLiteral("a"),
+        StringFromLiteral("abcdefghijkl"),
+        StringFromLiteral("abcabcabcabcabcabcab"),
+        StringFromLiteral("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"),
+        StringFromLiteral("The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy cat."),
+        StringFromBuffer(randomBuffer, ARRAY_COUNT(randomBuffer)),
+        StringFromBuffer(runBuffer, ARRAY_COUNT(runBuffer)),
+        StringFromBuffer(inputBuffer, 1000),
+        StringFromBuffer(inputBuffer, INPUT_MAX),
+    };
+    u32 searchDepths[] = {1, 4, LZ_SEARCH_DEPTH_DEFAULT, 256};
+
+    for (u32 inputIndex = 0; inputIndex < ARRAY_COUNT(inputs); inputIndex++) {
+      for (u32 depthIndex = 0; depthIndex < ARRAY_COUNT(searchDepths); depthIndex++) {
+        struct string *input = inputs + inputIndex;
+        u32 searchDepth = searchDepths[depthIndex];
+        memory_arena arena = {.block = lzBuffer, .total = sizeof(lzBuffer)};
+
+        struct string compressed = LZCompress(&arena, input, searchDepth);
+        u64 errorIndex = U64_MAX;
+        struct string decompressed = StringNull();
+        if (!IsStringNull(&compressed))
+          decompressed = LZDecompress(&arena, &compressed, input->length, &errorIndex);
+
+        if (IsStringNull(&compressed) || compressed.length > LZ_COMPRESS_BOUND(input->length) ||
+            IsStringNull(&decompressed) || !IsStringEqual(&decompressed, input)) {
+          errorCode = LZ_TEST_ERROR_ROUND_TRIP;
+
+          StringBuilderAppendErrorMessage(sb, errorCode);
+          StringBuilderAppendStringLiteral(sb, "\n         input: ");
+          StringBuilderAppendU64(sb, inputIndex);
+          StringBuilderAppendStringLiteral(sb, "\n  search depth: ");
+          StringBuilderAppendU64(sb, searchDepth);
+          StringBuilderAppendStringLiteral(sb, "\n    compressed: ");
+          StringBuilderAppendU64(sb, compressed.length);
+          StringBuilderAppendStringLiteral(sb, "\n   error index: ");
+          StringBuilderAppendU64(sb, errorIndex);
+          StringBuilderAppendStringLiteral(sb, "\n");
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+          continue;
+        }
+
+        // long runs and text with repeated words
+        b8 isRepetitive = inputIndex == 4 || inputIndex == 7 || inputIndex == 9;
+        if (isRepetitive && compressed.length * 2 > input->length) {
+          errorCode = LZ_TEST_ERROR_RATIO;
+
+          StringBuilderAppendErrorMessage(sb, errorCode);
+          StringBuilderAppendStringLiteral(sb, "\n         input: ");
+          StringBuilderAppendU64(sb, inputIndex);
+          StringBuilderAppendStringLiteral(sb, "\n  search depth: ");
+          StringBuilderAppendU64(sb, searchDepth);
+          StringBuilderAppendStringLiteral(sb, "\n    compressed: ");
+          StringBuilderAppendU64(sb, compressed.length);
+          StringBuilderAppendStringLiteral(sb, " of ");
+          StringBuilderAppendU64(sb, input->length);
+          StringBuilderAppendStringLiteral(sb, "\n");
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+        }
+      }
+    }
+  }
+
+  // Block written by hand in LZ4 format
+  {
+    // "abc", match at offset 3 of 12 bytes, last literals "abcab"
+    u8 block[] = {0x38, 'a', 'b', 'c', 0x03, 0x00, 0x50, 'a', 'b', 'c', 'a', 'b'};
+    struct string compressed = StringFromBuffer(block, ARRAY_COUNT(block));
+    struct string expected = StringFromLiteral("abcabcabcabcabcabcab");
+    memory_arena arena = {.block = lzBuffer, .total = sizeof(lzBuffer)};
+    struct string decompressed = LZDecompress(&arena, &compressed, expected.length, 0);
+    if (!IsStringEqual(&decompressed, &expected)) {
+      errorCode = LZ_TEST_ERROR_KNOWN_BLOCK;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n  decompressed: ");
+      if (IsStringNull(&decompressed))
+        StringBuilderAppendStringLiteral(sb, "(NULL)");
+      else
+        StringBuilderAppendString(sb, &decompressed);
+      StringBuilderAppendStringLiteral(sb, "\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+  }
+
+  // u64 LZDecompressBlock(u8 *input, u64 inputLength, u8 *output, u64 outputCapacity, u64 *errorIndex)
+  {
+    struct test_case {
+      struct string block;
+      u64 capacity;
+      u64 expected;
+    } testCases[] = {
+        // empty
+        {.block = StringFromLiteral(""), .capacity = 16, .expected = 0},
+        // literal longer than block
+        {.block = StringFromLiteral("\x30" "ab"), .capacity = 16, .expected = 1},
+        // literal longer than capacity
+        {.block = StringFromLiteral("\x30" "abc"), .capacity = 2, .expected = 1},
+        // length bytes missing
+        {.block = StringFromLiteral("\xf0\xff"), .capacity = 1024, .expected = 2},
+        // offset is 1 byte
+        {.block = StringFromLiteral("\x10" "a\x01"), .capacity = 16, .expected = 2},
+        // offset 0
+        {.block = StringFromLiteral("\x10" "a\x00\x00\x10" "a"), .capacity = 16, .expected = 2},
+        // offset before start of output
+        {.block = StringFromLiteral("\x10" "a\x02\x00\x10" "a"), .capacity = 16, .expected = 2},
+        // match longer than capacity
+        {.block = StringFromLiteral("\x10" "a\x01\x00\x10" "a"), .capacity = 4, .expected = 4},
+        // no last literals after match
+        {.block = StringFromLiteral("\x10" "a\x01\x00"), .capacity = 16, .expected = 4},
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+      u8 output[1024];
+      u64 errorIndex = U64_MAX;
+      u64 length = LZDecompressBlock(testCase->block.value, testCase->block.length, output, testCase->capacity,
+                                     &errorIndex);
+      if (length != U64_MAX || errorIndex != testCase->expected) {
+        errorCode = LZ_TEST_ERROR_MALFORMED;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n   test case: ");
+        StringBuilderAppendU64(sb, testCaseIndex);
+        StringBuilderAppendStringLiteral(sb, "\n    expected: ");
+        StringBuilderAppendU64(sb, testCase->expected);
+        StringBuilderAppendStringLiteral(sb, "\n         got: ");
+        StringBuilderAppendU64(sb, errorIndex);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // Corrupted bytes of valid block, output must stay in capacity and bytes after it untouched
+  {
+    memory_arena arena = {.block = lzBuffer, .total = sizeof(lzBuffer)};
+    struct string input = StringFromBuffer(inputBuffer, 4 * KILOBYTES);
+    struct string compressed = LZCompress(&arena, &input, LZ_SEARCH_DEPTH_DEFAULT);
+    u8 *corrupted = MemoryArenaPush(&arena, compressed.length);
+    u8 *output = MemoryArenaPush(&arena, input.length + 64);
+
+    for (u32 iteration = 0; iteration < 2000; iteration++) {
+      MemoryCopy(corrupted, compressed.value, compressed.length);
+      for (u32 byteIndex = 0; byteIndex < 1 + iteration % 4; byteIndex++) {
+        u64 corruptedIndex = NEXT_RANDOM() % compressed.length;
+        corrupted[corruptedIndex] = (u8)NEXT_RANDOM();
+      }
+      u64 inputLength = compressed.length - (iteration % 3 == 0 ? NEXT_RANDOM() % compressed.length : 0);
+
+      for (u32 index = 0; index < 64; index++)
+        output[input.length + index] = 0xcd;
+      u64 length = LZDecompressBlock(corrupted, inputLength, output, input.length, 0);
+
+      b8 isGuardUntouched = 1;
+      for (u32 index = 0; index < 64; index++)
+        isGuardUntouched = isGuardUntouched && output[input.length + index] == 0xcd;
+      if (!isGuardUntouched || (length != U64_MAX && length > input.length)) {
+        errorCode = LZ_TEST_ERROR_CORRUPTED;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  iteration: ");
+        StringBuilderAppendU64(sb, iteration);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+        break;
+      }
+    }
+  }
+
+  // Arena too small
+  {
+    u8 smallBuffer[256];
+    memory_arena smallMemory = {.block = smallBuffer, .total = sizeof(smallBuffer)};
+    struct string input = StringFromBuffer(inputBuffer, 128);
+    struct string compressed = LZCompress(&smallMemory, &input, LZ_SEARCH_DEPTH_DEFAULT);
+    if (!IsStringNull(&compressed) || smallMemory.used != 0) {
+      errorCode = LZ_TEST_ERROR_OUT_OF_MEMORY;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+  }
+
+  // struct string LZFrameWriterWrite(struct lz_frame_writer *writer, struct string_cursor *input)
+  // struct string LZFrameReaderNext(struct lz_frame_reader *reader, struct string_stream *stream)
+  {
+    static u8 frameBuffer[LZ_COMPRESS_BOUND(INPUT_MAX) + 1024];
+    static u8 windowBuffer[LZ_FRAME_WINDOW_MIN];
+    u64 pieceSizes[] = {1, 1000, LZ_FRAME_BLOCK_SIZE - 1, LZ_FRAME_BLOCK_SIZE, INPUT_MAX};
+    u64 chunkSizes[] = {997, 4099, LZ_FRAME_WINDOW_MIN};
+
+    for (u32 pieceIndex = 0; pieceIndex < ARRAY_COUNT(pieceSizes); pieceIndex++) {
+      u64 pieceSize = pieceSizes[pieceIndex];
+      memory_arena arena = {.block = lzBuffer, .total = sizeof(lzBuffer)};
+      struct lz_frame_writer writer;
+      LZFrameWriterFrom(&arena, LZ_SEARCH_DEPTH_DEFAULT, &writer);
+
+      // random part makes raw blocks
+      u64 frameLength = 0;
+      for (u64 position = 0; position < INPUT_MAX; position += pieceSize) {
+        struct string piece = StringFromBuffer(inputBuffer + position, Minimum(pieceSize, INPUT_MAX - position));
+        struct string_cursor cursor = StringCursorFromString(&piece);
+        while (!IsStringCursorAtEnd(&cursor)) {
+          struct string frame = LZFrameWriterWrite(&writer, &cursor);
+          MemoryCopy(frameBuffer + frameLength, frame.value, frame.length);
+          frameLength += frame.length;
+        }
+      }
+      struct string frame = LZFrameWriterFinish(&writer);
+      MemoryCopy(frameBuffer + frameLength, frame.value, frame.length);
+      frameLength += frame.length;
+
+      for (u32 chunkIndex = 0; chunkIndex < ARRAY_COUNT(chunkSizes); chunkIndex++) {
+        struct lz_frame_reader reader;
+        LZFrameReaderFrom(&arena, &reader);
+        struct string frameString = StringFromBuffer(frameBuffer, frameLength);
+        struct chunked_source source = {
+            .cursor = StringCursorFromString(&frameString),
+            .chunkSize = chunkSizes[chunkIndex],
+        };
+        struct string window = StringFromBuffer(windowBuffer, ARRAY_COUNT(windowBuffer));
+        struct string_stream stream = StringStreamFrom(&window, ChunkedSourceRead, &source);
+
+        u64 position = 0;
+        b8 isEqual = 1;
+        while (isEqual) {
+          struct string block = LZFrameReaderNext(&reader, &stream);
+          if (IsStringNull(&block) || reader.isEnd) {
+            isEqual = !IsStringNull(&block);
+            break;
+          }
+          struct string expected = StringFromBuffer(inputBuffer + position, block.length);
+          isEqual = position + block.length <= INPUT_MAX && IsStringEqual(&block, &expected);
+          position += block.length;
+        }
+        isEqual = isEqual && position == INPUT_MAX && IsStringStreamAtEnd(&stream);
+
+        if (!isEqual) {
+          errorCode = LZ_TEST_ERROR_FRAME;
+
+          StringBuilderAppendErrorMessage(sb, errorCode);
+          StringBuilderAppendStringLiteral(sb, "\n  piece size: ");
+          StringBuilderAppendU64(sb, pieceSize);
+          StringBuilderAppendStringLiteral(sb, "\n  chunk size: ");
+          StringBuilderAppendU64(sb, chunkSizes[chunkIndex]);
+          StringBuilderAppendStringLiteral(sb, "\n    position: ");
+          StringBuilderAppendU64(sb, position);
+          StringBuilderAppendStringLiteral(sb, "\n");
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+        }
+      }
+    }
+  }
+
+  // Frame that is malformed or ends early
+  {
+    struct string frames[] = {
+        StringFromLiteral(""),
+        StringFromLiteral("LZF2\x00\x00\x00\x00"),
+        StringFromLiteral("LZF1"),
+        StringFromLiteral("LZF1\x05\x00\x00\x80" "abc"),
+        StringFromLiteral("LZF1\x01\x00\x01\x80"),
+        StringFromLiteral("LZF1\x02\x00\x00\x00\x10" "a"),
+    };
+    static u8 windowBuffer[LZ_FRAME_WINDOW_MIN];
+
+    for (u32 frameIndex = 0; frameIndex < ARRAY_COUNT(frames); frameIndex++) {
+      memory_arena arena = {.block = lzBuffer, .total = sizeof(lzBuffer)};
+      struct lz_frame_reader reader;
+      LZFrameReaderFrom(&arena, &reader);
+      struct string_cursor source = StringCursorFromString(frames + frameIndex);
+      struct string window = StringFromBuffer(windowBuffer, ARRAY_COUNT(windowBuffer));
+      struct string_stream stream = StringStreamFrom(&window, StringStreamReadFromCursor, &source);
+
+      struct string block;
+      do
+        block = LZFrameReaderNext(&reader, &stream);
+      while (!IsStringNull(&block) && !reader.isEnd);
+
+      if (!IsStringNull(&block)) {
+        errorCode = LZ_TEST_ERROR_FRAME_MALFORMED;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  frame: ");
+        StringBuilderAppendU64(sb, frameIndex);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+#undef NEXT_RANDOM
+
+  return (int)errorCode;
+}
@@ -1,3 +1,9 @@
+#if IS_PLATFORM_LINUX
+// Feature test macros must be defined before any system header is included.
+// "text.h" includes compiler intrinsics, which include <stdlib.h>.
+#define _POSIX_C_SOURCE 199309L
+#endif
+
 #include "text.h"
 #include "type.h"
 
@@ -1,6 +1,5 @@
 #include "assert.h"
 
-#define _POSIX_C_SOURCE 199309L
 #include <time.h>
 #include <unistd.h>
 
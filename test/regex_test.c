@@ -0,0 +1,402 @@
+#include "platform.h"
+// platform.h must be first, it selects POSIX features
+#include "regex.h"
+#include "string_builder.h"
+
+#define TEST_ERROR_LIST(X)                                                                                             \
+  X(REGEX_TEST_ERROR_IS_MATCH, "RegexIsMatch: String must match regex as expected")                                    \
+  X(REGEX_TEST_ERROR_COMPILE_INVALID, "RegexCompile: Invalid pattern must fail at expected position")                  \
+  X(REGEX_TEST_ERROR_LITERAL, "RegexCompile: Required literal must match expected")                                    \
+  X(REGEX_TEST_ERROR_SMALL_CACHE, "RegexIsMatch: Flushing DFA cache must not change results")                          \
+  X(REGEX_TEST_ERROR_MATCHING_LINE, "StringCursorConsumeMatchingLine: Lines must match expected")                      \
+  X(REGEX_TEST_ERROR_COMPILE_OUT_OF_MEMORY, "RegexCompile: Must fail and leave arena untouched when full")
+
+enum regex_test_error {
+  REGEX_TEST_ERROR_NONE = 0,
+#define X(tag, message) tag,
+  TEST_ERROR_LIST(X)
+#undef X
+
+  // src: https://mesonbuild.com/Unit-tests.html#skipped-tests-and-hard-errors
+  // For the default exitcode testing protocol, the GNU standard approach in
+  // this case is to exit the program with error code 77. Meson will detect this
+  // and report these tests as skipped rather than failed. This behavior was
+  // added in version 0.37.0.
+  MESON_TEST_SKIP = 77,
+  // In addition, sometimes a test fails set up so that it should fail even if
+  // it is marked as an expected failure. The GNU standard approach in this case
+  // is to exit the program with error code 99. Again, Meson will detect this
+  // and report these tests as ERROR, ignoring the setting of should_fail. This
+  // behavior was added in version 0.50.0.
+  MESON_TEST_FAILED_TO_SET_UP = 99,
+};
+
+internalfn void
+StringBuilderAppendErrorMessage(struct string_builder *stringBuilder, enum regex_test_error errorCode)
+{
+  struct error {
+    enum regex_test_error code;
+    struct string message;
+  } errors[] = {
+#define XX(tag, msg) {.code = tag, .message = StringFromLiteral(msg)},
+      TEST_ERROR_LIST(XX)
+#undef XX
+  };
+
+  struct string message = StringFromLiteral("Unknown error");
+  for (u32 index = 0; index < ARRAY_COUNT(errors); index++) {
+    struct error *error = errors + index;
+    if (error->code == errorCode) {
+      message = error->message;
+      break;
+    }
+  }
+
+  StringBuilderAppendString(stringBuilder, &message);
+}
+
+int
+main(void)
+{
+  enum regex_test_error errorCode = REGEX_TEST_ERROR_NONE;
+
+  // setup
+  enum { KILOBYTES = (1 << 10) };
+  u8 stackBuffer[8 * KILOBYTES];
+  memory_arena stackMemory = {
+      .block = stackBuffer,
+      .total = ARRAY_COUNT(stackBuffer),
+  };
+
+  string_builder *sb = MakeStringBuilder(&stackMemory, 1024, 32);
+
+  static u8 regexBuffer[256 * KILOBYTES];
+
+  // b8 RegexIsMatch(struct regex *regex, struct string *string)
+  {
+    struct test_case {
+      struct string pattern;
+      struct string input;
+      b8 expected;
+    } testCases[] = {
+        {.pattern = StringFromLiteral(""), .input = StringFromLiteral(""), .expected = 1},
+        {.pattern = StringFromLiteral(""), .input = StringFromLiteral("abc"), .expected = 1},
+        {.pattern = StringFromLiteral("abc"), .input = StringFromLiteral("xxabcxx"), .expected = 1},
+        {.pattern = StringFromLiteral("abc"), .input = StringFromLiteral("xxabxcx"), .expected = 0},
+        {.pattern = StringFromLiteral("a.c"), .input = StringFromLiteral("a-c"), .expected = 1},
+        {.pattern = StringFromLiteral("a.c"), .input = StringFromLiteral("a\nc"), .expected = 0},
+        {.pattern = StringFromLiteral("^abc"), .input = StringFromLiteral("abcd"), .expected = 1},
+        {.pattern = StringFromLiteral("^abc"), .input = StringFromLiteral("xabc"), .expected = 0},
+        {.pattern = StringFromLiteral("abc$"), .input = StringFromLiteral("xabc"), .expected = 1},
+        {.pattern = StringFromLiteral("abc$"), .input = StringFromLiteral("abcx"), .expected = 0},
+        {.pattern = StringFromLiteral("^$"), .input = StringFromLiteral(""), .expected = 1},
+        {.pattern = StringFromLiteral("^$"), .input = StringFromLiteral("a"), .expected = 0},
+        {.pattern = StringFromLiteral("$^"), .input = StringFromLiteral(""), .expected = 1},
+        {.pattern = StringFromLiteral("$^"), .input = StringFromLiteral("a"), .expected = 0},
+        {.pattern = StringFromLiteral("^$^$"), .input = StringFromLiteral(""), .expected = 1},
+        {.pattern = StringFromLiteral("a|$^"), .input = StringFromLiteral(""), .expected = 1},
+        {.pattern = StringFromLiteral("a*$^"), .input = StringFromLiteral("a"), .expected = 0},
+        {.pattern = StringFromLiteral("x^a"), .input = StringFromLiteral("xa"), .expected = 0},
+        {.pattern = StringFromLiteral("cat|dog"), .input = StringFromLiteral("hotdog"), .expected = 1},
+        {.pattern = StringFromLiteral("cat|dog"), .input = StringFromLiteral("cow"), .expected = 0},
+        {.pattern = StringFromLiteral("^(cat|dog)s?$"), .input = StringFromLiteral("cats"), .expected = 1},
+        {.pattern = StringFromLiteral("^(cat|dog)s?$"), .input = StringFromLiteral("catss"), .expected = 0},
+        {.pattern = StringFromLiteral("^(?:ab)+$"), .input = StringFromLiteral("ababab"), .expected = 1},
+        {.pattern = StringFromLiteral("^(?:ab)+$"), .input = StringFromLiteral("ababa"), .expected = 0},
+        {.pattern = StringFromLiteral("^a*b*$"), .input = StringFromLiteral(""), .expected = 1},
+        {.pattern = StringFromLiteral("^a*?b$"), .input = StringFromLiteral("aaab"), .expected = 1},
+        {.pattern = StringFromLiteral("^a{3}$"), .input = StringFromLiteral("aaa"), .expected = 1},
+        {.pattern = StringFromLiteral("^a{3}$"), .input = StringFromLiteral("aaaa"), .expected = 0},
+        {.pattern = StringFromLiteral("^a{2,}$"), .input = StringFromLiteral("aaaaa"), .expected = 1},
+        {.pattern = StringFromLiteral("^a{2,}$"), .input = StringFromLiteral("a"), .expected = 0},
+        {.pattern = StringFromLiteral("^a{2,4}$"), .input = StringFromLiteral("aaaa"), .expected = 1},
+        {.pattern = StringFromLiteral("^a{2,4}$"), .input = StringFromLiteral("aaaaa"), .expected = 0},
+        {.pattern = StringFromLiteral("^a{0}b$"), .input = StringFromLiteral("b"), .expected = 1},
+        {.pattern = StringFromLiteral("^[a-c]+$"), .input = StringFromLiteral("abcba"), .expected = 1},
+        {.pattern = StringFromLiteral("^[a-c]+$"), .input = StringFromLiteral("abcd"), .expected = 0},
+        {.pattern = StringFromLiteral("^[^a-c]+$"), .input = StringFromLiteral("xyz"), .expected = 1},
+        {.pattern = StringFromLiteral("[]x]"), .input = StringFromLiteral("]"), .expected = 1},
+        {.pattern = StringFromLiteral("[a-]"), .input = StringFromLiteral("-"), .expected = 1},
+        {.pattern = StringFromLiteral("[\\d_]"), .input = StringFromLiteral("_"), .expected = 1},
+        {.pattern = StringFromLiteral("^\\d+\\.\\d+$"), .input = StringFromLiteral("3.14"), .expected = 1},
+        {.pattern = StringFromLiteral("^\\d+\\.\\d+$"), .input = StringFromLiteral("3x14"), .expected = 0},
+        {.pattern = StringFromLiteral("\\w+@\\w+"), .input = StringFromLiteral("mail me@host now"), .expected = 1},
+        {.pattern = StringFromLiteral("^\\S+\\s\\S+$"), .input = StringFromLiteral("a b"), .expected = 1},
+        {.pattern = StringFromLiteral("^\\D\\W$"), .input = StringFromLiteral("a!"), .expected = 1},
+        {.pattern = StringFromLiteral("\\x41\\t"), .input = StringFromLiteral("A\t"), .expected = 1},
+        {.pattern = StringFromLiteral("a{"), .input = StringFromLiteral("a{"), .expected = 0},
+        {.pattern = StringFromLiteral("{a}"), .input = StringFromLiteral("{a}"), .expected = 1},
+        {.pattern = StringFromLiteral("(a|)b"), .input = StringFromLiteral("b"), .expected = 1},
+        {.pattern = StringFromLiteral("(a*)*c"), .input = StringFromLiteral("aac"), .expected = 1},
+        {
+            .pattern = StringFromLiteral("ERROR .* took [0-9]{4,}ms"),
+            .input = StringFromLiteral("12:00 ERROR request /api took 12345ms"),
+            .expected = 1,
+        },
+        {
+            .pattern = StringFromLiteral("ERROR .* took [0-9]{4,}ms"),
+            .input = StringFromLiteral("12:00 ERROR request /api took 123ms"),
+            .expected = 0,
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+      memory_arena arena = {.block = regexBuffer, .total = sizeof(regexBuffer)};
+
+      struct regex regex;
+      u64 errorIndex = U64_MAX;
+      b8 isCompiled = RegexCompile(&arena, &testCase->pattern, 16 * KILOBYTES, &regex, &errorIndex);
+      // "a{" is invalid, it must not match anything
+      b8 got = isCompiled && RegexIsMatch(&regex, &testCase->input);
+      if (got != testCase->expected || (!isCompiled && testCase->expected)) {
+        errorCode = REGEX_TEST_ERROR_IS_MATCH;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  pattern: ");
+        StringBuilderAppendString(sb, &testCase->pattern);
+        StringBuilderAppendStringLiteral(sb, "\n    input: ");
+        StringBuilderAppendString(sb, &testCase->input);
+        StringBuilderAppendStringLiteral(sb, "\n expected: ");
+        struct string *expected = testCase->expected ? &StringFromLiteral("match") : &StringFromLiteral("no match");
+        StringBuilderAppendString(sb, expected);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // b8 RegexCompile(memory_arena *arena, struct string *pattern, u64 cacheSize, struct regex *regex,
+  //                 u64 *errorIndex)
+  {
+    struct test_case {
+      struct string pattern;
+      u64 expected;
+    } testCases[] = {
+        {.pattern = StringFromLiteral("(abc"), .expected = 4},
+        {.pattern = StringFromLiteral("abc)"), .expected = 3},
+        {.pattern = StringFromLiteral("*a"), .expected = 0},
+        {.pattern = StringFromLiteral("a|+"), .expected = 2},
+        {.pattern = StringFromLiteral("[abc"), .expected = 4},
+        {.pattern = StringFromLiteral("[z-a]"), .expected = 4},
+        {.pattern = StringFromLiteral("a\\"), .expected = 2},
+        {.pattern = StringFromLiteral("\\q"), .expected = 2},
+        {.pattern = StringFromLiteral("\\xZZ"), .expected = 2},
+        {.pattern = StringFromLiteral("a{3,2}"), .expected = 5},
+        {.pattern = StringFromLiteral("a{1001}"), .expected = 6},
+        {.pattern = StringFromLiteral("(a{1000}){1000}"), .expected = 15},
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+      memory_arena arena = {.block = regexBuffer, .total = sizeof(regexBuffer)};
+
+      struct regex regex;
+      u64 errorIndex = U64_MAX;
+      b8 isCompiled = RegexCompile(&arena, &testCase->pattern, 16 * KILOBYTES, &regex, &errorIndex);
+      if (isCompiled || errorIndex != testCase->expected || arena.used != 0) {
+        errorCode = REGEX_TEST_ERROR_COMPILE_INVALID;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n   pattern: ");
+        StringBuilderAppendString(sb, &testCase->pattern);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendU64(sb, testCase->expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendU64(sb, errorIndex);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // struct string regex.literal
+  {
+    struct test_case {
+      struct string pattern;
+      struct string expected;
+      b8 isLiteralOnly;
+    } testCases[] = {
+        {.pattern = StringFromLiteral("ERROR"), .expected = StringFromLiteral("ERROR"), .isLiteralOnly = 1},
+        {.pattern = StringFromLiteral("a\\.b"), .expected = StringFromLiteral("a.b"), .isLiteralOnly = 1},
+        {.pattern = StringFromLiteral("^ERROR"), .expected = StringFromLiteral("ERROR")},
+        {.pattern = StringFromLiteral("ab.*timeout"), .expected = StringFromLiteral("timeout")},
+        {.pattern = StringFromLiteral("x(abc)+y"), .expected = StringFromLiteral("xabc")},
+        {.pattern = StringFromLiteral("a(b|c)d"), .expected = StringFromLiteral("a")},
+        {.pattern = StringFromLiteral("cat|dog"), .expected = StringFromLiteral("")},
+        {.pattern = StringFromLiteral("[0-9]+"), .expected = StringFromLiteral("")},
+        {.pattern = StringFromLiteral("user=\\w+ id=\\d+"), .expected = StringFromLiteral("user=")},
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+      memory_arena arena = {.block = regexBuffer, .total = sizeof(regexBuffer)};
+
+      struct regex regex;
+      b8 isCompiled = RegexCompile(&arena, &testCase->pattern, 16 * KILOBYTES, &regex, 0);
+      if (!isCompiled || !IsStringEqual(&regex.literal, &testCase->expected) ||
+          regex.isLiteralOnly != testCase->isLiteralOnly) {
+        errorCode = REGEX_TEST_ERROR_LITERAL;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n   pattern: ");
+        StringBuilderAppendString(sb, &testCase->pattern);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendString(sb, &testCase->expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendString(sb, &regex.literal);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // DFA cache that holds few states is flushed many times
+  {
+    struct string pattern = StringFromLiteral("(a|b)*a(a|b){5}c|^b+$");
+    memory_arena arena = {.block = regexBuffer, .total = sizeof(regexBuffer)};
+    struct regex large;
+    struct regex small;
+    b8 isCompiled = RegexCompile(&arena, &pattern, 64 * KILOBYTES, &large, 0);
+    isCompiled &= RegexCompile(&arena, &pattern, 512, &small, 0);
+
+    u64 random = 0x9e3779b97f4a7c15;
+    u8 inputBuffer[64];
+    u64 matchCount = 0;
+    for (u32 trial = 0; trial < 2000 && isCompiled; trial++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      u64 length = random % ARRAY_COUNT(inputBuffer);
+      for (u64 index = 0; index < length; index++) {
+        random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+        inputBuffer[index] = (u8)("aaabbbbc"[random % 8]);
+      }
+      struct string input = StringFromBuffer(inputBuffer, length);
+      b8 expected = RegexIsMatch(&large, &input);
+      matchCount += expected;
+      if (RegexIsMatch(&small, &input) != expected) {
+        errorCode = REGEX_TEST_ERROR_SMALL_CACHE;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  input: ");
+        StringBuilderAppendString(sb, &input);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+        break;
+      }
+    }
+
+    if (!isCompiled || small.flushCount == 0 || large.flushCount != 0 || matchCount == 0 || matchCount == 2000) {
+      errorCode = REGEX_TEST_ERROR_SMALL_CACHE;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n  small cache must be flushed, large one must not\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+  }
+
+  // struct string StringCursorConsumeMatchingLine(struct string_cursor *cursor, struct regex *regex)
+  {
+    struct string text = StringFromLiteral("INFO start\n"
+                                           "ERROR disk full\n"
+                                           "WARN ERROR in middle\n"
+                                           "ERROR\n"
+                                           "\n"
+                                           "ERROR last");
+    struct test_case {
+      struct string pattern;
+      struct string expected[4];
+      u32 expectedCount;
+    } testCases[] = {
+        {
+            .pattern = StringFromLiteral("^ERROR"),
+            .expected = {StringFromLiteral("ERROR disk full"), StringFromLiteral("ERROR"),
+                         StringFromLiteral("ERROR last")},
+            .expectedCount = 3,
+        },
+        {
+            .pattern = StringFromLiteral("ERROR"),
+            .expected = {StringFromLiteral("ERROR disk full"), StringFromLiteral("WARN ERROR in middle"),
+                         StringFromLiteral("ERROR"), StringFromLiteral("ERROR last")},
+            .expectedCount = 4,
+        },
+        {
+            .pattern = StringFromLiteral("^$"),
+            .expected = {StringFromLiteral("")},
+            .expectedCount = 1,
+        },
+        {
+            .pattern = StringFromLiteral("$^"),
+            .expected = {StringFromLiteral("")},
+            .expectedCount = 1,
+        },
+        {
+            .pattern = StringFromLiteral("[a-z]$"),
+            .expected = {StringFromLiteral("INFO start"), StringFromLiteral("ERROR disk full"),
+                         StringFromLiteral("WARN ERROR in middle"), StringFromLiteral("ERROR last")},
+            .expectedCount = 4,
+        },
+        {
+            .pattern = StringFromLiteral("DEBUG"),
+            .expectedCount = 0,
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+      memory_arena arena = {.block = regexBuffer, .total = sizeof(regexBuffer)};
+
+      struct regex regex;
+      b8 isCompiled = RegexCompile(&arena, &testCase->pattern, 16 * KILOBYTES, &regex, 0);
+      struct string_cursor cursor = StringCursorFromString(&text);
+      u32 lineCount = 0;
+      b8 isEqual = isCompiled;
+      for (struct string line = StringCursorConsumeMatchingLine(&cursor, &regex); isCompiled && !IsStringNull(&line);
+           line = StringCursorConsumeMatchingLine(&cursor, &regex)) {
+        if (lineCount == testCase->expectedCount || !IsStringEqual(&line, testCase->expected + lineCount)) {
+          isEqual = 0;
+          break;
+        }
+        lineCount++;
+      }
+
+      if (!isEqual || lineCount != testCase->expectedCount || !IsStringCursorAtEnd(&cursor)) {
+        errorCode = REGEX_TEST_ERROR_MATCHING_LINE;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n   pattern: ");
+        StringBuilderAppendString(sb, &testCase->pattern);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendU64(sb, testCase->expectedCount);
+        StringBuilderAppendStringLiteral(sb, " lines\n       got: ");
+        StringBuilderAppendU64(sb, lineCount);
+        StringBuilderAppendStringLiteral(sb, " lines\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // arena too small for DFA cache
+  {
+    memory_arena smallMemory = {.block = regexBuffer, .total = KILOBYTES};
+    struct regex regex;
+    u64 errorIndex = 0;
+    struct string pattern = StringFromLiteral("a+b");
+    if (RegexCompile(&smallMemory, &pattern, 4 * KILOBYTES, &regex, &errorIndex) || errorIndex != pattern.length ||
+        smallMemory.used != 0) {
+      errorCode = REGEX_TEST_ERROR_COMPILE_OUT_OF_MEMORY;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+  }
+
+  return (int)errorCode;
+}
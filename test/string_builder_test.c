@@ -7,7 +7,14 @@ enum string_builder_test_error {
   STRING_BUILDER_TEST_ERROR_APPENDU64,
   STRING_BUILDER_TEST_ERROR_APPENDS64,
   STRING_BUILDER_TEST_ERROR_APPENDHEX,
+  STRING_BUILDER_TEST_ERROR_APPENDHEXENCODED,
+  STRING_BUILDER_TEST_ERROR_APPENDBASE64,
+  STRING_BUILDER_TEST_ERROR_APPENDU32ARRAY,
+  STRING_BUILDER_TEST_ERROR_APPENDU64ARRAY,
   STRING_BUILDER_TEST_ERROR_APPENDF32,
+  STRING_BUILDER_TEST_ERROR_PATHJOIN,
+  STRING_BUILDER_TEST_ERROR_APPENDTIMESTAMP,
+  STRING_BUILDER_TEST_ERROR_APPENDDURATION,
   STRING_BUILDER_TEST_ERROR_FLUSH,
 
   // src: https://mesonbuild.com/Unit-tests.html#skipped-tests-and-hard-errors
@@ -105,6 +112,134 @@ main(void)
   }
   StringBuilderFlush(sb);
 
+  // StringBuilderAppendHexEncoded(string_builder *stringBuilder, struct string *string)
+  {
+    StringBuilderAppendHexEncoded(sb, &StringFromLiteral("\x0f\x0c\x33\x98"));
+
+    string *expected = &StringFromLiteral("0f0c3398");
+    if (!IsStringStartsWith(outBuffer, expected)) {
+      errorCode = STRING_BUILDER_TEST_ERROR_APPENDHEXENCODED;
+      goto end;
+    }
+  }
+  StringBuilderFlush(sb);
+
+  // StringBuilderAppendBase64Encoded(string_builder *stringBuilder, struct string *string,
+  //                                  enum base64_alphabet alphabet)
+  // StringBuilderAppendBase64Decoded(string_builder *stringBuilder, struct string *string,
+  //                                  enum base64_alphabet alphabet, u64 *errorIndex)
+  {
+    StringBuilderAppendStringLiteral(sb, "data:");
+    StringBuilderAppendBase64Encoded(sb, &StringFromLiteral("\x0f\x0c\x33\x98"), BASE64_ALPHABET_STANDARD);
+    StringBuilderAppendStringLiteral(sb, ";");
+    b8 isDecoded = StringBuilderAppendBase64Decoded(sb, &StringFromLiteral("Zm9v"), BASE64_ALPHABET_URL, 0);
+    u64 errorIndex = 0;
+    // nothing appended on failure
+    b8 isInvalidDecoded = StringBuilderAppendBase64Decoded(sb, &StringFromLiteral("Zm9v!A"), BASE64_ALPHABET_URL,
+                                                           &errorIndex);
+
+    string *expected = &StringFromLiteral("data:DwwzmA==;foo");
+    if (!isDecoded || isInvalidDecoded || errorIndex != 4 || sb->length != expected->length ||
+        !IsStringStartsWith(outBuffer, expected)) {
+      errorCode = STRING_BUILDER_TEST_ERROR_APPENDBASE64;
+      goto end;
+    }
+  }
+  StringBuilderFlush(sb);
+
+  // StringBuilderAppendU32Array(string_builder *stringBuilder, u32 *values, u64 count, struct string *separator,
+  //                             struct string *prefix, enum string_builder_radix radix)
+  // StringBuilderAppendU64Array(string_builder *stringBuilder, u64 *values, u64 count, struct string *separator,
+  //                             struct string *prefix, enum string_builder_radix radix)
+  // Output must be same as appending elements one by one.
+  {
+    u64 values[] = {
+        0,
+        1,
+        9,
+        10,
+        99,
+        100,
+        0xff,
+        0x100,
+        0xffff,
+        0x10000,
+        999999999,
+        1000000000,
+        4294967295,
+        4294967296,
+        9999999999999999999UL,
+        10000000000000000000UL,
+        18446744073709551615UL,
+        0x00f2aa499b9028eaUL,
+    };
+    u32 values32[ARRAY_COUNT(values)];
+    for (u32 index = 0; index < ARRAY_COUNT(values); index++)
+      values32[index] = (u32)values[index];
+
+    struct string separators[] = {StringNull(), StringFromLiteral(", ")};
+    struct string prefixes[] = {StringNull(), StringFromLiteral("0x")};
+    enum string_builder_radix radixes[] = {
+        STRING_BUILDER_RADIX_DECIMAL,
+        STRING_BUILDER_RADIX_HEX,
+        STRING_BUILDER_RADIX_HEX_FIXED,
+    };
+
+    u8 expectedBytes[1024];
+    string_builder *expectedBuilder = &(string_builder){
+        .outBuffer = &(string){.value = expectedBytes, .length = sizeof(expectedBytes)},
+        .stringBuffer = stringBuffer,
+    };
+    u8 gotBytes[1024];
+    string_builder *gotBuilder = &(string_builder){
+        .outBuffer = &(string){.value = gotBytes, .length = sizeof(gotBytes)},
+    };
+
+    for (u32 elementSize = 4; elementSize <= 8; elementSize += 4) {
+      for (u32 separatorIndex = 0; separatorIndex < ARRAY_COUNT(separators); separatorIndex++) {
+        for (u32 prefixIndex = 0; prefixIndex < ARRAY_COUNT(prefixes); prefixIndex++) {
+          for (u32 radixIndex = 0; radixIndex < ARRAY_COUNT(radixes); radixIndex++) {
+            struct string *separator = separators + separatorIndex;
+            struct string *prefix = prefixes + prefixIndex;
+            enum string_builder_radix radix = radixes[radixIndex];
+
+            for (u32 index = 0; index < ARRAY_COUNT(values); index++) {
+              u64 value = elementSize == 4 ? (u64)values32[index] : values[index];
+              // null separator and prefix have no bytes to copy
+              if (index != 0 && separator->length != 0)
+                StringBuilderAppendString(expectedBuilder, separator);
+              if (prefix->length != 0)
+                StringBuilderAppendString(expectedBuilder, prefix);
+              if (radix == STRING_BUILDER_RADIX_DECIMAL) {
+                StringBuilderAppendU64(expectedBuilder, value);
+              } else if (radix == STRING_BUILDER_RADIX_HEX) {
+                StringBuilderAppendHex(expectedBuilder, value);
+              } else {
+                string hex = FormatHex(stringBuffer, value);
+                for (u64 padding = hex.length; padding < 2 * elementSize; padding++)
+                  StringBuilderAppendStringLiteral(expectedBuilder, "0");
+                StringBuilderAppendString(expectedBuilder, &hex);
+              }
+            }
+
+            if (elementSize == 4)
+              StringBuilderAppendU32Array(gotBuilder, values32, ARRAY_COUNT(values32), separator, prefix, radix);
+            else
+              StringBuilderAppendU64Array(gotBuilder, values, ARRAY_COUNT(values), separator, prefix, radix);
+
+            string expected = StringBuilderFlush(expectedBuilder);
+            string value = StringBuilderFlush(gotBuilder);
+            if (!IsStringEqual(&value, &expected)) {
+              errorCode =
+                  elementSize == 4 ? STRING_BUILDER_TEST_ERROR_APPENDU32ARRAY : STRING_BUILDER_TEST_ERROR_APPENDU64ARRAY;
+              goto end;
+            }
+          }
+        }
+      }
+    }
+  }
+
   // StringBuilderAppendF32(string_builder *stringBuilder, f32 value, u32 fractionCount)
   {
     StringBuilderAppendF32(sb, 4.31f, 2);
@@ -117,6 +252,78 @@ main(void)
   }
   StringBuilderFlush(sb);
 
+  // PathJoin(string_builder *stringBuilder, struct string *base, struct string *path)
+  {
+#if IS_PLATFORM_WINDOWS
+    string *expected = &StringFromLiteral("C:\\Users\\e2dk4r C:\\Windows\\ a/b a\\b/ /c");
+#else
+    string *expected = &StringFromLiteral("/usr/lib/libc.so /usr/lib/libc.so a/b a/b/ /c");
+#endif
+    PathJoin(sb, &StringFromLiteral(""), &StringFromLiteral(""));
+#if IS_PLATFORM_WINDOWS
+    PathJoin(sb, &StringFromLiteral("C:\\Users"), &StringFromLiteral("e2dk4r"));
+    StringBuilderAppendStringLiteral(sb, " ");
+    PathJoin(sb, &StringFromLiteral("C:\\Windows\\"), &StringFromLiteral(""));
+#else
+    PathJoin(sb, &StringFromLiteral("/usr/lib"), &StringFromLiteral("libc.so"));
+    StringBuilderAppendStringLiteral(sb, " ");
+    PathJoin(sb, &StringFromLiteral("/usr/lib/"), &StringFromLiteral("libc.so"));
+#endif
+    StringBuilderAppendStringLiteral(sb, " ");
+    PathJoin(sb, &StringFromLiteral(""), &StringFromLiteral("a/b"));
+    StringBuilderAppendStringLiteral(sb, " ");
+    PathJoin(sb, &StringFromLiteral("a"), &StringFromLiteral("b/"));
+    StringBuilderAppendStringLiteral(sb, " ");
+    // absolute path replaces base
+    PathJoin(sb, &StringFromLiteral("a/b"), &StringFromLiteral("/c"));
+
+    string value = StringBuilderFlush(sb);
+    if (!IsStringEqual(&value, expected)) {
+      errorCode = STRING_BUILDER_TEST_ERROR_PATHJOIN;
+      goto end;
+    }
+  }
+
+  // StringBuilderAppendTimestamp(string_builder *stringBuilder, struct timestamp *timestamp, u32 fractionCount)
+  {
+    StringBuilderAppendStringLiteral(sb, "[");
+    StringBuilderAppendTimestamp(sb, &(struct timestamp){.ns = 1709993159123456789}, 6);
+    StringBuilderAppendStringLiteral(sb, "]");
+
+    string value = StringBuilderFlush(sb);
+    string *expected = &StringFromLiteral("[2024-03-09T14:05:59.123456Z]");
+    if (!IsStringEqual(&value, expected)) {
+      errorCode = STRING_BUILDER_TEST_ERROR_APPENDTIMESTAMP;
+      goto end;
+    }
+  }
+
+  // StringBuilderAppendDuration(string_builder *stringBuilder, struct duration *duration)
+  // StringBuilderAppendDurationFixed(string_builder *stringBuilder, struct duration *duration, u32 fractionCount)
+  {
+    struct duration duration = {.ns = 1234567};
+    StringBuilderAppendDuration(sb, &duration);
+    StringBuilderAppendStringLiteral(sb, " ");
+    StringBuilderAppendDurationFixed(sb, &duration, 3);
+
+    string value = StringBuilderFlush(sb);
+    string *expected = &StringFromLiteral("1ms234us567ns 1.234ms");
+    if (!IsStringEqual(&value, expected)) {
+      errorCode = STRING_BUILDER_TEST_ERROR_APPENDDURATION;
+      goto end;
+    }
+
+    // out buffer has less room than formatter needs
+    sb->length = outBuffer->length - 10;
+    StringBuilderAppendDurationFixed(sb, &duration, 3);
+    value = StringBuilderFlush(sb);
+    struct string tail = StringFromBuffer(value.value + value.length - 7, 7);
+    if (value.length != outBuffer->length - 3 || !IsStringEqual(&tail, &StringFromLiteral("1.234ms"))) {
+      errorCode = STRING_BUILDER_TEST_ERROR_APPENDDURATION;
+      goto end;
+    }
+  }
+
   // StringBuilderFlush(string_builder *stringBuilder)
   {
     StringBuilderAppendZeroTerminated(sb, "abc", 3);
@@ -27,7 +27,13 @@
     "ExtractNumber: Number must be extracted from cursor position")                                                    \
   X(STRING_CURSOR_TEST_ERROR_EXTRACT_NUMBER_EXPECTED_FALSE,                                                            \
     "ExtractNumber: Number must NOT be extracted from cursor position")                                                \
-  X(STRING_CURSOR_TEST_ERROR_EXTRACT_CONSUMED, "ExtractConsumed: Consumed string not matching expected")
+  X(STRING_CURSOR_TEST_ERROR_EXTRACT_CONSUMED, "ExtractConsumed: Consumed string not matching expected")             \
+  X(STRING_CURSOR_TEST_ERROR_LINE_INDEX, "LineIndex: Lines must match lines split at newline")                         \
+  X(STRING_CURSOR_TEST_ERROR_LINE_INDEX_OUT_OF_MEMORY, "LineIndex: Must fail and leave arena untouched when full")    \
+  X(STRING_CURSOR_TEST_ERROR_CSV_READER, "CSVReader: Fields must match expected")                                      \
+  X(STRING_CURSOR_TEST_ERROR_CSV_READER_STREAM, "CSVReader: Fields read in chunks must match fields written")          \
+  X(STRING_CURSOR_TEST_ERROR_STREAM, "Stream: Text consumed across refills must match text consumed by cursor")        \
+  X(STRING_CURSOR_TEST_ERROR_STREAM_WINDOW_FULL, "Stream: Text longer than window must not be found")
 
 enum string_cursor_test_error {
   STRING_CURSOR_TEST_ERROR_NONE = 0,
@@ -93,6 +99,19 @@ StringBuilderAppendPrintableString(string_builder *sb, struct string *string)
     StringBuilderAppendString(sb, string);
 }
 
+struct chunked_source {
+  struct string_cursor cursor;
+  u64 chunkSize;
+};
+
+// string_stream_read that reads at most chunkSize bytes at once
+internalfn u64
+ChunkedSourceRead(void *context, u8 *buffer, u64 length)
+{
+  struct chunked_source *source = context;
+  return StringStreamReadFromCursor(&source->cursor, buffer, Minimum(length, source->chunkSize));
+}
+
 int
 main(void)
 {
@@ -1307,5 +1326,448 @@ main(void)
     }
   }
 
+  // b8 StringLineIndexFrom(memory_arena *arena, struct string *source, u32 flags, struct string_line_index *index)
+  {
+    struct test_case {
+      struct string input;
+      u32 flags;
+      struct string expected[4];
+      u64 expectedCount;
+    } testCases[] = {
+        {
+            .input = StringFromLiteral(""),
+            .expectedCount = 0,
+        },
+        {
+            .input = StringFromLiteral("abc"),
+            .expected = {StringFromLiteral("abc")},
+            .expectedCount = 1,
+        },
+        {
+            .input = StringFromLiteral("abc\n"),
+            .expected = {StringFromLiteral("abc")},
+            .expectedCount = 1,
+        },
+        {
+            .input = StringFromLiteral("\n"),
+            .expected = {StringFromLiteral("")},
+            .expectedCount = 1,
+        },
+        {
+            .input = StringFromLiteral("a\n\nb"),
+            .expected = {StringFromLiteral("a"), StringFromLiteral(""), StringFromLiteral("b")},
+            .expectedCount = 3,
+        },
+        {
+            .input = StringFromLiteral("a\r\nb\r\n"),
+            .expected = {StringFromLiteral("a\r"), StringFromLiteral("b\r")},
+            .expectedCount = 2,
+        },
+        {
+            .input = StringFromLiteral("a\r\nb\r\n\r\nc\r"),
+            .flags = STRING_LINE_INDEX_FLAG_CRLF,
+            .expected =
+                {
+                    StringFromLiteral("a"),
+                    StringFromLiteral("b"),
+                    StringFromLiteral(""),
+                    StringFromLiteral("c\r"),
+                },
+            .expectedCount = 4,
+        },
+    };
+
+    u64 offsetsBuffer[256];
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+      memory_arena arena = {.block = (u8 *)offsetsBuffer, .total = sizeof(offsetsBuffer)};
+
+      struct string_line_index index;
+      b8 isBuilt = StringLineIndexFrom(&arena, &testCase->input, testCase->flags, &index);
+      b8 isEqual = isBuilt && index.count == testCase->expectedCount;
+      for (u64 lineIndex = 0; isEqual && lineIndex < testCase->expectedCount; lineIndex++) {
+        struct string line = StringLineIndexGetLine(&index, lineIndex);
+        struct string_cursor cursor = StringCursorFromLine(&index, lineIndex);
+        isEqual = IsStringEqual(&line, testCase->expected + lineIndex) &&
+                  line.value == cursor.source->value + cursor.position;
+      }
+      if (isEqual) {
+        struct string line = StringLineIndexGetLine(&index, index.count);
+        struct string_cursor cursor = StringCursorFromLine(&index, index.count);
+        isEqual = IsStringNull(&line) && IsStringCursorAtEnd(&cursor);
+      }
+
+      if (!isEqual) {
+        errorCode = STRING_CURSOR_TEST_ERROR_LINE_INDEX;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  test case: ");
+        StringBuilderAppendU64(sb, testCaseIndex);
+        StringBuilderAppendStringLiteral(sb, "\n  expected count: ");
+        StringBuilderAppendU64(sb, testCase->expectedCount);
+        StringBuilderAppendStringLiteral(sb, "\n       got count: ");
+        StringBuilderAppendU64(sb, isBuilt ? index.count : 0);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+
+    // Long text, newlines at every position of 64 byte blocks
+    u8 text[1000];
+    u64 random = 0x9e3779b97f4a7c15;
+    for (u32 index = 0; index < ARRAY_COUNT(text); index++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      text[index] = (random % 5 == 0) ? '\n' : (u8)('a' + random % 26);
+    }
+
+    for (u64 length = 0; length <= ARRAY_COUNT(text); length += 37) {
+      struct string input = StringFromBuffer(text, length);
+      memory_arena arena = {.block = (u8 *)offsetsBuffer, .total = sizeof(offsetsBuffer)};
+
+      struct string_line_index index;
+      b8 isEqual = StringLineIndexFrom(&arena, &input, STRING_LINE_INDEX_FLAG_NONE, &index);
+      u64 expectedCount = 0;
+      struct string_cursor cursor = StringCursorFromString(&input);
+      while (isEqual && !IsStringCursorAtEnd(&cursor)) {
+        struct string expected = StringCursorConsumeUntilOrRest(&cursor, &StringFromLiteral("\n"));
+        IsStringCursorStartsWith(&cursor, &StringFromLiteral("\n"));
+        struct string got = StringLineIndexGetLine(&index, expectedCount);
+        isEqual = IsStringEqual(&got, &expected);
+        expectedCount++;
+      }
+      isEqual = isEqual && index.count == expectedCount &&
+                arena.used == (index.count + 1) * sizeof(*index.offsets);
+
+      if (!isEqual) {
+        errorCode = STRING_CURSOR_TEST_ERROR_LINE_INDEX;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  length: ");
+        StringBuilderAppendU64(sb, length);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+
+    // Out of memory
+    {
+      struct string input = StringFromBuffer(text, ARRAY_COUNT(text));
+      memory_arena arena = {.block = (u8 *)offsetsBuffer, .total = 64 * sizeof(*offsetsBuffer)};
+      struct string_line_index index;
+      if (StringLineIndexFrom(&arena, &input, STRING_LINE_INDEX_FLAG_NONE, &index) || arena.used != 0) {
+        errorCode = STRING_CURSOR_TEST_ERROR_LINE_INDEX_OUT_OF_MEMORY;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // enum csv_token CSVReaderNext(struct csv_reader *reader, struct string *field)
+  {
+    struct test_case {
+      struct string input;
+      u8 delimiter;
+      // fields separated with '|', records end with ';', '!' is error, '$' is end
+      struct string expected;
+    } testCases[] = {
+        {.input = StringFromLiteral(""), .delimiter = ',', .expected = StringFromLiteral("$")},
+        {.input = StringFromLiteral("a,b,c"), .delimiter = ',', .expected = StringFromLiteral("a|b|c;$")},
+        {.input = StringFromLiteral("a,b\nc,d\n"), .delimiter = ',', .expected = StringFromLiteral("a|b;c|d;$")},
+        {.input = StringFromLiteral("a,b\r\nc,d\r\n"), .delimiter = ',', .expected = StringFromLiteral("a|b;c|d;$")},
+        {.input = StringFromLiteral("a,\n,b\n\n"), .delimiter = ',', .expected = StringFromLiteral("a|;|b;;$")},
+        {.input = StringFromLiteral("a,"), .delimiter = ',', .expected = StringFromLiteral("a|;$")},
+        {.input = StringFromLiteral("a\tb,c\td"), .delimiter = '\t', .expected = StringFromLiteral("a|b,c|d;$")},
+        {
+            .input = StringFromLiteral("\"a,b\",\"c\nd\"\n"),
+            .delimiter = ',',
+            .expected = StringFromLiteral("a,b|c\nd;$"),
+        },
+        {
+            .input = StringFromLiteral("\"a\"\"b\",\"\"\"\",\"\""),
+            .delimiter = ',',
+            .expected = StringFromLiteral("a\"b|\"|;$"),
+        },
+        {.input = StringFromLiteral("\"a\r\n\"\r\nb"), .delimiter = ',', .expected = StringFromLiteral("a\r\n;b;$")},
+        {.input = StringFromLiteral("a,b\"c,d"), .delimiter = ',', .expected = StringFromLiteral("a|!$")},
+        {.input = StringFromLiteral("a,\"b\"c,d"), .delimiter = ',', .expected = StringFromLiteral("a|!$")},
+        {.input = StringFromLiteral("a,\"b\"c\"\",d"), .delimiter = ',', .expected = StringFromLiteral("a|!$")},
+        {.input = StringFromLiteral("a\n\"b,c"), .delimiter = ',', .expected = StringFromLiteral("a;!$")},
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      u8 inputBuffer[64];
+      MemoryCopy(inputBuffer, testCase->input.value, testCase->input.length);
+      struct string input = StringFromBuffer(inputBuffer, testCase->input.length);
+
+      struct csv_reader reader = CSVReaderFrom(&input, testCase->delimiter, 1);
+      struct string field;
+      enum csv_token token;
+      while ((token = CSVReaderNext(&reader, &field)) != CSV_TOKEN_END) {
+        if (token == CSV_TOKEN_ERROR) {
+          StringBuilderAppendStringLiteral(sb, "!");
+          break;
+        }
+        if (reader.isQuoted)
+          field = CSVFieldUnescape(&field);
+        StringBuilderAppendString(sb, &field);
+        StringBuilderAppendString(sb, token == CSV_TOKEN_FIELD ? &StringFromLiteral("|") : &StringFromLiteral(";"));
+      }
+      StringBuilderAppendStringLiteral(sb, "$");
+      struct string got = StringBuilderFlush(sb);
+
+      if (!IsStringEqual(&got, &testCase->expected)) {
+        errorCode = STRING_CURSOR_TEST_ERROR_CSV_READER;
+
+        u8 gotBuffer[64];
+        MemoryCopy(gotBuffer, got.value, got.length);
+        got.value = gotBuffer;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n     input: ");
+        StringBuilderAppendString(sb, &testCase->input);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendString(sb, &testCase->expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendString(sb, &got);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // Streaming: write random fields, read them back in chunks of every size
+  // void CSVReaderRefill(struct csv_reader *reader, struct string *chunk, b8 isFinal)
+  {
+    struct string alphabet = StringFromLiteral("ab,\"\n\r ");
+    enum { FIELD_COUNT = 96, FIELD_MAX = 12 };
+    u8 fieldBuffer[FIELD_COUNT][FIELD_MAX];
+    u64 fieldLengths[FIELD_COUNT];
+    u8 csvBuffer[FIELD_COUNT * (FIELD_MAX * 2 + 3)];
+    u64 csvLength = 0;
+
+    u64 random = 0x9e3779b97f4a7c15;
+#define NEXT_RANDOM() (random ^= random << 13, random ^= random >> 7, random ^= random << 17)
+    for (u32 fieldIndex = 0; fieldIndex < FIELD_COUNT; fieldIndex++) {
+      u64 length = NEXT_RANDOM() % FIELD_MAX;
+      b8 isQuoted = 0;
+      for (u64 index = 0; index < length; index++) {
+        u8 character = alphabet.value[NEXT_RANDOM() % alphabet.length];
+        fieldBuffer[fieldIndex][index] = character;
+        if (character == ',' || character == '"' || character == '\n' || character == '\r')
+          isQuoted = 1;
+      }
+      fieldLengths[fieldIndex] = length;
+
+      if (isQuoted)
+        csvBuffer[csvLength++] = '"';
+      for (u64 index = 0; index < length; index++) {
+        u8 character = fieldBuffer[fieldIndex][index];
+        csvBuffer[csvLength++] = character;
+        if (character == '"')
+          csvBuffer[csvLength++] = '"';
+      }
+      if (isQuoted)
+        csvBuffer[csvLength++] = '"';
+
+      // 4 fields per record
+      if (fieldIndex % 4 != 3)
+        csvBuffer[csvLength++] = ',';
+      else if (fieldIndex + 1 != FIELD_COUNT)
+        csvBuffer[csvLength++] = '\n';
+    }
+#undef NEXT_RANDOM
+
+    for (u64 chunkSize = 1; chunkSize <= csvLength; chunkSize += (chunkSize < 80 ? 1 : 97)) {
+      u8 buffer[2 * FIELD_MAX + 3 + 128];
+      u64 bufferLength = 0;
+      u64 csvPosition = 0;
+      u32 fieldIndex = 0;
+      b8 isEqual = 1;
+
+      struct string chunk = StringFromBuffer(buffer, 0);
+      struct csv_reader reader = CSVReaderFrom(&chunk, ',', 0);
+      while (isEqual) {
+        struct string field;
+        enum csv_token token = CSVReaderNext(&reader, &field);
+        if (token == CSV_TOKEN_END) {
+          if (reader.isFinal)
+            break;
+
+          // move incomplete field to start, append next chunk
+          struct string remaining = CSVReaderRemaining(&reader);
+          MemoryMove(buffer, remaining.value, remaining.length);
+          bufferLength = remaining.length;
+          u64 length = Minimum(Minimum(chunkSize, ARRAY_COUNT(buffer) - bufferLength), csvLength - csvPosition);
+          MemoryCopy(buffer + bufferLength, csvBuffer + csvPosition, length);
+          bufferLength += length;
+          csvPosition += length;
+
+          chunk = StringFromBuffer(buffer, bufferLength);
+          CSVReaderRefill(&reader, &chunk, csvPosition == csvLength);
+          continue;
+        }
+
+        if (token == CSV_TOKEN_ERROR || fieldIndex == FIELD_COUNT) {
+          isEqual = 0;
+          break;
+        }
+
+        if (reader.isQuoted)
+          field = CSVFieldUnescape(&field);
+        struct string expected = StringFromBuffer(fieldBuffer[fieldIndex], fieldLengths[fieldIndex]);
+        enum csv_token expectedToken = (fieldIndex % 4 == 3) ? CSV_TOKEN_LAST_FIELD : CSV_TOKEN_FIELD;
+        isEqual = IsStringEqual(&field, &expected) && token == expectedToken;
+        fieldIndex++;
+      }
+      isEqual = isEqual && fieldIndex == FIELD_COUNT;
+
+      if (!isEqual) {
+        errorCode = STRING_CURSOR_TEST_ERROR_CSV_READER_STREAM;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  chunk size: ");
+        StringBuilderAppendU64(sb, chunkSize);
+        StringBuilderAppendStringLiteral(sb, "\n       field: ");
+        StringBuilderAppendU64(sb, fieldIndex);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // struct string StringStreamConsumeUntil(struct string_stream *stream, struct string *search)
+  // struct string StringStreamConsumeThrough(struct string_stream *stream, struct string *search)
+  // struct string StringStreamConsumeUntilOrRest(struct string_stream *stream, struct string *search)
+  {
+    enum { TOKEN_COUNT = 64, TOKEN_MAX = 20 };
+    struct string separator = StringFromLiteral("<>");
+    u8 inputBuffer[TOKEN_COUNT * (TOKEN_MAX + 2)];
+    u64 inputLength = 0;
+
+    u64 random = 0x9e3779b97f4a7c15;
+#define NEXT_RANDOM() (random ^= random << 13, random ^= random >> 7, random ^= random << 17)
+    for (u32 tokenIndex = 0; tokenIndex < TOKEN_COUNT; tokenIndex++) {
+      u64 length = NEXT_RANDOM() % TOKEN_MAX;
+      // tokens may have "<>" too, or '<' before separator
+      for (u64 index = 0; index < length; index++)
+        inputBuffer[inputLength++] = (u8)"ab<>"[NEXT_RANDOM() % 4];
+      MemoryCopy(inputBuffer + inputLength, separator.value, separator.length);
+      inputLength += separator.length;
+    }
+#undef NEXT_RANDOM
+    struct string input = StringFromBuffer(inputBuffer, inputLength - 1);
+
+    u64 windowSizes[] = {TOKEN_MAX + 2, TOKEN_MAX + 5, 64, 256, 4096};
+    for (u32 windowIndex = 0; windowIndex < ARRAY_COUNT(windowSizes); windowIndex++) {
+      for (u64 chunkSize = 1; chunkSize <= 23; chunkSize++) {
+        u8 windowBuffer[4096];
+        struct string window = StringFromBuffer(windowBuffer, windowSizes[windowIndex]);
+        struct chunked_source source = {.cursor = StringCursorFromString(&input), .chunkSize = chunkSize};
+        struct string_stream stream = StringStreamFrom(&window, ChunkedSourceRead, &source);
+        struct string_cursor cursor = StringCursorFromString(&input);
+
+        u32 tokenIndex = 0;
+        b8 isEqual = 1;
+        while (isEqual) {
+          struct string expected;
+          struct string value;
+          if (tokenIndex % 2 == 0) {
+            expected = StringCursorConsumeUntil(&cursor, &separator);
+            value = StringStreamConsumeUntil(&stream, &separator);
+            if (!IsStringNull(&expected)) {
+              cursor.position += separator.length;
+              stream.position += separator.length;
+            }
+          } else {
+            expected = StringCursorConsumeThrough(&cursor, &separator);
+            value = StringStreamConsumeThrough(&stream, &separator);
+          }
+
+          isEqual = IsStringNull(&expected) == IsStringNull(&value) && IsStringEqual(&expected, &value);
+          if (IsStringNull(&expected))
+            break;
+          tokenIndex++;
+        }
+
+        // last token has no separator
+        struct string expectedRest = StringCursorConsumeUntilOrRest(&cursor, &separator);
+        struct string rest = StringStreamConsumeUntilOrRest(&stream, &separator);
+        isEqual = isEqual && IsStringEqual(&expectedRest, &rest) && IsStringStreamAtEnd(&stream) && !stream.isFailed &&
+                  stream.offset + stream.position == input.length;
+
+        // whole input in pieces of window
+        if (isEqual) {
+          source.cursor = StringCursorFromString(&input);
+          stream = StringStreamFrom(&window, ChunkedSourceRead, &source);
+          u64 position = 0;
+          while (isEqual && !IsStringStreamAtEnd(&stream)) {
+            struct string piece = StringStreamConsumeUntilOrRest(&stream, &separator);
+            struct string expectedPiece = StringFromBuffer(input.value + position, piece.length);
+            isEqual = position + piece.length <= input.length && IsStringEqual(&piece, &expectedPiece);
+            position += piece.length;
+            if (StringStreamPeekStartsWith(&stream, &separator)) {
+              stream.position += separator.length;
+              position += separator.length;
+            }
+          }
+          isEqual = isEqual && position == input.length;
+        }
+
+        if (!isEqual) {
+          errorCode = STRING_CURSOR_TEST_ERROR_STREAM;
+
+          StringBuilderAppendErrorMessage(sb, errorCode);
+          StringBuilderAppendStringLiteral(sb, "\n  window size: ");
+          StringBuilderAppendU64(sb, window.length);
+          StringBuilderAppendStringLiteral(sb, "\n   chunk size: ");
+          StringBuilderAppendU64(sb, chunkSize);
+          StringBuilderAppendStringLiteral(sb, "\n        token: ");
+          StringBuilderAppendU64(sb, tokenIndex);
+          StringBuilderAppendStringLiteral(sb, "\n");
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+          break;
+        }
+      }
+    }
+  }
+
+  // Text before search text does not fit in window
+  {
+    struct string input = StringFromLiteral("0123456789abcdef\n0123\n");
+    u8 windowBuffer[8];
+    struct string window = StringFromBuffer(windowBuffer, ARRAY_COUNT(windowBuffer));
+    struct string_cursor source = StringCursorFromString(&input);
+    struct string_stream stream = StringStreamFrom(&window, StringStreamReadFromCursor, &source);
+
+    struct string line = StringStreamConsumeThrough(&stream, &StringFromLiteral("\n"));
+    b8 isNotFound = IsStringNull(&line) && !stream.isEnd;
+    // skip rest of long line
+    do
+      StringStreamConsumeUntilOrRest(&stream, &StringFromLiteral("\n"));
+    while (!StringStreamPeekStartsWith(&stream, &StringFromLiteral("\n")));
+    stream.position++;
+    line = StringStreamConsumeThrough(&stream, &StringFromLiteral("\n"));
+    if (!isNotFound || !IsStringEqual(&line, &StringFromLiteral("0123\n"))) {
+      errorCode = STRING_CURSOR_TEST_ERROR_STREAM_WINDOW_FULL;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n  line: ");
+      StringBuilderAppendPrintableString(sb, &line);
+      StringBuilderAppendStringLiteral(sb, "\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+  }
+
   return (int)errorCode;
 }
@@ -1,9 +1,47 @@
 #include "platform.h"
+#include <stdlib.h>
+
+#include "glob.h"
+#include "json.h"
+#include "lz.h"
+#include "regex.h"
 #include "string_builder.h"
+#include "string_cursor.h"
 #include "text.h"
 
+// baseline for StringSort()
+internalfn int
+StringCompareForQSort(const void *left, const void *right)
+{
+  return StringCompare((struct string *)(u64)left, (struct string *)(u64)right);
+}
+
+// baseline for StringEditDistance(), one row of dynamic programming table
+internalfn u64
+StringEditDistanceSlow(struct string *left, struct string *right, u64 *row)
+{
+  for (u64 column = 0; column <= right->length; column++)
+    row[column] = column;
+  for (u64 leftIndex = 0; leftIndex < left->length; leftIndex++) {
+    u64 diagonal = row[0];
+    row[0] = leftIndex + 1;
+    for (u64 column = 1; column <= right->length; column++) {
+      u64 above = row[column];
+      u64 cost = diagonal + (left->value[leftIndex] != right->value[column - 1]);
+      if (above + 1 < cost)
+        cost = above + 1;
+      if (row[column - 1] + 1 < cost)
+        cost = row[column - 1] + 1;
+      row[column] = cost;
+      diagonal = above;
+    }
+  }
+  return row[right->length];
+}
+
+// baseline for StringBuilderAppendDuration(), division and StringBuilderAppendU64() per unit
 internalfn void
-StringBuilderAppendDuration(string_builder *sb, struct duration *duration)
+StringBuilderAppendDurationSlow(string_builder *sb, struct duration *duration)
 {
   struct string nanosecondUnitString = StringFromLiteral("ns");
   struct string microsecondUnitString = StringFromLiteral("us");
@@ -178,10 +216,32 @@ main(void)
   {
   }
 
-  // struct string StringStripWhitespace(struct string *string)
+  function = &StringFromLiteral("struct string StringStripWhitespace(struct string *string)");
   {
+    struct string *input = &StringFromLiteral("                                                                        "
+                                              "if (IsStringEqualOK) {\r\n                                          ");
+    u64 iterations = 10000000;
+    volatile u64 length;
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      length = StringStripWhitespace(input).length;
+    }
+    (void)length;
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
   }
 
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+
   function = &StringFromLiteral("b8 ParseDuration(struct string *string, struct duration *duration)");
   {
     struct string *input = &StringFromLiteral("78wk46day27hr08min14sec");
@@ -314,6 +374,1336 @@ main(void)
 
   StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
 
+  function = &StringFromLiteral("struct string HexEncode(struct string *buffer, struct string *input)");
+  {
+    u8 inputBuffer[1024];
+    for (u32 index = 0; index < ARRAY_COUNT(inputBuffer); index++)
+      inputBuffer[index] = (u8)(index * 167 + 13);
+    struct string input = StringFromBuffer(inputBuffer, ARRAY_COUNT(inputBuffer));
+    u64 iterations = 1000000;
+
+    u8 buffer[2 * ARRAY_COUNT(inputBuffer)];
+    struct string stringBuffer = {
+        .value = buffer,
+        .length = ARRAY_COUNT(buffer),
+    };
+
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      HexEncode(&stringBuffer, &input);
+    }
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("struct string HexDecode(struct string *buffer, struct string *input, u64 *errorIndex)");
+  {
+    u8 inputBuffer[2048];
+    for (u32 index = 0; index < ARRAY_COUNT(inputBuffer); index++)
+      inputBuffer[index] = (u8)("0123456789abcdefABCDEF"[index % 22]);
+    struct string input = StringFromBuffer(inputBuffer, ARRAY_COUNT(inputBuffer));
+    u64 iterations = 1000000;
+
+    u8 buffer[ARRAY_COUNT(inputBuffer) / 2];
+    struct string stringBuffer = {
+        .value = buffer,
+        .length = ARRAY_COUNT(buffer),
+    };
+
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      HexDecode(&stringBuffer, &input, 0);
+    }
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("u64 StringLength(struct string *string)");
+  {
+    struct string sample = StringFromLiteral("Σὲ γνωρίζω ἀπὸ τὴν κόψη, Зарегистрируйтесь сейчас, こんにちは, Xin chào! ");
+    u8 inputBuffer[4096];
+    for (u32 index = 0; index < ARRAY_COUNT(inputBuffer); index++)
+      inputBuffer[index] = sample.value[index % sample.length];
+    struct string input = StringFromBuffer(inputBuffer, ARRAY_COUNT(inputBuffer));
+    u64 iterations = 1000000;
+
+    volatile u64 length;
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      length = StringLength(&input);
+    }
+    (void)length;
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("b8 IsStringValidUTF8(struct string *string)");
+  {
+    struct string sample = StringFromLiteral("Σὲ γνωρίζω ἀπὸ τὴν κόψη, Зарегистрируйтесь сейчас, こんにちは, Xin chào! ");
+    u8 inputBuffer[4096];
+    u64 inputLength = 0;
+    while (inputLength + sample.length <= ARRAY_COUNT(inputBuffer)) {
+      MemoryCopy(inputBuffer + inputLength, sample.value, sample.length);
+      inputLength += sample.length;
+    }
+    struct string input = StringFromBuffer(inputBuffer, inputLength);
+    u64 iterations = 1000000;
+
+    volatile b8 isValid;
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      isValid = IsStringValidUTF8(&input);
+    }
+    (void)isValid;
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("struct string_utf16 StringToUTF16(memory_arena *arena, struct string *string, u64 *errorIndex)");
+  {
+    struct string sample =
+        StringFromLiteral("The quick brown fox jumps over the lazy dog. Σὲ γνωρίζω ἀπὸ τὴν κόψη, こんにちは, Xin chào! ");
+    u8 inputBuffer[1024];
+    u64 inputLength = 0;
+    while (inputLength + sample.length <= ARRAY_COUNT(inputBuffer)) {
+      MemoryCopy(inputBuffer + inputLength, sample.value, sample.length);
+      inputLength += sample.length;
+    }
+    struct string input = StringFromBuffer(inputBuffer, inputLength);
+    u64 iterations = 1000000;
+
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      memory_temp tempMemory = MemoryTempBegin(&stackMemory);
+      StringToUTF16(&stackMemory, &input, 0);
+      MemoryTempEnd(&tempMemory);
+    }
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("u64 StringHash(struct string *string, u64 seed)");
+  {
+    u64 inputLengths[] = {16, 64, 256, 4096};
+    u8 inputBuffer[4096];
+    for (u32 index = 0; index < ARRAY_COUNT(inputBuffer); index++)
+      inputBuffer[index] = (u8)(index * 131 + 7);
+
+    for (u32 inputLengthIndex = 0; inputLengthIndex < ARRAY_COUNT(inputLengths); inputLengthIndex++) {
+      struct string input = StringFromBuffer(inputBuffer, inputLengths[inputLengthIndex]);
+      u64 iterations = 100000000 / input.length;
+
+      volatile u64 hash;
+      u64 start = NowInNanoseconds();
+      for (u64 iteration = 0; iteration < iterations; iteration++) {
+        hash = StringHash(&input, iteration);
+      }
+      (void)hash;
+      struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+      StringBuilderAppendStringLiteral(sb, "  function: ");
+      StringBuilderAppendString(sb, function);
+      StringBuilderAppendStringLiteral(sb, "\n     input: ");
+      StringBuilderAppendU64(sb, input.length);
+      StringBuilderAppendStringLiteral(sb, " bytes");
+      StringBuilderAppendStringLiteral(sb, "\niterations: ");
+      StringBuilderAppendU64(sb, iterations);
+      StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+      StringBuilderAppendDuration(sb, &elapsed);
+      StringBuilderAppendStringLiteral(sb, "\nthroughput: ");
+      StringBuilderAppendU64(sb, input.length * iterations / (elapsed.ns == 0 ? 1 : elapsed.ns));
+      StringBuilderAppendStringLiteral(sb, ".");
+      StringBuilderAppendU64(sb, (input.length * iterations * 10 / (elapsed.ns == 0 ? 1 : elapsed.ns)) % 10);
+      StringBuilderAppendStringLiteral(sb, " GB/s\n");
+      struct string message = StringBuilderFlush(sb);
+      PrintString(&message);
+    }
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral(
+      "b8 StringLineIndexFrom(memory_arena *arena, struct string *source, u32 flags, struct string_line_index *index)");
+  {
+    static u8 inputBuffer[1 << 16];
+    u64 random = 0x9e3779b97f4a7c15;
+    for (u32 index = 0; index < ARRAY_COUNT(inputBuffer); index++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      // lines are 40 bytes on average
+      inputBuffer[index] = (random % 40 == 0) ? '\n' : (u8)('a' + random % 26);
+    }
+    struct string input = StringFromBuffer(inputBuffer, ARRAY_COUNT(inputBuffer));
+    static u64 offsetsBuffer[1 << 13];
+    u64 iterations = 10000;
+
+    struct string *names[] = {
+        &StringFromLiteral("StringLineIndexFrom()"),
+        &StringFromLiteral("StringCursorConsumeUntil() loop"),
+    };
+    for (u32 nameIndex = 0; nameIndex < ARRAY_COUNT(names); nameIndex++) {
+      volatile u64 lineCount;
+      u64 start = NowInNanoseconds();
+      for (u64 iteration = 0; iteration < iterations; iteration++) {
+        if (nameIndex == 0) {
+          memory_arena arena = {.block = (u8 *)offsetsBuffer, .total = sizeof(offsetsBuffer)};
+          struct string_line_index index = {0};
+          StringLineIndexFrom(&arena, &input, STRING_LINE_INDEX_FLAG_NONE, &index);
+          lineCount = index.count;
+        } else {
+          u64 count = 0;
+          struct string_cursor cursor = StringCursorFromString(&input);
+          while (!IsStringCursorAtEnd(&cursor)) {
+            StringCursorConsumeUntilOrRest(&cursor, &StringFromLiteral("\n"));
+            IsStringCursorStartsWith(&cursor, &StringFromLiteral("\n"));
+            count++;
+          }
+          lineCount = count;
+        }
+      }
+      (void)lineCount;
+      struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+      StringBuilderAppendStringLiteral(sb, "  function: ");
+      StringBuilderAppendString(sb, function);
+      StringBuilderAppendStringLiteral(sb, "\n   variant: ");
+      StringBuilderAppendString(sb, names[nameIndex]);
+      StringBuilderAppendStringLiteral(sb, "\niterations: ");
+      StringBuilderAppendU64(sb, iterations);
+      StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+      StringBuilderAppendDuration(sb, &elapsed);
+      StringBuilderAppendStringLiteral(sb, "\nthroughput: ");
+      StringBuilderAppendU64(sb, input.length * iterations / (elapsed.ns == 0 ? 1 : elapsed.ns));
+      StringBuilderAppendStringLiteral(sb, ".");
+      StringBuilderAppendU64(sb, (input.length * iterations * 10 / (elapsed.ns == 0 ? 1 : elapsed.ns)) % 10);
+      StringBuilderAppendStringLiteral(sb, " GB/s\n");
+      struct string message = StringBuilderFlush(sb);
+      PrintString(&message);
+    }
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("enum csv_token CSVReaderNext(struct csv_reader *reader, struct string *field)");
+  {
+    static u8 inputBuffer[1 << 16];
+    struct string sample = StringFromLiteral("1024,\"Doe, John\",john@example.com,\"said \"\"hi\"\"\",42.5\n"
+                                             "2048,Jane Roe,jane@example.com,plain text field,-7\n");
+    for (u32 index = 0; index < ARRAY_COUNT(inputBuffer); index++)
+      inputBuffer[index] = sample.value[index % sample.length];
+    struct string input = StringFromBuffer(inputBuffer, ARRAY_COUNT(inputBuffer));
+    u64 iterations = 10000;
+
+    volatile u64 fieldCount;
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      u64 count = 0;
+      struct csv_reader reader = CSVReaderFrom(&input, ',', 1);
+      struct string field;
+      while (CSVReaderNext(&reader, &field) != CSV_TOKEN_END)
+        count++;
+      fieldCount = count;
+    }
+    (void)fieldCount;
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\nthroughput: ");
+    StringBuilderAppendU64(sb, input.length * iterations / (elapsed.ns == 0 ? 1 : elapsed.ns));
+    StringBuilderAppendStringLiteral(sb, ".");
+    StringBuilderAppendU64(sb, (input.length * iterations * 10 / (elapsed.ns == 0 ? 1 : elapsed.ns)) % 10);
+    StringBuilderAppendStringLiteral(sb, " GB/s\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function =
+      &StringFromLiteral("b8 JSONParse(memory_arena *arena, struct string *source, struct json_tape *tape, u64 *errorIndex)");
+  {
+    static u8 inputBuffer[1 << 16];
+    struct string record = StringFromLiteral("{\"id\": 1024, \"name\": \"Doe, \\\"John\\\"\", \"score\": -42.5e-1,"
+                                             " \"tags\": [\"a\", \"b\", \"c\"], \"active\": true, \"next\": null},\n");
+    u64 inputLength = 0;
+    inputBuffer[inputLength++] = '[';
+    while (inputLength + record.length + 3 <= ARRAY_COUNT(inputBuffer)) {
+      MemoryCopy(inputBuffer + inputLength, record.value, record.length);
+      inputLength += record.length;
+    }
+    MemoryCopy(inputBuffer + inputLength, "{}]", 3);
+    inputLength += 3;
+    struct string input = StringFromBuffer(inputBuffer, inputLength);
+
+    static u8 tapeBuffer[1 << 20];
+    u64 iterations = 10000;
+
+    volatile u64 valueCount;
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      memory_arena arena = {.block = tapeBuffer, .total = sizeof(tapeBuffer)};
+      struct json_tape tape = {0};
+      JSONParse(&arena, &input, &tape, 0);
+      valueCount = tape.count;
+    }
+    (void)valueCount;
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\nthroughput: ");
+    StringBuilderAppendU64(sb, input.length * iterations / (elapsed.ns == 0 ? 1 : elapsed.ns));
+    StringBuilderAppendStringLiteral(sb, ".");
+    StringBuilderAppendU64(sb, (input.length * iterations * 10 / (elapsed.ns == 0 ? 1 : elapsed.ns)) % 10);
+    StringBuilderAppendStringLiteral(sb, " GB/s\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("void StringBuilderAppendJSONString(string_builder *stringBuilder, struct string *string)");
+  {
+    // log text, one escape per line
+    static u8 inputBuffer[1 << 16];
+    struct string line = StringFromLiteral("2024-01-01T00:00:00Z INFO request handled path=/api/v1/items status=200 "
+                                           "user=\"guest\" elapsed=12ms\n");
+    for (u64 index = 0; index < ARRAY_COUNT(inputBuffer); index++)
+      inputBuffer[index] = line.value[index % line.length];
+    struct string input = StringFromBuffer(inputBuffer, ARRAY_COUNT(inputBuffer));
+
+    static u8 outputBuffer[2 << 16];
+    struct string outBuffer = StringFromBuffer(outputBuffer, ARRAY_COUNT(outputBuffer));
+    string_builder jsonStringBuilder = {.outBuffer = &outBuffer};
+    u64 iterations = 10000;
+
+    volatile u64 outputLength;
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      StringBuilderClear(&jsonStringBuilder);
+      StringBuilderAppendJSONString(&jsonStringBuilder, &input);
+      outputLength = jsonStringBuilder.length;
+    }
+    (void)outputLength;
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\nthroughput: ");
+    StringBuilderAppendU64(sb, input.length * iterations / (elapsed.ns == 0 ? 1 : elapsed.ns));
+    StringBuilderAppendStringLiteral(sb, ".");
+    StringBuilderAppendU64(sb, (input.length * iterations * 10 / (elapsed.ns == 0 ? 1 : elapsed.ns)) % 10);
+    StringBuilderAppendStringLiteral(sb, " GB/s\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("struct string Base64Encode(struct string *buffer, struct string *input, enum base64_alphabet alphabet)");
+  {
+    static u8 inputBuffer[3 << 14];
+    u64 random = 0x9e3779b97f4a7c15;
+    for (u64 index = 0; index < ARRAY_COUNT(inputBuffer); index++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      inputBuffer[index] = (u8)random;
+    }
+    struct string bytes = StringFromBuffer(inputBuffer, ARRAY_COUNT(inputBuffer));
+
+    static u8 outputBuffer[4 << 14];
+    struct string outputBufferString = StringFromBuffer(outputBuffer, ARRAY_COUNT(outputBuffer));
+    struct string input = bytes;
+    u64 iterations = 10000;
+
+    volatile u64 outputLength;
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      struct string output = Base64Encode(&outputBufferString, &input, BASE64_ALPHABET_STANDARD);
+      outputLength = output.length;
+    }
+    (void)outputLength;
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\nthroughput: ");
+    StringBuilderAppendU64(sb, input.length * iterations / (elapsed.ns == 0 ? 1 : elapsed.ns));
+    StringBuilderAppendStringLiteral(sb, ".");
+    StringBuilderAppendU64(sb, (input.length * iterations * 10 / (elapsed.ns == 0 ? 1 : elapsed.ns)) % 10);
+    StringBuilderAppendStringLiteral(sb, " GB/s\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("struct string Base64Decode(struct string *buffer, struct string *input, "
+                                "enum base64_alphabet alphabet, u64 *errorIndex)");
+  {
+    static u8 inputBuffer[3 << 14];
+    u64 random = 0x9e3779b97f4a7c15;
+    for (u64 index = 0; index < ARRAY_COUNT(inputBuffer); index++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      inputBuffer[index] = (u8)random;
+    }
+    struct string bytes = StringFromBuffer(inputBuffer, ARRAY_COUNT(inputBuffer));
+
+    static u8 textBuffer[4 << 14];
+    struct string textBufferString = StringFromBuffer(textBuffer, ARRAY_COUNT(textBuffer));
+    struct string text = Base64Encode(&textBufferString, &bytes, BASE64_ALPHABET_STANDARD);
+    static u8 outputBuffer[4 << 14];
+    struct string outputBufferString = StringFromBuffer(outputBuffer, ARRAY_COUNT(outputBuffer));
+    struct string input = text;
+    u64 iterations = 10000;
+
+    volatile u64 outputLength;
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      struct string output = Base64Decode(&outputBufferString, &input, BASE64_ALPHABET_STANDARD, 0);
+      outputLength = output.length;
+    }
+    (void)outputLength;
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\nthroughput: ");
+    StringBuilderAppendU64(sb, input.length * iterations / (elapsed.ns == 0 ? 1 : elapsed.ns));
+    StringBuilderAppendStringLiteral(sb, ".");
+    StringBuilderAppendU64(sb, (input.length * iterations * 10 / (elapsed.ns == 0 ? 1 : elapsed.ns)) % 10);
+    StringBuilderAppendStringLiteral(sb, " GB/s\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("struct string PercentDecode(struct string *string, u32 flags, u64 *errorIndex)");
+  {
+    // query text, few escapes per parameter, copied back before each decode
+    static u8 inputBuffer[1 << 16];
+    struct string parameter = StringFromLiteral("redirect_uri=https%3A%2F%2Fexample.com%2Fcallback&state=af0ifjsldkj&"
+                                                "scope=openid+profile+email&nonce=n-0S6_WzA2Mj&");
+    for (u64 index = 0; index < ARRAY_COUNT(inputBuffer); index++)
+      inputBuffer[index] = parameter.value[index % parameter.length];
+    static u8 decodeBuffer[1 << 16];
+    struct string input = StringFromBuffer(inputBuffer, ARRAY_COUNT(inputBuffer));
+    u64 iterations = 10000;
+
+    volatile u64 outputLength;
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      MemoryCopy(decodeBuffer, inputBuffer, ARRAY_COUNT(inputBuffer));
+      struct string decode = StringFromBuffer(decodeBuffer, ARRAY_COUNT(decodeBuffer));
+      struct string output = PercentDecode(&decode, PERCENT_DECODE_FLAG_PLUS_AS_SPACE, 0);
+      outputLength = output.length;
+    }
+    (void)outputLength;
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\nthroughput: ");
+    StringBuilderAppendU64(sb, input.length * iterations / (elapsed.ns == 0 ? 1 : elapsed.ns));
+    StringBuilderAppendStringLiteral(sb, ".");
+    StringBuilderAppendU64(sb, (input.length * iterations * 10 / (elapsed.ns == 0 ? 1 : elapsed.ns)) % 10);
+    StringBuilderAppendStringLiteral(sb, " GB/s\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("b8 StringSort(memory_arena *arena, struct string *strings, u64 count)");
+  {
+    // log keys, shared prefixes longer than 8 bytes
+    enum { STRING_COUNT = 1 << 18 };
+    static u8 textBuffer[STRING_COUNT * 32];
+    static struct string input[STRING_COUNT];
+    static struct string strings[STRING_COUNT];
+    struct string services[] = {
+        StringFromLiteral("api.gateway.request."),
+        StringFromLiteral("api.gateway.response."),
+        StringFromLiteral("db.pool.connection."),
+        StringFromLiteral("cache.hit."),
+    };
+    u64 random = 0x9e3779b97f4a7c15;
+    u64 textLength = 0;
+    for (u64 index = 0; index < STRING_COUNT; index++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      struct string *service = services + random % ARRAY_COUNT(services);
+      MemoryCopy(textBuffer + textLength, service->value, service->length);
+      u8 digits[8];
+      struct string digitsBuffer = StringFromBuffer(digits, ARRAY_COUNT(digits));
+      struct string number = FormatHex(&digitsBuffer, (random >> 8) & 0xffffff);
+      MemoryCopy(textBuffer + textLength + service->length, number.value, number.length);
+      input[index] = StringFromBuffer(textBuffer + textLength, service->length + number.length);
+      textLength += input[index].length;
+    }
+
+    static u8 sortBuffer[STRING_COUNT * sizeof(struct string_sort_entry)];
+    u64 iterations = 10;
+
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      MemoryCopy(strings, input, sizeof(input));
+      memory_arena arena = {.block = sortBuffer, .total = sizeof(sortBuffer)};
+      StringSort(&arena, strings, STRING_COUNT);
+    }
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\n   strings: ");
+    StringBuilderAppendU64(sb, STRING_COUNT);
+    StringBuilderAppendStringLiteral(sb, "\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("qsort(strings, count, sizeof(struct string), StringCompare)");
+  {
+    // log keys, shared prefixes longer than 8 bytes
+    enum { STRING_COUNT = 1 << 18 };
+    static u8 textBuffer[STRING_COUNT * 32];
+    static struct string input[STRING_COUNT];
+    static struct string strings[STRING_COUNT];
+    struct string services[] = {
+        StringFromLiteral("api.gateway.request."),
+        StringFromLiteral("api.gateway.response."),
+        StringFromLiteral("db.pool.connection."),
+        StringFromLiteral("cache.hit."),
+    };
+    u64 random = 0x9e3779b97f4a7c15;
+    u64 textLength = 0;
+    for (u64 index = 0; index < STRING_COUNT; index++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      struct string *service = services + random % ARRAY_COUNT(services);
+      MemoryCopy(textBuffer + textLength, service->value, service->length);
+      u8 digits[8];
+      struct string digitsBuffer = StringFromBuffer(digits, ARRAY_COUNT(digits));
+      struct string number = FormatHex(&digitsBuffer, (random >> 8) & 0xffffff);
+      MemoryCopy(textBuffer + textLength + service->length, number.value, number.length);
+      input[index] = StringFromBuffer(textBuffer + textLength, service->length + number.length);
+      textLength += input[index].length;
+    }
+
+    u64 iterations = 10;
+
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      MemoryCopy(strings, input, sizeof(input));
+      qsort(strings, STRING_COUNT, sizeof(*strings), StringCompareForQSort);
+    }
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\n   strings: ");
+    StringBuilderAppendU64(sb, STRING_COUNT);
+    StringBuilderAppendStringLiteral(sb, "\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("b8 StringEditDistanceBatch(memory_arena *arena, struct string *query, "
+                                 "struct string *candidates, u64 count, u64 maxDistance, u64 *distances)");
+  {
+    // "did you mean", short query against many identifiers
+    enum { CANDIDATE_COUNT = 1 << 16 };
+    static u8 textBuffer[CANDIDATE_COUNT * 24];
+    static struct string candidates[CANDIDATE_COUNT];
+    static u64 distances[CANDIDATE_COUNT];
+    u64 random = 0x9e3779b97f4a7c15;
+    for (u64 index = 0; index < CANDIDATE_COUNT; index++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      u64 length = 4 + random % 20;
+      for (u64 byteIndex = 0; byteIndex < length; byteIndex++) {
+        random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+        textBuffer[index * 24 + byteIndex] = (u8)("etaoinshrdlu_"[random % 13]);
+      }
+      candidates[index] = StringFromBuffer(textBuffer + index * 24, length);
+    }
+    struct string query = StringFromLiteral("thread_count");
+
+    static u8 arenaBuffer[(256 + 3) * sizeof(u64)];
+    memory_arena arena = {.block = arenaBuffer, .total = sizeof(arenaBuffer)};
+    u64 iterations = 100;
+
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++)
+      StringEditDistanceBatch(&arena, &query, candidates, CANDIDATE_COUNT, 2, distances);
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\ncandidates: ");
+    StringBuilderAppendU64(sb, CANDIDATE_COUNT);
+    StringBuilderAppendStringLiteral(sb, "\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("b8 StringEditDistance(memory_arena *arena, struct string *left, struct string *right, "
+                                 "u64 maxDistance, u64 *distance)");
+  {
+    // long strings, 4 bytes differ in every 64
+    enum { TEXT_LENGTH = 4096 };
+    static u8 leftBuffer[TEXT_LENGTH];
+    static u8 rightBuffer[TEXT_LENGTH];
+    u64 random = 0x9e3779b97f4a7c15;
+    for (u64 index = 0; index < TEXT_LENGTH; index++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      leftBuffer[index] = (u8)('a' + random % 26);
+      rightBuffer[index] = (random >> 32) % 16 == 0 ? (u8)('a' + (random >> 40) % 26) : leftBuffer[index];
+    }
+    struct string left = StringFromBuffer(leftBuffer, TEXT_LENGTH);
+    struct string right = StringFromBuffer(rightBuffer, TEXT_LENGTH);
+
+    static u8 arenaBuffer[(256 + 3) * (TEXT_LENGTH / 64) * sizeof(u64)];
+    memory_arena arena = {.block = arenaBuffer, .total = sizeof(arenaBuffer)};
+    u64 distance = 0;
+    u64 iterations = 10;
+
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++)
+      StringEditDistance(&arena, &left, &right, U64_MAX, &distance);
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\n  distance: ");
+    StringBuilderAppendU64(sb, distance);
+    StringBuilderAppendStringLiteral(sb, "\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("u64 StringEditDistanceSlow(struct string *left, struct string *right, u64 *row)");
+  {
+    // long strings, 4 bytes differ in every 64
+    enum { TEXT_LENGTH = 4096 };
+    static u8 leftBuffer[TEXT_LENGTH];
+    static u8 rightBuffer[TEXT_LENGTH];
+    static u64 row[TEXT_LENGTH + 1];
+    u64 random = 0x9e3779b97f4a7c15;
+    for (u64 index = 0; index < TEXT_LENGTH; index++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      leftBuffer[index] = (u8)('a' + random % 26);
+      rightBuffer[index] = (random >> 32) % 16 == 0 ? (u8)('a' + (random >> 40) % 26) : leftBuffer[index];
+    }
+    struct string left = StringFromBuffer(leftBuffer, TEXT_LENGTH);
+    struct string right = StringFromBuffer(rightBuffer, TEXT_LENGTH);
+    u64 distance = 0;
+    u64 iterations = 10;
+
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++)
+      distance = StringEditDistanceSlow(&left, &right, row);
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\n  distance: ");
+    StringBuilderAppendU64(sb, distance);
+    StringBuilderAppendStringLiteral(sb, "\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("b8 GlobMatch(struct glob *glob, struct string *path, u64 *patternIndex)");
+  {
+    // source tree paths against exclude patterns, few of them match
+    enum { PATH_COUNT = 1 << 16 };
+    static u8 textBuffer[PATH_COUNT * 48];
+    static struct string paths[PATH_COUNT];
+    struct string directories[] = {
+        StringFromLiteral("src/"),       StringFromLiteral("src/lib/"),            StringFromLiteral("include/"),
+        StringFromLiteral("test/data/"), StringFromLiteral("build/obj/"),          StringFromLiteral("tmp/"),
+        StringFromLiteral("docs/api/"),  StringFromLiteral("web/node_modules/x/"),
+    };
+    struct string extensions[] = {
+        StringFromLiteral(".c"), StringFromLiteral(".h"), StringFromLiteral(".o"), StringFromLiteral(".log"),
+    };
+    u64 random = 0x9e3779b97f4a7c15;
+    u64 textLength = 0;
+    for (u64 index = 0; index < PATH_COUNT; index++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      struct string *directory = directories + random % ARRAY_COUNT(directories);
+      struct string *extension = extensions + (random >> 8) % ARRAY_COUNT(extensions);
+      u8 *text = textBuffer + textLength;
+      MemoryCopy(text, directory->value, directory->length);
+      u64 length = directory->length;
+      u64 nameLength = 4 + (random >> 16) % 12;
+      for (u64 byteIndex = 0; byteIndex < nameLength; byteIndex++)
+        text[length++] = (u8)('a' + (random >> (byteIndex * 2)) % 26);
+      MemoryCopy(text + length, extension->value, extension->length);
+      length += extension->length;
+      paths[index] = StringFromBuffer(text, length);
+      textLength += length;
+    }
+
+    struct string patterns[] = {
+        StringFromLiteral("build/**"),
+        StringFromLiteral("**/node_modules/**"),
+        StringFromLiteral("**/*.o"),
+        StringFromLiteral("**/*.log"),
+        StringFromLiteral("tmp/*"),
+        StringFromLiteral("**/.git/**"),
+        StringFromLiteral("**/*.[ch].orig"),
+        StringFromLiteral("docs/**/*.html"),
+    };
+    static u8 globBuffer[16 * 1024];
+    memory_arena arena = {.block = globBuffer, .total = sizeof(globBuffer)};
+    struct glob glob;
+    GlobCompile(&arena, patterns, ARRAY_COUNT(patterns), &glob, 0);
+
+    u64 iterations = 100;
+    u64 matchCount = 0;
+
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      for (u64 index = 0; index < PATH_COUNT; index++)
+        matchCount += GlobMatch(&glob, paths + index, 0);
+    }
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    u64 byteCount = textLength * iterations;
+    StringBuilderAppendStringLiteral(sb, "  function: ");
+    StringBuilderAppendString(sb, function);
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\n     paths: ");
+    StringBuilderAppendU64(sb, PATH_COUNT);
+    StringBuilderAppendStringLiteral(sb, "\n   matches: ");
+    StringBuilderAppendU64(sb, matchCount / iterations);
+    StringBuilderAppendStringLiteral(sb, "\nthroughput: ");
+    StringBuilderAppendU64(sb, byteCount / (elapsed.ns == 0 ? 1 : elapsed.ns));
+    StringBuilderAppendStringLiteral(sb, ".");
+    StringBuilderAppendU64(sb, (byteCount * 10 / (elapsed.ns == 0 ? 1 : elapsed.ns)) % 10);
+    StringBuilderAppendStringLiteral(sb, " GB/s\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("struct string StringCursorConsumeMatchingLine(struct string_cursor *cursor, "
+                                "struct regex *regex)");
+  {
+    // service log, first pattern has required literal, second one runs DFA on every line
+    enum { LINE_COUNT = 1 << 16 };
+    static u8 textBuffer[LINE_COUNT * 64];
+    struct string levels[] = {
+        StringFromLiteral("INFO"), StringFromLiteral("INFO"), StringFromLiteral("DEBUG"),
+        StringFromLiteral("WARN"), StringFromLiteral("ERROR"),
+    };
+    u64 random = 0x9e3779b97f4a7c15;
+    u64 textLength = 0;
+    for (u64 index = 0; index < LINE_COUNT; index++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      struct string *level = levels + random % ARRAY_COUNT(levels);
+      u8 *text = textBuffer + textLength;
+      MemoryCopy(text, level->value, level->length);
+      u64 length = level->length;
+      MemoryCopy(text + length, " request /api/", 14);
+      length += 14;
+      u64 nameLength = 4 + (random >> 8) % 12;
+      for (u64 byteIndex = 0; byteIndex < nameLength; byteIndex++)
+        text[length++] = (u8)('a' + (random >> (byteIndex * 2)) % 26);
+      MemoryCopy(text + length, " took ", 6);
+      length += 6;
+      u64 milliseconds = (random >> 32) % 20000;
+      do {
+        text[length++] = (u8)('0' + milliseconds % 10);
+        milliseconds /= 10;
+      } while (milliseconds != 0);
+      text[length++] = 'm';
+      text[length++] = 's';
+      text[length++] = '\n';
+      textLength += length;
+    }
+    struct string text = StringFromBuffer(textBuffer, textLength);
+
+    struct string patterns[] = {
+        StringFromLiteral("^ERROR .* took [0-9]{5,}ms$"),
+        StringFromLiteral("[0-9]{5,}ms$"),
+    };
+    for (u32 patternIndex = 0; patternIndex < ARRAY_COUNT(patterns); patternIndex++) {
+      struct string *pattern = patterns + patternIndex;
+      static u8 regexBuffer[256 * 1024];
+      memory_arena arena = {.block = regexBuffer, .total = sizeof(regexBuffer)};
+      struct regex regex;
+      RegexCompile(&arena, pattern, 64 * 1024, &regex, 0);
+
+      u64 iterations = 50;
+      u64 matchCount = 0;
+
+      u64 start = NowInNanoseconds();
+      for (u64 iteration = 0; iteration < iterations; iteration++) {
+        struct string_cursor cursor = StringCursorFromString(&text);
+        while (!IsStringCursorAtEnd(&cursor)) {
+          struct string line = StringCursorConsumeMatchingLine(&cursor, &regex);
+          if (IsStringNull(&line))
+            break;
+          matchCount++;
+        }
+      }
+      struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+      u64 byteCount = textLength * iterations;
+      StringBuilderAppendStringLiteral(sb, "  function: ");
+      StringBuilderAppendString(sb, function);
+      StringBuilderAppendStringLiteral(sb, "\n   pattern: ");
+      StringBuilderAppendString(sb, pattern);
+      StringBuilderAppendStringLiteral(sb, "\niterations: ");
+      StringBuilderAppendU64(sb, iterations);
+      StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+      StringBuilderAppendDuration(sb, &elapsed);
+      StringBuilderAppendStringLiteral(sb, "\n   matches: ");
+      StringBuilderAppendU64(sb, matchCount / iterations);
+      StringBuilderAppendStringLiteral(sb, "\nthroughput: ");
+      StringBuilderAppendU64(sb, byteCount / (elapsed.ns == 0 ? 1 : elapsed.ns));
+      StringBuilderAppendStringLiteral(sb, ".");
+      StringBuilderAppendU64(sb, (byteCount * 10 / (elapsed.ns == 0 ? 1 : elapsed.ns)) % 10);
+      StringBuilderAppendStringLiteral(sb, " GB/s\n");
+      struct string message = StringBuilderFlush(sb);
+      PrintString(&message);
+    }
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  {
+    // file indexer paths, some of them with ".", ".." and repeated separators
+    enum { PATH_COUNT = 1 << 16 };
+    static u8 sourceBuffer[PATH_COUNT * 80];
+    static u8 textBuffer[PATH_COUNT * 80];
+    static struct string paths[PATH_COUNT];
+    struct string directories[] = {
+        StringFromLiteral("/home/user/projects/"), StringFromLiteral("/usr/include/"),
+        StringFromLiteral("src/lib/../"),          StringFromLiteral("./build//obj/"),
+        StringFromLiteral("/var/log/./service/"),  StringFromLiteral("third_party/library/include/"),
+    };
+    u64 random = 0x9e3779b97f4a7c15;
+    u64 textLength = 0;
+    static u64 pathOffsets[PATH_COUNT];
+    for (u64 index = 0; index < PATH_COUNT; index++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      struct string *directory = directories + random % ARRAY_COUNT(directories);
+      u8 *text = sourceBuffer + textLength;
+      MemoryCopy(text, directory->value, directory->length);
+      u64 length = directory->length;
+      u64 depth = 1 + (random >> 8) % 4;
+      for (u64 level = 0; level < depth; level++) {
+        u64 nameLength = 3 + (random >> (16 + level * 8)) % 10;
+        for (u64 byteIndex = 0; byteIndex < nameLength; byteIndex++)
+          text[length++] = (u8)('a' + (random >> (byteIndex * 3 + level)) % 26);
+        text[length++] = level + 1 == depth ? '.' : '/';
+      }
+      text[length++] = 'c';
+      pathOffsets[index] = textLength;
+      paths[index] = StringFromBuffer(textBuffer + textLength, length);
+      textLength += length;
+    }
+
+    u64 iterations = 100;
+    u64 componentCount = 0;
+    u64 normalizedLength = 0;
+
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      // normalized in place, so it starts from source every time
+      MemoryCopy(textBuffer, sourceBuffer, textLength);
+      for (u64 index = 0; index < PATH_COUNT; index++) {
+        struct string path = paths[index];
+        struct string normalized = PathNormalize(&path);
+        normalizedLength += normalized.length;
+      }
+    }
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    u64 byteCount = textLength * iterations;
+    StringBuilderAppendStringLiteral(sb, "  function: struct string PathNormalize(struct string *path)");
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\n     paths: ");
+    StringBuilderAppendU64(sb, PATH_COUNT);
+    StringBuilderAppendStringLiteral(sb, "\n    length: ");
+    StringBuilderAppendU64(sb, textLength);
+    StringBuilderAppendStringLiteral(sb, " -> ");
+    StringBuilderAppendU64(sb, normalizedLength / iterations);
+    StringBuilderAppendStringLiteral(sb, "\nthroughput: ");
+    StringBuilderAppendU64(sb, byteCount / (elapsed.ns == 0 ? 1 : elapsed.ns));
+    StringBuilderAppendStringLiteral(sb, ".");
+    StringBuilderAppendU64(sb, (byteCount * 10 / (elapsed.ns == 0 ? 1 : elapsed.ns)) % 10);
+    StringBuilderAppendStringLiteral(sb, " GB/s\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+
+    start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      for (u64 index = 0; index < PATH_COUNT; index++) {
+        struct string path = StringFromBuffer(sourceBuffer + pathOffsets[index], paths[index].length);
+        struct path_iterator iterator = PathIteratorFrom(&path);
+        struct string component;
+        while (PathIteratorNext(&iterator, &component))
+          componentCount++;
+      }
+    }
+    elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: b8 PathIteratorNext(struct path_iterator *iterator, "
+                                         "struct string *component)");
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\ncomponents: ");
+    StringBuilderAppendU64(sb, componentCount / iterations);
+    StringBuilderAppendStringLiteral(sb, "\nthroughput: ");
+    StringBuilderAppendU64(sb, byteCount / (elapsed.ns == 0 ? 1 : elapsed.ns));
+    StringBuilderAppendStringLiteral(sb, ".");
+    StringBuilderAppendU64(sb, (byteCount * 10 / (elapsed.ns == 0 ? 1 : elapsed.ns)) % 10);
+    StringBuilderAppendStringLiteral(sb, " GB/s\n");
+    message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  {
+    // log line timestamps with milli, micro and nanosecond precision and offsets
+    enum { TIMESTAMP_COUNT = 1 << 16 };
+    static u8 textBuffer[TIMESTAMP_COUNT * 40];
+    static struct string timestamps[TIMESTAMP_COUNT];
+    static struct timestamp values[TIMESTAMP_COUNT];
+    struct string zones[] = {
+        StringFromLiteral("Z"),
+        StringFromLiteral("+02:00"),
+        StringFromLiteral("-07:30"),
+    };
+    u64 random = 0x9e3779b97f4a7c15;
+    u64 textLength = 0;
+    for (u64 index = 0; index < TIMESTAMP_COUNT; index++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      // 2000 to 2038
+      struct timestamp timestamp = {.ns = 946684800000000000 + (s64)(random % 1200000000000000000)};
+      u32 fractionCount = 3 * (1 + (u32)(random >> 60) % 3);
+      struct string buffer = StringFromBuffer(textBuffer + textLength, 40);
+      struct string text = FormatTimestamp(&buffer, &timestamp, fractionCount);
+      // zone replaces 'Z', local time is not adjusted because only parsing speed matters
+      struct string *zone = zones + (random >> 56) % ARRAY_COUNT(zones);
+      MemoryCopy(text.value + text.length - 1, zone->value, zone->length);
+      timestamps[index] = StringFromBuffer(text.value, text.length - 1 + zone->length);
+      textLength += timestamps[index].length;
+    }
+
+    u64 iterations = 100;
+    u64 parsedCount = 0;
+
+    u64 start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      for (u64 index = 0; index < TIMESTAMP_COUNT; index++)
+        parsedCount += ParseTimestamp(timestamps + index, values + index);
+    }
+    struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    u64 byteCount = textLength * iterations;
+    StringBuilderAppendStringLiteral(sb, "  function: b8 ParseTimestamp(struct string *string, "
+                                         "struct timestamp *timestamp)");
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\n    parsed: ");
+    StringBuilderAppendU64(sb, parsedCount / iterations);
+    StringBuilderAppendStringLiteral(sb, "\n  per call: ");
+    StringBuilderAppendU64(sb, elapsed.ns / (iterations * TIMESTAMP_COUNT));
+    StringBuilderAppendStringLiteral(sb, "ns\nthroughput: ");
+    StringBuilderAppendU64(sb, byteCount / (elapsed.ns == 0 ? 1 : elapsed.ns));
+    StringBuilderAppendStringLiteral(sb, ".");
+    StringBuilderAppendU64(sb, (byteCount * 10 / (elapsed.ns == 0 ? 1 : elapsed.ns)) % 10);
+    StringBuilderAppendStringLiteral(sb, " GB/s\n");
+    struct string message = StringBuilderFlush(sb);
+    PrintString(&message);
+
+    u8 buffer[32];
+    struct string stringBuffer = StringFromBuffer(buffer, sizeof(buffer));
+    u64 formattedLength = 0;
+    start = NowInNanoseconds();
+    for (u64 iteration = 0; iteration < iterations; iteration++) {
+      for (u64 index = 0; index < TIMESTAMP_COUNT; index++)
+        formattedLength += FormatTimestamp(&stringBuffer, values + index, 9).length;
+    }
+    elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+    StringBuilderAppendStringLiteral(sb, "  function: struct string FormatTimestamp(struct string *buffer, "
+                                         "struct timestamp *timestamp, u32 fractionCount)");
+    StringBuilderAppendStringLiteral(sb, "\niterations: ");
+    StringBuilderAppendU64(sb, iterations);
+    StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+    StringBuilderAppendDuration(sb, &elapsed);
+    StringBuilderAppendStringLiteral(sb, "\n    length: ");
+    StringBuilderAppendU64(sb, formattedLength / iterations);
+    StringBuilderAppendStringLiteral(sb, "\n  per call: ");
+    StringBuilderAppendU64(sb, elapsed.ns / (iterations * TIMESTAMP_COUNT));
+    StringBuilderAppendStringLiteral(sb, "ns\n");
+    message = StringBuilderFlush(sb);
+    PrintString(&message);
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  {
+    // latency histogram values, from nanoseconds to minutes
+    enum { DURATION_COUNT = 1 << 12 };
+    static struct duration durations[DURATION_COUNT];
+    u64 random = 0x9e3779b97f4a7c15;
+    for (u64 index = 0; index < DURATION_COUNT; index++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      durations[index].ns = (random >> 28) >> (random % 36);
+    }
+
+    struct string functions[] = {
+        StringFromLiteral("void StringBuilderAppendDurationSlow(string_builder *sb, struct duration *duration)"),
+        StringFromLiteral("void StringBuilderAppendDuration(string_builder *stringBuilder, "
+                          "struct duration *duration)"),
+        StringFromLiteral("void StringBuilderAppendDurationFixed(string_builder *stringBuilder, "
+                          "struct duration *duration, u32 fractionCount)"),
+    };
+    u8 outBufferBytes[64];
+    u8 stringBufferBytes[32];
+    struct string outBuffer = StringFromBuffer(outBufferBytes, sizeof(outBufferBytes));
+    struct string stringBuffer = StringFromBuffer(stringBufferBytes, sizeof(stringBufferBytes));
+    string_builder *durationBuilder = &(string_builder){
+        .outBuffer = &outBuffer,
+        .stringBuffer = &stringBuffer,
+    };
+    for (u32 functionIndex = 0; functionIndex < ARRAY_COUNT(functions); functionIndex++) {
+      u64 iterations = 500;
+      u64 length = 0;
+
+      u64 start = NowInNanoseconds();
+      for (u64 iteration = 0; iteration < iterations; iteration++) {
+        for (u64 index = 0; index < DURATION_COUNT; index++) {
+          if (functionIndex == 0)
+            StringBuilderAppendDurationSlow(durationBuilder, durations + index);
+          else if (functionIndex == 1)
+            StringBuilderAppendDuration(durationBuilder, durations + index);
+          else
+            StringBuilderAppendDurationFixed(durationBuilder, durations + index, 3);
+          length += StringBuilderFlush(durationBuilder).length;
+        }
+      }
+      struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+      StringBuilderAppendStringLiteral(sb, "  function: ");
+      StringBuilderAppendString(sb, functions + functionIndex);
+      StringBuilderAppendStringLiteral(sb, "\niterations: ");
+      StringBuilderAppendU64(sb, iterations);
+      StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+      StringBuilderAppendDuration(sb, &elapsed);
+      StringBuilderAppendStringLiteral(sb, "\n    length: ");
+      StringBuilderAppendU64(sb, length / iterations);
+      StringBuilderAppendStringLiteral(sb, "\n  per call: ");
+      StringBuilderAppendU64(sb, elapsed.ns / (iterations * DURATION_COUNT));
+      StringBuilderAppendStringLiteral(sb, "ns\n");
+      struct string message = StringBuilderFlush(sb);
+      PrintString(&message);
+    }
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("struct string StringStreamConsumeThrough(struct string_stream *stream, "
+                                "struct string *search)");
+  {
+    // log lines read through window much smaller than input, compared with cursor over whole input
+    enum { LINE_COUNT = 1 << 16 };
+    static u8 textBuffer[LINE_COUNT * 96];
+    u64 random = 0x9e3779b97f4a7c15;
+    u64 textLength = 0;
+    for (u64 index = 0; index < LINE_COUNT; index++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      u64 length = 16 + random % 80;
+      for (u64 byteIndex = 0; byteIndex < length - 1; byteIndex++)
+        textBuffer[textLength + byteIndex] = (u8)('a' + (random >> (byteIndex % 48)) % 26);
+      textBuffer[textLength + length - 1] = '\n';
+      textLength += length;
+    }
+    struct string text = StringFromBuffer(textBuffer, textLength);
+    struct string newline = StringFromLiteral("\n");
+
+    static u8 windowBuffer[64 * 1024];
+    struct string window = StringFromBuffer(windowBuffer, sizeof(windowBuffer));
+    struct string inputs[] = {
+        StringFromLiteral("string_cursor over whole input"),
+        StringFromLiteral("string_stream over 64 KiB window"),
+    };
+    for (u32 inputIndex = 0; inputIndex < ARRAY_COUNT(inputs); inputIndex++) {
+      u64 iterations = 50;
+      u64 lineCount = 0;
+
+      u64 start = NowInNanoseconds();
+      for (u64 iteration = 0; iteration < iterations; iteration++) {
+        if (inputIndex == 0) {
+          struct string_cursor cursor = StringCursorFromString(&text);
+          while (1) {
+            struct string line = StringCursorConsumeThrough(&cursor, &newline);
+            if (IsStringNull(&line))
+              break;
+            lineCount++;
+          }
+        } else {
+          struct string_cursor source = StringCursorFromString(&text);
+          struct string_stream stream = StringStreamFrom(&window, StringStreamReadFromCursor, &source);
+          while (1) {
+            struct string line = StringStreamConsumeThrough(&stream, &newline);
+            if (IsStringNull(&line))
+              break;
+            lineCount++;
+          }
+        }
+      }
+      struct duration elapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+      u64 byteCount = textLength * iterations;
+      StringBuilderAppendStringLiteral(sb, "  function: ");
+      StringBuilderAppendString(sb, function);
+      StringBuilderAppendStringLiteral(sb, "\n     input: ");
+      StringBuilderAppendString(sb, inputs + inputIndex);
+      StringBuilderAppendStringLiteral(sb, "\niterations: ");
+      StringBuilderAppendU64(sb, iterations);
+      StringBuilderAppendStringLiteral(sb, "\n   elapsed: ");
+      StringBuilderAppendDuration(sb, &elapsed);
+      StringBuilderAppendStringLiteral(sb, "\n     lines: ");
+      StringBuilderAppendU64(sb, lineCount / iterations);
+      StringBuilderAppendStringLiteral(sb, "\nthroughput: ");
+      StringBuilderAppendU64(sb, byteCount / (elapsed.ns == 0 ? 1 : elapsed.ns));
+      StringBuilderAppendStringLiteral(sb, ".");
+      StringBuilderAppendU64(sb, (byteCount * 10 / (elapsed.ns == 0 ? 1 : elapsed.ns)) % 10);
+      StringBuilderAppendStringLiteral(sb, " GB/s\n");
+      struct string message = StringBuilderFlush(sb);
+      PrintString(&message);
+    }
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
+  function = &StringFromLiteral("struct string LZCompress(memory_arena *arena, struct string *input, u32 searchDepth)");
+  {
+    // corpora like text that string_builder builds: service log, random number table as gen_pseudo_random writes,
+    // JSON records, and random bytes that do not compress
+    enum { CORPUS_LENGTH = 4 << 20 };
+    static u8 corpusBuffer[CORPUS_LENGTH];
+    static u8 lzBuffer[3 * CORPUS_LENGTH];
+    struct string corpusNames[] = {
+        StringFromLiteral("service log"),
+        StringFromLiteral("random number table"),
+        StringFromLiteral("JSON records"),
+        StringFromLiteral("random bytes"),
+    };
+    u8 hexDigits[] = "0123456789abcdef";
+    for (u32 corpusIndex = 0; corpusIndex < ARRAY_COUNT(corpusNames); corpusIndex++) {
+      u64 random = 0x9e3779b97f4a7c15;
+      u64 corpusLength = 0;
+      while (corpusLength + 128 <= CORPUS_LENGTH) {
+        random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+        u8 *text = corpusBuffer + corpusLength;
+        u64 length = 0;
+        if (corpusIndex == 0) {
+          struct string levels[] = {StringFromLiteral("INFO"), StringFromLiteral("DEBUG"), StringFromLiteral("WARN")};
+          struct string *level = levels + random % ARRAY_COUNT(levels);
+          MemoryCopy(text, level->value, level->length);
+          length = level->length;
+          MemoryCopy(text + length, " request /api/", 14);
+          length += 14;
+          u64 nameLength = 4 + (random >> 8) % 12;
+          for (u64 byteIndex = 0; byteIndex < nameLength; byteIndex++)
+            text[length++] = (u8)('a' + (random >> (byteIndex * 2)) % 26);
+          MemoryCopy(text + length, " took ", 6);
+          length += 6;
+          u64 milliseconds = (random >> 32) % 20000;
+          do {
+            text[length++] = (u8)('0' + milliseconds % 10);
+            milliseconds /= 10;
+          } while (milliseconds != 0);
+          MemoryCopy(text + length, "ms\n", 3);
+          length += 3;
+        } else if (corpusIndex == 1) {
+          // 16 per line, values are in [0, 2^18) as in tests
+          for (u32 valueIndex = 0; valueIndex < 8; valueIndex++) {
+            u32 value = (u32)(random >> (valueIndex * 4)) & 0x3ffff;
+            text[length++] = '0';
+            text[length++] = 'x';
+            for (u32 digitIndex = 0; digitIndex < 8; digitIndex++)
+              text[length++] = hexDigits[(value >> (28 - digitIndex * 4)) & 0xf];
+            MemoryCopy(text + length, ", ", 2);
+            length += 2;
+          }
+          if ((corpusLength / 96) % 2 == 1)
+            text[length - 1] = '\n';
+        } else if (corpusIndex == 2) {
+          MemoryCopy(text, "{\"id\": ", 7);
+          length = 7;
+          u64 id = random % 100000;
+          do {
+            text[length++] = (u8)('0' + id % 10);
+            id /= 10;
+          } while (id != 0);
+          struct string rest =
+              StringFromLiteral(", \"name\": \"Doe, John\", \"tags\": [\"a\", \"b\"], \"active\": true},\n");
+          MemoryCopy(text + length, rest.value, rest.length);
+          length += rest.length;
+        } else {
+          MemoryCopy(text, &random, sizeof(random));
+          length = sizeof(random);
+        }
+        corpusLength += length;
+      }
+      struct string corpus = StringFromBuffer(corpusBuffer, corpusLength);
+
+      u32 searchDepths[] = {1, LZ_SEARCH_DEPTH_DEFAULT};
+      for (u32 depthIndex = 0; depthIndex < ARRAY_COUNT(searchDepths); depthIndex++) {
+        u32 searchDepth = searchDepths[depthIndex];
+        memory_arena arena = {.block = lzBuffer, .total = sizeof(lzBuffer)};
+        u64 compressIterations = 5;
+        u64 decompressIterations = 20;
+
+        struct string compressed;
+        u64 start = NowInNanoseconds();
+        for (u64 iteration = 0; iteration < compressIterations; iteration++) {
+          arena.used = 0;
+          compressed = LZCompress(&arena, &corpus, searchDepth);
+        }
+        struct duration compressElapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+
+        u64 decompressedLength = 0;
+        start = NowInNanoseconds();
+        for (u64 iteration = 0; iteration < decompressIterations; iteration++) {
+          memory_temp temp = MemoryTempBegin(&arena);
+          struct string decompressed = LZDecompress(&arena, &compressed, corpus.length, 0);
+          decompressedLength += decompressed.length;
+          MemoryTempEnd(&temp);
+        }
+        struct duration decompressElapsed = DurationBetweenNanoseconds(start, NowInNanoseconds());
+
+        StringBuilderAppendStringLiteral(sb, "    function: ");
+        StringBuilderAppendString(sb, function);
+        StringBuilderAppendStringLiteral(sb, "\n      corpus: ");
+        StringBuilderAppendString(sb, corpusNames + corpusIndex);
+        StringBuilderAppendStringLiteral(sb, "\nsearch depth: ");
+        StringBuilderAppendU64(sb, searchDepth);
+        StringBuilderAppendStringLiteral(sb, "\n  compressed: ");
+        StringBuilderAppendU64(sb, compressed.length);
+        StringBuilderAppendStringLiteral(sb, " of ");
+        StringBuilderAppendU64(sb, corpus.length);
+        StringBuilderAppendStringLiteral(sb, " bytes, ");
+        StringBuilderAppendU64(sb, compressed.length * 100 / corpus.length);
+        StringBuilderAppendStringLiteral(sb, ".");
+        StringBuilderAppendU64(sb, compressed.length * 1000 / corpus.length % 10);
+        StringBuilderAppendStringLiteral(sb, "%\n    compress: ");
+        u64 compressedByteCount = corpus.length * compressIterations;
+        StringBuilderAppendU64(sb, compressedByteCount * 1000 / (compressElapsed.ns == 0 ? 1 : compressElapsed.ns));
+        StringBuilderAppendStringLiteral(sb, " MB/s\n  decompress: ");
+        StringBuilderAppendU64(sb, decompressedLength * 1000 / (decompressElapsed.ns == 0 ? 1 : decompressElapsed.ns));
+        StringBuilderAppendStringLiteral(sb, " MB/s\n");
+        struct string message = StringBuilderFlush(sb);
+        PrintString(&message);
+      }
+    }
+  }
+
+  StringBuilderAppendStringLiteral(sb, "----------------------------------------------------------------\n");
+
   function =
       &StringFromLiteral("struct string FormatF32Slow(struct string *stringBuffer, f32 value, u32 fractionCount)");
   {
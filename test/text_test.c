@@ -18,6 +18,8 @@
   X(TEXT_TEST_ERROR_IS_STRING_ENDS_WITH_EXPECTED_FALSE, "String must NOT end with search string")                      \
   X(TEXT_TEST_ERROR_STRIP_WHITESPACE_EXPECTED_STRING, "Stripping string from whitespace must return new string")       \
   X(TEXT_TEST_ERROR_STRIP_WHITESPACE_EXPECTED_NULL, "Stripping string from whitespace must return null")               \
+  X(TEXT_TEST_ERROR_STRIP_LEFT_RIGHT, "Stripping whitespace from one end of string must return new string")            \
+  X(TEXT_TEST_ERROR_STRIP_LINES, "Stripping every line of string must return new string")                              \
   X(TEXT_TEST_ERROR_PARSE_DURATION_EXPECTED_TRUE, "Parsing duration string must be successful")                        \
   X(TEXT_TEST_ERROR_PARSE_DURATION_EXPECTED_FALSE, "Parsing duration string must fail")                                \
   X(TEXT_TEST_ERROR_IS_DURATION_LESS_THAN_EXPECTED_TRUE, "lhs duration must be less then rhs")                         \
@@ -26,22 +28,55 @@
   X(TEXT_TEST_ERROR_IS_DURATION_GREATER_THAN_EXPECTED_FALSE, "lhs duration must NOT be greater then rhs")              \
   X(TEXT_TEST_ERROR_PARSE_U64_EXPECTED_TRUE, "Parsing unsigned value must be successful")                              \
   X(TEXT_TEST_ERROR_PARSE_U64_EXPECTED_FALSE, "Parsing unsigned value must fail")                                      \
+  X(TEXT_TEST_ERROR_PARSE_F64, "Parsing floating point value must match expected")                                     \
   X(TEXT_TEST_ERROR_PARSE_HEX_EXPECTED_TRUE, "Parsing hexadecimal value must be successful")                           \
   X(TEXT_TEST_ERROR_PARSE_HEX_EXPECTED_FALSE, "Parsing hexadecimal value must fail")                                   \
   X(TEXT_TEST_ERROR_FORMATU64_EXPECTED, "Formatting u64 value must be successful")                                     \
   X(TEXT_TEST_ERROR_FORMATF32SLOW_EXPECTED, "Formatting f32 value must be successful")                                 \
   X(TEXT_TEST_ERROR_FORMATHEX_EXPECTED, "Formatting value to hex must be successful")                                  \
+  X(TEXT_TEST_ERROR_HEX_ENCODE_EXPECTED, "Encoding bytes to hex must be successful")                                   \
+  X(TEXT_TEST_ERROR_HEX_DECODE_EXPECTED_TRUE, "Decoding hex to bytes must be successful")                              \
+  X(TEXT_TEST_ERROR_HEX_DECODE_EXPECTED_FALSE, "Decoding hex to bytes must fail")                                      \
+  X(TEXT_TEST_ERROR_BASE64_ENCODE_EXPECTED, "Encoding bytes to base64 must be successful")                             \
+  X(TEXT_TEST_ERROR_BASE64_DECODE_EXPECTED_TRUE, "Decoding base64 to bytes must be successful")                        \
+  X(TEXT_TEST_ERROR_BASE64_DECODE_EXPECTED_FALSE, "Decoding base64 to bytes must fail")                                \
   X(TEXT_TEST_ERROR_PATHGETDIRECTORY, "Extracting path's parent directory must be successful")                         \
   X(TEXT_TEST_ERROR_STRINGSPLIT_EXPECTED_TRUE, "Splitting string into parts must be successful")                       \
   X(TEXT_TEST_ERROR_STRINGSPLIT_EXPECTED_FALSE, "Splitting string into parts must be fail")                            \
+  X(TEXT_TEST_ERROR_STRING_INDEX_OF_EXPECTED_TRUE, "Search text must be found in string")                              \
+  X(TEXT_TEST_ERROR_STRING_INDEX_OF_EXPECTED_FALSE, "Search text must NOT be found in string")                         \
+  X(TEXT_TEST_ERROR_STRING_SPLIT_ITERATOR, "Splitting string into parts one by one must be successful")                \
   X(TEXT_TEST_ERROR_STRING_CUT_EXPECTED_TRUE, "Cutting string into before and after must be successful")               \
   X(TEXT_TEST_ERROR_STRING_CUT_EXPECTED_FALSE, "Cutting string into before and after must fail")                       \
   X(TEXT_TEST_ERROR_STRING_CUT_EXPECTED_BEFORE, "Cut string into before and after, but before is wrong")               \
   X(TEXT_TEST_ERROR_STRING_CUT_EXPECTED_AFTER, "Cut string into before and after, but after is wrong")                 \
+  X(TEXT_TEST_ERROR_PERCENT_DECODE, "Percent decoding must match expected")                                            \
+  X(TEXT_TEST_ERROR_URL_PARSE, "Parsing URL into components must match expected")                                      \
+  X(TEXT_TEST_ERROR_URL_QUERY_ITERATOR, "Iterating query parameters must match expected")                              \
   X(TEXT_TEST_ERROR_STRING_LENGTH_NOT_CORRECT, "String length is not correct")                                         \
   X(TEXT_TEST_ERROR_STRING_ITERATOR_LOOP_ALL, "String iterator not looping all codepoints")                            \
   X(TEXT_TEST_ERROR_STRING_ITERATOR_LOOP_OVERFLOW, "String iterator not overflowed")                                   \
-  X(TEXT_TEST_ERROR_STRING_ITERATOR_DECODE_UTF8, "String iterator not returning correct codepoint")
+  X(TEXT_TEST_ERROR_STRING_ITERATOR_DECODE_UTF8, "String iterator not returning correct codepoint")                    \
+  X(TEXT_TEST_ERROR_STRING_ITERATOR_BATCH, "String iterator not returning correct codepoints in batch")                \
+  X(TEXT_TEST_ERROR_UTF8_EXPECTED_VALID, "String must be valid UTF-8")                                                 \
+  X(TEXT_TEST_ERROR_UTF8_EXPECTED_INVALID, "String must be invalid UTF-8 at expected position")                        \
+  X(TEXT_TEST_ERROR_UTF_TRANSCODE, "Converting between UTF-8, UTF-16 and UTF-32 must be successful")                   \
+  X(TEXT_TEST_ERROR_UTF_TRANSCODE_EXPECTED_FAIL, "Converting invalid text must fail at expected position")             \
+  X(TEXT_TEST_ERROR_UTF_TRANSCODE_OUT_OF_MEMORY, "Converting must fail and leave arena untouched when full")           \
+  X(TEXT_TEST_ERROR_STRING_HASH_KNOWN_ANSWER, "String hash must match known answer")                                   \
+  X(TEXT_TEST_ERROR_STRING_HASH_LITERAL, "Compile-time string hash must match runtime hash")                           \
+  X(TEXT_TEST_ERROR_STRING_HASHER, "Hashing string in chunks must match hashing it at once")                           \
+  X(TEXT_TEST_ERROR_STRING_HASH_AVALANCHE, "Flipping any input bit must flip half of hash bits")                       \
+  X(TEXT_TEST_ERROR_STRING_HASH_COLLISION, "Different keys must not have same hash")                                   \
+  X(TEXT_TEST_ERROR_STRING_SWITCH, "String switch must map string to value of its literal")                            \
+  X(TEXT_TEST_ERROR_STRING_COMPARE, "Comparing strings must order them by bytes")                                      \
+  X(TEXT_TEST_ERROR_STRING_SORT, "Sorting strings must order them same as StringCompare")                              \
+  X(TEXT_TEST_ERROR_STRING_EDIT_DISTANCE, "Edit distance must be count of insertions, deletions and substitutions")    \
+  X(TEXT_TEST_ERROR_PATH_ITERATOR, "Iterating path must yield its components")                                         \
+  X(TEXT_TEST_ERROR_PATH_NORMALIZE, "Normalizing path must match expected")                                            \
+  X(TEXT_TEST_ERROR_PARSE_TIMESTAMP, "Parsing timestamp must match expected")                                          \
+  X(TEXT_TEST_ERROR_FORMAT_TIMESTAMP, "Formatting timestamp must match expected and parse back")                     \
+  X(TEXT_TEST_ERROR_FORMAT_DURATION, "Formatting duration must match expected")
 
 enum text_test_error {
   TEXT_TEST_ERROR_NONE = 0,
@@ -115,6 +150,31 @@ StringBuilderAppendCodepoint(string_builder *sb, u32 codepoint)
   StringBuilderAppendU32(sb, codepoint);
 }
 
+enum keyword {
+  KEYWORD_UNKNOWN,
+  KEYWORD_IF,
+  KEYWORD_ELSE,
+  KEYWORD_WHILE,
+  KEYWORD_RETURN,
+  KEYWORD_LONG,
+  KEYWORD_OPTION,
+  KEYWORD_SENTENCE,
+};
+
+#define KEYWORD_LIST(X)                                                                                                \
+  X(KEYWORD_IF, "if")                                                                                                  \
+  X(KEYWORD_ELSE, "else")                                                                                              \
+  X(KEYWORD_WHILE, "while")                                                                                            \
+  X(KEYWORD_RETURN, "return")                                                                                          \
+  X(KEYWORD_RETURN, "ret")                                                                                             \
+  X(KEYWORD_LONG, "sixteen_bytes_ok")                                                                                  \
+  X(KEYWORD_OPTION, "--a-very-long-option-name")                                                                       \
+  X(KEYWORD_OPTION, "--a-very-long-option-game")                                                                       \
+  X(KEYWORD_SENTENCE, "literal that is longer than every switch case")                                                 \
+  X(KEYWORD_SENTENCE, "literal that is longer than every switch cast")
+
+STRING_SWITCH(ParseKeyword, enum keyword, KEYWORD_LIST, KEYWORD_UNKNOWN)
+
 int
 main(void)
 {
@@ -363,6 +423,50 @@ main(void)
     }
   }
 
+  // s32 StringCompare(struct string *left, struct string *right)
+  {
+    struct test_case {
+      struct string left;
+      struct string right;
+      s32 expected;
+    } testCases[] = {
+        {.left = StringFromLiteral(""), .right = StringFromLiteral(""), .expected = 0},
+        {.left = StringNull(), .right = StringFromLiteral(""), .expected = 0},
+        {.left = StringFromLiteral(""), .right = StringFromLiteral("a"), .expected = -1},
+        {.left = StringFromLiteral("abc"), .right = StringFromLiteral("abd"), .expected = -1},
+        {.left = StringFromLiteral("abd"), .right = StringFromLiteral("abc"), .expected = 1},
+        {.left = StringFromLiteral("abc"), .right = StringFromLiteral("abc\0"), .expected = -1},
+        {.left = StringFromLiteral("B"), .right = StringFromLiteral("a"), .expected = -1},
+        {.left = StringFromLiteral("\x7f"), .right = StringFromLiteral("\x80"), .expected = -1},
+        {.left = StringFromLiteral("0123456789abcdef"), .right = StringFromLiteral("0123456789abcdef"), .expected = 0},
+        {.left = StringFromLiteral("01234567x9abcdef"), .right = StringFromLiteral("012345678"), .expected = 1},
+        {.left = StringFromLiteral("0123456\x01"), .right = StringFromLiteral("0123456\xff"), .expected = -1},
+        {.left = StringFromLiteral("\x01" "1234567"), .right = StringFromLiteral("\xff" "1234567"), .expected = -1},
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+      s32 got = StringCompare(&testCase->left, &testCase->right);
+      s32 gotReversed = StringCompare(&testCase->right, &testCase->left);
+      if ((got > 0) - (got < 0) != testCase->expected || (gotReversed > 0) - (gotReversed < 0) != -testCase->expected) {
+        errorCode = TEXT_TEST_ERROR_STRING_COMPARE;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n      left: '");
+        StringBuilderAppendPrintableString(sb, &testCase->left);
+        StringBuilderAppendStringLiteral(sb, "'\n     right: '");
+        StringBuilderAppendPrintableString(sb, &testCase->right);
+        StringBuilderAppendStringLiteral(sb, "'\n  expected: ");
+        StringBuilderAppendS64(sb, testCase->expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendS64(sb, got);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
   // b8 IsStringEqualIgnoreCase(struct string *left, struct string *right)
   {
     struct test_case {
@@ -782,6 +886,146 @@ main(void)
     PrintString(&errorMessage);
   }
 
+  // struct string StringStripLeft(struct string *string)
+  // struct string StringStripRight(struct string *string)
+  // Dependencies: IsStringEqual()
+  if (IsStringEqualOK) {
+    struct test_case {
+      struct string string;
+      struct string expectedLeft;
+      struct string expectedRight;
+    } testCases[] = {
+        {
+            .string = StringFromLiteral(" abc \n"),
+            .expectedLeft = StringFromLiteral("abc \n"),
+            .expectedRight = StringFromLiteral(" abc"),
+        },
+        {
+            .string = StringFromLiteral("abc"),
+            .expectedLeft = StringFromLiteral("abc"),
+            .expectedRight = StringFromLiteral("abc"),
+        },
+        {
+            .string = StringFromLiteral(" \t\r\n\v\f"),
+            .expectedLeft = StringNull(),
+            .expectedRight = StringNull(),
+        },
+        {
+            .string = StringNull(),
+            .expectedLeft = StringNull(),
+            .expectedRight = StringNull(),
+        },
+        {
+            .string = StringFromLiteral("                                                  indented 50 spaces"),
+            .expectedLeft = StringFromLiteral("indented 50 spaces"),
+            .expectedRight = StringFromLiteral("                                                  indented 50 spaces"),
+        },
+        {
+            .string = StringFromLiteral("\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\tx"
+                                        "\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n"),
+            .expectedLeft = StringFromLiteral("x\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n\r\n"),
+            .expectedRight = StringFromLiteral("\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\tx"),
+        },
+        {
+            // bytes around whitespace range
+            .string = StringFromLiteral("\x08\x0e\x1f!"),
+            .expectedLeft = StringFromLiteral("\x08\x0e\x1f!"),
+            .expectedRight = StringFromLiteral("\x08\x0e\x1f!"),
+        },
+        {
+            .string = StringFromLiteral("                                                                \xa0"),
+            .expectedLeft = StringFromLiteral("\xa0"),
+            .expectedRight = StringFromLiteral("                                                                \xa0"),
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      struct string *string = &testCase->string;
+      struct string gotLeft = StringStripLeft(string);
+      struct string gotRight = StringStripRight(string);
+      if (!IsStringEqual(&gotLeft, &testCase->expectedLeft) || !IsStringEqual(&gotRight, &testCase->expectedRight)) {
+        errorCode = TEXT_TEST_ERROR_STRIP_LEFT_RIGHT;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n          string: ");
+        StringBuilderAppendPrintableString(sb, string);
+        StringBuilderAppendStringLiteral(sb, "\n   expected left: ");
+        StringBuilderAppendPrintableString(sb, &testCase->expectedLeft);
+        StringBuilderAppendStringLiteral(sb, "\n        got left: ");
+        StringBuilderAppendPrintableString(sb, &gotLeft);
+        StringBuilderAppendStringLiteral(sb, "\n  expected right: ");
+        StringBuilderAppendPrintableString(sb, &testCase->expectedRight);
+        StringBuilderAppendStringLiteral(sb, "\n       got right: ");
+        StringBuilderAppendPrintableString(sb, &gotRight);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // struct string StringStripLines(struct string *string)
+  // Dependencies: IsStringEqual()
+  if (IsStringEqualOK) {
+    struct test_case {
+      struct string string;
+      struct string expected;
+    } testCases[] = {
+        {
+            .string = StringFromLiteral("  key = value  \r\n\t[section]\r\n\r\n   \n last"),
+            .expected = StringFromLiteral("key = value\n[section]\n\n\nlast"),
+        },
+        {
+            .string = StringFromLiteral("a,b,c\n  1,2,3  \n"),
+            .expected = StringFromLiteral("a,b,c\n1,2,3\n"),
+        },
+        {
+            .string = StringFromLiteral("no newline"),
+            .expected = StringFromLiteral("no newline"),
+        },
+        {
+            .string = StringFromLiteral("   "),
+            .expected = StringNull(),
+        },
+        {
+            .string = StringNull(),
+            .expected = StringNull(),
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      // strips in place
+      u8 buffer[64];
+      struct string string = testCase->string;
+      if (string.value) {
+        debug_assert(string.length <= ARRAY_COUNT(buffer));
+        MemoryCopy(buffer, string.value, string.length);
+        string.value = buffer;
+      }
+
+      struct string *expected = &testCase->expected;
+      struct string got = StringStripLines(&string);
+      if (!IsStringEqual(&got, expected)) {
+        errorCode = TEXT_TEST_ERROR_STRIP_LINES;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n    string: ");
+        StringBuilderAppendPrintableString(sb, &testCase->string);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendPrintableString(sb, expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendPrintableString(sb, &got);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
   // ParseDuration(struct string *string, struct duration *duration)
   {
     struct test_case {
@@ -1083,6 +1327,138 @@ main(void)
     }
   }
 
+  // b8 ParseF64(struct string *string, f64 *value)
+  {
+    f64 infinity = F64FromBits((u64)0x7ff << 52);
+    f64 minSubnormal = F64FromBits(1);
+    f64 maxSubnormal = F64FromBits(((u64)1 << 52) - 1);
+    f64 oneNext = F64FromBits(F64ToBits(1.0) + 1);
+
+    struct test_case {
+      struct string input;
+      b8 expectedResult;
+      f64 expectedValue;
+    } testCases[] = {
+        {.input = StringFromLiteral("0"), .expectedResult = 1, .expectedValue = 0.0},
+        {.input = StringFromLiteral("-0.5"), .expectedResult = 1, .expectedValue = -0.5},
+        {.input = StringFromLiteral("+42"), .expectedResult = 1, .expectedValue = 42.0},
+        {.input = StringFromLiteral("3.14159"), .expectedResult = 1, .expectedValue = 3.14159},
+        {.input = StringFromLiteral("0.000123"), .expectedResult = 1, .expectedValue = 0.000123},
+        {.input = StringFromLiteral("3."), .expectedResult = 1, .expectedValue = 3.0},
+        {.input = StringFromLiteral(".5"), .expectedResult = 1, .expectedValue = 0.5},
+        {.input = StringFromLiteral("1E10"), .expectedResult = 1, .expectedValue = 1e10},
+        {.input = StringFromLiteral("-12.5e-3"), .expectedResult = 1, .expectedValue = -12.5e-3},
+        {.input = StringFromLiteral("0.1"), .expectedResult = 1, .expectedValue = 0.1},
+        {.input = StringFromLiteral("1e23"), .expectedResult = 1, .expectedValue = 1e23},
+        {
+            .input = StringFromLiteral("123456789012345678901234567890"),
+            .expectedResult = 1,
+            .expectedValue = 1.2345678901234568e29,
+        },
+        // shortest round trip output, off by ulps when scaled by powers of 10
+        {.input = StringFromLiteral("1.7976931348623157e308"), .expectedResult = 1, .expectedValue = F64_MAX},
+        {
+            .input = StringFromLiteral("8.988465674311579e307"),
+            .expectedResult = 1,
+            .expectedValue = 8.988465674311579e307,
+        },
+        {.input = StringFromLiteral("12858.599957907945"), .expectedResult = 1, .expectedValue = 12858.599957907945},
+        {.input = StringFromLiteral("412772.48465837748"), .expectedResult = 1, .expectedValue = 412772.48465837748},
+        {
+            .input = StringFromLiteral("1.6852896567733752e+209"),
+            .expectedResult = 1,
+            .expectedValue = 1.6852896567733752e+209,
+        },
+        {
+            .input = StringFromLiteral("1.4184831845242508e-136"),
+            .expectedResult = 1,
+            .expectedValue = 1.4184831845242508e-136,
+        },
+        {
+            .input = StringFromLiteral("-3.2899256191212319e-308"),
+            .expectedResult = 1,
+            .expectedValue = -3.2899256191212319e-308,
+        },
+        {
+            .input = StringFromLiteral("-1.6646528343554509e-220"),
+            .expectedResult = 1,
+            .expectedValue = -1.6646528343554509e-220,
+        },
+        // largest and smallest normal, subnormals
+        {.input = StringFromLiteral("2.2250738585072014e-308"), .expectedResult = 1, .expectedValue = F64_MIN},
+        {.input = StringFromLiteral("2.2250738585072011e-308"), .expectedResult = 1, .expectedValue = maxSubnormal},
+        {.input = StringFromLiteral("2.2250738585072012e-308"), .expectedResult = 1, .expectedValue = F64_MIN},
+        {.input = StringFromLiteral("4.9406564584124654e-324"), .expectedResult = 1, .expectedValue = minSubnormal},
+        {.input = StringFromLiteral("5e-324"), .expectedResult = 1, .expectedValue = minSubnormal},
+        {.input = StringFromLiteral("1e-320"), .expectedResult = 1, .expectedValue = 1e-320},
+        // half of smallest subnormal is 2.4703282292062327208...e-324
+        {.input = StringFromLiteral("2.4703282292062327e-324"), .expectedResult = 1, .expectedValue = 0.0},
+        {.input = StringFromLiteral("2.4703282292062328e-324"), .expectedResult = 1, .expectedValue = minSubnormal},
+        {.input = StringFromLiteral("1e-400"), .expectedResult = 1, .expectedValue = 0.0},
+        // half ulp above F64_MAX rounds to infinity
+        {.input = StringFromLiteral("1.7976931348623158e308"), .expectedResult = 1, .expectedValue = F64_MAX},
+        {.input = StringFromLiteral("1.7976931348623159e308"), .expectedResult = 1, .expectedValue = infinity},
+        {.input = StringFromLiteral("1e400"), .expectedResult = 1, .expectedValue = infinity},
+        // halfway between doubles, ties to even
+        {.input = StringFromLiteral("9007199254740993"), .expectedResult = 1, .expectedValue = 9007199254740992.0},
+        {.input = StringFromLiteral("9007199254740995"), .expectedResult = 1, .expectedValue = 9007199254740996.0},
+        {
+            .input = StringFromLiteral("9007199254740993.000000000000000000001"),
+            .expectedResult = 1,
+            .expectedValue = 9007199254740994.0,
+        },
+        {
+            .input = StringFromLiteral("1.00000000000000011102230246251565404236316680908203125"),
+            .expectedResult = 1,
+            .expectedValue = 1.0,
+        },
+        {
+            .input = StringFromLiteral("1.00000000000000011102230246251565404236316680908203126"),
+            .expectedResult = 1,
+            .expectedValue = oneNext,
+        },
+        {
+            .input = StringFromLiteral("1.00000000000000011102230246251565404236316680908203124"),
+            .expectedResult = 1,
+            .expectedValue = 1.0,
+        },
+        {.input = StringFromLiteral("")},
+        {.input = StringFromLiteral("-")},
+        {.input = StringFromLiteral(".")},
+        {.input = StringFromLiteral("e5")},
+        {.input = StringFromLiteral("1e")},
+        {.input = StringFromLiteral("1e+")},
+        {.input = StringFromLiteral("1.2.3")},
+        {.input = StringFromLiteral("12a")},
+        {.input = StringFromLiteral(" 1")},
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      f64 value = 0;
+      b8 result = ParseF64(&testCase->input, &value);
+      if (result != testCase->expectedResult || (result && F64ToBits(value) != F64ToBits(testCase->expectedValue))) {
+        errorCode = TEXT_TEST_ERROR_PARSE_F64;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n     input: ");
+        StringBuilderAppendPrintableString(sb, &testCase->input);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendBool(sb, testCase->expectedResult);
+        StringBuilderAppendStringLiteral(sb, " 0x");
+        StringBuilderAppendHex(sb, F64ToBits(testCase->expectedValue));
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendBool(sb, result);
+        StringBuilderAppendStringLiteral(sb, " 0x");
+        StringBuilderAppendHex(sb, F64ToBits(value));
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
   // b8 ParseHex(struct string *string, u64 *value)
   {
     struct test_case {
@@ -1404,62 +1780,49 @@ main(void)
     }
   }
 
-  // struct string PathGetDirectory(struct string *path)
+  // struct string HexEncode(struct string *buffer, struct string *input)
   // Dependencies: IsStringEqual()
   if (IsStringEqualOK) {
     struct test_case {
       struct string input;
       struct string expected;
     } testCases[] = {
-#if IS_PLATFORM_WINDOWS
         {
-            .input = StringFromLiteral("C:\\Users\\e2dk4r"),
-            .expected = StringFromLiteral("C:\\Users"),
+            .input = StringFromLiteral(""),
+            .expected = StringFromLiteral(""),
         },
         {
-            .input = StringFromLiteral("C:\\Windows\\system32\\notepad.exe"),
-            .expected = StringFromLiteral("C:\\Windows\\system32"),
+            .input = StringFromLiteral("\x00"),
+            .expected = StringFromLiteral("00"),
         },
-#else
         {
-            .input = StringFromLiteral("/usr/bin/ls"),
-            .expected = StringFromLiteral("/usr/bin"),
+            .input = StringFromLiteral("\xde\xad\xbe\xef"),
+            .expected = StringFromLiteral("deadbeef"),
         },
         {
-            .input = StringFromLiteral("/usr"),
-            .expected = StringFromLiteral("/"),
+            .input = StringFromLiteral("The quick brown fox jumps over the lazy dog\xff"),
+            .expected = StringFromLiteral("54686520717569636b2062726f776e20666f78206a756d7073206f76657220746865206c617a79"
+                                          "20646f67ff"),
         },
-#endif
         {
             .input = StringNull(),
             .expected = StringNull(),
         },
-        {
-            .input = StringFromLiteral(""),
-            .expected = StringNull(),
-        },
-        {
-            .input = StringFromLiteral(" "),
-            .expected = StringNull(),
-        },
-        {
-            .input = StringFromLiteral("no directory"),
-            .expected = StringNull(),
-        },
     };
 
     for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
       struct test_case *testCase = testCases + testCaseIndex;
 
+      u8 buf[128];
+      struct string stringBuffer = {.value = buf, .length = sizeof(buf)};
+
       struct string *input = &testCase->input;
       struct string *expected = &testCase->expected;
-      struct string value = PathGetDirectory(input);
+      struct string value = HexEncode(&stringBuffer, input);
       if (!IsStringEqual(&value, expected)) {
-        errorCode = TEXT_TEST_ERROR_PATHGETDIRECTORY;
+        errorCode = TEXT_TEST_ERROR_HEX_ENCODE_EXPECTED;
 
         StringBuilderAppendErrorMessage(sb, errorCode);
-        StringBuilderAppendStringLiteral(sb, "\n  input:    ");
-        StringBuilderAppendPrintableString(sb, input);
         StringBuilderAppendStringLiteral(sb, "\n  expected: ");
         StringBuilderAppendPrintableString(sb, expected);
         StringBuilderAppendStringLiteral(sb, "\n       got: ");
@@ -1469,624 +1832,3412 @@ main(void)
         PrintString(&errorMessage);
       }
     }
+
+    // buffer too small
+    {
+      u8 buf[7];
+      struct string stringBuffer = {.value = buf, .length = sizeof(buf)};
+      struct string value = HexEncode(&stringBuffer, &StringFromLiteral("\xde\xad\xbe\xef"));
+      if (!IsStringNull(&value)) {
+        errorCode = TEXT_TEST_ERROR_HEX_ENCODE_EXPECTED;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  buffer is too small");
+        StringBuilderAppendStringLiteral(sb, "\n  expected: (NULL)");
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendPrintableString(sb, &value);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
   }
 
-  // b8 StringSplit(struct string *string, struct string *separator, u64 *splitCount, struct string *splits)
-  // Dependencies: IsStringEqual()
+  // struct string HexDecode(struct string *buffer, struct string *input, u64 *errorIndex)
+  // Dependencies: IsStringEqual(), HexEncode()
   if (IsStringEqualOK) {
-    __cleanup_memory_temp__ memory_temp tempMemory = MemoryTempBegin(&stackMemory);
-
     struct test_case {
       struct string input;
-      struct string separator;
       struct {
-        b8 value;
-        u64 splitCount;
-        struct string *splits;
+        b8 result;
+        struct string value;
+        u64 errorIndex;
       } expected;
     } testCases[] = {
         {
-            .input = StringFromLiteral("1 2 3"),
-            .separator = StringFromLiteral(" "),
-            .expected =
-                {
-                    .value = 1,
-                    .splitCount = 3,
-                    .splits =
-                        (struct string[]){
-                            StringFromLiteral("1"),
-                            StringFromLiteral("2"),
-                            StringFromLiteral("3"),
-                        },
-                },
+            .input = StringFromLiteral(""),
+            .expected = {.result = 1, .value = StringFromLiteral("")},
         },
         {
-            .input = StringFromLiteral("1xx2xx3"),
-            .separator = StringFromLiteral("xx"),
-            .expected =
-                {
-                    .value = 1,
-                    .splitCount = 3,
-                    .splits =
-                        (struct string[]){
-                            StringFromLiteral("1"),
-                            StringFromLiteral("2"),
-                            StringFromLiteral("3"),
-                        },
-                },
+            .input = StringFromLiteral("DeadBeef"),
+            .expected = {.result = 1, .value = StringFromLiteral("\xde\xad\xbe\xef")},
         },
         {
-            .input = StringFromLiteral("1xoxo2xo3"),
-            .separator = StringFromLiteral("xo"),
-            .expected =
-                {
-                    .value = 1,
-                    .splitCount = 4,
-                    .splits =
-                        (struct string[]){
-                            StringFromLiteral("1"),
-                            StringNull(),
-                            StringFromLiteral("2"),
-                            StringFromLiteral("3"),
-                        },
-                },
+            .input = StringFromLiteral("54686520717569636b2062726f776e20666f78206a756d7073206f76657220746865206c617a7920"
+                                       "646f67FF"),
+            .expected = {.result = 1, .value = StringFromLiteral("The quick brown fox jumps over the lazy dog\xff")},
         },
         {
-            .input = StringFromLiteral("1xo2xo3xo"),
-            .separator = StringFromLiteral("xo"),
-            .expected =
-                {
-                    .value = 1,
-                    .splitCount = 4,
-                    .splits =
-                        (struct string[]){
-                            StringFromLiteral("1"),
-                            StringFromLiteral("2"),
-                            StringFromLiteral("3"),
-                            StringNull(),
-                        },
-                },
+            .input = StringFromLiteral("0g"),
+            .expected = {.result = 0, .errorIndex = 1},
         },
         {
-            .input = StringFromLiteral("Lorem ipsum dolor sit amet, consectetur adipiscing elit"),
-            .separator = StringFromLiteral(" "),
-            .expected =
-                {
-                    .value = 1,
-                    .splitCount = 8,
-                    .splits =
-                        (struct string[]){
-                            StringFromLiteral("Lorem"),
-                            StringFromLiteral("ipsum"),
-                            StringFromLiteral("dolor"),
-                            StringFromLiteral("sit"),
-                            StringFromLiteral("amet,"),
-                            StringFromLiteral("consectetur"),
-                            StringFromLiteral("adipiscing"),
-                            StringFromLiteral("elit"),
-                        },
-                },
+            .input = StringFromLiteral("g0"),
+            .expected = {.result = 0, .errorIndex = 0},
         },
         {
-            .input = StringFromLiteral("Lorem ipsum dolor sit amet, consectetur adipiscing elit"),
-            .separator = StringFromLiteral("no separator"),
-            .expected =
-                {
-                    .value = 0,
-                },
+            .input = StringFromLiteral("abc"),
+            .expected = {.result = 0, .errorIndex = 3},
         },
         {
-            .input = StringFromLiteral("Lorem"),
-            .separator = StringFromLiteral("no separator"),
-            .expected =
-                {
-                    .value = 0,
-                },
+            .input = StringFromLiteral("abx"),
+            .expected = {.result = 0, .errorIndex = 2},
+        },
+        {
+            .input = StringFromLiteral("00112233445566778899aabbccddeeff00112233445566778899aabbccddeeff"
+                                       "0011223344556677:899aabbccddeeff"),
+            .expected = {.result = 0, .errorIndex = 80},
+        },
+        {
+            .input = StringFromLiteral("0x00"),
+            .expected = {.result = 0, .errorIndex = 1},
         },
     };
 
     for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
       struct test_case *testCase = testCases + testCaseIndex;
 
-      struct string *input = &testCase->input;
-      struct string *separator = &testCase->separator;
+      u8 buf[128];
+      struct string stringBuffer = {.value = buf, .length = sizeof(buf)};
 
-      u64 expectedSplitCount = testCase->expected.splitCount;
-      b8 expected = testCase->expected.value;
-      u64 splitCount = !expectedSplitCount;
-      b8 value = StringSplit(input, separator, &splitCount, 0);
-      if (value != expected || (expected && splitCount != expectedSplitCount)) {
-        errorCode = expected ? TEXT_TEST_ERROR_STRINGSPLIT_EXPECTED_TRUE : TEXT_TEST_ERROR_STRINGSPLIT_EXPECTED_FALSE;
+      struct string *input = &testCase->input;
+      u64 errorIndex = 0;
+      struct string value = HexDecode(&stringBuffer, input, &errorIndex);
+      b8 result = !IsStringNull(&value);
+      if (result != testCase->expected.result || (result && !IsStringEqual(&value, &testCase->expected.value)) ||
+          (!result && errorIndex != testCase->expected.errorIndex)) {
+        errorCode =
+            testCase->expected.result ? TEXT_TEST_ERROR_HEX_DECODE_EXPECTED_TRUE : TEXT_TEST_ERROR_HEX_DECODE_EXPECTED_FALSE;
 
         StringBuilderAppendErrorMessage(sb, errorCode);
-        StringBuilderAppendStringLiteral(sb, "\n      input: '");
-        StringBuilderAppendString(sb, input);
-        StringBuilderAppendStringLiteral(sb, "'");
-        StringBuilderAppendStringLiteral(sb, "\n  separator: '");
-        StringBuilderAppendString(sb, separator);
-        StringBuilderAppendStringLiteral(sb, "'");
-        if (value != expected) {
-          StringBuilderAppendStringLiteral(sb, "\n   expected: ");
-          StringBuilderAppendBool(sb, expected);
-          StringBuilderAppendStringLiteral(sb, "\n        got: ");
-          StringBuilderAppendBool(sb, value);
+        StringBuilderAppendStringLiteral(sb, "\n     input: ");
+        StringBuilderAppendPrintableString(sb, input);
+        if (result != testCase->expected.result) {
+          StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+          StringBuilderAppendBool(sb, testCase->expected.result);
+          StringBuilderAppendStringLiteral(sb, "\n       got: ");
+          StringBuilderAppendBool(sb, result);
+        } else if (result) {
+          StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+          StringBuilderAppendHexEncoded(sb, &testCase->expected.value);
+          StringBuilderAppendStringLiteral(sb, "\n       got: ");
+          StringBuilderAppendHexEncoded(sb, &value);
         } else {
-          StringBuilderAppendStringLiteral(sb, "\n  expected split count: ");
-          StringBuilderAppendU64(sb, expectedSplitCount);
+          StringBuilderAppendStringLiteral(sb, "\n  expected error index: ");
+          StringBuilderAppendU64(sb, testCase->expected.errorIndex);
           StringBuilderAppendStringLiteral(sb, "\n                   got: ");
-          StringBuilderAppendU64(sb, splitCount);
+          StringBuilderAppendU64(sb, errorIndex);
         }
         StringBuilderAppendStringLiteral(sb, "\n");
         struct string errorMessage = StringBuilderFlush(sb);
         PrintString(&errorMessage);
-      } else if (expected) {
-        struct string *expectedSplits = testCase->expected.splits;
-        struct string *splits = MemoryArenaPush(tempMemory.arena, sizeof(*splits) * splitCount);
-        StringSplit(input, separator, &splitCount, splits);
+      }
+    }
 
-        u32 splitFailCount = 0;
+    // round trip all lengths that cross vector widths, then make every character invalid one by one
+    u8 bytes[160];
+    for (u32 index = 0; index < ARRAY_COUNT(bytes); index++)
+      bytes[index] = (u8)(index * 167 + 13);
 
-        for (u32 splitIndex = 0; splitIndex < splitCount; splitIndex++) {
-          struct string *expectedSplit = expectedSplits + splitIndex;
-          struct string *split = splits + splitIndex;
-          if (!IsStringEqual(split, expectedSplit)) {
-            errorCode =
-                expected ? TEXT_TEST_ERROR_STRINGSPLIT_EXPECTED_TRUE : TEXT_TEST_ERROR_STRINGSPLIT_EXPECTED_FALSE;
+    for (u64 length = 0; length <= ARRAY_COUNT(bytes); length++) {
+      struct string input = StringFromBuffer(bytes, length);
+      u8 hexBuffer[2 * ARRAY_COUNT(bytes)];
+      struct string hexBufferString = StringFromBuffer(hexBuffer, ARRAY_COUNT(hexBuffer));
+      struct string hex = HexEncode(&hexBufferString, &input);
 
-            if (splitFailCount == 0) {
-              StringBuilderAppendErrorMessage(sb, errorCode);
-              StringBuilderAppendStringLiteral(sb, "\n        input: '");
-              StringBuilderAppendString(sb, input);
-              StringBuilderAppendStringLiteral(sb, "'");
-              StringBuilderAppendStringLiteral(sb, "\n    separator: '");
-              StringBuilderAppendString(sb, separator);
-              StringBuilderAppendStringLiteral(sb, "'");
-              StringBuilderAppendStringLiteral(sb, "\n  split count: ");
-              StringBuilderAppendU64(sb, splitCount);
-            }
+      u8 decodedBuffer[ARRAY_COUNT(bytes)];
+      struct string decodedBufferString = StringFromBuffer(decodedBuffer, ARRAY_COUNT(decodedBuffer));
+      struct string decoded = HexDecode(&decodedBufferString, &hex, 0);
+      if (hex.length != 2 * length || !IsStringEqual(&decoded, &input)) {
+        errorCode = TEXT_TEST_ERROR_HEX_DECODE_EXPECTED_TRUE;
 
-            StringBuilderAppendStringLiteral(sb, "\n  index ");
-            StringBuilderAppendU64(sb, splitIndex);
-            StringBuilderAppendStringLiteral(sb, " is wrong");
-            StringBuilderAppendStringLiteral(sb, "\n     expected: ");
-            StringBuilderAppendPrintableString(sb, expectedSplit);
-            StringBuilderAppendStringLiteral(sb, "\n          got: ");
-            StringBuilderAppendPrintableString(sb, split);
-            StringBuilderAppendStringLiteral(sb, "\n");
-            struct string errorMessage = StringBuilderFlush(sb);
-            PrintString(&errorMessage);
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  round trip failed at length: ");
+        StringBuilderAppendU64(sb, length);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+        break;
+      }
 
-            splitFailCount++;
-          }
+      for (u64 invalidIndex = 0; invalidIndex < hex.length; invalidIndex++) {
+        u8 original = hex.value[invalidIndex];
+        hex.value[invalidIndex] = (invalidIndex & 1) ? 'G' : '/';
+
+        u64 errorIndex = 0;
+        decoded = HexDecode(&decodedBufferString, &hex, &errorIndex);
+        hex.value[invalidIndex] = original;
+        if (!IsStringNull(&decoded) || errorIndex != invalidIndex) {
+          errorCode = TEXT_TEST_ERROR_HEX_DECODE_EXPECTED_FALSE;
+
+          StringBuilderAppendErrorMessage(sb, errorCode);
+          StringBuilderAppendStringLiteral(sb, "\n     input length: ");
+          StringBuilderAppendU64(sb, hex.length);
+          StringBuilderAppendStringLiteral(sb, "\n  expected error index: ");
+          StringBuilderAppendU64(sb, invalidIndex);
+          StringBuilderAppendStringLiteral(sb, "\n                   got: ");
+          StringBuilderAppendU64(sb, errorIndex);
+          StringBuilderAppendStringLiteral(sb, "\n");
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+          break;
         }
       }
     }
   }
 
-  // string_cut StringCut(struct string *string, struct string *separator)
+  // struct string Base64Encode(struct string *buffer, struct string *input, enum base64_alphabet alphabet)
+  // Dependencies: IsStringEqual()
   if (IsStringEqualOK) {
-    __cleanup_memory_temp__ memory_temp tempMemory = MemoryTempBegin(&stackMemory);
-
-    struct text_case_expected {
-      b8 ok;
-      struct string before;
-      struct string after;
-    };
     struct test_case {
       struct string input;
-      struct string separator;
-      struct text_case_expected expected;
+      enum base64_alphabet alphabet;
+      struct string expected;
     } testCases[] = {
+        // RFC 4648 section 10
+        {.input = StringFromLiteral(""), .alphabet = BASE64_ALPHABET_STANDARD, .expected = StringFromLiteral("")},
+        {.input = StringFromLiteral("f"), .alphabet = BASE64_ALPHABET_STANDARD, .expected = StringFromLiteral("Zg==")},
+        {.input = StringFromLiteral("fo"), .alphabet = BASE64_ALPHABET_STANDARD, .expected = StringFromLiteral("Zm8=")},
         {
-            .input = StringFromLiteral("one two three"),
-            .separator = StringFromLiteral(" "),
-            .expected =
-                {
-                    .ok = 1,
-                    .before = StringFromLiteral("one"),
-                    .after = StringFromLiteral("two three"),
-                },
-        },
-        {
-            .input = StringFromLiteral("apple...banana...watermelon"),
-            .separator = StringFromLiteral("..."),
-            .expected =
-                {
-                    .ok = 1,
-                    .before = StringFromLiteral("apple"),
-                    .after = StringFromLiteral("banana...watermelon"),
-                },
-        },
-        {
-            .input = StringFromLiteral("Arthropoda,"),
-            .separator = StringFromLiteral(","),
-            .expected =
-                {
-                    .ok = 1,
-                    .before = StringFromLiteral("Arthropoda"),
-                    .after = StringFromLiteral(""),
-                },
-        },
-        {
-            .input = StringNull(),
-            .separator = StringNull(),
-            .expected = {.ok = 0},
+            .input = StringFromLiteral("foo"),
+            .alphabet = BASE64_ALPHABET_STANDARD,
+            .expected = StringFromLiteral("Zm9v"),
         },
         {
-            .input = StringNull(),
-            .separator = StringFromLiteral(","),
-            .expected = {.ok = 0},
+            .input = StringFromLiteral("foobar"),
+            .alphabet = BASE64_ALPHABET_STANDARD,
+            .expected = StringFromLiteral("Zm9vYmFy"),
         },
+        {.input = StringFromLiteral("f"), .alphabet = BASE64_ALPHABET_URL, .expected = StringFromLiteral("Zg")},
+        {.input = StringFromLiteral("fo"), .alphabet = BASE64_ALPHABET_URL, .expected = StringFromLiteral("Zm8")},
         {
-            .input = StringFromLiteral(""),
-            .separator = StringNull(),
-            .expected = {.ok = 0},
+            .input = StringFromLiteral("\xfb\xff\xbf\xfb\xff\xbf"),
+            .alphabet = BASE64_ALPHABET_STANDARD,
+            .expected = StringFromLiteral("+/+/+/+/"),
         },
         {
-            .input = StringFromLiteral(""),
-            .separator = StringFromLiteral(","),
-            .expected = {.ok = 0},
+            .input = StringFromLiteral("\xfb\xff\xbf\xfb\xff\xbf"),
+            .alphabet = BASE64_ALPHABET_URL,
+            .expected = StringFromLiteral("-_-_-_-_"),
         },
         {
-            .input = StringFromLiteral("No separator found"),
-            .separator = StringFromLiteral(","),
-            .expected = {.ok = 0},
+            .input = StringFromLiteral("The quick brown fox jumps over the lazy dog\xfb\xff"),
+            .alphabet = BASE64_ALPHABET_STANDARD,
+            .expected = StringFromLiteral("VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZ/v/"),
         },
     };
 
     for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
       struct test_case *testCase = testCases + testCaseIndex;
 
-      struct string *input = &testCase->input;
-      struct string *separator = &testCase->separator;
-
-      struct text_case_expected expected = testCase->expected;
-      struct string_cut got = StringCut(input, separator);
+      u8 buf[128];
+      struct string stringBuffer = {.value = buf, .length = sizeof(buf)};
 
-      if (got.ok != expected.ok) {
-        errorCode = expected.ok ? TEXT_TEST_ERROR_STRING_CUT_EXPECTED_TRUE : TEXT_TEST_ERROR_STRING_CUT_EXPECTED_FALSE;
+      struct string *input = &testCase->input;
+      struct string value = Base64Encode(&stringBuffer, input, testCase->alphabet);
+      if (IsStringNull(&value) || !IsStringEqual(&value, &testCase->expected) ||
+          value.length != Base64EncodedLength(input->length, testCase->alphabet)) {
+        errorCode = TEXT_TEST_ERROR_BASE64_ENCODE_EXPECTED;
 
         StringBuilderAppendErrorMessage(sb, errorCode);
-        StringBuilderAppendStringLiteral(sb, "\n     input: '");
-        StringBuilderAppendString(sb, input);
-        StringBuilderAppendStringLiteral(sb, "'");
-        StringBuilderAppendStringLiteral(sb, "\n separator: '");
-        StringBuilderAppendString(sb, separator);
-        StringBuilderAppendStringLiteral(sb, "'");
+        StringBuilderAppendStringLiteral(sb, "\n     input: ");
+        StringBuilderAppendPrintableString(sb, input);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendString(sb, &testCase->expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendString(sb, &value);
         StringBuilderAppendStringLiteral(sb, "\n");
         struct string errorMessage = StringBuilderFlush(sb);
         PrintString(&errorMessage);
-      } else {
-
-        if (!IsStringEqual(&got.before, &expected.before)) {
-          errorCode = TEXT_TEST_ERROR_STRING_CUT_EXPECTED_BEFORE;
-
-          StringBuilderAppendErrorMessage(sb, errorCode);
-          StringBuilderAppendStringLiteral(sb, "\n     input: '");
-          StringBuilderAppendString(sb, input);
-          StringBuilderAppendStringLiteral(sb, "'");
-          StringBuilderAppendStringLiteral(sb, "\n separator: '");
-          StringBuilderAppendString(sb, separator);
-          StringBuilderAppendStringLiteral(sb, "'");
-          StringBuilderAppendStringLiteral(sb, "\n  expected: '");
-          StringBuilderAppendString(sb, &expected.before);
-          StringBuilderAppendStringLiteral(sb, "'");
-          StringBuilderAppendStringLiteral(sb, "\n       got: '");
-          StringBuilderAppendString(sb, &got.before);
-          StringBuilderAppendStringLiteral(sb, "'");
-          StringBuilderAppendStringLiteral(sb, "\n");
-          struct string errorMessage = StringBuilderFlush(sb);
-          PrintString(&errorMessage);
-        }
-
-        if (!IsStringEqual(&got.after, &expected.after)) {
-          errorCode = TEXT_TEST_ERROR_STRING_CUT_EXPECTED_AFTER;
-
-          StringBuilderAppendErrorMessage(sb, errorCode);
-          StringBuilderAppendStringLiteral(sb, "\n     input: '");
-          StringBuilderAppendString(sb, input);
-          StringBuilderAppendStringLiteral(sb, "'");
-          StringBuilderAppendStringLiteral(sb, "\n separator: '");
-          StringBuilderAppendString(sb, separator);
-          StringBuilderAppendStringLiteral(sb, "'");
-          StringBuilderAppendStringLiteral(sb, "\n  expected: '");
-          StringBuilderAppendString(sb, &expected.after);
-          StringBuilderAppendStringLiteral(sb, "'");
-          StringBuilderAppendStringLiteral(sb, "\n       got: '");
-          StringBuilderAppendString(sb, &got.after);
-          StringBuilderAppendStringLiteral(sb, "'");
-          StringBuilderAppendStringLiteral(sb, "\n");
-          struct string errorMessage = StringBuilderFlush(sb);
-          PrintString(&errorMessage);
-        }
       }
     }
   }
 
-  // u64 StringLength(struct string *string)
-  {
+  // struct string Base64Decode(struct string *buffer, struct string *input, enum base64_alphabet alphabet,
+  //                            u64 *errorIndex)
+  // Dependencies: IsStringEqual(), Base64Encode()
+  if (IsStringEqualOK) {
     struct test_case {
-      struct string language;
       struct string input;
-      u64 expected;
+      enum base64_alphabet alphabet;
+      struct {
+        b8 result;
+        struct string value;
+        u64 errorIndex;
+      } expected;
     } testCases[] = {
         {
-            .language = StringFromLiteral("Greek"),
-            .input = StringFromLiteral("Σὲ γνωρίζω ἀπὸ τὴν κόψη"),
-            .expected = 23,
+            .input = StringFromLiteral(""),
+            .alphabet = BASE64_ALPHABET_STANDARD,
+            .expected = {.result = 1, .value = StringFromLiteral("")},
         },
         {
-            .language = StringFromLiteral("Russian"),
-            .input = StringFromLiteral("Зарегистрируйтесь сейчас на Десятую Международную Конференцию по Unicode, "
-                                       "которая состоится 10-12 марта 1997 года в Майнце в Германии."),
-            .expected = 134,
+            .input = StringFromLiteral("Zm9vYg=="),
+            .alphabet = BASE64_ALPHABET_STANDARD,
+            .expected = {.result = 1, .value = StringFromLiteral("foob")},
         },
         {
-            .language = StringFromLiteral("Braille"),
-            .input = StringFromLiteral("⡌⠁⠧⠑ ⠼⠁⠒  ⡍⠜⠇⠑⠹⠰⠎ ⡣⠕⠌"),
-            .expected = 21,
+            .input = StringFromLiteral("Zm9vYmE="),
+            .alphabet = BASE64_ALPHABET_STANDARD,
+            .expected = {.result = 1, .value = StringFromLiteral("fooba")},
         },
         {
-            .language = StringFromLiteral("Arabic"),
-            .input = StringFromLiteral("مرحبا"),
-            .expected = 5,
+            .input = StringFromLiteral("Zm9vYmE"),
+            .alphabet = BASE64_ALPHABET_URL,
+            .expected = {.result = 1, .value = StringFromLiteral("fooba")},
         },
         {
-            .language = StringFromLiteral("Cantonese Chinese"),
-            .input = StringFromLiteral("哈囉"),
-            .expected = 2,
+            .input = StringFromLiteral("-_-_"),
+            .alphabet = BASE64_ALPHABET_URL,
+            .expected = {.result = 1, .value = StringFromLiteral("\xfb\xff\xbf")},
         },
+        // padding is required in standard and not allowed in url
         {
-            .language = StringFromLiteral("Japanese"),
-            .input = StringFromLiteral("こんにちは"),
-            .expected = 5,
+            .input = StringFromLiteral("Zm9vYmE"),
+            .alphabet = BASE64_ALPHABET_STANDARD,
+            .expected = {.result = 0, .errorIndex = 7},
         },
         {
-            .language = StringFromLiteral("Korean"),
-            .input = StringFromLiteral("안녕하세요"),
-            .expected = 5,
+            .input = StringFromLiteral("Zm9vYmE="),
+            .alphabet = BASE64_ALPHABET_URL,
+            .expected = {.result = 0, .errorIndex = 7},
         },
         {
-            .language = StringFromLiteral("Mandarin Chinese"),
-            .input = StringFromLiteral("你好"),
-            .expected = 2,
+            .input = StringFromLiteral("Zm9vY"),
+            .alphabet = BASE64_ALPHABET_URL,
+            .expected = {.result = 0, .errorIndex = 5},
         },
+        // alphabets are not mixed
         {
-            .language = StringFromLiteral("Polish"),
-            .input = StringFromLiteral("Cześć"),
-            .expected = 5,
+            .input = StringFromLiteral("+/-_"),
+            .alphabet = BASE64_ALPHABET_STANDARD,
+            .expected = {.result = 0, .errorIndex = 2},
         },
         {
-            .language = StringFromLiteral("Urdu"),
-            .input = StringFromLiteral("سلام"),
-            .expected = 4,
+            .input = StringFromLiteral("-_+/"),
+            .alphabet = BASE64_ALPHABET_URL,
+            .expected = {.result = 0, .errorIndex = 2},
         },
+        // padding only at end
         {
-            .language = StringFromLiteral("Vietnamese"),
-            .input = StringFromLiteral("Xin chào"),
-            .expected = 8,
+            .input = StringFromLiteral("Zg==Zm8="),
+            .alphabet = BASE64_ALPHABET_STANDARD,
+            .expected = {.result = 0, .errorIndex = 2},
         },
-    };
-
-    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+        {
+            .input = StringFromLiteral("Zm=v"),
+            .alphabet = BASE64_ALPHABET_STANDARD,
+            .expected = {.result = 0, .errorIndex = 3},
+        },
+        {
+            .input = StringFromLiteral("===="),
+            .alphabet = BASE64_ALPHABET_STANDARD,
+            .expected = {.result = 0, .errorIndex = 0},
+        },
+        // unused bits must be zero
+        {
+            .input = StringFromLiteral("Zh=="),
+            .alphabet = BASE64_ALPHABET_STANDARD,
+            .expected = {.result = 0, .errorIndex = 1},
+        },
+        {
+            .input = StringFromLiteral("Zm9"),
+            .alphabet = BASE64_ALPHABET_URL,
+            .expected = {.result = 0, .errorIndex = 2},
+        },
+        {
+            .input = StringFromLiteral("Zm9v YmFy"),
+            .alphabet = BASE64_ALPHABET_STANDARD,
+            .expected = {.result = 0, .errorIndex = 9},
+        },
+        {
+            .input = StringFromLiteral("VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZ\x80v/"),
+            .alphabet = BASE64_ALPHABET_STANDARD,
+            .expected = {.result = 0, .errorIndex = 57},
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
       struct test_case *testCase = testCases + testCaseIndex;
 
+      u8 buf[128];
+      struct string stringBuffer = {.value = buf, .length = sizeof(buf)};
+
       struct string *input = &testCase->input;
-      u64 expected = testCase->expected;
-      u64 got = StringLength(input);
+      u64 errorIndex = 0;
+      struct string value = Base64Decode(&stringBuffer, input, testCase->alphabet, &errorIndex);
+      b8 result = !IsStringNull(&value);
+      if (result != testCase->expected.result || (result && !IsStringEqual(&value, &testCase->expected.value)) ||
+          (!result && errorIndex != testCase->expected.errorIndex)) {
+        errorCode = testCase->expected.result ? TEXT_TEST_ERROR_BASE64_DECODE_EXPECTED_TRUE
+                                              : TEXT_TEST_ERROR_BASE64_DECODE_EXPECTED_FALSE;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n     input: ");
+        StringBuilderAppendPrintableString(sb, input);
+        if (result != testCase->expected.result) {
+          StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+          StringBuilderAppendBool(sb, testCase->expected.result);
+          StringBuilderAppendStringLiteral(sb, "\n       got: ");
+          StringBuilderAppendBool(sb, result);
+        } else if (result) {
+          StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+          StringBuilderAppendHexEncoded(sb, &testCase->expected.value);
+          StringBuilderAppendStringLiteral(sb, "\n       got: ");
+          StringBuilderAppendHexEncoded(sb, &value);
+        } else {
+          StringBuilderAppendStringLiteral(sb, "\n  expected error index: ");
+          StringBuilderAppendU64(sb, testCase->expected.errorIndex);
+          StringBuilderAppendStringLiteral(sb, "\n                   got: ");
+          StringBuilderAppendU64(sb, errorIndex);
+        }
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+
+    // round trip all lengths that cross vector widths into exactly sized buffers, then make every character
+    // invalid one by one
+    u8 bytes[160];
+    for (u32 index = 0; index < ARRAY_COUNT(bytes); index++)
+      bytes[index] = (u8)(index * 167 + 13);
+
+    enum base64_alphabet alphabets[] = {BASE64_ALPHABET_STANDARD, BASE64_ALPHABET_URL};
+    for (u32 alphabetIndex = 0; alphabetIndex < ARRAY_COUNT(alphabets); alphabetIndex++) {
+      enum base64_alphabet alphabet = alphabets[alphabetIndex];
+      for (u64 length = 0; length <= ARRAY_COUNT(bytes); length++) {
+        struct string input = StringFromBuffer(bytes, length);
+        u8 textBuffer[ARRAY_COUNT(bytes) / 3 * 4 + 4];
+        struct string textBufferString = StringFromBuffer(textBuffer, Base64EncodedLength(length, alphabet));
+        struct string text = Base64Encode(&textBufferString, &input, alphabet);
+
+        u8 decodedBuffer[ARRAY_COUNT(bytes)];
+        struct string decodedBufferString = StringFromBuffer(decodedBuffer, Base64DecodedLength(&text, alphabet));
+        struct string decoded = Base64Decode(&decodedBufferString, &text, alphabet, 0);
+        if (IsStringNull(&text) || text.length != textBufferString.length || !IsStringEqual(&decoded, &input)) {
+          errorCode = TEXT_TEST_ERROR_BASE64_DECODE_EXPECTED_TRUE;
+
+          StringBuilderAppendErrorMessage(sb, errorCode);
+          StringBuilderAppendStringLiteral(sb, "\n  round trip failed at length: ");
+          StringBuilderAppendU64(sb, length);
+          StringBuilderAppendStringLiteral(sb, "\n");
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+          break;
+        }
+
+        for (u64 invalidIndex = 0; invalidIndex < text.length; invalidIndex++) {
+          u8 original = text.value[invalidIndex];
+          if (original == '=')
+            continue;
+          text.value[invalidIndex] = (invalidIndex & 1) ? '.' : 0xf0;
+
+          u64 errorIndex = 0;
+          decoded = Base64Decode(&decodedBufferString, &text, alphabet, &errorIndex);
+          text.value[invalidIndex] = original;
+          if (!IsStringNull(&decoded) || errorIndex != invalidIndex) {
+            errorCode = TEXT_TEST_ERROR_BASE64_DECODE_EXPECTED_FALSE;
+
+            StringBuilderAppendErrorMessage(sb, errorCode);
+            StringBuilderAppendStringLiteral(sb, "\n     input length: ");
+            StringBuilderAppendU64(sb, text.length);
+            StringBuilderAppendStringLiteral(sb, "\n  expected error index: ");
+            StringBuilderAppendU64(sb, invalidIndex);
+            StringBuilderAppendStringLiteral(sb, "\n                   got: ");
+            StringBuilderAppendU64(sb, errorIndex);
+            StringBuilderAppendStringLiteral(sb, "\n");
+            struct string errorMessage = StringBuilderFlush(sb);
+            PrintString(&errorMessage);
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  // struct string PathGetDirectory(struct string *path)
+  // Dependencies: IsStringEqual()
+  if (IsStringEqualOK) {
+    struct test_case {
+      struct string input;
+      struct string expected;
+    } testCases[] = {
+#if IS_PLATFORM_WINDOWS
+        {
+            .input = StringFromLiteral("C:\\Users\\e2dk4r"),
+            .expected = StringFromLiteral("C:\\Users"),
+        },
+        {
+            .input = StringFromLiteral("C:\\Windows\\system32\\notepad.exe"),
+            .expected = StringFromLiteral("C:\\Windows\\system32"),
+        },
+#else
+        {
+            .input = StringFromLiteral("/usr/bin/ls"),
+            .expected = StringFromLiteral("/usr/bin"),
+        },
+        {
+            .input = StringFromLiteral("/usr"),
+            .expected = StringFromLiteral("/"),
+        },
+        {
+            .input = StringFromLiteral("/home/user/projects/library/include/very_long_header_name.h"),
+            .expected = StringFromLiteral("/home/user/projects/library/include"),
+        },
+        {
+            .input = StringFromLiteral("/a/file_name_that_is_longer_than_thirty_two_bytes.txt"),
+            .expected = StringFromLiteral("/a"),
+        },
+#endif
+        {
+            .input = StringNull(),
+            .expected = StringNull(),
+        },
+        {
+            .input = StringFromLiteral(""),
+            .expected = StringNull(),
+        },
+        {
+            .input = StringFromLiteral(" "),
+            .expected = StringNull(),
+        },
+        {
+            .input = StringFromLiteral("no directory"),
+            .expected = StringNull(),
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      struct string *input = &testCase->input;
+      struct string *expected = &testCase->expected;
+      struct string value = PathGetDirectory(input);
+      if (!IsStringEqual(&value, expected)) {
+        errorCode = TEXT_TEST_ERROR_PATHGETDIRECTORY;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  input:    ");
+        StringBuilderAppendPrintableString(sb, input);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendPrintableString(sb, expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendPrintableString(sb, &value);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // b8 PathIteratorNext(struct path_iterator *iterator, struct string *component)
+  // Dependencies: IsStringEqual()
+  if (IsStringEqualOK) {
+    struct test_case {
+      struct string input;
+      b8 isAbsolute;
+      struct string expected[4];
+      u32 expectedCount;
+    } testCases[] = {
+        {
+            .input = StringFromLiteral("/usr//lib/"),
+            .isAbsolute = 1,
+            .expected = {StringFromLiteral("usr"), StringFromLiteral("lib")},
+            .expectedCount = 2,
+        },
+        {
+            .input = StringFromLiteral("a/./../b"),
+            .expected = {StringFromLiteral("a"), StringFromLiteral("."), StringFromLiteral(".."),
+                         StringFromLiteral("b")},
+            .expectedCount = 4,
+        },
+        {
+            .input = StringFromLiteral("home/user/projects/library/include_directory_that_is_long/x.h"),
+            .expected = {StringFromLiteral("home"), StringFromLiteral("user"), StringFromLiteral("projects"),
+                         StringFromLiteral("library")},
+            .expectedCount = 4,
+        },
+#if IS_PLATFORM_WINDOWS
+        {
+            .input = StringFromLiteral("C:\\Windows/system32"),
+            .isAbsolute = 1,
+            .expected = {StringFromLiteral("Windows"), StringFromLiteral("system32")},
+            .expectedCount = 2,
+        },
+#endif
+        {
+            .input = StringFromLiteral("/"),
+            .isAbsolute = 1,
+        },
+        {
+            .input = StringFromLiteral(""),
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      struct string *input = &testCase->input;
+      struct path_iterator iterator = PathIteratorFrom(input);
+      struct string component;
+      u32 componentCount = 0;
+      b8 isEqual = IsPathAbsolute(input) == testCase->isAbsolute;
+      while (PathIteratorNext(&iterator, &component)) {
+        // only first components of long path are checked
+        if (componentCount < ARRAY_COUNT(testCase->expected) &&
+            !IsStringEqual(&component, testCase->expected + componentCount))
+          isEqual = 0;
+        componentCount++;
+      }
+      if (componentCount > ARRAY_COUNT(testCase->expected))
+        componentCount = testCase->expectedCount;
+
+      if (!isEqual || componentCount != testCase->expectedCount) {
+        errorCode = TEXT_TEST_ERROR_PATH_ITERATOR;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  input:    ");
+        StringBuilderAppendPrintableString(sb, input);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendU64(sb, testCase->expectedCount);
+        StringBuilderAppendStringLiteral(sb, " components\n       got: ");
+        StringBuilderAppendU64(sb, componentCount);
+        StringBuilderAppendStringLiteral(sb, " components\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // struct string PathNormalize(struct string *path)
+  // Dependencies: IsStringEqual()
+  if (IsStringEqualOK) {
+    struct test_case {
+      struct string input;
+      struct string expected;
+    } testCases[] = {
+#if IS_PLATFORM_WINDOWS
+        {
+            .input = StringFromLiteral("C:/Windows\\.\\Temp\\..\\system32\\"),
+            .expected = StringFromLiteral("C:\\Windows\\system32"),
+        },
+        {
+            .input = StringFromLiteral("C:..\\a"),
+            .expected = StringFromLiteral("C:..\\a"),
+        },
+#else
+        {
+            .input = StringFromLiteral("/usr//./local/../lib/"),
+            .expected = StringFromLiteral("/usr/lib"),
+        },
+        {
+            .input = StringFromLiteral("/usr/lib"),
+            .expected = StringFromLiteral("/usr/lib"),
+        },
+        {
+            .input = StringFromLiteral("/../a/.."),
+            .expected = StringFromLiteral("/"),
+        },
+        {
+            .input = StringFromLiteral("//"),
+            .expected = StringFromLiteral("/"),
+        },
+        {
+            .input = StringFromLiteral("../a/../../b/./c/"),
+            .expected = StringFromLiteral("../../b/c"),
+        },
+        {
+            .input = StringFromLiteral("a/b/../.."),
+            .expected = StringFromLiteral("."),
+        },
+        {
+            .input = StringFromLiteral("./"),
+            .expected = StringFromLiteral("."),
+        },
+        {
+            .input = StringFromLiteral("a/..b/.c/..."),
+            .expected = StringFromLiteral("a/..b/.c/..."),
+        },
+        {
+            .input = StringFromLiteral("project/build/../source_directory_with_long_name/./module///file.c"),
+            .expected = StringFromLiteral("project/source_directory_with_long_name/module/file.c"),
+        },
+#endif
+        {
+            .input = StringFromLiteral(""),
+            .expected = StringNull(),
+        },
+        {
+            .input = StringNull(),
+            .expected = StringNull(),
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      struct string *input = &testCase->input;
+      struct string *expected = &testCase->expected;
+      // normalized in place
+      u8 buffer[128];
+      struct string path = StringNull();
+      if (!IsStringNull(input)) {
+        MemoryCopy(buffer, input->value, input->length);
+        path = StringFromBuffer(buffer, input->length);
+      }
+      struct string value = PathNormalize(&path);
+      if (!IsStringEqual(&value, expected) || (!IsStringNull(&value) && value.value != buffer)) {
+        errorCode = TEXT_TEST_ERROR_PATH_NORMALIZE;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  input:    ");
+        StringBuilderAppendPrintableString(sb, input);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendPrintableString(sb, expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendPrintableString(sb, &value);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // b8 StringSplit(struct string *string, struct string *separator, u64 *splitCount, struct string *splits)
+  // Dependencies: IsStringEqual()
+  if (IsStringEqualOK) {
+    __cleanup_memory_temp__ memory_temp tempMemory = MemoryTempBegin(&stackMemory);
+
+    struct test_case {
+      struct string input;
+      struct string separator;
+      struct {
+        b8 value;
+        u64 splitCount;
+        struct string *splits;
+      } expected;
+    } testCases[] = {
+        {
+            .input = StringFromLiteral("1 2 3"),
+            .separator = StringFromLiteral(" "),
+            .expected =
+                {
+                    .value = 1,
+                    .splitCount = 3,
+                    .splits =
+                        (struct string[]){
+                            StringFromLiteral("1"),
+                            StringFromLiteral("2"),
+                            StringFromLiteral("3"),
+                        },
+                },
+        },
+        {
+            .input = StringFromLiteral("1xx2xx3"),
+            .separator = StringFromLiteral("xx"),
+            .expected =
+                {
+                    .value = 1,
+                    .splitCount = 3,
+                    .splits =
+                        (struct string[]){
+                            StringFromLiteral("1"),
+                            StringFromLiteral("2"),
+                            StringFromLiteral("3"),
+                        },
+                },
+        },
+        {
+            .input = StringFromLiteral("1xoxo2xo3"),
+            .separator = StringFromLiteral("xo"),
+            .expected =
+                {
+                    .value = 1,
+                    .splitCount = 4,
+                    .splits =
+                        (struct string[]){
+                            StringFromLiteral("1"),
+                            StringNull(),
+                            StringFromLiteral("2"),
+                            StringFromLiteral("3"),
+                        },
+                },
+        },
+        {
+            .input = StringFromLiteral("1xo2xo3xo"),
+            .separator = StringFromLiteral("xo"),
+            .expected =
+                {
+                    .value = 1,
+                    .splitCount = 4,
+                    .splits =
+                        (struct string[]){
+                            StringFromLiteral("1"),
+                            StringFromLiteral("2"),
+                            StringFromLiteral("3"),
+                            StringNull(),
+                        },
+                },
+        },
+        {
+            .input = StringFromLiteral("Lorem ipsum dolor sit amet, consectetur adipiscing elit"),
+            .separator = StringFromLiteral(" "),
+            .expected =
+                {
+                    .value = 1,
+                    .splitCount = 8,
+                    .splits =
+                        (struct string[]){
+                            StringFromLiteral("Lorem"),
+                            StringFromLiteral("ipsum"),
+                            StringFromLiteral("dolor"),
+                            StringFromLiteral("sit"),
+                            StringFromLiteral("amet,"),
+                            StringFromLiteral("consectetur"),
+                            StringFromLiteral("adipiscing"),
+                            StringFromLiteral("elit"),
+                        },
+                },
+        },
+        {
+            .input = StringFromLiteral("Lorem ipsum dolor sit amet, consectetur adipiscing elit"),
+            .separator = StringFromLiteral("no separator"),
+            .expected =
+                {
+                    .value = 0,
+                },
+        },
+        {
+            .input = StringFromLiteral("Lorem"),
+            .separator = StringFromLiteral("no separator"),
+            .expected =
+                {
+                    .value = 0,
+                },
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      struct string *input = &testCase->input;
+      struct string *separator = &testCase->separator;
+
+      u64 expectedSplitCount = testCase->expected.splitCount;
+      b8 expected = testCase->expected.value;
+      u64 splitCount = !expectedSplitCount;
+      b8 value = StringSplit(input, separator, &splitCount, 0);
+      if (value != expected || (expected && splitCount != expectedSplitCount)) {
+        errorCode = expected ? TEXT_TEST_ERROR_STRINGSPLIT_EXPECTED_TRUE : TEXT_TEST_ERROR_STRINGSPLIT_EXPECTED_FALSE;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n      input: '");
+        StringBuilderAppendString(sb, input);
+        StringBuilderAppendStringLiteral(sb, "'");
+        StringBuilderAppendStringLiteral(sb, "\n  separator: '");
+        StringBuilderAppendString(sb, separator);
+        StringBuilderAppendStringLiteral(sb, "'");
+        if (value != expected) {
+          StringBuilderAppendStringLiteral(sb, "\n   expected: ");
+          StringBuilderAppendBool(sb, expected);
+          StringBuilderAppendStringLiteral(sb, "\n        got: ");
+          StringBuilderAppendBool(sb, value);
+        } else {
+          StringBuilderAppendStringLiteral(sb, "\n  expected split count: ");
+          StringBuilderAppendU64(sb, expectedSplitCount);
+          StringBuilderAppendStringLiteral(sb, "\n                   got: ");
+          StringBuilderAppendU64(sb, splitCount);
+        }
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      } else if (expected) {
+        struct string *expectedSplits = testCase->expected.splits;
+        struct string *splits = MemoryArenaPush(tempMemory.arena, sizeof(*splits) * splitCount);
+        StringSplit(input, separator, &splitCount, splits);
+
+        u32 splitFailCount = 0;
+
+        for (u32 splitIndex = 0; splitIndex < splitCount; splitIndex++) {
+          struct string *expectedSplit = expectedSplits + splitIndex;
+          struct string *split = splits + splitIndex;
+          if (!IsStringEqual(split, expectedSplit)) {
+            errorCode =
+                expected ? TEXT_TEST_ERROR_STRINGSPLIT_EXPECTED_TRUE : TEXT_TEST_ERROR_STRINGSPLIT_EXPECTED_FALSE;
+
+            if (splitFailCount == 0) {
+              StringBuilderAppendErrorMessage(sb, errorCode);
+              StringBuilderAppendStringLiteral(sb, "\n        input: '");
+              StringBuilderAppendString(sb, input);
+              StringBuilderAppendStringLiteral(sb, "'");
+              StringBuilderAppendStringLiteral(sb, "\n    separator: '");
+              StringBuilderAppendString(sb, separator);
+              StringBuilderAppendStringLiteral(sb, "'");
+              StringBuilderAppendStringLiteral(sb, "\n  split count: ");
+              StringBuilderAppendU64(sb, splitCount);
+            }
+
+            StringBuilderAppendStringLiteral(sb, "\n  index ");
+            StringBuilderAppendU64(sb, splitIndex);
+            StringBuilderAppendStringLiteral(sb, " is wrong");
+            StringBuilderAppendStringLiteral(sb, "\n     expected: ");
+            StringBuilderAppendPrintableString(sb, expectedSplit);
+            StringBuilderAppendStringLiteral(sb, "\n          got: ");
+            StringBuilderAppendPrintableString(sb, split);
+            StringBuilderAppendStringLiteral(sb, "\n");
+            struct string errorMessage = StringBuilderFlush(sb);
+            PrintString(&errorMessage);
+
+            splitFailCount++;
+          }
+        }
+      }
+    }
+  }
+
+  // b8 StringIndexOf(struct string *string, struct string *search, u64 *index)
+  {
+    struct test_case {
+      struct string input;
+      struct string search;
+      struct {
+        b8 result;
+        u64 index;
+      } expected;
+    } testCases[] = {
+        {
+            .input = StringFromLiteral("abc"),
+            .search = StringFromLiteral("c"),
+            .expected = {.result = 1, .index = 2},
+        },
+        {
+            .input = StringFromLiteral("Lorem ipsum dolor sit amet, consectetur adipiscing elit"),
+            .search = StringFromLiteral("elit"),
+            .expected = {.result = 1, .index = 51},
+        },
+        {
+            .input = StringFromLiteral("Lorem ipsum dolor sit amet, consectetur adipiscing elit"),
+            .search = StringFromLiteral("Lorem ipsum dolor sit amet, consectetur adipiscing elit"),
+            .expected = {.result = 1, .index = 0},
+        },
+        {
+            .input = StringFromLiteral("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab"),
+            .search = StringFromLiteral("aab"),
+            .expected = {.result = 1, .index = 47},
+        },
+        {
+            .input = StringFromLiteral("Lorem ipsum dolor sit amet, consectetur adipiscing elit"),
+            .search = StringFromLiteral("elite"),
+            .expected = {.result = 0},
+        },
+        {
+            .input = StringFromLiteral("abc"),
+            .search = StringFromLiteral(""),
+            .expected = {.result = 0},
+        },
+        {
+            .input = StringFromLiteral(""),
+            .search = StringFromLiteral("a"),
+            .expected = {.result = 0},
+        },
+        {
+            .input = StringNull(),
+            .search = StringFromLiteral("a"),
+            .expected = {.result = 0},
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      struct string *input = &testCase->input;
+      struct string *search = &testCase->search;
+      u64 index = 0;
+      b8 result = StringIndexOf(input, search, &index);
+      if (result != testCase->expected.result || (result && index != testCase->expected.index)) {
+        errorCode = testCase->expected.result ? TEXT_TEST_ERROR_STRING_INDEX_OF_EXPECTED_TRUE
+                                              : TEXT_TEST_ERROR_STRING_INDEX_OF_EXPECTED_FALSE;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n     input: ");
+        StringBuilderAppendPrintableString(sb, input);
+        StringBuilderAppendStringLiteral(sb, "\n    search: ");
+        StringBuilderAppendPrintableString(sb, search);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendBool(sb, testCase->expected.result);
+        StringBuilderAppendStringLiteral(sb, " at ");
+        StringBuilderAppendU64(sb, testCase->expected.index);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendBool(sb, result);
+        StringBuilderAppendStringLiteral(sb, " at ");
+        StringBuilderAppendU64(sb, index);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+
+    // search text at every position of long text, crossing vector widths
+    u8 textBuffer[100];
+    for (u32 index = 0; index < ARRAY_COUNT(textBuffer); index++)
+      textBuffer[index] = (u8)('a' + index % 3);
+    struct string text = StringFromBuffer(textBuffer, ARRAY_COUNT(textBuffer));
+    for (u64 searchLength = 1; searchLength <= 5; searchLength++) {
+      for (u64 expectedIndex = 0; expectedIndex + searchLength <= text.length; expectedIndex++) {
+        for (u64 index = 0; index < searchLength; index++)
+          textBuffer[expectedIndex + index] = 'x';
+        textBuffer[expectedIndex + searchLength - 1] = 'y';
+
+        struct string search = StringFromBuffer(textBuffer + expectedIndex, searchLength);
+        u64 index = 0;
+        b8 result = StringIndexOf(&text, &search, &index);
+
+        for (u64 restoreIndex = 0; restoreIndex < searchLength; restoreIndex++)
+          textBuffer[expectedIndex + restoreIndex] = (u8)('a' + (expectedIndex + restoreIndex) % 3);
+
+        if (!result || index != expectedIndex) {
+          errorCode = TEXT_TEST_ERROR_STRING_INDEX_OF_EXPECTED_TRUE;
+
+          StringBuilderAppendErrorMessage(sb, errorCode);
+          StringBuilderAppendStringLiteral(sb, "\n  search length: ");
+          StringBuilderAppendU64(sb, searchLength);
+          StringBuilderAppendStringLiteral(sb, "\n       expected: ");
+          StringBuilderAppendU64(sb, expectedIndex);
+          StringBuilderAppendStringLiteral(sb, "\n            got: ");
+          StringBuilderAppendU64(sb, index);
+          StringBuilderAppendStringLiteral(sb, "\n");
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+          break;
+        }
+      }
+    }
+  }
+
+  // b8 StringSplitIteratorNext(struct string_split_iterator *iterator, struct string *split)
+  // Dependencies: IsStringEqual()
+  if (IsStringEqualOK) {
+    struct test_case {
+      struct string input;
+      struct string separator;
+      u64 maxSplitCount;
+      u32 flags;
+      struct {
+        u64 splitCount;
+        struct string *splits;
+      } expected;
+    } testCases[] = {
+        {
+            .input = StringFromLiteral("1 2 3"),
+            .separator = StringFromLiteral(" "),
+            .expected =
+                {
+                    .splitCount = 3,
+                    .splits =
+                        (struct string[]){
+                            StringFromLiteral("1"),
+                            StringFromLiteral("2"),
+                            StringFromLiteral("3"),
+                        },
+                },
+        },
+        {
+            .input = StringFromLiteral("1xoxo2xo3xo"),
+            .separator = StringFromLiteral("xo"),
+            .expected =
+                {
+                    .splitCount = 5,
+                    .splits =
+                        (struct string[]){
+                            StringFromLiteral("1"),
+                            StringNull(),
+                            StringFromLiteral("2"),
+                            StringFromLiteral("3"),
+                            StringNull(),
+                        },
+                },
+        },
+        {
+            .input = StringFromLiteral("1xoxo2xo3xo"),
+            .separator = StringFromLiteral("xo"),
+            .flags = STRING_SPLIT_FLAG_SKIP_EMPTY,
+            .expected =
+                {
+                    .splitCount = 3,
+                    .splits =
+                        (struct string[]){
+                            StringFromLiteral("1"),
+                            StringFromLiteral("2"),
+                            StringFromLiteral("3"),
+                        },
+                },
+        },
+        {
+            .input = StringFromLiteral("key=value=with=equals"),
+            .separator = StringFromLiteral("="),
+            .maxSplitCount = 1,
+            .expected =
+                {
+                    .splitCount = 2,
+                    .splits =
+                        (struct string[]){
+                            StringFromLiteral("key"),
+                            StringFromLiteral("value=with=equals"),
+                        },
+                },
+        },
+        {
+            .input = StringFromLiteral("  GET   /index.html  HTTP/1.1  "),
+            .separator = StringFromLiteral(" "),
+            .maxSplitCount = 1,
+            .flags = STRING_SPLIT_FLAG_SKIP_EMPTY,
+            .expected =
+                {
+                    .splitCount = 2,
+                    .splits =
+                        (struct string[]){
+                            StringFromLiteral("GET"),
+                            StringFromLiteral("/index.html  HTTP/1.1  "),
+                        },
+                },
+        },
+        {
+            .input = StringFromLiteral("no separator"),
+            .separator = StringFromLiteral(","),
+            .expected =
+                {
+                    .splitCount = 1,
+                    .splits =
+                        (struct string[]){
+                            StringFromLiteral("no separator"),
+                        },
+                },
+        },
+        {
+            .input = StringFromLiteral(""),
+            .separator = StringFromLiteral(","),
+            .expected =
+                {
+                    .splitCount = 1,
+                    .splits =
+                        (struct string[]){
+                            StringNull(),
+                        },
+                },
+        },
+        {
+            .input = StringFromLiteral(",,,"),
+            .separator = StringFromLiteral(","),
+            .flags = STRING_SPLIT_FLAG_SKIP_EMPTY,
+            .expected =
+                {
+                    .splitCount = 0,
+                },
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      struct string *input = &testCase->input;
+      struct string *separator = &testCase->separator;
+
+      u64 splitCount = 0;
+      struct string split;
+      struct string_split_iterator iterator =
+          StringSplitIteratorFrom(input, separator, testCase->maxSplitCount, testCase->flags);
+      while (StringSplitIteratorNext(&iterator, &split)) {
+        b8 isOverflow = splitCount >= testCase->expected.splitCount;
+        struct string *expectedSplit = isOverflow ? 0 : testCase->expected.splits + splitCount;
+        if (isOverflow || !IsStringEqual(&split, expectedSplit)) {
+          errorCode = TEXT_TEST_ERROR_STRING_SPLIT_ITERATOR;
+
+          StringBuilderAppendErrorMessage(sb, errorCode);
+          StringBuilderAppendStringLiteral(sb, "\n      input: '");
+          StringBuilderAppendString(sb, input);
+          StringBuilderAppendStringLiteral(sb, "'");
+          StringBuilderAppendStringLiteral(sb, "\n  separator: '");
+          StringBuilderAppendString(sb, separator);
+          StringBuilderAppendStringLiteral(sb, "'");
+          StringBuilderAppendStringLiteral(sb, "\n      index: ");
+          StringBuilderAppendU64(sb, splitCount);
+          StringBuilderAppendStringLiteral(sb, "\n   expected: ");
+          if (isOverflow)
+            StringBuilderAppendStringLiteral(sb, "(END)");
+          else
+            StringBuilderAppendPrintableString(sb, expectedSplit);
+          StringBuilderAppendStringLiteral(sb, "\n        got: ");
+          StringBuilderAppendPrintableString(sb, &split);
+          StringBuilderAppendStringLiteral(sb, "\n");
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+          break;
+        }
+        splitCount++;
+      }
+
+      if (splitCount != testCase->expected.splitCount && errorCode != TEXT_TEST_ERROR_STRING_SPLIT_ITERATOR) {
+        errorCode = TEXT_TEST_ERROR_STRING_SPLIT_ITERATOR;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n      input: '");
+        StringBuilderAppendString(sb, input);
+        StringBuilderAppendStringLiteral(sb, "'");
+        StringBuilderAppendStringLiteral(sb, "\n  expected split count: ");
+        StringBuilderAppendU64(sb, testCase->expected.splitCount);
+        StringBuilderAppendStringLiteral(sb, "\n                   got: ");
+        StringBuilderAppendU64(sb, splitCount);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // string_cut StringCut(struct string *string, struct string *separator)
+  if (IsStringEqualOK) {
+    __cleanup_memory_temp__ memory_temp tempMemory = MemoryTempBegin(&stackMemory);
+
+    struct text_case_expected {
+      b8 ok;
+      struct string before;
+      struct string after;
+    };
+    struct test_case {
+      struct string input;
+      struct string separator;
+      struct text_case_expected expected;
+    } testCases[] = {
+        {
+            .input = StringFromLiteral("one two three"),
+            .separator = StringFromLiteral(" "),
+            .expected =
+                {
+                    .ok = 1,
+                    .before = StringFromLiteral("one"),
+                    .after = StringFromLiteral("two three"),
+                },
+        },
+        {
+            .input = StringFromLiteral("apple...banana...watermelon"),
+            .separator = StringFromLiteral("..."),
+            .expected =
+                {
+                    .ok = 1,
+                    .before = StringFromLiteral("apple"),
+                    .after = StringFromLiteral("banana...watermelon"),
+                },
+        },
+        {
+            .input = StringFromLiteral("Arthropoda,"),
+            .separator = StringFromLiteral(","),
+            .expected =
+                {
+                    .ok = 1,
+                    .before = StringFromLiteral("Arthropoda"),
+                    .after = StringFromLiteral(""),
+                },
+        },
+        {
+            .input = StringNull(),
+            .separator = StringNull(),
+            .expected = {.ok = 0},
+        },
+        {
+            .input = StringNull(),
+            .separator = StringFromLiteral(","),
+            .expected = {.ok = 0},
+        },
+        {
+            .input = StringFromLiteral(""),
+            .separator = StringNull(),
+            .expected = {.ok = 0},
+        },
+        {
+            .input = StringFromLiteral(""),
+            .separator = StringFromLiteral(","),
+            .expected = {.ok = 0},
+        },
+        {
+            .input = StringFromLiteral("No separator found"),
+            .separator = StringFromLiteral(","),
+            .expected = {.ok = 0},
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      struct string *input = &testCase->input;
+      struct string *separator = &testCase->separator;
+
+      struct text_case_expected expected = testCase->expected;
+      struct string_cut got = StringCut(input, separator);
+
+      if (got.ok != expected.ok) {
+        errorCode = expected.ok ? TEXT_TEST_ERROR_STRING_CUT_EXPECTED_TRUE : TEXT_TEST_ERROR_STRING_CUT_EXPECTED_FALSE;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n     input: '");
+        StringBuilderAppendString(sb, input);
+        StringBuilderAppendStringLiteral(sb, "'");
+        StringBuilderAppendStringLiteral(sb, "\n separator: '");
+        StringBuilderAppendString(sb, separator);
+        StringBuilderAppendStringLiteral(sb, "'");
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      } else {
+
+        if (!IsStringEqual(&got.before, &expected.before)) {
+          errorCode = TEXT_TEST_ERROR_STRING_CUT_EXPECTED_BEFORE;
+
+          StringBuilderAppendErrorMessage(sb, errorCode);
+          StringBuilderAppendStringLiteral(sb, "\n     input: '");
+          StringBuilderAppendString(sb, input);
+          StringBuilderAppendStringLiteral(sb, "'");
+          StringBuilderAppendStringLiteral(sb, "\n separator: '");
+          StringBuilderAppendString(sb, separator);
+          StringBuilderAppendStringLiteral(sb, "'");
+          StringBuilderAppendStringLiteral(sb, "\n  expected: '");
+          StringBuilderAppendString(sb, &expected.before);
+          StringBuilderAppendStringLiteral(sb, "'");
+          StringBuilderAppendStringLiteral(sb, "\n       got: '");
+          StringBuilderAppendString(sb, &got.before);
+          StringBuilderAppendStringLiteral(sb, "'");
+          StringBuilderAppendStringLiteral(sb, "\n");
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+        }
+
+        if (!IsStringEqual(&got.after, &expected.after)) {
+          errorCode = TEXT_TEST_ERROR_STRING_CUT_EXPECTED_AFTER;
+
+          StringBuilderAppendErrorMessage(sb, errorCode);
+          StringBuilderAppendStringLiteral(sb, "\n     input: '");
+          StringBuilderAppendString(sb, input);
+          StringBuilderAppendStringLiteral(sb, "'");
+          StringBuilderAppendStringLiteral(sb, "\n separator: '");
+          StringBuilderAppendString(sb, separator);
+          StringBuilderAppendStringLiteral(sb, "'");
+          StringBuilderAppendStringLiteral(sb, "\n  expected: '");
+          StringBuilderAppendString(sb, &expected.after);
+          StringBuilderAppendStringLiteral(sb, "'");
+          StringBuilderAppendStringLiteral(sb, "\n       got: '");
+          StringBuilderAppendString(sb, &got.after);
+          StringBuilderAppendStringLiteral(sb, "'");
+          StringBuilderAppendStringLiteral(sb, "\n");
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+        }
+      }
+    }
+  }
+
+  // struct string PercentDecode(struct string *string, u32 flags, u64 *errorIndex)
+  // Dependencies: IsStringEqual()
+  if (IsStringEqualOK) {
+    struct test_case {
+      struct string input;
+      u32 flags;
+      struct {
+        b8 result;
+        struct string value;
+        u64 errorIndex;
+      } expected;
+    } testCases[] = {
+        {
+            .input = StringFromLiteral(""),
+            .expected = {.result = 1, .value = StringFromLiteral("")},
+        },
+        {
+            .input = StringFromLiteral("plain+text"),
+            .expected = {.result = 1, .value = StringFromLiteral("plain+text")},
+        },
+        {
+            .input = StringFromLiteral("plain+text"),
+            .flags = PERCENT_DECODE_FLAG_PLUS_AS_SPACE,
+            .expected = {.result = 1, .value = StringFromLiteral("plain text")},
+        },
+        {
+            .input = StringFromLiteral("%2Fa%2fb%20c%25"),
+            .expected = {.result = 1, .value = StringFromLiteral("/a/b c%")},
+        },
+        {
+            .input = StringFromLiteral("caf%C3%A9+%E2%82%AC"),
+            .flags = PERCENT_DECODE_FLAG_PLUS_AS_SPACE,
+            .expected = {.result = 1, .value = StringFromLiteral("café €")},
+        },
+        {
+            .input = StringFromLiteral("clean run longer than one vector width%21 and another clean run after it%3F"),
+            .expected = {.result = 1, .value = StringFromLiteral("clean run longer than one vector width! and another "
+                                                                 "clean run after it?")},
+        },
+        {
+            .input = StringFromLiteral("100%"),
+            .expected = {.result = 0, .errorIndex = 3},
+        },
+        {
+            .input = StringFromLiteral("a%2"),
+            .expected = {.result = 0, .errorIndex = 1},
+        },
+        {
+            .input = StringFromLiteral("%41%g1"),
+            .expected = {.result = 0, .errorIndex = 3},
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      u8 buffer[128];
+      MemoryCopy(buffer, testCase->input.value, testCase->input.length);
+      struct string input = StringFromBuffer(buffer, testCase->input.length);
+      u64 errorIndex = 0;
+      struct string value = PercentDecode(&input, testCase->flags, &errorIndex);
+      b8 result = !IsStringNull(&value);
+      if (result != testCase->expected.result || (result && !IsStringEqual(&value, &testCase->expected.value)) ||
+          (!result && errorIndex != testCase->expected.errorIndex)) {
+        errorCode = TEXT_TEST_ERROR_PERCENT_DECODE;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n     input: ");
+        StringBuilderAppendString(sb, &testCase->input);
+        if (result != testCase->expected.result) {
+          StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+          StringBuilderAppendBool(sb, testCase->expected.result);
+          StringBuilderAppendStringLiteral(sb, "\n       got: ");
+          StringBuilderAppendBool(sb, result);
+        } else if (result) {
+          StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+          StringBuilderAppendString(sb, &testCase->expected.value);
+          StringBuilderAppendStringLiteral(sb, "\n       got: ");
+          StringBuilderAppendString(sb, &value);
+        } else {
+          StringBuilderAppendStringLiteral(sb, "\n  expected error index: ");
+          StringBuilderAppendU64(sb, testCase->expected.errorIndex);
+          StringBuilderAppendStringLiteral(sb, "\n                   got: ");
+          StringBuilderAppendU64(sb, errorIndex);
+        }
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // b8 URLParse(struct string *string, struct url *url, u64 *errorIndex)
+  // Dependencies: IsStringEqual()
+  if (IsStringEqualOK) {
+    struct test_case {
+      struct string input;
+      struct {
+        b8 result;
+        // "null" for null string
+        struct string components[7];
+        u64 errorIndex;
+      } expected;
+    } testCases[] = {
+        {
+            .input = StringFromLiteral("https://user:pw@example.com:8080/a/b%20c?x=1&y=2#top"),
+            .expected = {.result = 1,
+                         .components = {StringFromLiteral("https"), StringFromLiteral("user:pw"),
+                                        StringFromLiteral("example.com"), StringFromLiteral("8080"),
+                                        StringFromLiteral("/a/b%20c"), StringFromLiteral("x=1&y=2"),
+                                        StringFromLiteral("top")}},
+        },
+        {
+            .input = StringFromLiteral("http://[::1]:80/"),
+            .expected = {.result = 1,
+                         .components = {StringFromLiteral("http"), StringFromLiteral("null"), StringFromLiteral("::1"),
+                                        StringFromLiteral("80"), StringFromLiteral("/"), StringFromLiteral("null"),
+                                        StringFromLiteral("null")}},
+        },
+        {
+            .input = StringFromLiteral("/index.html?q=a+b"),
+            .expected = {.result = 1,
+                         .components = {StringFromLiteral("null"), StringFromLiteral("null"), StringFromLiteral("null"),
+                                        StringFromLiteral("null"), StringFromLiteral("/index.html"),
+                                        StringFromLiteral("q=a+b"), StringFromLiteral("null")}},
+        },
+        {
+            .input = StringFromLiteral("file:///etc/hosts"),
+            .expected = {.result = 1,
+                         .components = {StringFromLiteral("file"), StringFromLiteral("null"), StringFromLiteral(""),
+                                        StringFromLiteral("null"), StringFromLiteral("/etc/hosts"),
+                                        StringFromLiteral("null"), StringFromLiteral("null")}},
+        },
+        {
+            .input = StringFromLiteral("mailto:someone@example.com"),
+            .expected = {.result = 1,
+                         .components = {StringFromLiteral("mailto"), StringFromLiteral("null"),
+                                        StringFromLiteral("null"), StringFromLiteral("null"),
+                                        StringFromLiteral("someone@example.com"), StringFromLiteral("null"),
+                                        StringFromLiteral("null")}},
+        },
+        {
+            .input = StringFromLiteral("//cdn.example.com?"),
+            .expected = {.result = 1,
+                         .components = {StringFromLiteral("null"), StringFromLiteral("null"),
+                                        StringFromLiteral("cdn.example.com"), StringFromLiteral("null"),
+                                        StringFromLiteral(""), StringFromLiteral(""), StringFromLiteral("null")}},
+        },
+        {
+            .input = StringFromLiteral("1http://example.com"),
+            .expected = {.result = 0, .errorIndex = 0},
+        },
+        {
+            .input = StringFromLiteral("http://example.com:80a/"),
+            .expected = {.result = 0, .errorIndex = 21},
+        },
+        {
+            .input = StringFromLiteral("http://[::1/"),
+            .expected = {.result = 0, .errorIndex = 11},
+        },
+        {
+            .input = StringFromLiteral("http://[1:2:3:4:5:6:7:8]/"),
+            .expected = {.result = 1,
+                         .components = {StringFromLiteral("http"), StringFromLiteral("null"),
+                                        StringFromLiteral("1:2:3:4:5:6:7:8"), StringFromLiteral("null"),
+                                        StringFromLiteral("/"), StringFromLiteral("null"), StringFromLiteral("null")}},
+        },
+        {
+            .input = StringFromLiteral("http://[::ffff:192.0.2.1]/"),
+            .expected = {.result = 1,
+                         .components = {StringFromLiteral("http"), StringFromLiteral("null"),
+                                        StringFromLiteral("::ffff:192.0.2.1"), StringFromLiteral("null"),
+                                        StringFromLiteral("/"), StringFromLiteral("null"), StringFromLiteral("null")}},
+        },
+        {
+            .input = StringFromLiteral("http://[fe80::]/"),
+            .expected = {.result = 1,
+                         .components = {StringFromLiteral("http"), StringFromLiteral("null"),
+                                        StringFromLiteral("fe80::"), StringFromLiteral("null"),
+                                        StringFromLiteral("/"), StringFromLiteral("null"), StringFromLiteral("null")}},
+        },
+        {
+            .input = StringFromLiteral("http://[]/"),
+            .expected = {.result = 0, .errorIndex = 8},
+        },
+        {
+            .input = StringFromLiteral("http://[:::.]/"),
+            .expected = {.result = 0, .errorIndex = 10},
+        },
+        {
+            .input = StringFromLiteral("http://[1::2::3]/"),
+            .expected = {.result = 0, .errorIndex = 13},
+        },
+        {
+            .input = StringFromLiteral("http://[12345::]/"),
+            .expected = {.result = 0, .errorIndex = 12},
+        },
+        {
+            .input = StringFromLiteral("http://[1:2]/"),
+            .expected = {.result = 0, .errorIndex = 11},
+        },
+        {
+            .input = StringFromLiteral("http://[1:]/"),
+            .expected = {.result = 0, .errorIndex = 10},
+        },
+        {
+            .input = StringFromLiteral("http://[::1.2.3]/"),
+            .expected = {.result = 0, .errorIndex = 15},
+        },
+        {
+            .input = StringFromLiteral("http://[1.2.3.4::]/"),
+            .expected = {.result = 0, .errorIndex = 15},
+        },
+        {
+            .input = StringFromLiteral("http://[::256.0.0.1]/"),
+            .expected = {.result = 0, .errorIndex = 10},
+        },
+        {
+            .input = StringFromLiteral("http://exa mple.com/"),
+            .expected = {.result = 0, .errorIndex = 10},
+        },
+        {
+            .input = StringFromLiteral("/a b"),
+            .expected = {.result = 0, .errorIndex = 2},
+        },
+        {
+            .input = StringFromLiteral("/a?b=%zz"),
+            .expected = {.result = 0, .errorIndex = 5},
+        },
+        {
+            .input = StringFromLiteral("/a#b#c"),
+            .expected = {.result = 0, .errorIndex = 4},
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      struct url url;
+      u64 errorIndex = 0;
+      b8 result = URLParse(&testCase->input, &url, &errorIndex);
+      struct string got[7] = {url.scheme, url.userInfo, url.host, url.port, url.path, url.query, url.fragment};
+
+      b8 isMatching = result == testCase->expected.result;
+      if (isMatching && result) {
+        for (u32 index = 0; index < ARRAY_COUNT(got); index++) {
+          struct string *expected = testCase->expected.components + index;
+          if (IsStringEqual(expected, &StringFromLiteral("null")) ? !IsStringNull(&got[index])
+                                                                  : IsStringNull(&got[index]) ||
+                                                                        !IsStringEqual(&got[index], expected))
+            isMatching = 0;
+        }
+      } else if (isMatching) {
+        isMatching = errorIndex == testCase->expected.errorIndex;
+      }
+
+      if (!isMatching) {
+        errorCode = TEXT_TEST_ERROR_URL_PARSE;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n     input: ");
+        StringBuilderAppendString(sb, &testCase->input);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendBool(sb, testCase->expected.result);
+        StringBuilderAppendStringLiteral(sb, " ");
+        StringBuilderAppendU64(sb, testCase->expected.errorIndex);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendBool(sb, result);
+        StringBuilderAppendStringLiteral(sb, " ");
+        StringBuilderAppendU64(sb, errorIndex);
+        for (u32 index = 0; result && index < ARRAY_COUNT(got); index++) {
+          StringBuilderAppendStringLiteral(sb, " '");
+          if (!IsStringNull(&got[index]))
+            StringBuilderAppendString(sb, &got[index]);
+          StringBuilderAppendStringLiteral(sb, "'");
+        }
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // b8 URLQueryIteratorNext(struct url_query_iterator *iterator, struct string *key, struct string *value)
+  // Dependencies: IsStringEqual()
+  if (IsStringEqualOK) {
+    struct string query = StringFromLiteral("a=1&&flag&empty=&q=x%3Dy+z&");
+    struct string expected[] = {
+        StringFromLiteral("a"),     StringFromLiteral("1"), StringFromLiteral("flag"), StringFromLiteral("null"),
+        StringFromLiteral("empty"), StringFromLiteral(""),  StringFromLiteral("q"),    StringFromLiteral("x=y z"),
+    };
+
+    u8 buffer[64];
+    MemoryCopy(buffer, query.value, query.length);
+    struct string input = StringFromBuffer(buffer, query.length);
+    struct url_query_iterator iterator = URLQueryIteratorFrom(&input);
+    struct string key, value;
+    u32 expectedIndex = 0;
+    while (URLQueryIteratorNext(&iterator, &key, &value)) {
+      if (!IsStringNull(&value))
+        value = PercentDecode(&value, PERCENT_DECODE_FLAG_PLUS_AS_SPACE, 0);
+
+      b8 isExpectedNull = expectedIndex + 1 < ARRAY_COUNT(expected) &&
+                          IsStringEqual(&expected[expectedIndex + 1], &StringFromLiteral("null"));
+      if (expectedIndex + 1 >= ARRAY_COUNT(expected) || !IsStringEqual(&key, &expected[expectedIndex]) ||
+          (isExpectedNull ? !IsStringNull(&value)
+                          : IsStringNull(&value) || !IsStringEqual(&value, &expected[expectedIndex + 1]))) {
+        errorCode = TEXT_TEST_ERROR_URL_QUERY_ITERATOR;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  parameter: ");
+        StringBuilderAppendU64(sb, expectedIndex / 2);
+        StringBuilderAppendStringLiteral(sb, "\n        got: ");
+        StringBuilderAppendString(sb, &key);
+        StringBuilderAppendStringLiteral(sb, " = ");
+        if (!IsStringNull(&value))
+          StringBuilderAppendString(sb, &value);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+        break;
+      }
+      expectedIndex += 2;
+    }
+
+    if (expectedIndex != ARRAY_COUNT(expected) && errorCode != TEXT_TEST_ERROR_URL_QUERY_ITERATOR) {
+      errorCode = TEXT_TEST_ERROR_URL_QUERY_ITERATOR;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n  expected parameter count: ");
+      StringBuilderAppendU64(sb, ARRAY_COUNT(expected) / 2);
+      StringBuilderAppendStringLiteral(sb, "\n                       got: ");
+      StringBuilderAppendU64(sb, expectedIndex / 2);
+      StringBuilderAppendStringLiteral(sb, "\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+  }
+
+  // u64 StringLength(struct string *string)
+  {
+    struct test_case {
+      struct string language;
+      struct string input;
+      u64 expected;
+    } testCases[] = {
+        {
+            .language = StringFromLiteral("Greek"),
+            .input = StringFromLiteral("Σὲ γνωρίζω ἀπὸ τὴν κόψη"),
+            .expected = 23,
+        },
+        {
+            .language = StringFromLiteral("Russian"),
+            .input = StringFromLiteral("Зарегистрируйтесь сейчас на Десятую Международную Конференцию по Unicode, "
+                                       "которая состоится 10-12 марта 1997 года в Майнце в Германии."),
+            .expected = 134,
+        },
+        {
+            .language = StringFromLiteral("Braille"),
+            .input = StringFromLiteral("⡌⠁⠧⠑ ⠼⠁⠒  ⡍⠜⠇⠑⠹⠰⠎ ⡣⠕⠌"),
+            .expected = 21,
+        },
+        {
+            .language = StringFromLiteral("Arabic"),
+            .input = StringFromLiteral("مرحبا"),
+            .expected = 5,
+        },
+        {
+            .language = StringFromLiteral("Cantonese Chinese"),
+            .input = StringFromLiteral("哈囉"),
+            .expected = 2,
+        },
+        {
+            .language = StringFromLiteral("Japanese"),
+            .input = StringFromLiteral("こんにちは"),
+            .expected = 5,
+        },
+        {
+            .language = StringFromLiteral("Korean"),
+            .input = StringFromLiteral("안녕하세요"),
+            .expected = 5,
+        },
+        {
+            .language = StringFromLiteral("Mandarin Chinese"),
+            .input = StringFromLiteral("你好"),
+            .expected = 2,
+        },
+        {
+            .language = StringFromLiteral("Polish"),
+            .input = StringFromLiteral("Cześć"),
+            .expected = 5,
+        },
+        {
+            .language = StringFromLiteral("Urdu"),
+            .input = StringFromLiteral("سلام"),
+            .expected = 4,
+        },
+        {
+            .language = StringFromLiteral("Vietnamese"),
+            .input = StringFromLiteral("Xin chào"),
+            .expected = 8,
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      struct string *input = &testCase->input;
+      u64 expected = testCase->expected;
+      u64 got = StringLength(input);
+
+      if (got != expected) {
+        errorCode = TEXT_TEST_ERROR_STRING_LENGTH_NOT_CORRECT;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n language: ");
+        StringBuilderAppendString(sb, &testCase->language);
+        StringBuilderAppendStringLiteral(sb, "\n    input: ");
+        StringBuilderAppendString(sb, input);
+        StringBuilderAppendStringLiteral(sb, "\n expected: ");
+        StringBuilderAppendU64(sb, expected);
+        StringBuilderAppendStringLiteral(sb, "\n      got: ");
+        StringBuilderAppendU64(sb, got);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+
+    // all languages joined at every offset, crossing vector widths
+    u8 textBuffer[1024];
+    for (u64 offset = 0; offset < 64; offset++) {
+      u64 textLength = offset;
+      u64 expected = offset;
+      for (u64 index = 0; index < offset; index++)
+        textBuffer[index] = 'a';
+      for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+        struct test_case *testCase = testCases + testCaseIndex;
+        debug_assert(textLength + testCase->input.length <= ARRAY_COUNT(textBuffer));
+        MemoryCopy(textBuffer + textLength, testCase->input.value, testCase->input.length);
+        textLength += testCase->input.length;
+        expected += testCase->expected;
+      }
+
+      struct string text = StringFromBuffer(textBuffer, textLength);
+      u64 got = StringLength(&text);
+      if (got != expected) {
+        errorCode = TEXT_TEST_ERROR_STRING_LENGTH_NOT_CORRECT;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n   offset: ");
+        StringBuilderAppendU64(sb, offset);
+        StringBuilderAppendStringLiteral(sb, "\n expected: ");
+        StringBuilderAppendU64(sb, expected);
+        StringBuilderAppendStringLiteral(sb, "\n      got: ");
+        StringBuilderAppendU64(sb, got);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+        break;
+      }
+    }
+  }
+
+  // u32 StringIteratorNext(struct string_iterator *iterator)
+  {
+    struct test_case_expected {
+      u64 length;
+      u32 *codepoints;
+    };
+
+    struct test_case {
+      struct string language;
+      struct string input;
+      struct test_case_expected expected;
+    } testCases[] = {
+        {
+            .language = StringFromLiteral("Arabic"),
+            .input = StringFromLiteral("مرحبا"),
+            .expected =
+                {
+                    .length = 5,
+                    .codepoints =
+                        (u32[]){
+                            0x0645,
+                            0x0631,
+                            0x062D,
+                            0x0628,
+                            0x0627,
+                        },
+                },
+        },
+        {
+            .language = StringFromLiteral("Cantonese Chinese"),
+            .input = StringFromLiteral("哈囉"),
+            .expected =
+                {
+                    .length = 2,
+                    .codepoints =
+                        (u32[]){
+                            0x54C8,
+                            0x56C9,
+                        },
+                },
+        },
+        {
+            .language = StringFromLiteral("Japanese"),
+            .input = StringFromLiteral("こんにちは"),
+            .expected =
+                {
+                    .length = 5,
+                    .codepoints =
+                        (u32[]){
+                            0x3053,
+                            0x3093,
+                            0x306B,
+                            0x3061,
+                            0x306F,
+                        },
+                },
+        },
+        {
+            .language = StringFromLiteral("Korean"),
+            .input = StringFromLiteral("안녕하세요"),
+            .expected =
+                {
+                    .length = 5,
+                    .codepoints =
+                        (u32[]){
+                            0xC548,
+                            0xB155,
+                            0xD558,
+                            0xC138,
+                            0xC694,
+                        },
+                },
+        },
+        {
+            .language = StringFromLiteral("Mandarin Chinese"),
+            .input = StringFromLiteral("你好"),
+            .expected =
+                {
+                    .length = 2,
+                    .codepoints =
+                        (u32[]){
+                            0x4F60,
+                            0x597D,
+                        },
+                },
+        },
+        {
+            .language = StringFromLiteral("Polish"),
+            .input = StringFromLiteral("Cześć"),
+            .expected =
+                {
+                    .length = 5,
+                    .codepoints =
+                        (u32[]){
+                            0x0043,
+                            0x007A,
+                            0x0065,
+                            0x015B,
+                            0x0107,
+                        },
+                },
+        },
+        {
+            .language = StringFromLiteral("Urdu"),
+            .input = StringFromLiteral("سلام"),
+            .expected =
+                {
+                    .length = 4,
+                    .codepoints =
+                        (u32[]){
+                            0x0633,
+                            0x0644,
+                            0x0627,
+                            0x0645,
+                        },
+                },
+        },
+        {
+            .language = StringFromLiteral("Vietnamese"),
+            .input = StringFromLiteral("Xin chào"),
+            .expected =
+                {
+                    .length = 8,
+                    .codepoints =
+                        (u32[]){
+                            0x0058,
+                            0x0069,
+                            0x006E,
+                            0x0020,
+                            0x0063,
+                            0x0068,
+                            0x00E0,
+                            0x006F,
+                        },
+                },
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      struct string *input = &testCase->input;
+      struct test_case_expected *expected = &testCase->expected;
+      b8 isInputShown = 0;
+
+      u64 index = 0;
+      for (struct string_iterator iterator = StringIteratorFrom(input); StringIteratorHasNext(&iterator); index++) {
+
+        if (index >= expected->length) {
+          errorCode = TEXT_TEST_ERROR_STRING_ITERATOR_LOOP_OVERFLOW;
+
+          StringBuilderAppendErrorMessage(sb, errorCode);
+          if (!isInputShown) {
+            StringBuilderAppendStringLiteral(sb, "\n language: ");
+            StringBuilderAppendString(sb, &testCase->language);
+            StringBuilderAppendStringLiteral(sb, "\n    input: ");
+            StringBuilderAppendString(sb, input);
+            isInputShown = 1;
+          }
+          StringBuilderAppendStringLiteral(sb, "\n  maximum length: ");
+          StringBuilderAppendU64(sb, expected->length);
+
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+          break;
+        }
+
+        u32 expectedCodepoint = *(expected->codepoints + index);
+        u32 codepoint = StringIteratorNext(&iterator);
+        if (codepoint != expectedCodepoint) {
+          errorCode = TEXT_TEST_ERROR_STRING_ITERATOR_DECODE_UTF8;
+
+          if (!isInputShown) {
+            StringBuilderAppendErrorMessage(sb, errorCode);
+            StringBuilderAppendStringLiteral(sb, "\n  language: ");
+            StringBuilderAppendString(sb, &testCase->language);
+            StringBuilderAppendStringLiteral(sb, "\n     input: ");
+            StringBuilderAppendString(sb, input);
+            StringBuilderAppendStringLiteral(sb, "\n");
+            isInputShown = 1;
+          }
+
+          StringBuilderAppendStringLiteral(sb, "\n     index: ");
+          StringBuilderAppendU64(sb, index);
+          StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+          StringBuilderAppendCodepoint(sb, expectedCodepoint);
+          StringBuilderAppendStringLiteral(sb, "\n       got: ");
+          StringBuilderAppendCodepoint(sb, codepoint);
+          StringBuilderAppendStringLiteral(sb, "\n");
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+        }
+      }
+    }
+  }
+
+  // b8 StringIndexOfInvalidUTF8(struct string *string, u64 *index)
+  {
+    struct test_case {
+      struct string input;
+      struct {
+        b8 result;
+        u64 index;
+      } expected;
+    } testCases[] = {
+        {
+            .input = StringFromLiteral(""),
+            .expected = {.result = 0},
+        },
+        {
+            .input = StringFromLiteral("hello"),
+            .expected = {.result = 0},
+        },
+        {
+            .input = StringFromLiteral("Σὲ γνωρίζω ἀπὸ τὴν κόψη"),
+            .expected = {.result = 0},
+        },
+        {
+            .input = StringFromLiteral("\xf0\x9f\x98\x80 \xf4\x8f\xbf\xbf \xed\x9f\xbf \xee\x80\x80"),
+            .expected = {.result = 0},
+        },
+        {
+            // overlong '/'
+            .input = StringFromLiteral("\xc0\xaf"),
+            .expected = {.result = 1, .index = 0},
+        },
+        {
+            // overlong 3 byte
+            .input = StringFromLiteral("a\xe0\x80\xaf"),
+            .expected = {.result = 1, .index = 1},
+        },
+        {
+            // overlong 4 byte
+            .input = StringFromLiteral("a\xf0\x80\x80\xaf"),
+            .expected = {.result = 1, .index = 1},
+        },
+        {
+            // U+D800
+            .input = StringFromLiteral("ab\xed\xa0\x80"),
+            .expected = {.result = 1, .index = 2},
+        },
+        {
+            // U+110000
+            .input = StringFromLiteral("\xf4\x90\x80\x80"),
+            .expected = {.result = 1, .index = 0},
+        },
+        {
+            .input = StringFromLiteral("\xf5\x80\x80\x80"),
+            .expected = {.result = 1, .index = 0},
+        },
+        {
+            .input = StringFromLiteral("\xff"),
+            .expected = {.result = 1, .index = 0},
+        },
+        {
+            // stray continuation
+            .input = StringFromLiteral("abc\x80"),
+            .expected = {.result = 1, .index = 3},
+        },
+        {
+            // truncated
+            .input = StringFromLiteral("abc\xe2\x82"),
+            .expected = {.result = 1, .index = 3},
+        },
+        {
+            .input = StringFromLiteral("\xe2\x82" "abc"),
+            .expected = {.result = 1, .index = 0},
+        },
+        {
+            // too long
+            .input = StringFromLiteral("\xf0\x9f\x98\x80\x80"),
+            .expected = {.result = 1, .index = 4},
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      struct string *input = &testCase->input;
+      u64 index = 0;
+      b8 result = StringIndexOfInvalidUTF8(input, &index);
+      b8 isValid = IsStringValidUTF8(input);
+      if (result != testCase->expected.result || (result && index != testCase->expected.index) || isValid == result) {
+        errorCode = testCase->expected.result ? TEXT_TEST_ERROR_UTF8_EXPECTED_INVALID : TEXT_TEST_ERROR_UTF8_EXPECTED_VALID;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n     input: ");
+        StringBuilderAppendHexEncoded(sb, input);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendBool(sb, testCase->expected.result);
+        StringBuilderAppendStringLiteral(sb, " at ");
+        StringBuilderAppendU64(sb, testCase->expected.index);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendBool(sb, result);
+        StringBuilderAppendStringLiteral(sb, " at ");
+        StringBuilderAppendU64(sb, index);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // invalid sequence at every codepoint boundary of long text, crossing vector widths
+  // b8 UTF8ValidatorUpdate(struct utf8_validator *validator, struct string *chunk)
+  {
+    struct string sample = StringFromLiteral("Σὲ γνωρίζω ἀπὸ τὴν κόψη, Зарегистрируйтесь, こんにちは \xf0\x9f\x98\x80, Xin chào!");
+    struct string invalidSequences[] = {
+        StringFromLiteral("\xc0\xaf"),
+        StringFromLiteral("\xed\xa0\x80"),
+        StringFromLiteral("\x80"),
+        StringFromLiteral("\xe2\x82"),
+        StringFromLiteral("\xf4\x90\x80\x80"),
+    };
+
+    u8 textBuffer[256];
+    for (u32 sequenceIndex = 0; sequenceIndex < ARRAY_COUNT(invalidSequences); sequenceIndex++) {
+      struct string *invalidSequence = invalidSequences + sequenceIndex;
+      for (u64 expected = 0; expected <= sample.length; expected++) {
+        if (expected < sample.length && (sample.value[expected] & 0b11000000) == 0b10000000)
+          continue;
+
+        debug_assert(sample.length + invalidSequence->length <= ARRAY_COUNT(textBuffer));
+        MemoryCopy(textBuffer, sample.value, expected);
+        MemoryCopy(textBuffer + expected, invalidSequence->value, invalidSequence->length);
+        MemoryCopy(textBuffer + expected + invalidSequence->length, sample.value + expected, sample.length - expected);
+        struct string text = StringFromBuffer(textBuffer, sample.length + invalidSequence->length);
+
+        u64 index = 0;
+        b8 result = StringIndexOfInvalidUTF8(&text, &index);
+
+        // in 3 chunks, split at every position
+        b8 isStreamOK = 1;
+        u64 streamIndex = 0;
+        for (u64 split1 = 0; split1 <= text.length && isStreamOK; split1++) {
+          for (u64 split2 = split1; split2 <= text.length; split2++) {
+            struct string chunks[] = {
+                StringFromBuffer(text.value, split1),
+                StringFromBuffer(text.value + split1, split2 - split1),
+                StringFromBuffer(text.value + split2, text.length - split2),
+            };
+            struct utf8_validator validator = {0};
+            for (u32 chunkIndex = 0; chunkIndex < ARRAY_COUNT(chunks); chunkIndex++) {
+              if (!UTF8ValidatorUpdate(&validator, chunks + chunkIndex))
+                break;
+            }
+            if (UTF8ValidatorFinish(&validator) || validator.errorOffset != expected) {
+              isStreamOK = 0;
+              streamIndex = validator.errorOffset;
+              break;
+            }
+          }
+        }
+
+        if (!result || index != expected || !isStreamOK) {
+          errorCode = TEXT_TEST_ERROR_UTF8_EXPECTED_INVALID;
+
+          StringBuilderAppendErrorMessage(sb, errorCode);
+          StringBuilderAppendStringLiteral(sb, "\n  invalid sequence: ");
+          StringBuilderAppendHexEncoded(sb, invalidSequence);
+          StringBuilderAppendStringLiteral(sb, "\n          expected: ");
+          StringBuilderAppendU64(sb, expected);
+          StringBuilderAppendStringLiteral(sb, "\n               got: ");
+          StringBuilderAppendU64(sb, index);
+          if (!isStreamOK) {
+            StringBuilderAppendStringLiteral(sb, "\n   got from stream: ");
+            StringBuilderAppendU64(sb, streamIndex);
+          }
+          StringBuilderAppendStringLiteral(sb, "\n");
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+          break;
+        }
+      }
+    }
+
+    // valid text in chunks
+    for (u64 split1 = 0; split1 <= sample.length; split1++) {
+      for (u64 split2 = split1; split2 <= sample.length; split2++) {
+        struct string chunks[] = {
+            StringFromBuffer(sample.value, split1),
+            StringFromBuffer(sample.value + split1, split2 - split1),
+            StringFromBuffer(sample.value + split2, sample.length - split2),
+        };
+        struct utf8_validator validator = {0};
+        b8 isValid = 1;
+        for (u32 chunkIndex = 0; chunkIndex < ARRAY_COUNT(chunks); chunkIndex++)
+          isValid &= UTF8ValidatorUpdate(&validator, chunks + chunkIndex);
+        isValid &= UTF8ValidatorFinish(&validator);
+
+        if (!isValid || validator.offset != sample.length) {
+          errorCode = TEXT_TEST_ERROR_UTF8_EXPECTED_VALID;
+
+          StringBuilderAppendErrorMessage(sb, errorCode);
+          StringBuilderAppendStringLiteral(sb, "\n  chunks split at: ");
+          StringBuilderAppendU64(sb, split1);
+          StringBuilderAppendStringLiteral(sb, ", ");
+          StringBuilderAppendU64(sb, split2);
+          StringBuilderAppendStringLiteral(sb, "\n");
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+          split1 = sample.length;
+          break;
+        }
+      }
+    }
+  }
+
+  // struct string_utf16 StringToUTF16(memory_arena *arena, struct string *string, u64 *errorIndex)
+  // struct string_utf32 StringToUTF32(memory_arena *arena, struct string *string, u64 *errorIndex)
+  // struct string StringFromUTF16(memory_arena *arena, struct string_utf16 *string, u64 *errorIndex)
+  // struct string StringFromUTF32(memory_arena *arena, struct string_utf32 *string, u64 *errorIndex)
+  // Dependencies: IsStringEqual()
+  if (IsStringEqualOK) {
+    struct test_case {
+      struct string input;
+      u64 utf16Length;
+      u16 *utf16;
+      u64 utf32Length;
+      u32 *utf32;
+    } testCases[] = {
+        {
+            .input = StringFromLiteral(""),
+        },
+        {
+            .input = StringFromLiteral("aΣ€😀"),
+            .utf16Length = 5,
+            .utf16 = (u16[]){0x0061, 0x03a3, 0x20ac, 0xd83d, 0xde00},
+            .utf32Length = 4,
+            .utf32 = (u32[]){0x61, 0x3a3, 0x20ac, 0x1f600},
+        },
+        {
+            .input = StringFromLiteral("\xf4\x8f\xbf\xbf\xee\x80\x80"),
+            .utf16Length = 3,
+            .utf16 = (u16[]){0xdbff, 0xdfff, 0xe000},
+            .utf32Length = 2,
+            .utf32 = (u32[]){0x10ffff, 0xe000},
+        },
+        {
+            .input = StringFromLiteral("Zarejestruj się teraz na 10. Międzynarodową Konferencję"),
+            .utf16Length = 55,
+            .utf32Length = 55,
+        },
+        {
+            .input = StringFromLiteral("Σὲ γνωρίζω ἀπὸ τὴν κόψη, Зарегистрируйтесь, こんにちは 😀, Xin chào!"),
+            .utf16Length = 63,
+            .utf32Length = 62,
+        },
+        {
+            .input = StringFromLiteral("The quick brown fox jumps over the lazy dog, then over 😀 again and again and again"),
+            .utf16Length = 83,
+            .utf32Length = 82,
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+      struct string *input = &testCase->input;
+
+      memory_temp tempMemory = MemoryTempBegin(&stackMemory);
+
+      u64 errorIndex = 0;
+      struct string_utf16 utf16 = StringToUTF16(&stackMemory, input, &errorIndex);
+      struct string_utf32 utf32 = StringToUTF32(&stackMemory, input, &errorIndex);
+      b8 isEqual = utf16.value != 0 && utf16.length == testCase->utf16Length && utf32.value != 0 &&
+                   utf32.length == testCase->utf32Length;
+      if (isEqual && testCase->utf16)
+        isEqual = IsMemoryEqual(utf16.value, testCase->utf16, sizeof(*utf16.value) * utf16.length);
+      if (isEqual && testCase->utf32)
+        isEqual = IsMemoryEqual(utf32.value, testCase->utf32, sizeof(*utf32.value) * utf32.length);
+
+      struct string fromUTF16 = StringNull();
+      struct string fromUTF32 = StringNull();
+      if (isEqual) {
+        fromUTF16 = StringFromUTF16(&stackMemory, &utf16, &errorIndex);
+        fromUTF32 = StringFromUTF32(&stackMemory, &utf32, &errorIndex);
+        isEqual = IsStringEqual(&fromUTF16, input) && IsStringEqual(&fromUTF32, input);
+      }
+
+      if (!isEqual) {
+        errorCode = TEXT_TEST_ERROR_UTF_TRANSCODE;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n               input: ");
+        StringBuilderAppendString(sb, input);
+        StringBuilderAppendStringLiteral(sb, "\n  UTF-16 length expected: ");
+        StringBuilderAppendU64(sb, testCase->utf16Length);
+        StringBuilderAppendStringLiteral(sb, " got: ");
+        StringBuilderAppendU64(sb, utf16.length);
+        StringBuilderAppendStringLiteral(sb, "\n  UTF-32 length expected: ");
+        StringBuilderAppendU64(sb, testCase->utf32Length);
+        StringBuilderAppendStringLiteral(sb, " got: ");
+        StringBuilderAppendU64(sb, utf32.length);
+        StringBuilderAppendStringLiteral(sb, "\n         from UTF-16: ");
+        StringBuilderAppendPrintableString(sb, &fromUTF16);
+        StringBuilderAppendStringLiteral(sb, "\n         from UTF-32: ");
+        StringBuilderAppendPrintableString(sb, &fromUTF32);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+
+      MemoryTempEnd(&tempMemory);
+    }
+
+    // invalid input is reported at its position and arena is left unchanged
+    struct string invalidUTF8 = StringFromLiteral("0123456789abcdefghijklmnopqrstuvwxyz\xed\xa0\x80");
+    u16 invalidUTF16Units[40];
+    u32 invalidUTF32Codepoints[40];
+    for (u32 index = 0; index < ARRAY_COUNT(invalidUTF16Units); index++) {
+      invalidUTF16Units[index] = (u16)('a' + index % 26);
+      invalidUTF32Codepoints[index] = 'a' + index % 26;
+    }
+    invalidUTF16Units[36] = 0xdc00;
+    invalidUTF32Codepoints[36] = 0x110000;
+    struct string_utf16 invalidUTF16 = {.value = invalidUTF16Units, .length = ARRAY_COUNT(invalidUTF16Units)};
+    struct string_utf32 invalidUTF32 = {.value = invalidUTF32Codepoints, .length = ARRAY_COUNT(invalidUTF32Codepoints)};
+
+    u64 used = stackMemory.used;
+    u64 errorIndexes[4] = {0};
+    b8 isNull = StringToUTF16(&stackMemory, &invalidUTF8, errorIndexes + 0).value == 0 &&
+                StringToUTF32(&stackMemory, &invalidUTF8, errorIndexes + 1).value == 0 &&
+                StringFromUTF16(&stackMemory, &invalidUTF16, errorIndexes + 2).value == 0 &&
+                StringFromUTF32(&stackMemory, &invalidUTF32, errorIndexes + 3).value == 0;
+    b8 isErrorIndexCorrect = 1;
+    for (u32 index = 0; index < ARRAY_COUNT(errorIndexes); index++)
+      isErrorIndexCorrect &= errorIndexes[index] == 36;
+
+    if (!isNull || !isErrorIndexCorrect || stackMemory.used != used) {
+      errorCode = TEXT_TEST_ERROR_UTF_TRANSCODE_EXPECTED_FAIL;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n  error indexes expected: 36");
+      StringBuilderAppendStringLiteral(sb, "\n                     got:");
+      for (u32 index = 0; index < ARRAY_COUNT(errorIndexes); index++) {
+        StringBuilderAppendStringLiteral(sb, " ");
+        StringBuilderAppendU64(sb, errorIndexes[index]);
+      }
+      StringBuilderAppendStringLiteral(sb, "\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+
+    // output at its worst case size does not fit, string length is reported
+    u8 smallBuffer[64];
+    memory_arena smallMemory = {.block = smallBuffer, .total = sizeof(smallBuffer)};
+    struct string validUTF8 = StringFromBuffer(invalidUTF8.value, 36);
+    struct string_utf16 validUTF16 = {.value = invalidUTF16Units, .length = 36};
+    struct string_utf32 validUTF32 = {.value = invalidUTF32Codepoints, .length = 36};
+    u64 outOfMemoryIndexes[4] = {0};
+    isNull = StringToUTF16(&smallMemory, &validUTF8, outOfMemoryIndexes + 0).value == 0 &&
+             StringToUTF32(&smallMemory, &validUTF8, outOfMemoryIndexes + 1).value == 0 &&
+             StringFromUTF16(&smallMemory, &validUTF16, outOfMemoryIndexes + 2).value == 0 &&
+             StringFromUTF32(&smallMemory, &validUTF32, outOfMemoryIndexes + 3).value == 0;
+    isErrorIndexCorrect = 1;
+    for (u32 index = 0; index < ARRAY_COUNT(outOfMemoryIndexes); index++)
+      isErrorIndexCorrect &= outOfMemoryIndexes[index] == 36;
+
+    if (!isNull || !isErrorIndexCorrect || smallMemory.used != 0) {
+      errorCode = TEXT_TEST_ERROR_UTF_TRANSCODE_OUT_OF_MEMORY;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+  }
+
+  // u64 StringIteratorNextBatch(struct string_iterator *iterator, u32 *codepoints, u64 maxCount, u32 flags)
+  {
+    struct string inputs[] = {
+        StringFromLiteral("a"),
+        StringFromLiteral("The quick brown fox jumps over the lazy dog, then over 😀 again and again and again"),
+        StringFromLiteral("Σὲ γνωρίζω ἀπὸ τὴν κόψη, Зарегистрируйтесь, こんにちは 😀, Xin chào!"),
+    };
+    u64 batchSizes[] = {1, 7, 32, 64};
+
+    for (u32 inputIndex = 0; inputIndex < ARRAY_COUNT(inputs); inputIndex++) {
+      struct string *input = inputs + inputIndex;
+
+      u32 expected[128];
+      u64 expectedCount = 0;
+      for (struct string_iterator iterator = StringIteratorFrom(input); StringIteratorHasNext(&iterator);) {
+        debug_assert(expectedCount < ARRAY_COUNT(expected));
+        expected[expectedCount++] = StringIteratorNext(&iterator);
+      }
+
+      for (u32 batchSizeIndex = 0; batchSizeIndex < ARRAY_COUNT(batchSizes) * 2; batchSizeIndex++) {
+        u64 batchSize = batchSizes[batchSizeIndex % ARRAY_COUNT(batchSizes)];
+        u32 flags = batchSizeIndex < ARRAY_COUNT(batchSizes) ? STRING_ITERATOR_FLAG_NONE
+                                                             : STRING_ITERATOR_FLAG_BOUNDS_CHECKED;
+
+        u32 got[128];
+        u64 gotCount = 0;
+        struct string_iterator iterator = StringIteratorFrom(input);
+        u64 count;
+        while ((count = StringIteratorNextBatch(&iterator, got + gotCount, batchSize, flags))) {
+          debug_assert(count <= batchSize);
+          gotCount += count;
+        }
+
+        if (gotCount != expectedCount || !IsMemoryEqual(got, expected, sizeof(*got) * gotCount)) {
+          errorCode = TEXT_TEST_ERROR_STRING_ITERATOR_BATCH;
+
+          StringBuilderAppendErrorMessage(sb, errorCode);
+          StringBuilderAppendStringLiteral(sb, "\n       input: ");
+          StringBuilderAppendString(sb, input);
+          StringBuilderAppendStringLiteral(sb, "\n  batch size: ");
+          StringBuilderAppendU64(sb, batchSize);
+          StringBuilderAppendStringLiteral(sb, "\n       flags: ");
+          StringBuilderAppendU64(sb, flags);
+          StringBuilderAppendStringLiteral(sb, "\n    expected: ");
+          StringBuilderAppendU64(sb, expectedCount);
+          StringBuilderAppendStringLiteral(sb, " codepoints");
+          StringBuilderAppendStringLiteral(sb, "\n         got: ");
+          StringBuilderAppendU64(sb, gotCount);
+          StringBuilderAppendStringLiteral(sb, " codepoints\n");
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+          break;
+        }
+      }
+    }
+
+    // bounds checked decoding of malformed input
+    struct test_case {
+      struct string input;
+      u64 expectedCount;
+      u32 *expected;
+    } testCases[] = {
+        {
+            .input = StringFromLiteral("ab\xe2\x82"),
+            .expectedCount = 4,
+            .expected = (u32[]){'a', 'b', 0xfffd, 0xfffd},
+        },
+        {
+            .input = StringFromLiteral("\xf0\x9f\x98"),
+            .expectedCount = 3,
+            .expected = (u32[]){0xfffd, 0xfffd, 0xfffd},
+        },
+        {
+            .input = StringFromLiteral("\xc0\xafz\xe2\x82\xac"),
+            .expectedCount = 4,
+            .expected = (u32[]){0xfffd, 0xfffd, 'z', 0x20ac},
+        },
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+      struct string *input = &testCase->input;
+
+      u32 got[8];
+      struct string_iterator iterator = StringIteratorFrom(input);
+      u64 gotCount = StringIteratorNextBatch(&iterator, got, ARRAY_COUNT(got), STRING_ITERATOR_FLAG_BOUNDS_CHECKED);
+      if (gotCount != testCase->expectedCount || !IsMemoryEqual(got, testCase->expected, sizeof(*got) * gotCount) ||
+          iterator.index != input->length) {
+        errorCode = TEXT_TEST_ERROR_STRING_ITERATOR_BATCH;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n     input: ");
+        StringBuilderAppendHexEncoded(sb, input);
+        StringBuilderAppendStringLiteral(sb, "\n  expected:");
+        for (u64 index = 0; index < testCase->expectedCount; index++) {
+          StringBuilderAppendStringLiteral(sb, " ");
+          StringBuilderAppendCodepoint(sb, testCase->expected[index]);
+        }
+        StringBuilderAppendStringLiteral(sb, "\n       got:");
+        for (u64 index = 0; index < gotCount; index++) {
+          StringBuilderAppendStringLiteral(sb, " ");
+          StringBuilderAppendCodepoint(sb, got[index]);
+        }
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // u64 StringHash(struct string *string, u64 seed)
+  {
+    // wyhash reference vectors, seed is index
+    struct string wyhashInputs[] = {
+        StringFromLiteral(""),
+        StringFromLiteral("a"),
+        StringFromLiteral("abc"),
+        StringFromLiteral("message digest"),
+        StringFromLiteral("abcdefghijklmnopqrstuvwxyz"),
+        StringFromLiteral("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789"),
+        StringFromLiteral("12345678901234567890123456789012345678901234567890123456789012345678901234567890"),
+    };
+    u64 wyhashExpected[] = {
+        0x0409638ee2bde459, 0xa8412d091b5fe0a9, 0x32dd92e4b2915153, 0x8619124089a3a16b,
+        0x7a43afb61d7f5f40, 0xff42329b90e50d58, 0xc39cab13b115aad3,
+    };
+    for (u32 index = 0; index < ARRAY_COUNT(wyhashInputs); index++) {
+      u64 got = StringHash(wyhashInputs + index, index);
+      if (got != wyhashExpected[index]) {
+        errorCode = TEXT_TEST_ERROR_STRING_HASH_KNOWN_ANSWER;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n     input: ");
+        StringBuilderAppendString(sb, wyhashInputs + index);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendHex(sb, wyhashExpected[index]);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendHex(sb, got);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+
+    u8 inputBuffer[5000];
+    for (u32 index = 0; index < ARRAY_COUNT(inputBuffer); index++)
+      inputBuffer[index] = (u8)(index * 131 + 7);
+
+    // long inputs, must be same with and without SIMD
+    struct test_case {
+      u64 length;
+      u64 expected;
+    } testCases[] = {
+        {.length = 256, .expected = 0x4a2f4acabdaa9740},  {.length = 257, .expected = 0x5eff0b369f5aa4a9},
+        {.length = 320, .expected = 0x81b86f0c8d997743},  {.length = 1024, .expected = 0xdb48754307d98ee5},
+        {.length = 1025, .expected = 0x81e0cd4ad5e23205}, {.length = 4999, .expected = 0x7597e12fe61b1e9a},
+    };
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+      struct string input = StringFromBuffer(inputBuffer, testCase->length);
+      u64 got = StringHash(&input, 0x1234);
+      if (got != testCase->expected) {
+        errorCode = TEXT_TEST_ERROR_STRING_HASH_KNOWN_ANSWER;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n    length: ");
+        StringBuilderAppendU64(sb, testCase->length);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendHex(sb, testCase->expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendHex(sb, got);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+
+    // compile-time form
+    comptime u64 helpHash = StringHashLiteral("--help", 42);
+    struct {
+      struct string input;
+      u64 literalHash;
+    } literals[] = {
+        {StringFromLiteral(""), StringHashLiteral("", 42)},
+        {StringFromLiteral("a"), StringHashLiteral("a", 42)},
+        {StringFromLiteral("-c"), StringHashLiteral("-c", 42)},
+        {StringFromLiteral("abc"), StringHashLiteral("abc", 42)},
+        {StringFromLiteral("--help"), helpHash},
+        {StringFromLiteral("--count"), StringHashLiteral("--count", 42)},
+        {StringFromLiteral("--template"), StringHashLiteral("--template", 42)},
+        {StringFromLiteral("0123456789abcdef"), StringHashLiteral("0123456789abcdef", 42)},
+    };
+    for (u32 index = 0; index < ARRAY_COUNT(literals); index++) {
+      u64 expected = StringHash(&literals[index].input, 42);
+      if (literals[index].literalHash != expected) {
+        errorCode = TEXT_TEST_ERROR_STRING_HASH_LITERAL;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n   literal: ");
+        StringBuilderAppendString(sb, &literals[index].input);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendHex(sb, expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendHex(sb, literals[index].literalHash);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+
+    // streaming in chunks gives same hash
+    u64 chunkSizes[] = {1, 63, 256, 300};
+    for (u64 length = 0; length <= 1100 && errorCode != TEXT_TEST_ERROR_STRING_HASHER; length++) {
+      struct string input = StringFromBuffer(inputBuffer, length);
+      u64 expected = StringHash(&input, 7);
+      for (u32 chunkSizeIndex = 0; chunkSizeIndex < ARRAY_COUNT(chunkSizes); chunkSizeIndex++) {
+        u64 chunkSize = chunkSizes[chunkSizeIndex];
+        struct string_hasher hasher = StringHasherFrom(7);
+        for (u64 position = 0; position < length; position += chunkSize) {
+          u64 remaining = length - position;
+          struct string chunk = StringFromBuffer(inputBuffer + position, remaining < chunkSize ? remaining : chunkSize);
+          StringHasherUpdate(&hasher, &chunk);
+        }
+
+        u64 got = StringHasherDigest(&hasher);
+        if (got != expected) {
+          errorCode = TEXT_TEST_ERROR_STRING_HASHER;
+
+          StringBuilderAppendErrorMessage(sb, errorCode);
+          StringBuilderAppendStringLiteral(sb, "\n      length: ");
+          StringBuilderAppendU64(sb, length);
+          StringBuilderAppendStringLiteral(sb, "\n  chunk size: ");
+          StringBuilderAppendU64(sb, chunkSize);
+          StringBuilderAppendStringLiteral(sb, "\n    expected: ");
+          StringBuilderAppendHex(sb, expected);
+          StringBuilderAppendStringLiteral(sb, "\n         got: ");
+          StringBuilderAppendHex(sb, got);
+          StringBuilderAppendStringLiteral(sb, "\n");
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+          break;
+        }
+      }
+    }
+  }
+
+  // Quality tests in style of SMHasher
+  // u64 StringHash(struct string *string, u64 seed)
+  {
+    u64 random = 0x9e3779b97f4a7c15;
+#define NEXT_RANDOM() (random ^= random << 13, random ^= random >> 7, random ^= random << 17)
+
+    /*
+     * Avalanche: flipping any input bit must flip every output bit with
+     * probability close to 1/2.
+     * key length 0 flips seed bits instead.
+     */
+    u64 keyLengths[] = {0, 3, 8, 16, 40, 256, 300, 1100};
+    u8 key[1100];
+    for (u32 keyLengthIndex = 0; keyLengthIndex < ARRAY_COUNT(keyLengths); keyLengthIndex++) {
+      u64 keyLength = keyLengths[keyLengthIndex];
+      u64 bitCount = keyLength == 0 ? 64 : keyLength * 8;
+      // sample long keys
+      u64 bitStep = bitCount > 512 ? 13 : 1;
+      u32 trialCount = 64;
+
+      u32 outputFlipCounts[64] = {0};
+      u64 sampleCount = 0;
+      b8 isInputBitBiased = 0;
+      for (u64 bit = 0; bit < bitCount; bit += bitStep) {
+        u32 inputBitFlipCount = 0;
+        for (u32 trial = 0; trial < trialCount; trial++) {
+          for (u64 index = 0; index < keyLength; index++)
+            key[index] = (u8)NEXT_RANDOM();
+          u64 seed = NEXT_RANDOM();
+
+          struct string input = StringFromBuffer(key, keyLength);
+          u64 hash = StringHash(&input, seed);
+          if (keyLength == 0)
+            seed ^= (u64)1 << bit;
+          else
+            key[bit / 8] ^= (u8)(1 << (bit % 8));
+          u64 flipped = hash ^ StringHash(&input, seed);
+
+          inputBitFlipCount += (u32)__builtin_popcountll(flipped);
+          for (u32 outputBit = 0; outputBit < 64; outputBit++)
+            outputFlipCounts[outputBit] += (flipped >> outputBit) & 1;
+        }
+        sampleCount += trialCount;
+
+        // trialCount * 64 samples, 0.45 and 0.55 are more than 6 standard deviations away
+        f64 probability = (f64)inputBitFlipCount / (f64)(trialCount * 64);
+        if (probability < 0.45 || probability > 0.55)
+          isInputBitBiased = 1;
+      }
+
+      b8 isOutputBitBiased = 0;
+      for (u32 outputBit = 0; outputBit < 64; outputBit++) {
+        f64 probability = (f64)outputFlipCounts[outputBit] / (f64)sampleCount;
+        if (probability < 0.45 || probability > 0.55)
+          isOutputBitBiased = 1;
+      }
+
+      if (isInputBitBiased || isOutputBitBiased) {
+        errorCode = TEXT_TEST_ERROR_STRING_HASH_AVALANCHE;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  key length: ");
+        StringBuilderAppendU64(sb, keyLength);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+#undef NEXT_RANDOM
+
+    /*
+     * Collisions: sparse keys, all 2 byte keys and zero keys of every length
+     * must not collide.
+     */
+    enum { HASH_SET_CAPACITY = 1 << 18 };
+    static u64 hashSet[HASH_SET_CAPACITY];
+    static b8 isHashSetUsed[HASH_SET_CAPACITY];
+    u64 collisionCount = 0;
+    u64 keyCount = 0;
+#define INSERT_HASH(hashValue)                                                                                         \
+  {                                                                                                                    \
+    u64 hashToInsert = (hashValue);                                                                                    \
+    u64 slot = hashToInsert & (HASH_SET_CAPACITY - 1);                                                                 \
+    while (isHashSetUsed[slot] && hashSet[slot] != hashToInsert)                                                       \
+      slot = (slot + 1) & (HASH_SET_CAPACITY - 1);                                                                     \
+    collisionCount += isHashSetUsed[slot];                                                                             \
+    isHashSetUsed[slot] = 1;                                                                                           \
+    hashSet[slot] = hashToInsert;                                                                                      \
+    keyCount++;                                                                                                        \
+  }
+
+    // 32 byte keys with at most 2 bits set
+    MemoryClear(key, 32);
+    struct string sparseKey = StringFromBuffer(key, 32);
+    INSERT_HASH(StringHash(&sparseKey, 0));
+    for (u32 bit1 = 0; bit1 < 256; bit1++) {
+      key[bit1 / 8] ^= (u8)(1 << (bit1 % 8));
+      INSERT_HASH(StringHash(&sparseKey, 0));
+      for (u32 bit2 = bit1 + 1; bit2 < 256; bit2++) {
+        key[bit2 / 8] ^= (u8)(1 << (bit2 % 8));
+        INSERT_HASH(StringHash(&sparseKey, 0));
+        key[bit2 / 8] ^= (u8)(1 << (bit2 % 8));
+      }
+      key[bit1 / 8] ^= (u8)(1 << (bit1 % 8));
+    }
+
+    // 2 byte keys, they differ from sparse keys by length
+    for (u32 value = 0; value <= U16_MAX; value++) {
+      key[0] = (u8)value;
+      key[1] = (u8)(value >> 8);
+      struct string twoByteKey = StringFromBuffer(key, 2);
+      INSERT_HASH(StringHash(&twoByteKey, 0));
+    }
+
+    // zero keys, only length differs
+    MemoryClear(key, ARRAY_COUNT(key));
+    for (u64 length = 3; length <= ARRAY_COUNT(key); length++) {
+      if (length == 32)
+        continue;
+      struct string zeroKey = StringFromBuffer(key, length);
+      INSERT_HASH(StringHash(&zeroKey, 0));
+    }
+#undef INSERT_HASH
+
+    if (collisionCount != 0) {
+      errorCode = TEXT_TEST_ERROR_STRING_HASH_COLLISION;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n       keys: ");
+      StringBuilderAppendU64(sb, keyCount);
+      StringBuilderAppendStringLiteral(sb, "\n  collisions: ");
+      StringBuilderAppendU64(sb, collisionCount);
+      StringBuilderAppendStringLiteral(sb, "\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+  }
+
+  // STRING_SWITCH(functionName, valueType, LIST, defaultValue)
+  {
+    struct test_case {
+      struct string input;
+      enum keyword expected;
+    } testCases[] = {
+        {.input = StringFromLiteral("if"), .expected = KEYWORD_IF},
+        {.input = StringFromLiteral("else"), .expected = KEYWORD_ELSE},
+        {.input = StringFromLiteral("while"), .expected = KEYWORD_WHILE},
+        {.input = StringFromLiteral("return"), .expected = KEYWORD_RETURN},
+        {.input = StringFromLiteral("ret"), .expected = KEYWORD_RETURN},
+        {.input = StringFromLiteral("sixteen_bytes_ok"), .expected = KEYWORD_LONG},
+        {.input = StringFromLiteral("sixteen_bytes_ok!"), .expected = KEYWORD_UNKNOWN},
+        {.input = StringFromLiteral("sixteen_bytes_oK"), .expected = KEYWORD_UNKNOWN},
+        {.input = StringFromLiteral("--a-very-long-option-name"), .expected = KEYWORD_OPTION},
+        {.input = StringFromLiteral("--a-very-long-option-game"), .expected = KEYWORD_OPTION},
+        {.input = StringFromLiteral("--a-very-long-option-nam"), .expected = KEYWORD_UNKNOWN},
+        {.input = StringFromLiteral("--a-very-long-option-same"), .expected = KEYWORD_UNKNOWN},
+        {.input = StringFromLiteral("literal that is longer than every switch case"), .expected = KEYWORD_SENTENCE},
+        {.input = StringFromLiteral("literal that is longer than every switch cast"), .expected = KEYWORD_SENTENCE},
+        {.input = StringFromLiteral("literal that is longer than every switch cases"), .expected = KEYWORD_UNKNOWN},
+        {.input = StringFromLiteral("Literal that is longer than every switch case"), .expected = KEYWORD_UNKNOWN},
+        {.input = StringFromLiteral("If"), .expected = KEYWORD_UNKNOWN},
+        {.input = StringFromLiteral("i"), .expected = KEYWORD_UNKNOWN},
+        {.input = StringFromLiteral("if "), .expected = KEYWORD_UNKNOWN},
+        {.input = StringFromLiteral(""), .expected = KEYWORD_UNKNOWN},
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+      enum keyword got = ParseKeyword(&testCase->input);
+      if (got != testCase->expected) {
+        errorCode = TEXT_TEST_ERROR_STRING_SWITCH;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n     input: '");
+        StringBuilderAppendPrintableString(sb, &testCase->input);
+        StringBuilderAppendStringLiteral(sb, "'");
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendU64(sb, testCase->expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendU64(sb, got);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+
+    if (ParseKeyword(0) != KEYWORD_UNKNOWN) {
+      errorCode = TEXT_TEST_ERROR_STRING_SWITCH;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n  null string must map to default value\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+  }
+
+  // b8 StringSort(memory_arena *arena, struct string *strings, u64 count)
+  // b8 StringSortPartition(memory_arena *arena, struct string *strings, u64 count, u64 bucketStarts[258])
+  {
+    // few letters and long shared prefixes so that many strings are equal for more than 8 bytes
+    enum { STRING_COUNT = 2000 };
+    static u8 textBuffer[STRING_COUNT * 24];
+    static struct string strings[STRING_COUNT];
+    static struct string partitioned[STRING_COUNT];
+    u64 random = 0x9e3779b97f4a7c15;
+    u64 textLength = 0;
+    for (u32 index = 0; index < STRING_COUNT; index++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      u64 length = random % 24;
+      u8 *text = textBuffer + textLength;
+      for (u64 byteIndex = 0; byteIndex < length; byteIndex++) {
+        random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+        text[byteIndex] = byteIndex < 10 && (random & 7) != 0 ? 'k' : (u8)("\0\x01" "ab\xff"[random % 5]);
+      }
+      strings[index] = StringFromBuffer(text, length);
+      textLength += length;
+    }
+    MemoryCopy(partitioned, strings, sizeof(strings));
+
+    u64 checksum = 0;
+    for (u32 index = 0; index < STRING_COUNT; index++)
+      checksum += (u64)strings[index].value;
+
+    static u8 sortBuffer[STRING_COUNT * 24];
+    memory_arena sortMemory = {.block = sortBuffer, .total = ARRAY_COUNT(sortBuffer)};
+    b8 isSorted = StringSort(&sortMemory, strings, STRING_COUNT);
+
+    u64 bucketStarts[258];
+    b8 isPartitioned = StringSortPartition(&sortMemory, partitioned, STRING_COUNT, bucketStarts);
+    for (u32 bucket = 0; bucket < 257 && isPartitioned; bucket++) {
+      isPartitioned &=
+          StringSort(&sortMemory, partitioned + bucketStarts[bucket], bucketStarts[bucket + 1] - bucketStarts[bucket]);
+    }
+
+    u64 sortedChecksum = 0;
+    u64 errorPosition = 0;
+    for (u32 index = 0; index < STRING_COUNT; index++) {
+      sortedChecksum += (u64)strings[index].value;
+      if ((index > 0 && StringCompare(strings + index - 1, strings + index) > 0) ||
+          StringCompare(strings + index, partitioned + index) != 0) {
+        errorPosition = index;
+        break;
+      }
+    }
+
+    if (!isSorted || !isPartitioned || sortMemory.used != 0 || errorPosition != 0 || sortedChecksum != checksum) {
+      errorCode = TEXT_TEST_ERROR_STRING_SORT;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n  out of order at: ");
+      StringBuilderAppendU64(sb, errorPosition);
+      StringBuilderAppendStringLiteral(sb, "\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+
+    // 1 MiB shared prefix, every 8 bytes deeper is loop, not recursion
+    {
+      enum { PREFIX_LENGTH = 1 << 20, PREFIX_STRING_COUNT = 17 };
+      static u8 prefixBuffer[PREFIX_LENGTH + PREFIX_STRING_COUNT];
+      for (u64 index = 0; index < ARRAY_COUNT(prefixBuffer); index++)
+        prefixBuffer[index] = 'x';
+      struct string prefixStrings[PREFIX_STRING_COUNT];
+      for (u32 index = 0; index < PREFIX_STRING_COUNT; index++)
+        prefixStrings[index] = StringFromBuffer(prefixBuffer, PREFIX_LENGTH + PREFIX_STRING_COUNT - 1 - index);
+
+      b8 isPrefixSorted = StringSort(&sortMemory, prefixStrings, PREFIX_STRING_COUNT);
+      for (u32 index = 0; index < PREFIX_STRING_COUNT && isPrefixSorted; index++)
+        isPrefixSorted = prefixStrings[index].length == PREFIX_LENGTH + index;
+
+      if (!isPrefixSorted) {
+        errorCode = TEXT_TEST_ERROR_STRING_SORT;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  strings with 1 MiB shared prefix must be shorter first\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+
+    // arena too small
+    memory_arena smallMemory = {.block = sortBuffer, .total = 100 * sizeof(struct string_sort_entry)};
+    struct string first = strings[0];
+    if (StringSort(&smallMemory, strings, 101) || smallMemory.used != 0 || strings[0].value != first.value) {
+      errorCode = TEXT_TEST_ERROR_STRING_SORT;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n  must fail and leave arena untouched when full\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+  }
+
+  // b8 StringEditDistance(memory_arena *arena, struct string *left, struct string *right, u64 maxDistance,
+  //                       u64 *distance)
+  {
+    struct test_case {
+      struct string left;
+      struct string right;
+      u64 maxDistance;
+      u64 expected;
+    } testCases[] = {
+        {.left = StringFromLiteral(""), .right = StringFromLiteral(""), .maxDistance = U64_MAX, .expected = 0},
+        {.left = StringFromLiteral(""), .right = StringFromLiteral("abc"), .maxDistance = U64_MAX, .expected = 3},
+        {.left = StringFromLiteral("abc"), .right = StringFromLiteral("abc"), .maxDistance = 0, .expected = 0},
+        {
+            .left = StringFromLiteral("kitten"),
+            .right = StringFromLiteral("sitting"),
+            .maxDistance = U64_MAX,
+            .expected = 3,
+        },
+        {.left = StringFromLiteral("sitting"), .right = StringFromLiteral("kitten"), .maxDistance = 3, .expected = 3},
+        {.left = StringFromLiteral("kitten"), .right = StringFromLiteral("sitting"), .maxDistance = 2, .expected = 3},
+        {.left = StringFromLiteral("flaw"), .right = StringFromLiteral("lawn"), .maxDistance = U64_MAX, .expected = 2},
+        {.left = StringFromLiteral("a"), .right = StringFromLiteral("bcdefg"), .maxDistance = 1, .expected = 2},
+        {.left = StringFromLiteral("commit"), .right = StringFromLiteral("comit"), .maxDistance = 2, .expected = 1},
+        {
+            .left = StringFromLiteral("intention"),
+            .right = StringFromLiteral("execution"),
+            .maxDistance = 10,
+            .expected = 5,
+        },
+        // 159 bytes, one substitution at 150, top block goes over limit first
+        {.left = {.length = 159}, .right = {.length = 159}, .maxDistance = 1, .expected = 1},
+        {.left = {.length = 159}, .right = {.length = 159}, .maxDistance = 2, .expected = 1},
+        {.left = {.length = 159}, .right = {.length = 159}, .maxDistance = 4, .expected = 1},
+        {.left = {.length = 159}, .right = {.length = 159}, .maxDistance = 8, .expected = 1},
+        {.left = {.length = 159}, .right = {.length = 159}, .maxDistance = 16, .expected = 1},
+    };
+
+    static u8 leftBuffer[159];
+    static u8 rightBuffer[159];
+    for (u64 index = 0; index < ARRAY_COUNT(leftBuffer); index++)
+      leftBuffer[index] = rightBuffer[index] = (u8)('a' + index % 7);
+    rightBuffer[150] = 'z';
+
+    static u8 arenaBuffer[(256 + 3) * 3 * sizeof(u64)];
+    memory_arena arena = {.block = arenaBuffer, .total = ARRAY_COUNT(arenaBuffer)};
+    for (u32 index = 0; index < ARRAY_COUNT(testCases); index++) {
+      struct test_case *testCase = testCases + index;
+      if (testCase->left.value == 0)
+        testCase->left.value = leftBuffer, testCase->right.value = rightBuffer;
+      u64 distance = 0;
+      b8 isComputed = StringEditDistance(&arena, &testCase->left, &testCase->right, testCase->maxDistance, &distance);
+      if (!isComputed || distance != testCase->expected) {
+        errorCode = TEXT_TEST_ERROR_STRING_EDIT_DISTANCE;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  left: ");
+        StringBuilderAppendString(sb, &testCase->left);
+        StringBuilderAppendStringLiteral(sb, "\n  right: ");
+        StringBuilderAppendString(sb, &testCase->right);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendU64(sb, testCase->expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendU64(sb, distance);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+  }
+
+  // b8 StringEditDistanceBatch(memory_arena *arena, struct string *query, struct string *candidates, u64 count,
+  //                            u64 maxDistance, u64 *distances)
+  {
+    // random strings over 3 letters up to 7 blocks long, compared with plain dynamic programming
+    enum { CANDIDATE_COUNT = 60, MAX_LENGTH = 400 };
+    static u8 textBuffer[(CANDIDATE_COUNT + 1) * MAX_LENGTH];
+    static struct string candidates[CANDIDATE_COUNT];
+    static u64 row[MAX_LENGTH + 1];
+    static u8 arenaBuffer[(256 + 3) * ((MAX_LENGTH + 63) / 64) * sizeof(u64)];
+    memory_arena arena = {.block = arenaBuffer, .total = ARRAY_COUNT(arenaBuffer)};
+
+    u64 random = 0x2545f4914f6cdd1d;
+    for (u32 round = 0; round < 40; round++) {
+      struct string strings[CANDIDATE_COUNT + 1];
+      for (u32 index = 0; index < CANDIDATE_COUNT + 1; index++) {
+        random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+        // mostly close lengths, so that limits are reached inside table
+        u64 length = index == 0 || (random & 3) ? (round * 10 + random % 16) % MAX_LENGTH : random % MAX_LENGTH;
+        u8 *text = textBuffer + index * MAX_LENGTH;
+        if (index != 0 && round % 2 == 1) {
+          // query with few substitutions, distance stays small while top rows go over limit
+          length = strings[0].length;
+          MemoryCopy(text, strings[0].value, length);
+          for (u64 edit = random % 4; edit != 0 && length != 0; edit--) {
+            random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+            text[random % length] = 'z';
+          }
+        } else {
+          for (u64 byteIndex = 0; byteIndex < length; byteIndex++) {
+            random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+            text[byteIndex] = (u8)('a' + random % 3);
+          }
+        }
+        strings[index] = StringFromBuffer(text, length);
+      }
+      struct string *query = strings;
+      MemoryCopy(candidates, strings + 1, sizeof(candidates));
+
+      u64 maxDistance = round % 4 == 0 ? U64_MAX : round % 4 == 1 ? round % 9 : round * 4;
+      u64 distances[CANDIDATE_COUNT];
+      b8 isComputed = StringEditDistanceBatch(&arena, query, candidates, CANDIDATE_COUNT, maxDistance, distances);
+
+      for (u32 index = 0; index < CANDIDATE_COUNT && isComputed; index++) {
+        struct string *candidate = candidates + index;
+        for (u64 column = 0; column <= candidate->length; column++)
+          row[column] = column;
+        for (u64 queryIndex = 0; queryIndex < query->length; queryIndex++) {
+          u64 diagonal = row[0];
+          row[0] = queryIndex + 1;
+          for (u64 column = 1; column <= candidate->length; column++) {
+            u64 above = row[column];
+            u64 cost = diagonal + (query->value[queryIndex] != candidate->value[column - 1]);
+            if (above + 1 < cost)
+              cost = above + 1;
+            if (row[column - 1] + 1 < cost)
+              cost = row[column - 1] + 1;
+            row[column] = cost;
+            diagonal = above;
+          }
+        }
+        u64 expected = row[candidate->length];
+        if (expected > maxDistance)
+          expected = maxDistance + 1;
+
+        u64 distance;
+        b8 isSingleComputed = StringEditDistance(&arena, candidate, query, maxDistance, &distance);
+        if (distances[index] != expected || !isSingleComputed || distance != expected || arena.used != 0) {
+          errorCode = TEXT_TEST_ERROR_STRING_EDIT_DISTANCE;
+
+          StringBuilderAppendErrorMessage(sb, errorCode);
+          StringBuilderAppendStringLiteral(sb, "\n  query: ");
+          StringBuilderAppendString(sb, query);
+          StringBuilderAppendStringLiteral(sb, "\n  candidate: ");
+          StringBuilderAppendString(sb, candidate);
+          StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+          StringBuilderAppendU64(sb, expected);
+          StringBuilderAppendStringLiteral(sb, "\n       got: ");
+          StringBuilderAppendU64(sb, distances[index]);
+          StringBuilderAppendStringLiteral(sb, "\n");
+          struct string errorMessage = StringBuilderFlush(sb);
+          PrintString(&errorMessage);
+          break;
+        }
+      }
+
+      if (!isComputed) {
+        errorCode = TEXT_TEST_ERROR_STRING_EDIT_DISTANCE;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  batch must fit in arena\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+
+    // arena too small for blocks of long query
+    memory_arena smallMemory = {.block = arenaBuffer, .total = 100};
+    struct string longString = StringFromBuffer(textBuffer, 100);
+    u64 distance;
+    if (StringEditDistance(&smallMemory, &longString, &longString, U64_MAX, &distance) || smallMemory.used != 0) {
+      errorCode = TEXT_TEST_ERROR_STRING_EDIT_DISTANCE;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n  must fail and leave arena untouched when full\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+  }
+
+  // b8 ParseTimestamp(struct string *string, struct timestamp *timestamp)
+  // Dependencies: IsStringEqual()
+  if (IsStringEqualOK) {
+    struct test_case {
+      struct string input;
+      b8 expected;
+      s64 ns;
+    } testCases[] = {
+        {.input = StringFromLiteral("1970-01-01T00:00:00Z"), .expected = 1, .ns = 0},
+        {.input = StringFromLiteral("1970-01-01T00:00:01.5Z"), .expected = 1, .ns = 1500000000},
+        {.input = StringFromLiteral("2024-03-09T14:05:59.123456789Z"), .expected = 1, .ns = 1709993159123456789},
+        {.input = StringFromLiteral("2024-03-09t14:05:59.1234567891234z"), .expected = 1, .ns = 1709993159123456789},
+        {.input = StringFromLiteral("2024-03-09 16:05:59.12345678+02:00"), .expected = 1, .ns = 1709993159123456780},
+        {.input = StringFromLiteral("2024-03-09T09:35:59.1-04:30"), .expected = 1, .ns = 1709993159100000000},
+        {.input = StringFromLiteral("2024-03-09T23:35:59+09:30"), .expected = 1, .ns = 1709993159000000000},
+        {.input = StringFromLiteral("2024-03-09T22:50:59+08:45"), .expected = 1, .ns = 1709993159000000000},
+        {.input = StringFromLiteral("2024-03-09T04:35:59-09:30"), .expected = 1, .ns = 1709993159000000000},
+        {.input = StringFromLiteral("2024-03-08T14:06:59-23:59"), .expected = 1, .ns = 1709993159000000000},
+        {.input = StringFromLiteral("2024-02-29T00:00:00Z"), .expected = 1, .ns = 1709164800000000000},
+        {.input = StringFromLiteral("2000-02-29T00:00:00Z"), .expected = 1, .ns = 951782400000000000},
+        {.input = StringFromLiteral("1969-12-31T23:59:59.999Z"), .expected = 1, .ns = -1000000},
+        {.input = StringFromLiteral("1900-01-01T00:00:00Z"), .expected = 1, .ns = -2208988800000000000},
+        {.input = StringFromLiteral("2016-12-31T23:59:60Z"), .expected = 1, .ns = 1483228800000000000},
+        {.input = StringFromLiteral("2262-04-11T23:47:15Z"), .expected = 1, .ns = 9223372035000000000},
+        {.input = StringFromLiteral("2262-04-11T23:47:16Z"), .expected = 0},
+        {.input = StringFromLiteral("1677-09-21T00:12:43Z"), .expected = 0},
+        {.input = StringFromLiteral("2023-02-29T00:00:00Z"), .expected = 0},
+        {.input = StringFromLiteral("1900-02-29T00:00:00Z"), .expected = 0},
+        {.input = StringFromLiteral("2024-04-31T00:00:00Z"), .expected = 0},
+        {.input = StringFromLiteral("2024-00-01T00:00:00Z"), .expected = 0},
+        {.input = StringFromLiteral("2024-13-01T00:00:00Z"), .expected = 0},
+        {.input = StringFromLiteral("2024-01-00T00:00:00Z"), .expected = 0},
+        {.input = StringFromLiteral("2024-01-01T24:00:00Z"), .expected = 0},
+        {.input = StringFromLiteral("2024-01-01T00:60:00Z"), .expected = 0},
+        {.input = StringFromLiteral("2024-01-01T00:00:61Z"), .expected = 0},
+        {.input = StringFromLiteral("2024-01-01T00:00:00"), .expected = 0},
+        {.input = StringFromLiteral("2024-01-01T00:00:00.Z"), .expected = 0},
+        {.input = StringFromLiteral("2024-01-01T00:00:00Zx"), .expected = 0},
+        {.input = StringFromLiteral("2024-01-01T00:00:00+2:00"), .expected = 0},
+        {.input = StringFromLiteral("2024-01-01T00:00:00+0a:00"), .expected = 0},
+        {.input = StringFromLiteral("2024-01-01T00:00:00+00:3/"), .expected = 0},
+        {.input = StringFromLiteral("2024-01-01T00:00:00+24:00"), .expected = 0},
+        {.input = StringFromLiteral("2024-01-01X00:00:00Z"), .expected = 0},
+        {.input = StringFromLiteral("2024/01/01T00:00:00Z"), .expected = 0},
+        {.input = StringFromLiteral("2O24-01-01T00:00:00Z"), .expected = 0},
+        {.input = StringFromLiteral("2024-01-01T00:00:0:Z"), .expected = 0},
+        {.input = StringFromLiteral("2024-01-01T00:00:00.12345678:Z"), .expected = 0},
+        {.input = StringNull(), .expected = 0},
+    };
+
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
 
-      if (got != expected) {
-        errorCode = TEXT_TEST_ERROR_STRING_LENGTH_NOT_CORRECT;
+      struct timestamp timestamp = {.ns = 0};
+      b8 value = ParseTimestamp(&testCase->input, &timestamp);
+      if (value != testCase->expected || (value && timestamp.ns != testCase->ns)) {
+        errorCode = TEXT_TEST_ERROR_PARSE_TIMESTAMP;
 
         StringBuilderAppendErrorMessage(sb, errorCode);
-        StringBuilderAppendStringLiteral(sb, "\n language: ");
-        StringBuilderAppendString(sb, &testCase->language);
-        StringBuilderAppendStringLiteral(sb, "\n    input: ");
-        StringBuilderAppendString(sb, input);
-        StringBuilderAppendStringLiteral(sb, "\n expected: ");
-        StringBuilderAppendU64(sb, expected);
-        StringBuilderAppendStringLiteral(sb, "\n      got: ");
-        StringBuilderAppendU64(sb, got);
+        StringBuilderAppendStringLiteral(sb, "\n  input:    ");
+        StringBuilderAppendPrintableString(sb, &testCase->input);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        if (testCase->expected)
+          StringBuilderAppendS64(sb, testCase->ns);
+        else
+          StringBuilderAppendStringLiteral(sb, "invalid");
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        if (value)
+          StringBuilderAppendS64(sb, timestamp.ns);
+        else
+          StringBuilderAppendStringLiteral(sb, "invalid");
         StringBuilderAppendStringLiteral(sb, "\n");
         struct string errorMessage = StringBuilderFlush(sb);
         PrintString(&errorMessage);
       }
     }
+
+    // every day in range, against counting days one by one
+    s64 days = DaysFromCivil(1677, 1, 1);
+    u8 daysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    for (u32 year = 1677; year <= 2262 && errorCode != TEXT_TEST_ERROR_PARSE_TIMESTAMP; year++) {
+      b8 isLeapYear = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+      for (u32 month = 1; month <= 12; month++) {
+        u32 dayCount = daysInMonth[month - 1] + (u32)(month == 2 && isLeapYear);
+        for (u32 day = 1; day <= dayCount; day++, days++) {
+          u32 gotYear, gotMonth, gotDay;
+          CivilFromDays(days, &gotYear, &gotMonth, &gotDay);
+          if (DaysFromCivil(year, month, day) != days || gotYear != year || gotMonth != month || gotDay != day) {
+            errorCode = TEXT_TEST_ERROR_PARSE_TIMESTAMP;
+
+            StringBuilderAppendErrorMessage(sb, errorCode);
+            StringBuilderAppendStringLiteral(sb, "\n  days from civil wrong at ");
+            StringBuilderAppendU64(sb, year);
+            StringBuilderAppendStringLiteral(sb, "-");
+            StringBuilderAppendU64(sb, month);
+            StringBuilderAppendStringLiteral(sb, "-");
+            StringBuilderAppendU64(sb, day);
+            StringBuilderAppendStringLiteral(sb, "\n");
+            struct string errorMessage = StringBuilderFlush(sb);
+            PrintString(&errorMessage);
+            break;
+          }
+        }
+      }
+    }
   }
 
-  // u32 StringIteratorNext(struct string_iterator *iterator)
-  {
-    struct test_case_expected {
-      u64 length;
-      u32 *codepoints;
+  // struct string FormatTimestamp(struct string *buffer, struct timestamp *timestamp, u32 fractionCount)
+  // Dependencies: IsStringEqual()
+  if (IsStringEqualOK) {
+    struct test_case {
+      s64 ns;
+      u32 fractionCount;
+      struct string expected;
+    } testCases[] = {
+        {.ns = 0, .fractionCount = 0, .expected = StringFromLiteral("1970-01-01T00:00:00Z")},
+        {
+            .ns = 1709993159123456789,
+            .fractionCount = 9,
+            .expected = StringFromLiteral("2024-03-09T14:05:59.123456789Z"),
+        },
+        {.ns = 1709993159123456789, .fractionCount = 3, .expected = StringFromLiteral("2024-03-09T14:05:59.123Z")},
+        {.ns = -1000000, .fractionCount = 3, .expected = StringFromLiteral("1969-12-31T23:59:59.999Z")},
+        {.ns = -2208988800000000000, .fractionCount = 1, .expected = StringFromLiteral("1900-01-01T00:00:00.0Z")},
+        {.ns = S64_MAX, .fractionCount = 9, .expected = StringFromLiteral("2262-04-11T23:47:16.854775807Z")},
+        {.ns = S64_MIN, .fractionCount = 9, .expected = StringFromLiteral("1677-09-21T00:12:43.145224192Z")},
     };
 
+    u8 buffer[32];
+    struct string stringBuffer = StringFromBuffer(buffer, sizeof(buffer));
+    for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
+      struct test_case *testCase = testCases + testCaseIndex;
+
+      struct timestamp timestamp = {.ns = testCase->ns};
+      struct string value = FormatTimestamp(&stringBuffer, &timestamp, testCase->fractionCount);
+      if (!IsStringEqual(&value, &testCase->expected)) {
+        errorCode = TEXT_TEST_ERROR_FORMAT_TIMESTAMP;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  input:    ");
+        StringBuilderAppendS64(sb, testCase->ns);
+        StringBuilderAppendStringLiteral(sb, "\n  expected: ");
+        StringBuilderAppendString(sb, &testCase->expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendPrintableString(sb, &value);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
+
+    // buffer too small
+    struct string smallBuffer = StringFromBuffer(buffer, 23);
+    struct timestamp timestamp = {.ns = 0};
+    struct string truncated = FormatTimestamp(&smallBuffer, &timestamp, 3);
+    if (!IsStringNull(&truncated)) {
+      errorCode = TEXT_TEST_ERROR_FORMAT_TIMESTAMP;
+
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n  must fail when buffer is too small\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
+    }
+
+    // random timestamps parse back to same value
+    u64 random = 0x9e3779b97f4a7c15;
+    for (u32 trial = 0; trial < 100000; trial++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      // last second of range cannot be parsed
+      timestamp.ns = (s64)random;
+      if (timestamp.ns > 9223372035999999999 || timestamp.ns < -9223372036000000000)
+        continue;
+      struct string value = FormatTimestamp(&stringBuffer, &timestamp, 9);
+      struct timestamp parsed;
+      if (!ParseTimestamp(&value, &parsed) || parsed.ns != timestamp.ns) {
+        errorCode = TEXT_TEST_ERROR_FORMAT_TIMESTAMP;
+
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  input:    ");
+        StringBuilderAppendS64(sb, timestamp.ns);
+        StringBuilderAppendStringLiteral(sb, "\n  formatted: ");
+        StringBuilderAppendPrintableString(sb, &value);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+        break;
+      }
+    }
+  }
+
+  // struct string FormatDuration(struct string *buffer, struct duration *duration)
+  // struct string FormatDurationFixed(struct string *buffer, struct duration *duration, u32 fractionCount)
+  // Dependencies: IsStringEqual()
+  if (IsStringEqualOK) {
     struct test_case {
-      struct string language;
-      struct string input;
-      struct test_case_expected expected;
+      u64 ns;
+      u32 fractionCount;
+      struct string expected;
+      struct string expectedFixed;
     } testCases[] = {
+        {.ns = 0, .fractionCount = 3, .expected = StringFromLiteral("0"), .expectedFixed = StringFromLiteral("0ns")},
+        {.ns = 7, .fractionCount = 3, .expected = StringFromLiteral("7ns"), .expectedFixed = StringFromLiteral("7ns")},
         {
-            .language = StringFromLiteral("Arabic"),
-            .input = StringFromLiteral("مرحبا"),
-            .expected =
-                {
-                    .length = 5,
-                    .codepoints =
-                        (u32[]){
-                            0x0645,
-                            0x0631,
-                            0x062D,
-                            0x0628,
-                            0x0627,
-                        },
-                },
+            .ns = 850,
+            .fractionCount = 3,
+            .expected = StringFromLiteral("850ns"),
+            .expectedFixed = StringFromLiteral("850ns"),
         },
         {
-            .language = StringFromLiteral("Cantonese Chinese"),
-            .input = StringFromLiteral("哈囉"),
-            .expected =
-                {
-                    .length = 2,
-                    .codepoints =
-                        (u32[]){
-                            0x54C8,
-                            0x56C9,
-                        },
-                },
+            .ns = 1000,
+            .fractionCount = 3,
+            .expected = StringFromLiteral("1us"),
+            .expectedFixed = StringFromLiteral("1.000us"),
         },
         {
-            .language = StringFromLiteral("Japanese"),
-            .input = StringFromLiteral("こんにちは"),
-            .expected =
-                {
-                    .length = 5,
-                    .codepoints =
-                        (u32[]){
-                            0x3053,
-                            0x3093,
-                            0x306B,
-                            0x3061,
-                            0x306F,
-                        },
-                },
+            .ns = 12500,
+            .fractionCount = 1,
+            .expected = StringFromLiteral("12us500ns"),
+            .expectedFixed = StringFromLiteral("12.5us"),
         },
         {
-            .language = StringFromLiteral("Korean"),
-            .input = StringFromLiteral("안녕하세요"),
-            .expected =
-                {
-                    .length = 5,
-                    .codepoints =
-                        (u32[]){
-                            0xC548,
-                            0xB155,
-                            0xD558,
-                            0xC138,
-                            0xC694,
-                        },
-                },
+            .ns = 1234567,
+            .fractionCount = 3,
+            .expected = StringFromLiteral("1ms234us567ns"),
+            .expectedFixed = StringFromLiteral("1.234ms"),
         },
         {
-            .language = StringFromLiteral("Mandarin Chinese"),
-            .input = StringFromLiteral("你好"),
-            .expected =
-                {
-                    .length = 2,
-                    .codepoints =
-                        (u32[]){
-                            0x4F60,
-                            0x597D,
-                        },
-                },
+            .ns = 999999999,
+            .fractionCount = 0,
+            .expected = StringFromLiteral("999ms999us999ns"),
+            .expectedFixed = StringFromLiteral("999ms"),
         },
         {
-            .language = StringFromLiteral("Polish"),
-            .input = StringFromLiteral("Cześć"),
-            .expected =
-                {
-                    .length = 5,
-                    .codepoints =
-                        (u32[]){
-                            0x0043,
-                            0x007A,
-                            0x0065,
-                            0x015B,
-                            0x0107,
-                        },
-                },
+            .ns = 90005000000,
+            .fractionCount = 9,
+            .expected = StringFromLiteral("1min30sec5ms"),
+            .expectedFixed = StringFromLiteral("90.005000000sec"),
         },
         {
-            .language = StringFromLiteral("Urdu"),
-            .input = StringFromLiteral("سلام"),
-            .expected =
-                {
-                    .length = 4,
-                    .codepoints =
-                        (u32[]){
-                            0x0633,
-                            0x0644,
-                            0x0627,
-                            0x0645,
-                        },
-                },
+            .ns = 1000000000ull * 60 * 60 * 24 * 8 + 3600000000000,
+            .fractionCount = 2,
+            .expected = StringFromLiteral("1wk1day1hr"),
+            .expectedFixed = StringFromLiteral("694800.00sec"),
         },
         {
-            .language = StringFromLiteral("Vietnamese"),
-            .input = StringFromLiteral("Xin chào"),
-            .expected =
-                {
-                    .length = 8,
-                    .codepoints =
-                        (u32[]){
-                            0x0058,
-                            0x0069,
-                            0x006E,
-                            0x0020,
-                            0x0063,
-                            0x0068,
-                            0x00E0,
-                            0x006F,
-                        },
-                },
+            .ns = U64_MAX,
+            .fractionCount = 9,
+            .expected = StringFromLiteral("30500wk3day23hr34min33sec709ms551us615ns"),
+            .expectedFixed = StringFromLiteral("18446744073.709551615sec"),
         },
     };
 
+    u8 buffer[48];
+    struct string stringBuffer = StringFromBuffer(buffer, sizeof(buffer));
     for (u32 testCaseIndex = 0; testCaseIndex < ARRAY_COUNT(testCases); testCaseIndex++) {
       struct test_case *testCase = testCases + testCaseIndex;
 
-      struct string *input = &testCase->input;
-      struct test_case_expected *expected = &testCase->expected;
-      b8 isInputShown = 0;
+      struct duration duration = {.ns = testCase->ns};
+      struct string value = FormatDuration(&stringBuffer, &duration);
+      b8 isEqual = IsStringEqual(&value, &testCase->expected);
+      struct string *expected = &testCase->expected;
+      if (isEqual) {
+        value = FormatDurationFixed(&stringBuffer, &duration, testCase->fractionCount);
+        isEqual = IsStringEqual(&value, &testCase->expectedFixed);
+        expected = &testCase->expectedFixed;
+      }
+      if (!isEqual) {
+        errorCode = TEXT_TEST_ERROR_FORMAT_DURATION;
 
-      u64 index = 0;
-      for (struct string_iterator iterator = StringIteratorFrom(input); StringIteratorHasNext(&iterator); index++) {
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  input:    ");
+        StringBuilderAppendU64(sb, testCase->ns);
+        StringBuilderAppendStringLiteral(sb, "ns\n  expected: ");
+        StringBuilderAppendString(sb, expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendPrintableString(sb, &value);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
 
-        if (index >= expected->length) {
-          errorCode = TEXT_TEST_ERROR_STRING_ITERATOR_LOOP_OVERFLOW;
+    // random durations of every magnitude, against dividing by each unit
+    u64 random = 0x9e3779b97f4a7c15;
+    u64 unitsInNanoseconds[] = {
+        1000000000ull * 60 * 60 * 24 * 7, 1000000000ull * 60 * 60 * 24, 1000000000ull * 60 * 60,
+        1000000000ull * 60,               1000000000ull,                1000000ull,
+        1000ull,                          1ull,
+    };
+    struct string unitStrings[] = {
+        StringFromLiteral("wk"),  StringFromLiteral("day"), StringFromLiteral("hr"), StringFromLiteral("min"),
+        StringFromLiteral("sec"), StringFromLiteral("ms"),  StringFromLiteral("us"), StringFromLiteral("ns"),
+    };
+    for (u32 trial = 0; trial < 100000 && errorCode != TEXT_TEST_ERROR_FORMAT_DURATION; trial++) {
+      random ^= random << 13, random ^= random >> 7, random ^= random << 17;
+      struct duration duration = {.ns = random >> (random % 64)};
 
-          StringBuilderAppendErrorMessage(sb, errorCode);
-          if (!isInputShown) {
-            StringBuilderAppendStringLiteral(sb, "\n language: ");
-            StringBuilderAppendString(sb, &testCase->language);
-            StringBuilderAppendStringLiteral(sb, "\n    input: ");
-            StringBuilderAppendString(sb, input);
-            isInputShown = 1;
-          }
-          StringBuilderAppendStringLiteral(sb, "\n  maximum length: ");
-          StringBuilderAppendU64(sb, expected->length);
+      u8 expectedBuffer[64];
+      u64 expectedLength = 0;
+      u64 remaining = duration.ns;
+      for (u32 unitIndex = 0; unitIndex < ARRAY_COUNT(unitsInNanoseconds); unitIndex++) {
+        u64 count = remaining / unitsInNanoseconds[unitIndex];
+        remaining -= count * unitsInNanoseconds[unitIndex];
+        if (count == 0)
+          continue;
+        struct string digitBuffer = StringFromBuffer(expectedBuffer + expectedLength, 20);
+        expectedLength += FormatU64(&digitBuffer, count).length;
+        MemoryCopy(expectedBuffer + expectedLength, unitStrings[unitIndex].value, unitStrings[unitIndex].length);
+        expectedLength += unitStrings[unitIndex].length;
+      }
+      if (duration.ns == 0)
+        expectedBuffer[expectedLength++] = '0';
+      struct string expected = StringFromBuffer(expectedBuffer, expectedLength);
 
-          struct string errorMessage = StringBuilderFlush(sb);
-          PrintString(&errorMessage);
-          break;
-        }
+      struct string value = FormatDuration(&stringBuffer, &duration);
+      if (!IsStringEqual(&value, &expected)) {
+        errorCode = TEXT_TEST_ERROR_FORMAT_DURATION;
 
-        u32 expectedCodepoint = *(expected->codepoints + index);
-        u32 codepoint = StringIteratorNext(&iterator);
-        if (codepoint != expectedCodepoint) {
-          errorCode = TEXT_TEST_ERROR_STRING_ITERATOR_DECODE_UTF8;
+        StringBuilderAppendErrorMessage(sb, errorCode);
+        StringBuilderAppendStringLiteral(sb, "\n  input:    ");
+        StringBuilderAppendU64(sb, duration.ns);
+        StringBuilderAppendStringLiteral(sb, "ns\n  expected: ");
+        StringBuilderAppendString(sb, &expected);
+        StringBuilderAppendStringLiteral(sb, "\n       got: ");
+        StringBuilderAppendPrintableString(sb, &value);
+        StringBuilderAppendStringLiteral(sb, "\n");
+        struct string errorMessage = StringBuilderFlush(sb);
+        PrintString(&errorMessage);
+      }
+    }
 
-          if (!isInputShown) {
-            StringBuilderAppendErrorMessage(sb, errorCode);
-            StringBuilderAppendStringLiteral(sb, "\n  language: ");
-            StringBuilderAppendString(sb, &testCase->language);
-            StringBuilderAppendStringLiteral(sb, "\n     input: ");
-            StringBuilderAppendString(sb, input);
-            StringBuilderAppendStringLiteral(sb, "\n");
-            isInputShown = 1;
-          }
+    // buffer too small
+    struct string smallBuffer = StringFromBuffer(buffer, 47);
+    struct duration duration = {.ns = 5};
+    struct string value = FormatDuration(&smallBuffer, &duration);
+    struct string valueFixed = FormatDurationFixed(&smallBuffer, &duration, 3);
+    if (!IsStringNull(&value) || !IsStringNull(&valueFixed)) {
+      errorCode = TEXT_TEST_ERROR_FORMAT_DURATION;
 
-          StringBuilderAppendStringLiteral(sb, "\n     index: ");
-          StringBuilderAppendU64(sb, index);
-          StringBuilderAppendStringLiteral(sb, "\n  expected: ");
-          StringBuilderAppendCodepoint(sb, expectedCodepoint);
-          StringBuilderAppendStringLiteral(sb, "\n       got: ");
-          StringBuilderAppendCodepoint(sb, codepoint);
-          StringBuilderAppendStringLiteral(sb, "\n");
-          struct string errorMessage = StringBuilderFlush(sb);
-          PrintString(&errorMessage);
-        }
-      }
+      StringBuilderAppendErrorMessage(sb, errorCode);
+      StringBuilderAppendStringLiteral(sb, "\n  must fail when buffer is too small\n");
+      struct string errorMessage = StringBuilderFlush(sb);
+      PrintString(&errorMessage);
     }
   }
 
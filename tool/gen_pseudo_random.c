@@ -2,7 +2,22 @@
 #include "string_builder.h"
 #include "string_cursor.h"
 
-// TODO: refactor parsing options to be more easy
+enum option {
+  OPTION_UNKNOWN,
+  OPTION_TEMPLATE,
+  OPTION_COUNT,
+  OPTION_HELP,
+};
+
+#define OPTION_LIST(X)                                                                                                 \
+  X(OPTION_TEMPLATE, "-t")                                                                                             \
+  X(OPTION_TEMPLATE, "--template")                                                                                     \
+  X(OPTION_COUNT, "-c")                                                                                                \
+  X(OPTION_COUNT, "--count")                                                                                           \
+  X(OPTION_HELP, "-h")                                                                                                 \
+  X(OPTION_HELP, "--help")
+
+STRING_SWITCH(ParseOption, enum option, OPTION_LIST, OPTION_UNKNOWN)
 
 struct options {
   u32 randomNumberCount;
@@ -47,7 +62,8 @@ main(int argc, char *argv[])
   for (u32 argumentIndex = 1; argumentIndex < argumentCount; argumentIndex++) {
     string option = StringFromZeroTerminated((u8 *)argv[argumentIndex], 1024);
 
-    if (IsStringEqual(&option, &StringFromLiteral("-t")) || IsStringEqual(&option, &StringFromLiteral("--template"))) {
+    enum option parsed = ParseOption(&option);
+    if (parsed == OPTION_TEMPLATE) {
       if (!IsStringNullOrEmpty(&options->templatePath)) {
         PrintString(&StringFromLiteral("Only one template file is allowed\n"));
         return -1;
@@ -78,8 +94,7 @@ main(int argc, char *argv[])
       }
 
       options->templatePath = value;
-    } else if (IsStringEqual(&option, &StringFromLiteral("-c")) ||
-               IsStringEqual(&option, &StringFromLiteral("--count"))) {
+    } else if (parsed == OPTION_COUNT) {
       argumentIndex++;
       if (argumentIndex == argumentCount) {
         PrintString(&StringFromLiteral("Count is required to take positive value\n"));
@@ -113,8 +128,7 @@ main(int argc, char *argv[])
       }
 
       options->randomNumberCount = (u32)randomNumberCount;
-    } else if (IsStringEqual(&option, &StringFromLiteral("-h")) ||
-               IsStringEqual(&option, &StringFromLiteral("--help"))) {
+    } else if (parsed == OPTION_HELP) {
       StringBuilderAppendStringLiteral(sb, "NAME");
       StringBuilderAppendStringLiteral(sb, "\n  gen_pseudo_random - Generate pseudo random numbers with template");
       StringBuilderAppendStringLiteral(sb, "\n\nSYNOPSIS:");
@@ -229,11 +243,10 @@ main(int argc, char *argv[])
     }
   }
 
-  // Read template
-  string *templateBuffer = MakeString(&stackMemory, 256 * KILOBYTES);
-  string template;
+  // Open template, it is read in pieces into window
+  struct platform_file templateFile;
   {
-    enum platform_error error = PlatformReadFile(templateBuffer, &options->templatePath, &template);
+    enum platform_error error = PlatformOpenFile(&options->templatePath, &templateFile);
     if (error != IO_ERROR_NONE) {
       StringBuilderAppendStringLiteral(sb, "Error: file not read\n");
 
@@ -244,8 +257,6 @@ main(int argc, char *argv[])
       StringBuilderAppendStringLiteral(sb, "  ");
       if (error == IO_ERROR_FILE_NOT_FOUND)
         StringBuilderAppendStringLiteral(sb, "File not found");
-      else if (error == IO_ERROR_BUFFER_OUT_OF_MEMORY)
-        StringBuilderAppendStringLiteral(sb, "File is too big");
       else if (error == IO_ERROR_PLATFORM)
         StringBuilderAppendPlatformError(sb);
 
@@ -254,60 +265,56 @@ main(int argc, char *argv[])
       PrintString(&message);
       return -1;
     }
+  }
 
-    if (IsStringNullOrEmpty(&template)) {
-      // file is not valid
-      StringBuilderAppendStringLiteral(sb, "Error: file is not valid");
-      string message = StringBuilderFlush(sb);
-      PrintString(&message);
-      return 1;
-    }
+  string *templateWindow = MakeString(&stackMemory, 16 * KILOBYTES);
+  struct string_stream templateStream = StringStreamFrom(templateWindow, PlatformFileRead, &templateFile);
+  if (IsStringStreamAtEnd(&templateStream)) {
+    // file is not valid
+    PlatformCloseFile(&templateFile);
+    StringBuilderAppendStringLiteral(sb, "Error: file is not valid");
+    string message = StringBuilderFlush(sb);
+    PrintString(&message);
+    return 1;
   }
+
   // TODO: Write output to a file
 
   // Replace variables with values
-  string_cursor templateCursor = StringCursorFromString(&template);
   while (1) {
     string *variableMagicStart = &StringFromLiteral("$$");
     string *variableMagicEnd = variableMagicStart;
 
-    string beforeVariable = StringCursorConsumeUntilOrRest(&templateCursor, variableMagicStart);
+    string beforeVariable = StringStreamConsumeUntilOrRest(&templateStream, variableMagicStart);
     if (beforeVariable.length != 0)
       PrintString(&beforeVariable);
-    if (IsStringCursorAtEnd(&templateCursor))
+    if (IsStringStreamAtEnd(&templateStream))
       break;
-    templateCursor.position += variableMagicStart->length;
-
-    u64 variableStartPosition = templateCursor.position;
-    string variable = StringCursorConsumeUntil(&templateCursor, variableMagicEnd);
-    if (IsStringCursorAtEnd(&templateCursor))
+    // text longer than window is printed in pieces
+    if (!StringStreamPeekStartsWith(&templateStream, variableMagicStart))
+      continue;
+    templateStream.position += variableMagicStart->length;
+
+    u64 variableStartPosition = templateStream.offset + templateStream.position;
+    string variable = StringStreamConsumeUntil(&templateStream, variableMagicEnd);
+    if (IsStringNull(&variable))
       break;
 
-    templateCursor.position += variableMagicEnd->length;
+    templateStream.position += variableMagicEnd->length;
 
     if (IsStringEqual(&variable, &StringFromLiteral("RANDOM_NUMBER_TABLE"))) {
       u32 batchCount = 8192;
+      u32 maxRandomNumberPerLine = 16;
       for (u32 batch = 0; batch < options->randomNumberCount; batch += batchCount) {
-        for (u32 randomNumberIndex = batch; randomNumberIndex < Minimum(batch + batchCount, options->randomNumberCount);
-             randomNumberIndex++) {
-          u32 randomNumber = *(randomNumbers + randomNumberIndex);
-
-          StringBuilderAppendStringLiteral(sb, "0x");
-          string randomNumberInHex = FormatHex(sb->stringBuffer, randomNumber);
-          if (randomNumberInHex.length < 8) {
-            string sliced = StringSlice(&StringFromLiteral("00000000"), 0, 8 - randomNumberInHex.length);
-            StringBuilderAppendString(sb, &sliced);
-          }
-          StringBuilderAppendString(sb, &randomNumberInHex);
-
-          b8 isNotLastOne = randomNumberIndex + 1 != options->randomNumberCount;
-          if (isNotLastOne)
-            StringBuilderAppendStringLiteral(sb, ", ");
+        for (u32 line = batch; line < Minimum(batch + batchCount, options->randomNumberCount);
+             line += maxRandomNumberPerLine) {
+          u32 lineCount = Minimum(maxRandomNumberPerLine, options->randomNumberCount - line);
+          StringBuilderAppendU32Array(sb, randomNumbers + line, lineCount, &StringFromLiteral(", "),
+                                      &StringFromLiteral("0x"), STRING_BUILDER_RADIX_HEX_FIXED);
 
-          u32 maxRandomNumberPerLine = 16;
-          b8 isMaxPerLine = (randomNumberIndex + 1) % maxRandomNumberPerLine == 0;
-          if (isMaxPerLine && isNotLastOne)
-            StringBuilderAppendStringLiteral(sb, "\n");
+          b8 isNotLastOne = line + lineCount != options->randomNumberCount;
+          if (isNotLastOne)
+            StringBuilderAppendStringLiteral(sb, ", \n");
         }
 
         string message = StringBuilderFlush(sb);
@@ -338,4 +345,14 @@ main(int argc, char *argv[])
       return 1;
     }
   }
+
+  PlatformCloseFile(&templateFile);
+  if (templateStream.isFailed) {
+    StringBuilderAppendStringLiteral(sb, "Error: file not read\n  ");
+    StringBuilderAppendPlatformError(sb);
+    StringBuilderAppendStringLiteral(sb, "\n");
+    string message = StringBuilderFlush(sb);
+    PrintString(&message);
+    return -1;
+  }
 }
@@ -24,6 +24,22 @@ PlatformIsFileExists(struct string *path, enum platform_error *error);
 internalfn enum platform_error
 PlatformReadFile(struct string *buffer, struct string *path, struct string *content);
 
+// defined by platform
+struct platform_file;
+
+internalfn enum platform_error
+PlatformOpenFile(struct string *path, struct platform_file *file);
+
+/*
+ * Source of string_stream.
+ * @param context struct platform_file
+ */
+internalfn u64
+PlatformFileRead(void *context, u8 *buffer, u64 length);
+
+internalfn void
+PlatformCloseFile(struct platform_file *file);
+
 #if IS_PLATFORM_LINUX
 #include "platform_linux.c"
 #elif IS_PLATFORM_WINDOWS
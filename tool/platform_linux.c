@@ -102,3 +102,41 @@ failure:
   close(fd);
   return error;
 }
+
+struct platform_file {
+  int fd;
+};
+
+internalfn enum platform_error
+PlatformOpenFile(struct string *path, struct platform_file *file)
+{
+  debug_assert(path->value[path->length] == 0 && "must be zero-terminated string");
+  file->fd = open((char *)path->value, O_RDONLY);
+  if (file->fd < 0) {
+    // e.g. EACCES or EMFILE, errno is kept for StringBuilderAppendPlatformError()
+    if (errno == ENOENT || errno == ENOTDIR)
+      return IO_ERROR_FILE_NOT_FOUND;
+    return IO_ERROR_PLATFORM;
+  }
+  return IO_ERROR_NONE;
+}
+
+internalfn u64
+PlatformFileRead(void *context, u8 *buffer, u64 length)
+{
+  struct platform_file *file = context;
+  s64 readBytes;
+  do {
+    readBytes = read(file->fd, buffer, length);
+  } while (readBytes == -1 && errno == EINTR);
+
+  if (readBytes == -1)
+    return U64_MAX;
+  return (u64)readBytes;
+}
+
+internalfn void
+PlatformCloseFile(struct platform_file *file)
+{
+  close(file->fd);
+}
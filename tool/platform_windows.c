@@ -96,3 +96,45 @@ failure:
   CloseHandle(file);
   return error;
 }
+
+struct platform_file {
+  HANDLE handle;
+};
+
+internalfn enum platform_error
+PlatformOpenFile(struct string *path, struct platform_file *file)
+{
+  debug_assert(path->value[path->length] == 0 && "must be zero-terminated string");
+  file->handle =
+      CreateFileA((char *)path->value, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+  if (file->handle == INVALID_HANDLE_VALUE) {
+    DWORD error = GetLastError();
+    if (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND)
+      return IO_ERROR_FILE_NOT_FOUND;
+    return IO_ERROR_PLATFORM;
+  }
+  return IO_ERROR_NONE;
+}
+
+internalfn u64
+PlatformFileRead(void *context, u8 *buffer, u64 length)
+{
+  struct platform_file *file = context;
+  if (length > U32_MAX)
+    length = U32_MAX;
+
+  DWORD readBytes;
+  if (!ReadFile(file->handle, buffer, (u32)length, &readBytes, 0)) {
+    // write end of pipe is closed
+    if (GetLastError() == ERROR_BROKEN_PIPE)
+      return 0;
+    return U64_MAX;
+  }
+  return (u64)readBytes;
+}
+
+internalfn void
+PlatformCloseFile(struct platform_file *file)
+{
+  CloseHandle(file->handle);
+}